@@ -35,6 +35,25 @@ int Arduino_HTTP_Client::get(char const * url_path) {
     return m_http_client.get(url_path);
 }
 
+size_t Arduino_HTTP_Client::read_response_body(uint8_t * buffer, size_t size) {
+    if (m_http_client.skipResponseHeaders() != HTTP_SUCCESS) {
+        return 0U;
+    }
+    // The underlying read does not wait for data to be received, therefore we have to wait ourselves until atleast one byte is available
+    unsigned long const start = millis();
+    while (!m_http_client.endOfBodyReached() && millis() - start < HTTP_READ_TIMEOUT_MILLISECONDS) {
+        int const read = m_http_client.read(buffer, size);
+        if (read > 0) {
+            return read;
+        }
+        else if (!m_http_client.connected()) {
+            break;
+        }
+        yield();
+    }
+    return 0U;
+}
+
 #if THINGSBOARD_ENABLE_STL
 std::string Arduino_HTTP_Client::get_response_body() {
     return m_http_client.responseBody().c_str();
@@ -10,6 +10,10 @@
 #include <ArduinoHttpClient.h>
 
 
+// Maximum amount of time in milliseconds we wait for the next bytes of the response body, the same as the response timeout of the ArduinoHttpClient
+unsigned long constexpr HTTP_READ_TIMEOUT_MILLISECONDS = 30U * 1000U;
+
+
 /// @brief HTTP Client interface implementation that uses the ArduinoHttpClient (https://github.com/arduino-libraries/ArduinoHttpClient),
 /// under the hood to establish and communicate over an HTTP connection
 class Arduino_HTTP_Client : public IHTTP_Client {
@@ -36,6 +40,8 @@ class Arduino_HTTP_Client : public IHTTP_Client {
 
     int get(char const * url_path) override;
 
+    size_t read_response_body(uint8_t * buffer, size_t size) override;
+
 #if THINGSBOARD_ENABLE_STL
     std::string get_response_body() override;
 #else
@@ -68,6 +68,11 @@ bool Arduino_MQTT_Client::connected() {
     return m_mqtt_client.connected();
 }
 
+bool Arduino_MQTT_Client::authentication_rejected() {
+    int const state = m_mqtt_client.state();
+    return state == MQTT_CONNECT_BAD_CREDENTIALS || state == MQTT_CONNECT_UNAUTHORIZED;
+}
+
 #if THINGSBOARD_ENABLE_STREAM_UTILS
 
 bool Arduino_MQTT_Client::begin_publish(char const * topic, size_t const & length) {
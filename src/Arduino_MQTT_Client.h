@@ -47,12 +47,21 @@ class Arduino_MQTT_Client : public IMQTT_Client {
 
     bool publish(char const * topic, uint8_t const * payload, size_t const & length) override;
 
+    // The PubSubClient only supports subscribing with QoS level 1, but not publishing, therefore the default implementation failing messages with a higher QoS level is used
+    // and the callback set with set_publish_acknowledged_callback() is never called
+    using IMQTT_Client::publish;
+
     bool subscribe(char const * topic) override;
 
+    // The PubSubClient only supports subscribing a single topic filter per SUBSCRIBE packet, therefore the default implementation subscribing each topic seperately is used
+    using IMQTT_Client::subscribe;
+
     bool unsubscribe(char const * topic) override;
 
     bool connected() override;
 
+    bool authentication_rejected() override;
+
 #if THINGSBOARD_ENABLE_STREAM_UTILS
 
     bool begin_publish(char const * topic, size_t const & length) override;
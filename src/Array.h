@@ -175,6 +175,12 @@ class Array {
         }
     }
 
+    /// @brief Removes the last element of the underlying data container
+    void pop_back() {
+        assert(m_size != 0U);
+        m_size--;
+    }
+
     /// @brief Method to access an element at a given index,
     /// ensures the device crashes if we attempted to access in an invalid location
     /// @param index Index we want to get the corresponding element for
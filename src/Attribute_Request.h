@@ -4,10 +4,11 @@
 // Local includes.
 #include "Attribute_Request_Callback.h"
 #include "IAPI_Implementation.h"
+#include "Topic_Builder.h"
 
 
 // Attribute request API topics.
-char constexpr ATTRIBUTE_REQUEST_TOPIC[] = "v1/devices/me/attributes/request/%u";
+char constexpr ATTRIBUTE_REQUEST_TOPIC[] = "v1/devices/me/attributes/request/";
 char constexpr ATTRIBUTE_RESPONSE_SUBSCRIBE_TOPIC[] = "v1/devices/me/attributes/response/+";
 char constexpr ATTRIBUTE_RESPONSE_TOPIC[] = "v1/devices/me/attributes/response/";
 // Client side attribute request keys.
@@ -41,7 +42,11 @@ template<size_t MaxSubscriptions = Default_Subscriptions_Amount, size_t MaxAttri
 class Attribute_Request : public IAPI_Implementation {
   public:
     /// @brief Constructor
-    Attribute_Request() = default;
+    Attribute_Request()
+      : m_request_topic(ATTRIBUTE_REQUEST_TOPIC)
+    {
+        // Nothing to do
+    }
 
     /// @brief Requests one client-side attribute calllback,
     /// that will be called if the key-value pair from the server for the given client-side attributes is received.
@@ -84,6 +89,7 @@ class Attribute_Request : public IAPI_Implementation {
     void Process_Json_Response(char const * topic, JsonDocument const & data) override {
         size_t const request_id = Helper::parseRequestId(ATTRIBUTE_RESPONSE_TOPIC, topic);
         JsonObjectConst object = data.template as<JsonObjectConst>();
+        size_t const previous_amount = m_attribute_request_callbacks.size();
 
 #if THINGSBOARD_ENABLE_STL
 #if THINGSBOARD_ENABLE_DYNAMIC
@@ -120,7 +126,7 @@ class Attribute_Request : public IAPI_Implementation {
 
             delete_callback:
             // Delete callback because the changes have been requested and the callback is no longer needed
-            Helper::remove(m_attribute_request_callbacks, it);
+            Helper::remove_unordered(m_attribute_request_callbacks, it);
 #if !THINGSBOARD_ENABLE_STL
             break;
 #endif // !THINGSBOARD_ENABLE_STL
@@ -128,9 +134,10 @@ class Attribute_Request : public IAPI_Implementation {
 
         // Unsubscribe from the shared attribute request topic,
         // if we are not waiting for any further responses with shared attributes from the server.
+        // Only done if this response removed the last request, because the topic is only referenced once while any request is pending.
         // Will be resubscribed if another request is sent anyway
-        if (m_attribute_request_callbacks.empty()) {
-            (void)Attributes_Request_Unsubscribe();
+        if (previous_amount != 0U && m_attribute_request_callbacks.empty()) {
+            (void)m_unsubscribe_topic_callback.Call_Callback(ATTRIBUTE_RESPONSE_SUBSCRIBE_TOPIC);
         }
     }
 
@@ -254,9 +261,7 @@ class Attribute_Request : public IAPI_Implementation {
         registered_callback->Set_Attribute_Key(attribute_response_key);
         registered_callback->Start_Timeout_Timer();
 
-        char topic[Helper::detectSize(ATTRIBUTE_REQUEST_TOPIC, request_id)] = {};
-        (void)snprintf(topic, sizeof(topic), ATTRIBUTE_REQUEST_TOPIC, request_id);
-        return m_send_json_callback.Call_Callback(topic, request_buffer, Helper::Measure_Json(request_buffer));
+        return m_send_json_callback.Call_Callback(m_request_topic.build(request_id), request_buffer, Helper::Measure_Json(request_buffer));
     }
 
     /// @brief Subscribes to attribute response topic
@@ -274,12 +279,15 @@ class Attribute_Request : public IAPI_Implementation {
             return false;
         }
 #endif // !THINGSBOARD_ENABLE_DYNAMIC
-        if (!m_subscribe_topic_callback.Call_Callback(ATTRIBUTE_RESPONSE_SUBSCRIBE_TOPIC)) {
+        // All requests share the same response topic, therefore it is only subscribed once for the first pending request
+        if (m_attribute_request_callbacks.empty() && !m_subscribe_topic_callback.Call_Callback(ATTRIBUTE_RESPONSE_SUBSCRIBE_TOPIC)) {
             Logger::printfln(SUBSCRIBE_TOPIC_FAILED, ATTRIBUTE_RESPONSE_SUBSCRIBE_TOPIC);
           return false;
         }
-        m_attribute_request_callbacks.push_back(callback);
+        // Only the callback methods have to be stored, because the attributes are not needed anymore once the request has been created
+        m_attribute_request_callbacks.push_back({});
         registered_callback = &m_attribute_request_callbacks.back();
+        registered_callback->Assign_Without_Attributes(callback);
         return true;
     }
 
@@ -287,6 +295,9 @@ class Attribute_Request : public IAPI_Implementation {
     /// @return Whether unsubcribing the previously subscribed callbacks
     /// and from the  attribute response topic, was successful or not
     bool Attributes_Request_Unsubscribe() {
+        if (m_attribute_request_callbacks.empty()) {
+            return true;
+        }
         m_attribute_request_callbacks.clear();
         return m_unsubscribe_topic_callback.Call_Callback(ATTRIBUTE_RESPONSE_SUBSCRIBE_TOPIC);
     }
@@ -295,6 +306,7 @@ class Attribute_Request : public IAPI_Implementation {
     Callback<bool, char const * const>                                       m_subscribe_topic_callback = {};    // Subscribe mqtt topic client callback
     Callback<bool, char const * const>                                       m_unsubscribe_topic_callback = {};  // Unubscribe mqtt topic client callback
     Callback<size_t *>                                                       m_get_request_id_callback = {};     // Get internal request id callback
+    Topic_Builder<sizeof(ATTRIBUTE_REQUEST_TOPIC) + MAX_NUMBER_CHARACTERS>   m_request_topic;                    // Request topic with the request id of the sent request appended
 
     // Vectors or array (depends on wheter if THINGSBOARD_ENABLE_DYNAMIC is set to 1 or 0), hold copy of the actual passed data, this is to ensure they stay valid,
     // even if the user only temporarily created the object before the method was called.
@@ -303,7 +315,8 @@ class Attribute_Request : public IAPI_Implementation {
     // arise if references were used and the end user does not take care to ensure the Callbacks live on for the entirety
     // of its usage, which will lead to dangling references and undefined behaviour.
     // Therefore copy-by-value has been choosen as for this specific use case it is more advantageous,
-    // especially because at most we copy internal vectors or array, that will only ever contain a few pointers
+    // especially because at most we copy internal vectors or array, that will only ever contain a few pointers.
+    // The requested attributes are not copied at all, because they are only needed to create the request
 #if THINGSBOARD_ENABLE_DYNAMIC
     Vector<Attribute_Request_Callback>                                       m_attribute_request_callbacks = {}; // Client-side or shared attribute request callback vector
 #else
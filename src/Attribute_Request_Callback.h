@@ -122,6 +122,19 @@ class Attribute_Request_Callback : public Callback<void, JsonObjectConst const &
         m_attributes.assign(args...);
     }
 
+    /// @brief Copies the callback methods, the timeout and the request settings of the given callback, but not its requested client-side or shared attributes.
+    /// Used to store the callback once the request has been sent, because the attributes are only needed to create the request and not to handle the response,
+    /// which avoids the heap allocation copying the attributes would require if THINGSBOARD_ENABLE_DYNAMIC is set
+    /// @param other Callback that should be copied
+    void Assign_Without_Attributes(Attribute_Request_Callback const & other) {
+        Callback::operator=(other);
+        m_attributes.clear();
+        m_request_id = other.m_request_id;
+        m_attribute_key = other.m_attribute_key;
+        m_timeout_microseconds = other.m_timeout_microseconds;
+        m_timeout_callback = other.m_timeout_callback;
+    }
+
     /// @brief Gets the amount of microseconds until we expect to have received a response
     /// @return Timeout time until timeout callback is called
     uint64_t const & Get_Timeout() const {
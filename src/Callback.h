@@ -8,6 +8,7 @@
 #else
 #include "Array.h"
 #endif // !THINGSBOARD_ENABLE_STL && THINGSBOARD_ENABLE_DYNAMIC
+#include "Inplace_Function.h"
 
 // Library includes.
 #include <ArduinoJson.h>
@@ -24,8 +25,9 @@ using Vector = std::vector<T>;
 #endif // THINGSBOARD_ENABLE_STL && THINGSBOARD_ENABLE_DYNAMIC
 
 
-/// @brief General purpose safe callback wrapper. Expects either c-style or c++ style function pointer,
-/// depending on if the C++ STL has been implemented on the given device or not.
+/// @brief General purpose safe callback wrapper. Expects either c-style function pointer or any c++ style callable that fits into an Inplace_Function,
+/// depending on if the C++ STL has been implemented on the given device or not. The Inplace_Function is used instead of std::function,
+/// because it never allocates memory on the heap when a callable is registered or the callback is copied.
 /// Simply wraps that function pointer and before calling it ensures it actually exists
 /// @tparam return_typ Type the given callback method should return
 /// @tparam argument_types Types the given callback method should receive
@@ -34,7 +36,7 @@ class Callback {
   public:
     /// @brief Callback signature
 #if THINGSBOARD_ENABLE_STL
-    using function = std::function<return_typ(argument_types... arguments)>;
+    using function = Inplace_Function<return_typ(argument_types... arguments)>;
 #else
     using function = return_typ (*)(argument_types... arguments);
 #endif // THINGSBOARD_ENABLE_STL
@@ -7,6 +7,8 @@
 // Library includes.
 #if THINGSBOARD_USE_ESP_TIMER
 #include <esp_timer.h>
+#elif THINGSBOARD_USE_POSIX_TIMER
+#include <time.h>
 #else
 #include <arduino-timer.h>
 #endif // THINGSBOARD_USE_ESP_TIMER
@@ -23,6 +25,7 @@ constexpr char WATCHDOG_TIMER_NAME[] = "watchdog_timer";
 /// This is done because it uses FreeRTOS to start the actual timer in the background, which removes the need for a Hardware Timer with Interrupts but still achieve the advantage of accurate timings and no need for active polling.
 /// For all other use cases where the esp timer does not exists we instead use the Arduino timer as a fallback, because is is a simple software timer with active polling that works on all Arduino based devices,
 /// because it simply uses the millis() method per default but can be configured over template arguments to use other methods that return the current time.
+/// When running on a host operating system like Linux neither exists, instead the deadline is compared with the POSIX monotonic clock, which is polled the same way as the Arduino timer.
 /// The class instance is meant to be started with once() which will then call the registered callback after the timeout has passed.
 /// if the detach() method has not been called yet.
 /// This results in behaviour similair to a esp task watchdog but without as high of an accuracy and without restarting the device,
@@ -39,6 +42,9 @@ class Callback_Watchdog : public Callback<void> {
       : Callback(callback)
 #if THINGSBOARD_USE_ESP_TIMER
       , m_oneshot_timer(nullptr)
+#elif THINGSBOARD_USE_POSIX_TIMER
+      , m_deadline(0U)
+      , m_running(false)
 #else
       , m_oneshot_timer()
 #endif // THINGSBOARD_USE_ESP_TIMER
@@ -62,6 +68,9 @@ class Callback_Watchdog : public Callback<void> {
 #if THINGSBOARD_USE_ESP_TIMER
         create_timer();
         (void)esp_timer_start_once(m_oneshot_timer, timeout_microseconds);
+#elif THINGSBOARD_USE_POSIX_TIMER
+        m_deadline = get_time_microseconds() + timeout_microseconds;
+        m_running = true;
 #else
         m_oneshot_timer.in(timeout_microseconds, &Callback_Watchdog::oneshot_timer_callback, this);
 #endif // THINGSBOARD_USE_ESP_TIMER
@@ -71,6 +80,8 @@ class Callback_Watchdog : public Callback<void> {
     void detach() {
 #if THINGSBOARD_USE_ESP_TIMER
         (void)esp_timer_stop(m_oneshot_timer);
+#elif THINGSBOARD_USE_POSIX_TIMER
+        m_running = false;
 #else
         m_oneshot_timer.cancel();
 #endif // THINGSBOARD_USE_ESP_TIMER
@@ -81,7 +92,15 @@ class Callback_Watchdog : public Callback<void> {
     /// Indirectly called from the interal processing loop of this library, so we expect the user to recently often call the library loop() function.
     /// In the worst case the actuall call of the callback might be massively delayed compared to the original timer time
     void update() {
+#if THINGSBOARD_USE_POSIX_TIMER
+        // Stopped before the callback is called, so that the callback can directly start the timer again
+        if (m_running && get_time_microseconds() >= m_deadline) {
+            m_running = false;
+            Call_Callback();
+        }
+#else
         m_oneshot_timer.tick<void>();
+#endif // THINGSBOARD_USE_POSIX_TIMER
     }
 #endif // !THINGSBOARD_USE_ESP_TIMER
 
@@ -109,8 +128,17 @@ class Callback_Watchdog : public Callback<void> {
             return;
         }
     }
+#elif THINGSBOARD_USE_POSIX_TIMER
+    /// @brief Gets the current time of the monotonic clock, which is not affected by changes to the system time
+    /// @return Current time in microseconds
+    static uint64_t get_time_microseconds() {
+        timespec time = {};
+        (void)clock_gettime(CLOCK_MONOTONIC, &time);
+        return (static_cast<uint64_t>(time.tv_sec) * 1000000U) + (time.tv_nsec / 1000U);
+    }
 #endif // THINGSBOARD_USE_ESP_TIMER
 
+#if !THINGSBOARD_USE_POSIX_TIMER
     /// @brief Static callback used to call the initally subscribed callback, if the internal watchdog has not been reset in time with detach()
 #if THINGSBOARD_USE_ESP_TIMER
     static void
@@ -133,9 +161,13 @@ class Callback_Watchdog : public Callback<void> {
         return false;
 #endif // !THINGSBOARD_USE_ESP_TIMER
     }
+#endif // !THINGSBOARD_USE_POSIX_TIMER
 
 #if THINGSBOARD_USE_ESP_TIMER
     esp_timer_handle_t m_oneshot_timer = {}; // ESP Timer handle that is used to start and stop the oneshot timer
+#elif THINGSBOARD_USE_POSIX_TIMER
+    uint64_t           m_deadline = {};      // Time of the monotonic clock in microseconds, once it has passed the callback is called
+    bool               m_running = {};       // Whether the timer has been started and neither stopped nor expired since
 #else
     Timer<1, micros>   m_oneshot_timer = {}; // Ticker instance that handles the timer under the hood, if possible we directly use esp timer instead because it is more efficient
 #endif // THINGSBOARD_USE_ESP_TIMER
@@ -4,12 +4,13 @@
 // Local includes.
 #include "RPC_Request_Callback.h"
 #include "IAPI_Implementation.h"
+#include "Topic_Builder.h"
 
 
 // Client side RPC topics.
 char constexpr RPC_RESPONSE_SUBSCRIBE_TOPIC[] = "v1/devices/me/rpc/response/+";
 char constexpr RPC_RESPONSE_TOPIC[] = "v1/devices/me/rpc/response/";
-char constexpr RPC_SEND_REQUEST_TOPIC[] = "v1/devices/me/rpc/request/%u";
+char constexpr RPC_SEND_REQUEST_TOPIC[] = "v1/devices/me/rpc/request/";
 // Log messages.
 char constexpr CLIENT_RPC_METHOD_NULL[] = "Client-side RPC method name is NULL";
 #if !THINGSBOARD_ENABLE_DYNAMIC
@@ -36,7 +37,11 @@ template<size_t MaxSubscriptions = Default_Subscriptions_Amount, size_t MaxReque
 class Client_Side_RPC : public IAPI_Implementation {
   public:
     /// @brief Constructor
-    Client_Side_RPC() = default;
+    Client_Side_RPC()
+      : m_request_topic(RPC_SEND_REQUEST_TOPIC)
+    {
+        // Nothing to do
+    }
 
     /// @brief Requests one client-side RPC callback,
     /// that will be called if a response from the server for the method with the given name is received.
@@ -98,9 +103,7 @@ class Client_Side_RPC : public IAPI_Implementation {
         registered_callback->Set_Request_ID(++request_id);
         registered_callback->Start_Timeout_Timer();
 
-        char topic[Helper::detectSize(RPC_SEND_REQUEST_TOPIC, request_id)] = {};
-        (void)snprintf(topic, sizeof(topic), RPC_SEND_REQUEST_TOPIC, request_id);
-        return m_send_json_callback.Call_Callback(topic, request_buffer, Helper::Measure_Json(request_buffer));
+        return m_send_json_callback.Call_Callback(m_request_topic.build(request_id), request_buffer, Helper::Measure_Json(request_buffer));
     }
 
     API_Process_Type Get_Process_Type() const override {
@@ -113,6 +116,7 @@ class Client_Side_RPC : public IAPI_Implementation {
 
     void Process_Json_Response(char const * topic, JsonDocument const & data) override {
         size_t const request_id = Helper::parseRequestId(RPC_RESPONSE_TOPIC, topic);
+        size_t const previous_amount = m_rpc_request_callbacks.size();
 
 #if THINGSBOARD_ENABLE_STL
         auto it = std::find_if(m_rpc_request_callbacks.begin(), m_rpc_request_callbacks.end(), [&request_id](RPC_Request_Callback & rpc_request) {
@@ -132,7 +136,7 @@ class Client_Side_RPC : public IAPI_Implementation {
             rpc_request.Call_Callback(data);
 
             // Delete callback because the changes have been requested and the callback is no longer needed
-            Helper::remove(m_rpc_request_callbacks, it);
+            Helper::remove_unordered(m_rpc_request_callbacks, it);
 #if !THINGSBOARD_ENABLE_STL
             break;
 #endif // !THINGSBOARD_ENABLE_STL
@@ -140,9 +144,10 @@ class Client_Side_RPC : public IAPI_Implementation {
 
         // Attempt to unsubscribe from the shared attribute request topic,
         // if we are not waiting for any further responses with shared attributes from the server.
+        // Only done if this response removed the last request, because the topic is only referenced once while any request is pending.
         // Will be resubscribed if another request is sent anyway
-        if (m_rpc_request_callbacks.empty()) {
-            (void)RPC_Request_Unsubscribe();
+        if (previous_amount != 0U && m_rpc_request_callbacks.empty()) {
+            (void)m_unsubscribe_topic_callback.Call_Callback(RPC_RESPONSE_SUBSCRIBE_TOPIC);
         }
     }
 
@@ -191,7 +196,8 @@ class Client_Side_RPC : public IAPI_Implementation {
             return false;
         }
 #endif // !THINGSBOARD_ENABLE_DYNAMIC
-        if (!m_subscribe_topic_callback.Call_Callback(RPC_RESPONSE_SUBSCRIBE_TOPIC)) {
+        // All requests share the same response topic, therefore it is only subscribed once for the first pending request
+        if (m_rpc_request_callbacks.empty() && !m_subscribe_topic_callback.Call_Callback(RPC_RESPONSE_SUBSCRIBE_TOPIC)) {
             Logger::printfln(SUBSCRIBE_TOPIC_FAILED, RPC_RESPONSE_SUBSCRIBE_TOPIC);
             return false;
         }
@@ -204,6 +210,9 @@ class Client_Side_RPC : public IAPI_Implementation {
     /// @return Whether unsubcribing the previously subscribed callbacks
     /// and from the client-side RPC response topic, was successful or not
     bool RPC_Request_Unsubscribe() {
+        if (m_rpc_request_callbacks.empty()) {
+            return true;
+        }
         m_rpc_request_callbacks.clear();
         return m_unsubscribe_topic_callback.Call_Callback(RPC_RESPONSE_SUBSCRIBE_TOPIC);
     }
@@ -212,6 +221,7 @@ class Client_Side_RPC : public IAPI_Implementation {
     Callback<bool, char const * const>                                       m_subscribe_topic_callback = {};    // Subscribe mqtt topic client callback
     Callback<bool, char const * const>                                       m_unsubscribe_topic_callback = {};  // Unubscribe mqtt topic client callback
     Callback<size_t *>                                                       m_get_request_id_callback = {};     // Get internal request id callback
+    Topic_Builder<sizeof(RPC_SEND_REQUEST_TOPIC) + MAX_NUMBER_CHARACTERS>    m_request_topic;                    // Request topic with the request id of the sent request appended
 
     // Vectors or array (depends on wheter if THINGSBOARD_ENABLE_DYNAMIC is set to 1 or 0), hold copy of the actual passed data, this is to ensure they stay valid,
     // even if the user only temporarily created the object before the method was called.
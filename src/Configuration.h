@@ -53,6 +53,21 @@
 #    endif
 #  endif
 
+// Use the C++ STL mutex to guard the state that is changed by the callbacks of the MQTT client, because some implementations like the Espressif_MQTT_Client call them from their own task,
+// instead of from the loop() method, meaning they could otherwise run at the same time as the main task publishing data. Disabled on platforms without threads (ESP8266 and AVR),
+// because the mutex header might exist there, but std::mutex does not, additionally the callbacks can only ever be called from loop() on those platforms anyway.
+#  ifndef THINGSBOARD_USE_MUTEX
+#    ifdef __has_include
+#      if THINGSBOARD_ENABLE_STL && __has_include(<mutex>) && !defined(ESP8266) && !defined(__AVR__)
+#        define THINGSBOARD_USE_MUTEX 1
+#      else
+#        define THINGSBOARD_USE_MUTEX 0
+#      endif
+#    else
+#      define THINGSBOARD_USE_MUTEX 0
+#    endif
+#  endif
+
 // Use the esp_timer header internally for handling timeouts and callbacks, as long as the header exists, because it is more efficient than the Arduino Ticker implementation,
 // because we can stop the timer without having to delete it, removing the need to create a new timer to restart it. Because instead we can simply stop and start again.
 // Only exists following major version 3 minor version 0 on ESP32 (https://github.com/espressif/esp-idf/releases/tag/v3.0-rc1)and major version 3 minor version 1 on ESP8266 (https://github.com/espressif/ESP8266_RTOS_SDK/releases/tag/v3.1-rc1)
@@ -68,6 +83,36 @@
 #    endif
 #  endif
 
+// Use the esp_heap_caps header internally for querying the free heap memory, as long as the header exists, to allow the adaptive OTA chunk size to grow beyond MAX_CHUNK_SIZE, as long as there is enough memory left.
+// Checked seperately from the esp_timer header, because the heap capabilities and the timer are seperate components, which do not have to be available together.
+// Only exists following major version 3 minor version 0 on ESP32 (https://github.com/espressif/esp-idf/releases/tag/v3.0-rc1) and major version 3 minor version 0 on ESP8266 (https://github.com/espressif/ESP8266_RTOS_SDK/releases/tag/v3.0-rc1)
+#  ifndef THINGSBOARD_USE_ESP_HEAP
+#    ifdef __has_include
+#      if __has_include(<esp_heap_caps.h>)
+#        define THINGSBOARD_USE_ESP_HEAP 1
+#      else
+#        define THINGSBOARD_USE_ESP_HEAP 0
+#      endif
+#    else
+#      define THINGSBOARD_USE_ESP_HEAP 0
+#    endif
+#  endif
+
+// Use the monotonic clock of the POSIX time header internally for handling timeouts, as long as we are not compiling for Arduino or Espressif IDF and the esp_timer header does not exist,
+// to allow users running on a host operating system like Linux to use the library without the arduino-timer library (https://github.com/contrem/arduino-timer), which relies on the Arduino micros() method.
+// The same as with the arduino-timer library, the timeouts are checked in the loop() method, meaning the callback is called the first time loop() is called after the timeout has passed.
+#  ifndef THINGSBOARD_USE_POSIX_TIMER
+#    ifdef __has_include
+#      if !THINGSBOARD_USE_ESP_TIMER && !defined(ARDUINO) && !defined(ESP_PLATFORM) && __has_include(<time.h>)
+#        define THINGSBOARD_USE_POSIX_TIMER 1
+#      else
+#        define THINGSBOARD_USE_POSIX_TIMER 0
+#      endif
+#    else
+#      define THINGSBOARD_USE_POSIX_TIMER 0
+#    endif
+#  endif
+
 // Use the mqtt_client header internally for handling the sending and receiving of MQTT data, as long as the header exists,
 // to allow users that do have the needed component to use the Espressif_MQTT_Client instead of only the Arduino_MQTT_Client.
 // Only exists following major version 3 minor version 2 on ESP32 (https://github.com/espressif/esp-idf/releases/tag/v3.2) and major version 3 minor version 4 on ESP8266 (https://github.com/espressif/ESP8266_RTOS_SDK/releases/tag/v3.4).
@@ -83,6 +128,35 @@
 #    endif
 #  endif
 
+// Use the POSIX socket headers internally for handling the sending and receiving of MQTT and HTTP data, as long as the headers exist and we are not compiling for Arduino or Espressif IDF,
+// to allow users running on a host operating system like Linux to use the POSIX_MQTT_Client or POSIX_HTTP_Client instead of having to implement their own IMQTT_Client or IHTTP_Client.
+// Boards compiling for Arduino or Espressif IDF might expose similar headers through lwIP, but should use the Arduino_MQTT_Client or Espressif_MQTT_Client instead.
+#  ifndef THINGSBOARD_USE_POSIX_SOCKET
+#    ifdef __has_include
+#      if !defined(ARDUINO) && !defined(ESP_PLATFORM) && __has_include(<sys/socket.h>) && __has_include(<poll.h>) && __has_include(<netdb.h>) && __has_include(<fcntl.h>)
+#        define THINGSBOARD_USE_POSIX_SOCKET 1
+#      else
+#        define THINGSBOARD_USE_POSIX_SOCKET 0
+#      endif
+#    else
+#      define THINGSBOARD_USE_POSIX_SOCKET 0
+#    endif
+#  endif
+
+// Use the POSIX fsync function to flush written files from the operating system to the storage device, as long as the unistd header exists,
+// which is the case on host operating systems like Linux and on the ESP32, where it is forwarded to the mounted SPIFFS, LittleFS or FAT filesystem.
+#  ifndef THINGSBOARD_USE_FSYNC
+#    ifdef __has_include
+#      if __has_include(<unistd.h>)
+#        define THINGSBOARD_USE_FSYNC 1
+#      else
+#        define THINGSBOARD_USE_FSYNC 0
+#      endif
+#    else
+#      define THINGSBOARD_USE_FSYNC 0
+#    endif
+#  endif
+
 // Use the mbed_tls header internally for handling the creation of hashes from binary data, as long as the header exists,
 // because if it is already included we do not need to rely on and incude external lbiraries like Seeed_mbedtls.h, which implements the same features.
 // Only exists following major version 0 minor version 9 on ESP32 (https://github.com/espressif/esp-idf/releases/v0.9) and major version 3 minor version 3 on ESP8266 (https://github.com/espressif/ESP8266_RTOS_SDK/releases/tag/v3.3-rc1).
@@ -98,6 +172,21 @@
 #    endif
 #  endif
 
+// Use the hash implementation contained in the library itself internally for handling the creation of hashes from binary data, if neither the mbed_tls header nor the Seeed_mbedtls header exist,
+// to allow users running on a host operating system like Linux to verify firmware updates without installing Mbed TLS. Supports all checksum algorithms ThingsBoard firmware can be created with (MD5, SHA-256, SHA-384 and SHA-512),
+// but is slower than Mbed TLS, which might use hardware acceleration, therefore it is only used as the last fallback.
+#  ifndef THINGSBOARD_USE_BUILTIN_HASH
+#    ifdef __has_include
+#      if !THINGSBOARD_USE_MBED_TLS && !__has_include(<Seeed_mbedtls.h>)
+#        define THINGSBOARD_USE_BUILTIN_HASH 1
+#      else
+#        define THINGSBOARD_USE_BUILTIN_HASH 0
+#      endif
+#    else
+#      define THINGSBOARD_USE_BUILTIN_HASH 0
+#    endif
+#  endif
+
 // Use the esp_ota_ops header internally for handling the writing of ota update data, as long as the header exists,
 // to allow users that do have the needed component to use the Espressif_Updater instead of only the Arduino_ESP32_Updater.
 // Only exists following major version 1 minor version 0 on ESP32 (https://github.com/espressif/esp-idf/releases/v0.9) and major version 3 minor version 0 on ESP8266 (https://github.com/espressif/ESP8266_RTOS_SDK/releases/tag/v3.0-rc1).
@@ -132,6 +221,13 @@
 #    define THINGSBOARD_ENABLE_DEBUG CONFIG_THINGSBOARD_ENABLE_DEBUG
 #  endif
 
+// Enables the ThingsBoard class to record metrics about its internal processes, like the amount of published and received bytes or how long serializing and deserializing json documents took,
+// which can then be published as telemetry data on a configurable interval, to be able to find hot spots across all devices. Requires more memory for the counters and latency histograms,
+// and the recording needs some additional time for every published and received message. Disabled by default, because the metrics are only needed to analyze the performance of the devices.
+#  ifndef THINGSBOARD_ENABLE_METRICS
+#    define THINGSBOARD_ENABLE_METRICS 0
+#  endif
+
 // Use the StreamUtils header internally for enabling the usage of an additonal library as a fallback, as long as the header exists,
 // to allwo to directly serialize a json message that is sent to the cloud, if the size of that message would be bigger than the internal buffer size of the client.
 // Allows sending much bigger messages than would otherwise be possible, and without the need to increase stack or heap requirements, but at the cost of increased send times.
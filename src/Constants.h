@@ -8,6 +8,7 @@
 #if THINGSBOARD_ENABLE_PSRAM || THINGSBOARD_ENABLE_DYNAMIC
 #include <ArduinoJson.h>
 #endif // THINGSBOARD_ENABLE_PSRAM || THINGSBOARD_ENABLE_DYNAMIC
+#include <stdint.h>
 
 #define Default_Endpoints_Amount 7
 #define Default_Response_Amount 8
@@ -17,6 +18,13 @@
 #define Default_Request_RPC_Amount 2
 #define Default_Payload_Size 64
 #define Default_Max_Stack_Size 1024
+#define Default_Max_In_Flight_Amount 8
+#define Default_Publish_Queue_Amount 16
+#define Default_Log_Buffer_Size 512
+// Can be defined before including the library, to store callables that are bigger than 4 pointers in the callbacks if THINGSBOARD_ENABLE_STL is set
+#ifndef Default_Callback_Size
+#define Default_Callback_Size (4U * sizeof(void *))
+#endif // Default_Callback_Size
 #if THINGSBOARD_ENABLE_STREAM_UTILS
 #define Default_Buffering_Size 64
 #endif // THINGSBOARD_ENABLE_STREAM_UTILS
@@ -25,6 +33,11 @@
 #endif // THINGSBOARD_ENABLE_DYNAMIC
 
 
+// Conversion factors between time units.
+uint16_t constexpr MILLISECONDS_PER_SECOND = 1000U;
+uint32_t constexpr NANOSECONDS_PER_MILLISECOND = 1000000U;
+
+
 // Log messages.
 #if !THINGSBOARD_ENABLE_DYNAMIC
 char constexpr TOO_MANY_JSON_FIELDS[] = "Attempt to enter to many JSON fields into StaticJsonDocument (%u), increase (%s) (%u) accordingly";
@@ -53,8 +66,26 @@ struct SpiRamAllocator {
   }
 };
 
+using TBJsonAllocator = SpiRamAllocator;
 using TBJsonDocument = BasicJsonDocument<SpiRamAllocator>;
 #elif THINGSBOARD_ENABLE_DYNAMIC
+#include <stdlib.h>
+
+struct HeapAllocator {
+  void* allocate(size_t size) {
+    return malloc(size);
+  }
+
+  void deallocate(void* pointer) {
+    free(pointer);
+  }
+
+  void* reallocate(void* ptr, size_t new_size) {
+    return realloc(ptr, new_size);
+  }
+};
+
+using TBJsonAllocator = HeapAllocator;
 using TBJsonDocument = DynamicJsonDocument;
 #endif
 
@@ -13,33 +13,49 @@ char constexpr LOG_MESSAGE_FORMAT[] = "[TB] %s\n";
 /// @brief Default logger class used by the ThingsBoard class to log messages into the console output
 class DefaultLogger {
   public:
+    /// @brief Prints the given message as well as a new line character at the end of the message, without inserting any arguments
+    /// @param message Messsage that should be printed, is printed as is, meaning any format specifiers (subsequences beginning with %) are not replaced
+    /// @return Either the written amount of characters or an error indicator (being a negative number) if one occured
+    static int printfln(char const * message) {
+        return printf(LOG_MESSAGE_FORMAT, message);
+    }
+
     /// @brief Prints the given format message containing format specifiers (subsequences beginning with %) as well as a new line character at the end of the message.
-    /// If no additional arguments are given it simply prints the given format messsage
+    /// The formatted message is written into a fixed size buffer on the stack, which is big enough for the given format message and the maximum amount of characters the types of the given arguments can need.
+    /// Meaning strings passed as pointers that are longer than MAX_FORMAT_STRING_CHARACTERS are truncated, see Helper::calculateFormatSize for more information
+    /// @tparam FormatSize Size of the format message including the null termination, deduced from the constant format message at compile time
+    /// @tparam Arg Type of the first argument, ensures this method is only used if atleast one argument is passed
+    /// @tparam ...Args Additional arguments formatted and inserted in the resulting string replacing their respective specifiers.
+    /// See https://cplusplus.com/reference/cstdio/printf/ for more information on the possible format specifiers and the corresponding argument type
+    /// @param format Formatting message that the given arguments will be inserted into
+    /// @param arg First argument that will be formatted and inserted into the resulting string, replacing its respective specifier
+    /// @param ...args Arguments that will be formatted and inserted into the resulting string, replacing their respective specifiers
+    /// @return Either the written amount of characters or an error indicator (being a negative number) if one occured
+    template<size_t FormatSize, typename Arg, typename ...Args>
+    static int printfln(char const (&format)[FormatSize], Arg const & arg, Args const &... args) {
+        char arguments[Helper::calculateFormatSize<Arg, Args...>(FormatSize)] = {};
+        int const written_characters = snprintf(arguments, sizeof(arguments), format, arg, args...);
+        // Negative written characters are only returned if the arguments did not match the format specifiers,
+        // a truncated string pointer argument still results in a valid null terminated message that can be printed
+        return printf(LOG_MESSAGE_FORMAT, written_characters >= 0 ? arguments : FAILED_MESSAGE);
+    }
+
+    /// @brief Prints the given format message, that is only known at runtime, containing format specifiers (subsequences beginning with %) as well as a new line character at the end of the message.
+    /// Because the size of the format message is not known at compile time, it is bounded by MAX_FORMAT_STRING_CHARACTERS the same way a string argument passed as a pointer is,
+    /// meaning the formatted message is truncated if the format message is longer, see Helper::calculateFormatSize for more information
+    /// @tparam Character Type of the characters in the format message, deduced from the given pointer, ensures arrays use the overload that knows their size instead
+    /// @tparam Arg Type of the first argument, ensures this method is only used if atleast one argument is passed
     /// @tparam ...Args Additional arguments formatted and inserted in the resulting string replacing their respective specifiers.
     /// See https://cplusplus.com/reference/cstdio/printf/ for more information on the possible format specifiers and the corresponding argument type
     /// @param format Formatting message that the given arguments will be inserted into
+    /// @param arg First argument that will be formatted and inserted into the resulting string, replacing its respective specifier
     /// @param ...args Arguments that will be formatted and inserted into the resulting string, replacing their respective specifiers
     /// @return Either the written amount of characters or an error indicator (being a negative number) if one occured
-    template<typename ...Args>
-    static int printfln(char const * format, Args const &... args) {
-        // Check if variadic template contains any actual additional arguments that should be inserted into format message.
-        // If it does, use constexpr if statement for C++20 supported devices to optimize away the branch instruction at compile time
-        // or alternatively runtime for devices that do not support C++20
-#if THINGSBOARD_ENABLE_CXX20
-        if constexpr (sizeof...(Args) == 0U) {
-#else
-        if (sizeof...(Args) == 0U) {
-#endif // THINGSBOARD_ENABLE_CXX20
-            return printf(LOG_MESSAGE_FORMAT, format);
-        }
-        else {
-            int const size = Helper::detectSize(format, args...);
-            char arguments[size] = {};
-            int const written_characters = snprintf(arguments, size, format, args...);
-            // Written characters is expected to be one less, because of the null termination character
-            bool const result = (written_characters == (size - 1));
-            return printf(LOG_MESSAGE_FORMAT, result ? arguments : FAILED_MESSAGE);
-        }
+    template<typename Character, typename Arg, typename ...Args>
+    static int printfln(Character * const & format, Arg const & arg, Args const &... args) {
+        char arguments[Helper::calculateFormatSize<Arg, Args...>(MAX_FORMAT_STRING_CHARACTERS + 1U)] = {};
+        int const written_characters = snprintf(arguments, sizeof(arguments), format, arg, args...);
+        return printf(LOG_MESSAGE_FORMAT, written_characters >= 0 ? arguments : FAILED_MESSAGE);
     }
 };
 
@@ -0,0 +1,381 @@
+#ifndef Deferred_Logger_h
+#define Deferred_Logger_h
+
+// Local includes.
+#include "Constants.h"
+#include "DefaultLogger.h"
+
+// Library includes.
+#if THINGSBOARD_ENABLE_STL
+#include <atomic>
+#endif // THINGSBOARD_ENABLE_STL
+#include <string.h>
+
+
+/// @brief Type an argument of a message logged with the DeferredLogger is read as when the message is formatted,
+/// strings are copied into the ring buffer and are therefore read as a pointer to that copy, all other types are copied and read as their raw value
+/// @tparam T Type of the argument that was logged
+template<typename T>
+struct Deferred_Argument {
+    using type = T;
+};
+
+template<size_t N>
+struct Deferred_Argument<char[N]> {
+    using type = char const *;
+};
+
+template<>
+struct Deferred_Argument<char *> {
+    using type = char const *;
+};
+
+
+/// @brief Logger class that does not format or print messages when they are logged, but instead only copies the format message and the raw arguments into a ring buffer.
+/// The messages are formatted and forwarded to the underlying logger later, once process() is called, which should be done from a low priority task or from the main loop.
+/// Allows to keep logging out of time critical code paths like the MQTT callbacks, because logging a message only costs copying the arguments, instead of formatting and printing the complete message.
+/// Because formatting happens later, only the pointer to the format message is copied, meaning the format message has to be a constant that lives for the lifetime of the program, like all log messages in this library.
+/// String arguments on the other hand are copied into the ring buffer, because they often point to temporary buffers, they are truncated to MAX_FORMAT_STRING_CHARACTERS.
+/// Messages without any arguments are copied completly, because they might have been formatted into a temporary buffer before they were logged, format messages passed as pointers instead of constant arrays are formatted immediately and copied the same way.
+/// If the ring buffer is full or currently used by another task, the message is discarded instead of blocking the caller, the amount of discarded messages can be read with get_dropped_messages().
+/// Messages that should never be logged at all are instead removed at compile time, debug messages with THINGSBOARD_ENABLE_DEBUG and all messages by using the NullLogger
+/// @tparam BufferSize Size of the ring buffer in bytes, each message needs the size of its arguments and an additional header of a few pointers, default = Default_Log_Buffer_Size (512)
+/// @tparam Logger Implementation that the messages are forwarded to, once they are formatted by calling process(), default = DefaultLogger
+template<size_t BufferSize = Default_Log_Buffer_Size, typename Logger = DefaultLogger>
+class DeferredLogger {
+  public:
+    /// @brief Copies the given message into the ring buffer, so it can be printed later by calling process()
+    /// @param message Message that should be printed, is printed as is, meaning any format specifiers (subsequences beginning with %) are not replaced
+    /// @return Amount of bytes the message needs in the ring buffer or 0 if the message had to be discarded
+    static int printfln(char const * message) {
+        size_t const length = string_length(message, BufferSize);
+        size_t const size = sizeof(Entry_Header) + length + 1U;
+        size_t position = 0U;
+        if (!reserve(size, position)) {
+            return 0;
+        }
+        write_entry_header(position, size, print_message, nullptr);
+        write_string(position, message, length);
+        release(size);
+        return static_cast<int>(size);
+    }
+
+    /// @brief Copies the given constant format message and the raw values of the given arguments into the ring buffer,
+    /// so they can be formatted and printed later by calling process()
+    /// @tparam FormatSize Size of the format message including the null termination, deduced from the constant format message at compile time
+    /// @tparam Arg Type of the first argument, ensures this method is only used if atleast one argument is passed
+    /// @tparam ...Args Additional arguments formatted and inserted in the resulting string replacing their respective specifiers.
+    /// See https://cplusplus.com/reference/cstdio/printf/ for more information on the possible format specifiers and the corresponding argument type
+    /// @param format Formatting message that the given arguments will be inserted into, has to be a constant, because only the pointer to it is copied
+    /// @param arg First argument that will be formatted and inserted into the resulting string, replacing its respective specifier
+    /// @param ...args Arguments that will be formatted and inserted into the resulting string, replacing their respective specifiers
+    /// @return Amount of bytes the message needs in the ring buffer or 0 if the message had to be discarded
+    template<size_t FormatSize, typename Arg, typename ...Args>
+    static int printfln(char const (&format)[FormatSize], Arg const & arg, Args const &... args) {
+        size_t const size = sizeof(Entry_Header) + arguments_size(arg, args...);
+        size_t position = 0U;
+        if (!reserve(size, position)) {
+            return 0;
+        }
+        write_entry_header(position, size, format_message<FormatSize, Arg, Args...>, format);
+        write_arguments(position, arg, args...);
+        release(size);
+        return static_cast<int>(size);
+    }
+
+    /// @brief Formats the given format message, that is only known at runtime, immediately and copies the formatted message into the ring buffer, so it can be printed later by calling process().
+    /// Formatting can not be deferred, because the format message might point to a temporary buffer, it is bounded by MAX_FORMAT_STRING_CHARACTERS the same way DefaultLogger bounds it
+    /// @tparam Character Type of the characters in the format message, deduced from the given pointer, ensures arrays use the overload that knows their size instead
+    /// @tparam Arg Type of the first argument, ensures this method is only used if atleast one argument is passed
+    /// @tparam ...Args Additional arguments formatted and inserted in the resulting string replacing their respective specifiers.
+    /// See https://cplusplus.com/reference/cstdio/printf/ for more information on the possible format specifiers and the corresponding argument type
+    /// @param format Formatting message that the given arguments will be inserted into
+    /// @param arg First argument that will be formatted and inserted into the resulting string, replacing its respective specifier
+    /// @param ...args Arguments that will be formatted and inserted into the resulting string, replacing their respective specifiers
+    /// @return Amount of bytes the message needs in the ring buffer or 0 if the message had to be discarded
+    template<typename Character, typename Arg, typename ...Args>
+    static int printfln(Character * const & format, Arg const & arg, Args const &... args) {
+        char message[Helper::calculateFormatSize<Arg, Args...>(MAX_FORMAT_STRING_CHARACTERS + 1U)] = {};
+        int const written_characters = snprintf(message, sizeof(message), format, arg, args...);
+        return printfln(written_characters >= 0 ? message : FAILED_MESSAGE);
+    }
+
+    /// @brief Formats the messages in the ring buffer and forwards them to the underlying logger, in the order they were logged in.
+    /// Should only ever be called from one task at a time, preferably a low priority task or the main loop, so the formatting does not delay any time critical code paths
+    /// @param max_messages Maximum amount of messages that should be processed, allows to limit the time spent in this method, 0 processes all messages, default = 0
+    /// @return Amount of messages that were processed
+    static size_t process(size_t max_messages = 0U) {
+        size_t processed = 0U;
+        while (max_messages == 0U || processed < max_messages) {
+            // The entry is copied out of the ring buffer before it is formatted, so that the lock is only held while copying
+            // and other tasks can continue logging while the message is formatted and printed
+            if (!try_lock()) {
+                break;
+            }
+            size_t const used = m_head - m_tail;
+            if (used == 0U) {
+                unlock();
+                break;
+            }
+            Entry_Header header = {};
+            read_bytes(m_tail, reinterpret_cast<uint8_t *>(&header), sizeof(header));
+            read_bytes(m_tail + sizeof(header), m_arguments, header.size - sizeof(header));
+            m_tail += header.size;
+            unlock();
+
+            header.formatter(header.format, m_arguments);
+            processed++;
+        }
+        return processed;
+    }
+
+    /// @brief Returns the amount of bytes currently used by messages in the ring buffer, that have not been processed yet
+    /// @return Amount of used bytes in the ring buffer
+    static size_t get_used_bytes() {
+        return m_head - m_tail;
+    }
+
+    /// @brief Returns the amount of messages that had to be discarded since the program started,
+    /// because the ring buffer was full or used by another task while they were logged
+    /// @return Amount of discarded messages
+    static size_t get_dropped_messages() {
+        return m_dropped;
+    }
+
+  private:
+    /// @brief Method that reads the raw arguments of a message, formats them and forwards the formatted message to the underlying logger
+    using Formatter = void (*)(char const * format, uint8_t const * arguments);
+
+    /// @brief Header that is written into the ring buffer in front of the raw arguments of each message
+    struct Entry_Header {
+        size_t       size;      // Size of the complete entry including this header
+        Formatter    formatter; // Method instantiated for the specific argument types of the message, which reads and formats the following raw arguments
+        char const * format;    // Constant format message the arguments should be inserted into
+    };
+
+    /// @brief Empty type used to pass the types of the arguments that still have to be read, to the recursive format_arguments method
+    template<typename... Types>
+    struct Type_List {};
+
+    static size_t string_length(char const * string, size_t const & max_length) {
+        if (string == nullptr) {
+            return 0U;
+        }
+        size_t length = 0U;
+        while (length < max_length && string[length] != '\0') {
+            length++;
+        }
+        return length;
+    }
+
+    template<typename T>
+    static size_t argument_size(T const & argument) {
+        return sizeof(T);
+    }
+
+    template<size_t N>
+    static size_t argument_size(char const (&argument)[N]) {
+        return string_length(argument, MAX_FORMAT_STRING_CHARACTERS) + 1U;
+    }
+
+    static size_t argument_size(char const * argument) {
+        return string_length(argument, MAX_FORMAT_STRING_CHARACTERS) + 1U;
+    }
+
+    static size_t argument_size(char * argument) {
+        return string_length(argument, MAX_FORMAT_STRING_CHARACTERS) + 1U;
+    }
+
+    static size_t arguments_size() {
+        return 0U;
+    }
+
+    template<typename T, typename... Rest>
+    static size_t arguments_size(T const & argument, Rest const &... rest) {
+        return argument_size(argument) + arguments_size(rest...);
+    }
+
+    template<typename T>
+    static void write_argument(size_t & position, T const & argument) {
+        write_bytes(position, reinterpret_cast<uint8_t const *>(&argument), sizeof(T));
+    }
+
+    template<size_t N>
+    static void write_argument(size_t & position, char const (&argument)[N]) {
+        write_string(position, argument, string_length(argument, MAX_FORMAT_STRING_CHARACTERS));
+    }
+
+    static void write_argument(size_t & position, char const * argument) {
+        write_string(position, argument, string_length(argument, MAX_FORMAT_STRING_CHARACTERS));
+    }
+
+    static void write_argument(size_t & position, char * argument) {
+        write_string(position, argument, string_length(argument, MAX_FORMAT_STRING_CHARACTERS));
+    }
+
+    static void write_arguments(size_t & position) {
+        // Nothing to do
+    }
+
+    template<typename T, typename... Rest>
+    static void write_arguments(size_t & position, T const & argument, Rest const &... rest) {
+        write_argument(position, argument);
+        write_arguments(position, rest...);
+    }
+
+    static void write_string(size_t & position, char const * string, size_t const & length) {
+        if (length > 0U) {
+            write_bytes(position, reinterpret_cast<uint8_t const *>(string), length);
+        }
+        uint8_t const null_termination = 0U;
+        write_bytes(position, &null_termination, sizeof(null_termination));
+    }
+
+    static void write_entry_header(size_t & position, size_t const & size, Formatter formatter, char const * format) {
+        Entry_Header header = {};
+        header.size = size;
+        header.formatter = formatter;
+        header.format = format;
+        write_bytes(position, reinterpret_cast<uint8_t const *>(&header), sizeof(header));
+    }
+
+    template<typename T>
+    static size_t read_argument(uint8_t const * arguments, T & value) {
+        (void)memcpy(&value, arguments, sizeof(T));
+        return sizeof(T);
+    }
+
+    static size_t read_argument(uint8_t const * arguments, char const * & value) {
+        value = reinterpret_cast<char const *>(arguments);
+        return strlen(value) + 1U;
+    }
+
+    /// @brief Reads the raw value of the first remaining argument type and calls itself with the read value appended to the already read values,
+    /// until no types remain and the message can be formatted with all read values. Recursion is used to read the arguments in order, because the evaluation order of function arguments is unspecified
+    template<size_t FormatSize, typename T, typename... Rest, typename... Values>
+    static void format_arguments(Type_List<T, Rest...>, char const * format, uint8_t const * arguments, Values const &... values) {
+        typename Deferred_Argument<T>::type value = {};
+        size_t const size = read_argument(arguments, value);
+        format_arguments<FormatSize>(Type_List<Rest...>(), format, arguments + size, values..., value);
+    }
+
+    template<size_t FormatSize, typename... Values>
+    static void format_arguments(Type_List<>, char const * format, uint8_t const * arguments, Values const &... values) {
+        char message[Helper::calculateFormatSize<Values...>(FormatSize)] = {};
+        int const written_characters = snprintf(message, sizeof(message), format, values...);
+        Logger::printfln(written_characters >= 0 ? message : FAILED_MESSAGE);
+    }
+
+    template<size_t FormatSize, typename... Args>
+    static void format_message(char const * format, uint8_t const * arguments) {
+        format_arguments<FormatSize>(Type_List<Args...>(), format, arguments);
+    }
+
+    static void print_message(char const * format, uint8_t const * arguments) {
+        Logger::printfln(reinterpret_cast<char const *>(arguments));
+    }
+
+    /// @brief Locks the ring buffer and reserves the given amount of bytes for a new entry, the lock is only kept if reserving was successful and has to be released with release()
+    /// @param size Amount of bytes the new entry needs
+    /// @param position Position the entry has to be written at
+    /// @return Whether the bytes could be reserved, if not the message has been counted as discarded
+    static bool reserve(size_t const & size, size_t & position) {
+        if (!try_lock()) {
+            m_dropped++;
+            return false;
+        }
+        if (size > BufferSize - (m_head - m_tail)) {
+            unlock();
+            m_dropped++;
+            return false;
+        }
+        position = m_head;
+        return true;
+    }
+
+    /// @brief Publishes the reserved entry and releases the lock, must only be called after reserve() returned true and the complete entry has been written
+    /// @param size Amount of bytes that were reserved and written for the new entry
+    static void release(size_t const & size) {
+        m_head += size;
+        unlock();
+    }
+
+    static void write_bytes(size_t & position, uint8_t const * source, size_t const & length) {
+        // Positions increase monotonically and are only mapped onto the ring buffer when writing,
+        // meaning the amount of used bytes is always the difference between head and tail, even after the positions have overflowed
+        size_t const index = position % BufferSize;
+        size_t const first_part = (length < BufferSize - index) ? length : BufferSize - index;
+        (void)memcpy(m_buffer + index, source, first_part);
+        (void)memcpy(m_buffer, source + first_part, length - first_part);
+        position += length;
+    }
+
+    static void read_bytes(size_t const & position, uint8_t * destination, size_t const & length) {
+        size_t const index = position % BufferSize;
+        size_t const first_part = (length < BufferSize - index) ? length : BufferSize - index;
+        (void)memcpy(destination, m_buffer + index, first_part);
+        (void)memcpy(destination + first_part, m_buffer, length - first_part);
+    }
+
+    // Logging does not block if another task currently uses the ring buffer, because waiting for a lower priority task could stall the calling task indefinitely,
+    // instead the message is discarded, which only happens if multiple tasks log at the exact same time
+    static bool try_lock() {
+#if THINGSBOARD_ENABLE_STL
+        return !m_lock.test_and_set(std::memory_order_acquire);
+#else
+        if (m_lock) {
+            return false;
+        }
+        m_lock = true;
+        return true;
+#endif // THINGSBOARD_ENABLE_STL
+    }
+
+    static void unlock() {
+#if THINGSBOARD_ENABLE_STL
+        m_lock.clear(std::memory_order_release);
+#else
+        m_lock = false;
+#endif // THINGSBOARD_ENABLE_STL
+    }
+
+    static uint8_t          m_buffer[BufferSize];    // Ring buffer containing the entries of the messages that have not been processed yet
+    static uint8_t          m_arguments[BufferSize]; // Buffer the entry that is currently processed is copied into, kept static so it does not have to be allocated on the stack
+    static size_t           m_head;                  // Position the next entry is written at
+    static size_t           m_tail;                  // Position of the oldest entry that has not been processed yet
+#if THINGSBOARD_ENABLE_STL
+    static std::atomic_size_t m_dropped;             // Amount of messages that had to be discarded, atomic because it is increased without holding the lock
+    static std::atomic_flag m_lock;                  // Lock that ensures only one task writes or reads the ring buffer at a time
+#else
+    static size_t           m_dropped;               // Amount of messages that had to be discarded
+    static bool             m_lock;                  // Lock that ensures the ring buffer is not written again, while it is already being written or read
+#endif // THINGSBOARD_ENABLE_STL
+};
+
+template<size_t BufferSize, typename Logger>
+uint8_t DeferredLogger<BufferSize, Logger>::m_buffer[BufferSize] = {};
+
+template<size_t BufferSize, typename Logger>
+uint8_t DeferredLogger<BufferSize, Logger>::m_arguments[BufferSize] = {};
+
+template<size_t BufferSize, typename Logger>
+size_t DeferredLogger<BufferSize, Logger>::m_head = 0U;
+
+template<size_t BufferSize, typename Logger>
+size_t DeferredLogger<BufferSize, Logger>::m_tail = 0U;
+
+#if THINGSBOARD_ENABLE_STL
+template<size_t BufferSize, typename Logger>
+std::atomic_size_t DeferredLogger<BufferSize, Logger>::m_dropped(0U);
+
+template<size_t BufferSize, typename Logger>
+std::atomic_flag DeferredLogger<BufferSize, Logger>::m_lock = ATOMIC_FLAG_INIT;
+#else
+template<size_t BufferSize, typename Logger>
+size_t DeferredLogger<BufferSize, Logger>::m_dropped = 0U;
+
+template<size_t BufferSize, typename Logger>
+bool DeferredLogger<BufferSize, Logger>::m_lock = false;
+#endif // THINGSBOARD_ENABLE_STL
+
+#endif // Deferred_Logger_h
@@ -0,0 +1,422 @@
+// Header include.
+#include "Ed25519_Firmware_Verifier.h"
+
+// Local include.
+#include "Helper.h"
+
+// Library include.
+#include <string.h>
+
+
+// Element of the field of integers modulo 2^255 - 19, stored as 16 limbs of 16 bits each in little endian order.
+// The limbs are signed and bigger than needed, so that additions and subtractions can be done without carrying and multiplications only have to carry once at the end.
+// Arithmetic follows the public domain TweetNaCl implementation, see https://tweetnacl.cr.yp.to for more information
+using Field_Element = int64_t[16];
+// Point on the twisted Edwards curve in extended coordinates (X, Y, Z, T), where x = X / Z, y = Y / Z and x * y = T / Z
+using Curve_Point = Field_Element[4];
+
+// Field elements representing zero and one
+Field_Element constexpr FIELD_ZERO = {};
+Field_Element constexpr FIELD_ONE = {1};
+// Curve constant d = -121665 / 121666
+Field_Element constexpr CURVE_D = {
+    0x78A3, 0x1359, 0x4DCA, 0x75EB, 0xD8AB, 0x4141, 0x0A4D, 0x0070, 0xE898, 0x7779, 0x4079, 0x8CC7, 0xFE73, 0x2B6F, 0x6CEE, 0x5203
+};
+// Curve constant 2 * d, used when adding points
+Field_Element constexpr CURVE_D2 = {
+    0xF159, 0x26B2, 0x9B94, 0xEBD6, 0xB156, 0x8283, 0x149A, 0x00E0, 0xD130, 0xEEF3, 0x80F2, 0x198E, 0xFCE7, 0x56DF, 0xD9DC, 0x2406
+};
+// Coordinates of the base point B
+Field_Element constexpr BASE_X = {
+    0xD51A, 0x8F25, 0x2D60, 0xC956, 0xA7B2, 0x9525, 0xC760, 0x692C, 0xDC5C, 0xFDD6, 0xE231, 0xC0A4, 0x53FE, 0xCD6E, 0x36D3, 0x2169
+};
+Field_Element constexpr BASE_Y = {
+    0x6658, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666
+};
+// Square root of -1, used to find the second possible x coordinate when decoding a point
+Field_Element constexpr SQRT_MINUS_ONE = {
+    0xA0B0, 0x4A0E, 0x1B27, 0xC4EE, 0xE478, 0xAD2F, 0x1806, 0x2F43, 0xD7A7, 0x3DFB, 0x0099, 0x2B4D, 0xDF0B, 0x4FC1, 0x2480, 0x2B83
+};
+// Order L of the base point, 2^252 + 27742317777372353535851937790883648493, as little endian bytes
+uint8_t constexpr GROUP_ORDER[32] = {
+    0xED, 0xD3, 0xF5, 0x5C, 0x1A, 0x63, 0x12, 0x58, 0xD6, 0x9C, 0xF7, 0xA2, 0xDE, 0xF9, 0xDE, 0x14,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10
+};
+// Amount of bytes in an encoded point or scalar
+size_t constexpr ED25519_ELEMENT_SIZE = 32U;
+
+/// @brief Copies the given field element
+/// @param result Output field element
+/// @param value Field element that should be copied
+static void field_copy(Field_Element result, Field_Element const value) {
+    for (size_t i = 0U; i < 16U; i++) {
+        result[i] = value[i];
+    }
+}
+
+/// @brief Carries the bits above 16 of every limb into the next limb, the carry of the last limb is multiplied with 38 and added to the first limb, because 2^256 is equal to 38 modulo 2^255 - 19
+/// @param value Field element that should be carried
+static void field_carry(Field_Element value) {
+    for (size_t i = 0U; i < 16U; i++) {
+        value[i] += (1LL << 16);
+        int64_t const carry = value[i] >> 16;
+        value[(i + 1U) * (i < 15U)] += carry - 1 + 37 * (carry - 1) * (i == 15U);
+        value[i] -= carry * (1LL << 16);
+    }
+}
+
+/// @brief Swaps the given field elements if the given bit is set, without branching
+/// @param first First field element
+/// @param second Second field element
+/// @param bit Whether the field elements should be swapped, has to be either 0 or 1
+static void field_swap(Field_Element first, Field_Element second, int64_t const bit) {
+    int64_t const mask = ~(bit - 1);
+    for (size_t i = 0U; i < 16U; i++) {
+        int64_t const difference = mask & (first[i] ^ second[i]);
+        first[i] ^= difference;
+        second[i] ^= difference;
+    }
+}
+
+/// @brief Encodes the given field element fully reduced as 32 little endian bytes
+/// @param bytes Output buffer containing atleast 32 bytes
+/// @param value Field element that should be encoded
+static void field_pack(uint8_t * bytes, Field_Element const value) {
+    Field_Element reduced = {};
+    Field_Element subtracted = {};
+    field_copy(reduced, value);
+    field_carry(reduced);
+    field_carry(reduced);
+    field_carry(reduced);
+    // Subtracts the prime twice, keeping the result only if it did not become negative
+    for (size_t j = 0U; j < 2U; j++) {
+        subtracted[0] = reduced[0] - 0xFFED;
+        for (size_t i = 1U; i < 15U; i++) {
+            subtracted[i] = reduced[i] - 0xFFFF - ((subtracted[i - 1U] >> 16) & 1);
+            subtracted[i - 1U] &= 0xFFFF;
+        }
+        subtracted[15] = reduced[15] - 0x7FFF - ((subtracted[14] >> 16) & 1);
+        int64_t const borrow = (subtracted[15] >> 16) & 1;
+        subtracted[14] &= 0xFFFF;
+        field_swap(reduced, subtracted, 1 - borrow);
+    }
+    for (size_t i = 0U; i < 16U; i++) {
+        bytes[2U * i] = static_cast<uint8_t>(reduced[i] & 0xFF);
+        bytes[2U * i + 1U] = static_cast<uint8_t>(reduced[i] >> 8);
+    }
+}
+
+/// @brief Decodes the given 32 little endian bytes into a field element, ignoring the most significant bit
+/// @param value Output field element
+/// @param bytes Bytes that should be decoded, contains atleast 32 bytes
+static void field_unpack(Field_Element value, uint8_t const * bytes) {
+    for (size_t i = 0U; i < 16U; i++) {
+        value[i] = bytes[2U * i] + (static_cast<int64_t>(bytes[2U * i + 1U]) << 8);
+    }
+    value[15] &= 0x7FFF;
+}
+
+/// @brief Compares the given field elements after fully reducing them
+/// @param first First field element
+/// @param second Second field element
+/// @return Whether both field elements represent the same value
+static bool field_equals(Field_Element const first, Field_Element const second) {
+    uint8_t first_bytes[ED25519_ELEMENT_SIZE] = {};
+    uint8_t second_bytes[ED25519_ELEMENT_SIZE] = {};
+    field_pack(first_bytes, first);
+    field_pack(second_bytes, second);
+    return Helper::constantTimeEquals(first_bytes, second_bytes, ED25519_ELEMENT_SIZE);
+}
+
+/// @brief Returns whether the given field element is odd, which is encoded as the sign of the x coordinate of a point
+/// @param value Field element that should be checked
+/// @return Least significant bit of the fully reduced field element
+static uint8_t field_parity(Field_Element const value) {
+    uint8_t bytes[ED25519_ELEMENT_SIZE] = {};
+    field_pack(bytes, value);
+    return bytes[0] & 1U;
+}
+
+/// @brief Adds the given field elements without carrying
+/// @param result Output field element, can be the same as one of the inputs
+/// @param first First summand
+/// @param second Second summand
+static void field_add(Field_Element result, Field_Element const first, Field_Element const second) {
+    for (size_t i = 0U; i < 16U; i++) {
+        result[i] = first[i] + second[i];
+    }
+}
+
+/// @brief Subtracts the given field elements without carrying
+/// @param result Output field element, can be the same as one of the inputs
+/// @param first Minuend
+/// @param second Subtrahend
+static void field_subtract(Field_Element result, Field_Element const first, Field_Element const second) {
+    for (size_t i = 0U; i < 16U; i++) {
+        result[i] = first[i] - second[i];
+    }
+}
+
+/// @brief Multiplies the given field elements and carries the result
+/// @param result Output field element, can be the same as one of the inputs
+/// @param first First factor
+/// @param second Second factor
+static void field_multiply(Field_Element result, Field_Element const first, Field_Element const second) {
+    int64_t product[31] = {};
+    for (size_t i = 0U; i < 16U; i++) {
+        for (size_t j = 0U; j < 16U; j++) {
+            product[i + j] += first[i] * second[j];
+        }
+    }
+    // Limbs above 2^256 are folded back into the lower limbs, because 2^256 is equal to 38 modulo 2^255 - 19
+    for (size_t i = 0U; i < 15U; i++) {
+        product[i] += 38 * product[i + 16U];
+    }
+    for (size_t i = 0U; i < 16U; i++) {
+        result[i] = product[i];
+    }
+    field_carry(result);
+    field_carry(result);
+}
+
+/// @brief Raises the given field element to the power of (p - 5) / 8 = 2^252 - 3, which is needed to calculate the square root when decoding a point
+/// @param result Output field element, can be the same as the input
+/// @param value Field element that should be raised
+static void field_pow_2523(Field_Element result, Field_Element const value) {
+    Field_Element power = {};
+    field_copy(power, value);
+    for (int a = 250; a >= 0; a--) {
+        field_multiply(power, power, power);
+        if (a != 1) {
+            field_multiply(power, power, value);
+        }
+    }
+    field_copy(result, power);
+}
+
+/// @brief Raises the given field element to the power of p - 2 = 2^255 - 21, which is its multiplicative inverse
+/// @param result Output field element, can be the same as the input
+/// @param value Field element that should be inverted
+static void field_invert(Field_Element result, Field_Element const value) {
+    Field_Element power = {};
+    field_copy(power, value);
+    for (int a = 253; a >= 0; a--) {
+        field_multiply(power, power, power);
+        if (a != 2 && a != 4) {
+            field_multiply(power, power, value);
+        }
+    }
+    field_copy(result, power);
+}
+
+/// @brief Adds the second point to the first point
+/// @param first Point the second point is added to, contains the sum afterwards
+/// @param second Point that should be added
+static void point_add(Curve_Point first, Curve_Point const second) {
+    Field_Element a = {}, b = {}, c = {}, d = {}, t = {}, e = {}, f = {}, g = {}, h = {};
+    field_subtract(a, first[1], first[0]);
+    field_subtract(t, second[1], second[0]);
+    field_multiply(a, a, t);
+    field_add(b, first[0], first[1]);
+    field_add(t, second[0], second[1]);
+    field_multiply(b, b, t);
+    field_multiply(c, first[3], second[3]);
+    field_multiply(c, c, CURVE_D2);
+    field_multiply(d, first[2], second[2]);
+    field_add(d, d, d);
+    field_subtract(e, b, a);
+    field_subtract(f, d, c);
+    field_add(g, d, c);
+    field_add(h, b, a);
+    field_multiply(first[0], e, f);
+    field_multiply(first[1], h, g);
+    field_multiply(first[2], g, f);
+    field_multiply(first[3], e, h);
+}
+
+/// @brief Swaps the given points if the given bit is set, without branching
+/// @param first First point
+/// @param second Second point
+/// @param bit Whether the points should be swapped, has to be either 0 or 1
+static void point_swap(Curve_Point first, Curve_Point second, uint8_t const bit) {
+    for (size_t i = 0U; i < 4U; i++) {
+        field_swap(first[i], second[i], bit);
+    }
+}
+
+/// @brief Encodes the given point as its y coordinate, with the most significant bit set to the parity of its x coordinate
+/// @param bytes Output buffer containing atleast 32 bytes
+/// @param point Point that should be encoded
+static void point_pack(uint8_t * bytes, Curve_Point const point) {
+    Field_Element z_inverse = {}, x = {}, y = {};
+    field_invert(z_inverse, point[2]);
+    field_multiply(x, point[0], z_inverse);
+    field_multiply(y, point[1], z_inverse);
+    field_pack(bytes, y);
+    bytes[31] ^= field_parity(x) << 7;
+}
+
+/// @brief Multiplies the given point with the given scalar, with a double and add ladder over all 256 bits of the scalar
+/// @param result Output point
+/// @param point Point that should be multiplied, is modified while multiplying
+/// @param scalar Scalar as 32 little endian bytes
+static void point_multiply(Curve_Point result, Curve_Point point, uint8_t const * scalar) {
+    field_copy(result[0], FIELD_ZERO);
+    field_copy(result[1], FIELD_ONE);
+    field_copy(result[2], FIELD_ONE);
+    field_copy(result[3], FIELD_ZERO);
+    for (int i = 255; i >= 0; i--) {
+        uint8_t const bit = (scalar[i / 8] >> (i & 7)) & 1U;
+        point_swap(result, point, bit);
+        point_add(point, result);
+        point_add(result, result);
+        point_swap(result, point, bit);
+    }
+}
+
+/// @brief Multiplies the base point with the given scalar
+/// @param result Output point
+/// @param base Point the base point is copied into before it is multiplied, passed to reuse an existing point instead of needing another one on the stack
+/// @param scalar Scalar as 32 little endian bytes
+static void point_multiply_base(Curve_Point result, Curve_Point base, uint8_t const * scalar) {
+    field_copy(base[0], BASE_X);
+    field_copy(base[1], BASE_Y);
+    field_copy(base[2], FIELD_ONE);
+    field_multiply(base[3], BASE_X, BASE_Y);
+    point_multiply(result, base, scalar);
+}
+
+/// @brief Decodes the given encoded point and negates it, because the verification equation subtracts it
+/// @param point Output point
+/// @param bytes Encoded point, contains atleast 32 bytes
+/// @return Whether the bytes encode a valid point on the curve
+static bool point_unpack_negative(Curve_Point point, uint8_t const * bytes) {
+    Field_Element t = {}, check = {}, numerator = {}, denominator = {}, denominator2 = {}, denominator4 = {}, denominator6 = {};
+    field_copy(point[2], FIELD_ONE);
+    field_unpack(point[1], bytes);
+    // Recovers x from x^2 = (y^2 - 1) / (d * y^2 + 1), see RFC 8032 section 5.1.3 for more information
+    field_multiply(numerator, point[1], point[1]);
+    field_multiply(denominator, numerator, CURVE_D);
+    field_subtract(numerator, numerator, point[2]);
+    field_add(denominator, point[2], denominator);
+    field_multiply(denominator2, denominator, denominator);
+    field_multiply(denominator4, denominator2, denominator2);
+    field_multiply(denominator6, denominator4, denominator2);
+    field_multiply(t, denominator6, numerator);
+    field_multiply(t, t, denominator);
+    field_pow_2523(t, t);
+    field_multiply(t, t, numerator);
+    field_multiply(t, t, denominator);
+    field_multiply(t, t, denominator);
+    field_multiply(point[0], t, denominator);
+    field_multiply(check, point[0], point[0]);
+    field_multiply(check, check, denominator);
+    if (!field_equals(check, numerator)) {
+        field_multiply(point[0], point[0], SQRT_MINUS_ONE);
+    }
+    field_multiply(check, point[0], point[0]);
+    field_multiply(check, check, denominator);
+    if (!field_equals(check, numerator)) {
+        return false;
+    }
+    if (field_parity(point[0]) == (bytes[31] >> 7)) {
+        field_subtract(point[0], FIELD_ZERO, point[0]);
+    }
+    field_multiply(point[3], point[0], point[1]);
+    return true;
+}
+
+/// @brief Reduces the given 64 byte little endian number modulo the group order L
+/// @param result Output buffer containing atleast 32 bytes
+/// @param bytes Bytes of the number that should be reduced, contains atleast 64 bytes
+static void scalar_reduce(uint8_t * result, uint8_t const * bytes) {
+    int64_t x[64] = {};
+    for (size_t i = 0U; i < 64U; i++) {
+        x[i] = bytes[i];
+    }
+    for (int i = 63; i >= 32; i--) {
+        int64_t carry = 0;
+        int j = i - 32;
+        for (; j < i - 12; j++) {
+            x[j] += carry - 16 * x[i] * GROUP_ORDER[j - (i - 32)];
+            carry = (x[j] + 128) >> 8;
+            x[j] -= carry * 256;
+        }
+        x[j] += carry;
+        x[i] = 0;
+    }
+    int64_t carry = 0;
+    for (size_t j = 0U; j < 32U; j++) {
+        x[j] += carry - (x[31] >> 4) * GROUP_ORDER[j];
+        carry = x[j] >> 8;
+        x[j] &= 255;
+    }
+    for (size_t j = 0U; j < 32U; j++) {
+        x[j] -= carry * GROUP_ORDER[j];
+    }
+    for (size_t i = 0U; i < 32U; i++) {
+        x[i + 1U] += x[i] >> 8;
+        result[i] = static_cast<uint8_t>(x[i] & 255);
+    }
+}
+
+/// @brief Returns whether the given scalar is smaller than the group order L, which RFC 8032 requires for S, to ensure a valid signature can not be changed into another valid signature
+/// @param scalar Scalar as 32 little endian bytes
+/// @return Whether the given scalar is fully reduced
+static bool scalar_is_canonical(uint8_t const * scalar) {
+    for (size_t i = ED25519_ELEMENT_SIZE; i > 0U; i--) {
+        if (scalar[i - 1U] != GROUP_ORDER[i - 1U]) {
+            return scalar[i - 1U] < GROUP_ORDER[i - 1U];
+        }
+    }
+    return false;
+}
+
+Ed25519_Firmware_Verifier::Ed25519_Firmware_Verifier(uint8_t const * public_key)
+  : m_public_key(public_key)
+  , m_hash()
+  , m_signature()
+  , m_signature_set(false)
+{
+    // Nothing to do
+}
+
+bool Ed25519_Firmware_Verifier::set_signature(char const * signature) {
+    m_signature_set = signature != nullptr && Helper::parseHexString(signature, m_signature, ED25519_SIGNATURE_SIZE) && scalar_is_canonical(m_signature + ED25519_ELEMENT_SIZE);
+    return m_signature_set;
+}
+
+bool Ed25519_Firmware_Verifier::begin(size_t const & firmware_size) {
+    // The signed message is hashed after the encoded point R from the signature and the public key, therefore both have to be known before the first packet is received
+    return m_hash.start(mbedtls_md_type_t::MBEDTLS_MD_SHA512) && m_hash.update(m_signature, ED25519_ELEMENT_SIZE) && m_hash.update(m_public_key, ED25519_PUBLIC_KEY_SIZE);
+}
+
+bool Ed25519_Firmware_Verifier::update(uint8_t const * payload, size_t const & total_bytes) {
+    return m_hash.update(payload, total_bytes);
+}
+
+bool Ed25519_Firmware_Verifier::verify() {
+    if (!m_signature_set) {
+        return false;
+    }
+    uint8_t hash[MBEDTLS_MD_MAX_SIZE] = {};
+    if (!m_hash.finish(hash)) {
+        return false;
+    }
+    Curve_Point negative_public_key = {};
+    if (!point_unpack_negative(negative_public_key, m_public_key)) {
+        return false;
+    }
+    // Signature is valid if [S]B - [h]A encodes to the same bytes as R, with h being the hash of R, the public key A and the firmware binary reduced modulo L
+    uint8_t scalar[ED25519_ELEMENT_SIZE] = {};
+    scalar_reduce(scalar, hash);
+    Curve_Point result = {};
+    point_multiply(result, negative_public_key, scalar);
+    // Public key has been modified by the multiplication and is not needed anymore, therefore it is reused for the base point
+    Curve_Point signature_point = {};
+    point_multiply_base(signature_point, negative_public_key, m_signature + ED25519_ELEMENT_SIZE);
+    point_add(result, signature_point);
+    uint8_t encoded_result[ED25519_ELEMENT_SIZE] = {};
+    point_pack(encoded_result, result);
+    return Helper::constantTimeEquals(m_signature, encoded_result, ED25519_ELEMENT_SIZE);
+}
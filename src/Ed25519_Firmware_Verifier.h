@@ -0,0 +1,46 @@
+#ifndef Ed25519_Firmware_Verifier_h
+#define Ed25519_Firmware_Verifier_h
+
+// Local includes.
+#include "IFirmware_Verifier.h"
+#include "HashGenerator.h"
+
+
+// Amount of bytes in an Ed25519 public key
+size_t constexpr ED25519_PUBLIC_KEY_SIZE = 32U;
+// Amount of bytes in an Ed25519 signature, consisting of the encoded point R followed by the scalar S
+size_t constexpr ED25519_SIGNATURE_SIZE = 64U;
+
+
+/// @brief IFirmware_Verifier implementation that verifies the received firmware binary with an Ed25519 signature (see RFC 8032), created over the complete firmware binary with a private key that never has to leave the party that builds and uploads the firmware.
+/// The device only contains the public key, meaning unlike the HMAC_Firmware_Verifier, extracting the key from a device does not allow to create firmware images that are accepted by other devices.
+/// The signature has to be set as the hex representation in the fw_signature shared attribute of the device, before the firmware is assigned to it.
+/// Because the signed message is hashed together with the first half of the signature and the public key, the firmware binary is hashed with SHA-512 alongside the download, the remaining elliptic curve operations only run once in verify().
+/// Those are implemented in the library itself, meaning the verifier works on every platform that HashGenerator supports, but needs around 4 KiB of stack while verify() is executing.
+/// The key pair and the signature can for example be created with the following commands:
+/// openssl genpkey -algorithm ed25519 -out private.pem
+/// openssl pkey -in private.pem -pubout -outform DER | tail -c 32 | xxd -i
+/// openssl pkeyutl -sign -inkey private.pem -rawin -in firmware.bin | xxd -p -c 64
+class Ed25519_Firmware_Verifier : public IFirmware_Verifier {
+  public:
+    /// @brief Constructor
+    /// @param public_key Public key matching the private key the signature of the firmware binary was created with, has to contain ED25519_PUBLIC_KEY_SIZE bytes.
+    /// Is not copied and therefore needs to stay valid for as long as the verifier is used
+    Ed25519_Firmware_Verifier(uint8_t const * public_key);
+
+    bool set_signature(char const * signature) override;
+
+    bool begin(size_t const & firmware_size) override;
+
+    bool update(uint8_t const * payload, size_t const & total_bytes) override;
+
+    bool verify() override;
+
+  private:
+    uint8_t const *m_public_key = {};                        // Public key matching the private key the signature of the firmware binary was created with
+    HashGenerator m_hash = {};                               // SHA-512 hash over the first half of the signature, the public key and the firmware binary
+    uint8_t       m_signature[ED25519_SIGNATURE_SIZE] = {};  // Raw bytes of the expected signature, parsed from the fw_signature shared attribute
+    bool          m_signature_set = {};                      // Whether a valid expected signature has been set, verify() always fails if it has not
+};
+
+#endif // Ed25519_Firmware_Verifier_h
@@ -7,6 +7,7 @@
 #if THINGSBOARD_USE_ESP_MQTT
 
 // Local includes.
+#include "Constants.h"
 #include "IMQTT_Client.h"
 
 // Library includes.
@@ -19,6 +20,10 @@
 // to ensure other errors are indentified as well
 constexpr int MQTT_FAILURE_MESSAGE_ID = -1;
 constexpr char MQTT_DATA_EXCEEDS_BUFFER[] = "Received amount of data (%u) is bigger than current buffer size (%u), increase accordingly";
+constexpr char MQTT_FRAGMENT_TOPIC_EXCEEDS_BUFFER[] = "Received topic length (%u) of fragmented message is bigger than the internal topic buffer size (%u), discarding message";
+// Maximum length of the topic of a message that is received in multiple fragments, the topic is only received with the first fragment and therefore has to be cached for the following ones.
+// Big enough to hold the longest topic that can be received in fragments (v2/fw/response/4294967295/chunk/4294967295) + 1 for null termination
+constexpr size_t MAX_FRAGMENT_TOPIC_SIZE = 64U;
 #if THINGSBOARD_ENABLE_DEBUG
 constexpr char RECEIVED_MQTT_EVENT[] = "Handling received mqtt event: (%s)";
 constexpr char UPDATING_CONFIGURATION[] = "Updated configuration after inital connection with response: (%s)";
@@ -37,8 +42,12 @@ class Espressif_MQTT_Client : public IMQTT_Client {
     /// @brief Constructs a IMQTT_Client implementation which creates and empty esp_mqtt_client_config_t, which then has to be configured with the other methods in the class
     Espressif_MQTT_Client()
       : m_received_data_callback()
+      , m_received_data_fragment_callback()
+      , m_fragment_topic()
+      , m_publish_acknowledged_callback()
       , m_connected_callback()
       , m_connected(false)
+      , m_authentication_rejected(false)
       , m_enqueue_messages(false)
       , m_mqtt_configuration()
       , m_mqtt_client(nullptr)
@@ -214,6 +223,18 @@ class Espressif_MQTT_Client : public IMQTT_Client {
         m_received_data_callback.Set_Callback(callback);
     }
 
+    void set_data_fragment_callback(Callback<void, char *, uint8_t *, unsigned int, unsigned int, unsigned int>::function callback) override {
+        m_received_data_fragment_callback.Set_Callback(callback);
+    }
+
+    bool supports_fragmented_receive() override {
+        return true;
+    }
+
+    void set_publish_acknowledged_callback(Callback<void, uint16_t>::function callback) override {
+        m_publish_acknowledged_callback.Set_Callback(callback);
+    }
+
     void set_connect_callback(Callback<void>::function callback) override {
         m_connected_callback.Set_Callback(callback);
     }
@@ -285,6 +306,7 @@ class Espressif_MQTT_Client : public IMQTT_Client {
         m_mqtt_configuration.credentials.username = user_name;
         m_mqtt_configuration.credentials.authentication.password = password;
 #endif // ESP_IDF_VERSION_MAJOR < 5
+        m_authentication_rejected = false;
         // Update configuration is called to ensure that if we connected previously and call connect again with other credentials,
         // then we also update the client_id, username and password we connect with. Especially important for the provisioning workflow to work correctly
         update_configuration();
@@ -319,20 +341,27 @@ class Espressif_MQTT_Client : public IMQTT_Client {
     }
 
     bool publish(char const * topic, uint8_t const * payload, size_t const & length) override {
+        uint16_t packet_id = 0U;
+        return publish(topic, payload, length, 0U, packet_id);
+    }
+
+    bool publish(char const * topic, uint8_t const * payload, size_t const & length, uint8_t qos, uint16_t & packet_id) override {
         int message_id = MQTT_FAILURE_MESSAGE_ID;
 
         if (m_enqueue_messages) {
-            message_id = esp_mqtt_client_enqueue(m_mqtt_client, topic, reinterpret_cast<const char*>(payload), length, 0U, 0U, true);
-            return message_id > MQTT_FAILURE_MESSAGE_ID;
+            message_id = esp_mqtt_client_enqueue(m_mqtt_client, topic, reinterpret_cast<const char*>(payload), length, qos, 0U, true);
         }
-
-        // The blocking version esp_mqtt_client_publish() it is sent directly from the users task context.
-        // This way is used to send messages to the cloud, because like that no internal buffer has to be used to store the message until it should be sent,
-        // because all messages are sent with QoS level 0. If this is not wanted esp_mqtt_client_enqueue() could be used with store = true,
-        // to ensure the sending is done in the mqtt event context instead of the users task context.
-        // Allows to use the publish method without having to worry about any CPU overhead, so it can even be used in callbacks or high priority tasks, without starving other tasks,
-        // but compared to the other method esp_mqtt_client_enqueue() requires to save the message in the outbox, which increases the memory requirements for the internal buffer size
-        message_id = esp_mqtt_client_publish(m_mqtt_client, topic, reinterpret_cast<const char*>(payload), length, 0U, 0U);
+        else {
+            // The blocking version esp_mqtt_client_publish() it is sent directly from the users task context.
+            // This way is used to send messages to the cloud, because like that no internal buffer has to be used to store the message until it should be sent,
+            // as long as the message is sent with QoS level 0. If this is not wanted esp_mqtt_client_enqueue() could be used with store = true,
+            // to ensure the sending is done in the mqtt event context instead of the users task context.
+            // Allows to use the publish method without having to worry about any CPU overhead, so it can even be used in callbacks or high priority tasks, without starving other tasks,
+            // but compared to the other method esp_mqtt_client_enqueue() requires to save the message in the outbox, which increases the memory requirements for the internal buffer size.
+            // Messages sent with QoS level 1 are always kept in the outbox until they have been acknowledged, so they can be retransmitted
+            message_id = esp_mqtt_client_publish(m_mqtt_client, topic, reinterpret_cast<const char*>(payload), length, qos, 0U);
+        }
+        packet_id = (message_id > 0) ? static_cast<uint16_t>(message_id) : 0U;
         return message_id > MQTT_FAILURE_MESSAGE_ID;
     }
 
@@ -346,6 +375,32 @@ class Espressif_MQTT_Client : public IMQTT_Client {
         return message_id > MQTT_FAILURE_MESSAGE_ID;
     }
 
+#if ESP_IDF_VERSION_MAJOR > 5 || (ESP_IDF_VERSION_MAJOR == 5 && ESP_IDF_VERSION_MINOR >= 1)
+    bool subscribe(char const * const * topics, size_t const & count) override {
+        if (!connected()) {
+            return false;
+        }
+        // Topics are sent in batches of at most Default_Endpoints_Amount topic filters, which covers all topics the ThingsBoard client resubscribes with one packet,
+        // while keeping the size of the topic list on the stack fixed, no matter how many topics are passed
+        esp_mqtt_topic_t topic_list[Default_Endpoints_Amount] = {};
+        for (size_t offset = 0U; offset < count; offset += Default_Endpoints_Amount) {
+            size_t const batch_size = (count - offset < Default_Endpoints_Amount) ? count - offset : Default_Endpoints_Amount;
+            for (size_t i = 0U; i < batch_size; i++) {
+                topic_list[i].filter = topics[offset + i];
+                topic_list[i].qos = 0;
+            }
+            int const message_id = esp_mqtt_client_subscribe_multiple(m_mqtt_client, topic_list, static_cast<int>(batch_size));
+            if (message_id <= MQTT_FAILURE_MESSAGE_ID) {
+                return false;
+            }
+        }
+        return true;
+    }
+#else
+    // Subscribing multiple topic filters with a single packet is only supported by the esp-mqtt client contained in ESP-IDF v5.1 and newer, therefore the default implementation subscribing each topic seperately is used
+    using IMQTT_Client::subscribe;
+#endif // ESP_IDF_VERSION_MAJOR > 5 || (ESP_IDF_VERSION_MAJOR == 5 && ESP_IDF_VERSION_MINOR >= 1)
+
     bool unsubscribe(char const * topic) override {
         // The esp_mqtt_client_unsubscribe method does not return false, if we send a unsubscribe request while not being connected to a broker,
         // so we have to check for that case to ensure the end user is informed that their unsubscribe request could not be sent and has been ignored.
@@ -360,6 +415,11 @@ class Espressif_MQTT_Client : public IMQTT_Client {
         return m_connected;
     }
 
+    bool authentication_rejected() override {
+        // The connection is established asynchronously, therefore this only returns true once the error event of the refused connection has been received
+        return m_authentication_rejected;
+    }
+
 private:
     /// @brief Is internally used to allow changes to the underlying configuration of the esp_mqtt_client_handle_t after it has connected,
     /// to for example increase the buffer size or increase the timeouts or stack size, allows to change the underlying client configuration,
@@ -421,16 +481,40 @@ private:
         switch (event_id) {
             case esp_mqtt_event_id_t::MQTT_EVENT_CONNECTED:
                 m_connected = true;
+                m_authentication_rejected = false;
                 m_connected_callback.Call_Callback();
                 break;
             case esp_mqtt_event_id_t::MQTT_EVENT_DISCONNECTED:
                 m_connected = false;
                 break;
+            case esp_mqtt_event_id_t::MQTT_EVENT_ERROR:
+                if (event->error_handle != nullptr && event->error_handle->error_type == MQTT_ERROR_TYPE_CONNECTION_REFUSED) {
+                    esp_mqtt_connect_return_code_t const return_code = event->error_handle->connect_return_code;
+                    m_authentication_rejected = return_code == MQTT_CONNECTION_REFUSE_BAD_USERNAME || return_code == MQTT_CONNECTION_REFUSE_NOT_AUTHORIZED;
+                }
+                break;
+            case esp_mqtt_event_id_t::MQTT_EVENT_PUBLISHED:
+                // Only posted for messages sent with QoS level 1 or 2, once the broker has acknowledged them
+                m_publish_acknowledged_callback.Call_Callback(static_cast<uint16_t>(event->msg_id));
+                break;
             case esp_mqtt_event_id_t::MQTT_EVENT_DATA: {
-                // Check wheter the given message has not bee received completly, but instead would be received in multiple chunks,
-                // if it were we discard the message because receiving a message over multiple chunks is currently not supported
+                // Check wheter the given message has not bee received completly, but instead is received in multiple fragments,
+                // if it is we forward each fragment directly from the receive buffer, but because only the first fragment contains the topic, it has to be cached for the following fragments
                 if (event->data_len != event->total_data_len) {
-                    Logger::printfln(MQTT_DATA_EXCEEDS_BUFFER, event->total_data_len, get_receive_buffer_size());
+                    if (event->current_data_offset == 0) {
+                        if (static_cast<size_t>(event->topic_len) >= sizeof(m_fragment_topic)) {
+                            Logger::printfln(MQTT_FRAGMENT_TOPIC_EXCEEDS_BUFFER, event->topic_len, sizeof(m_fragment_topic));
+                            m_fragment_topic[0] = '\0';
+                            break;
+                        }
+                        (void)strncpy(m_fragment_topic, event->topic, event->topic_len);
+                        m_fragment_topic[event->topic_len] = '\0';
+                    }
+                    // First fragment of the message has been discarded, therefore the following fragments are discarded as well
+                    else if (m_fragment_topic[0] == '\0') {
+                        break;
+                    }
+                    m_received_data_fragment_callback.Call_Callback(m_fragment_topic, reinterpret_cast<uint8_t*>(event->data), event->data_len, event->current_data_offset, event->total_data_len);
                     break;
                 }
                 // Topic is not null terminated, to fix this issue we copy the topic string.
@@ -454,12 +538,16 @@ private:
         instance->mqtt_event_handler(base, static_cast<esp_mqtt_event_id_t>(event_id), event_data);
     }
 
-    Callback<void, char *, uint8_t *, unsigned int> m_received_data_callback = {}; // Callback that will be called as soon as the mqtt client receives any data
-    Callback<void>                                  m_connected_callback = {};     // Callback that will be called as soon as the mqtt client has connected
-    bool                                            m_connected = {};              // Whether the client has received the connected or disconnected event
-    bool                                            m_enqueue_messages = {};       // Whether we enqueue messages making nearly all ThingsBoard calls non blocking or wheter we publish instead
-    esp_mqtt_client_config_t                        m_mqtt_configuration = {};     // Configuration of the underlying mqtt client, saved as a private variable to allow changes after inital configuration with the same options for all non changed settings
-    esp_mqtt_client_handle_t                        m_mqtt_client = {};            // Handle to the underlying mqtt client, used to establish the communication
+    Callback<void, char *, uint8_t *, unsigned int>                             m_received_data_callback = {};                  // Callback that will be called as soon as the mqtt client receives any data
+    Callback<void, char *, uint8_t *, unsigned int, unsigned int, unsigned int> m_received_data_fragment_callback = {};         // Callback that will be called for every fragment of data that is bigger than the receive buffer
+    char                                                                        m_fragment_topic[MAX_FRAGMENT_TOPIC_SIZE] = {}; // Topic of the message that is currently received in fragments, because only the first fragment contains the topic
+    Callback<void, uint16_t>                                                    m_publish_acknowledged_callback = {};           // Callback that will be called as soon as the mqtt broker has acknowledged a message published with QoS level 1
+    Callback<void>                                                              m_connected_callback = {};                      // Callback that will be called as soon as the mqtt client has connected
+    bool                                                                        m_connected = {};                               // Whether the client has received the connected or disconnected event
+    bool                                                                        m_authentication_rejected = {};                 // Whether the last connection attempt has been refused by the server because of the sent credentials
+    bool                                                                        m_enqueue_messages = {};                        // Whether we enqueue messages making nearly all ThingsBoard calls non blocking or wheter we publish instead
+    esp_mqtt_client_config_t                                                    m_mqtt_configuration = {};                      // Configuration of the underlying mqtt client, saved as a private variable to allow changes after inital configuration with the same options for all non changed settings
+    esp_mqtt_client_handle_t                                                    m_mqtt_client = {};                             // Handle to the underlying mqtt client, used to establish the communication
 };
 
 #endif // THINGSBOARD_USE_ESP_MQTT
@@ -0,0 +1,142 @@
+#ifndef File_Credential_Store_h
+#define File_Credential_Store_h
+
+// Local includes.
+#include "DefaultLogger.h"
+#include "ICredential_Store.h"
+
+// Library includes.
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#if THINGSBOARD_USE_FSYNC
+#include <fcntl.h>
+#include <unistd.h>
+#endif // THINGSBOARD_USE_FSYNC
+
+
+// First line of the file, allows to detect files that were not written by this class or with a different format
+char constexpr CREDENTIAL_FILE_HEADER[] = "tb-credentials-v1";
+// Suffix of the temporary file the credentials are written into, before it replaces the actual file
+char constexpr CREDENTIAL_FILE_TEMPORARY_SUFFIX[] = ".tmp";
+// Maximum length of the path of the credentials file, the path of the temporary file is built on the stack and therefore needs an upper bound
+size_t constexpr MAX_CREDENTIAL_FILE_PATH_LENGTH = 128U;
+// Log messages.
+char constexpr CREDENTIAL_FILE_WRITE_FAILED[] = "Failed to write credentials to file (%s)";
+char constexpr CREDENTIAL_FILE_INVALID[] = "Credentials file (%s) is invalid or truncated, ignoring it";
+char constexpr CREDENTIAL_CONTAINS_NEW_LINE[] = "Credentials containing line breaks can not be stored";
+char constexpr CREDENTIAL_FILE_PATH_TOO_LONG[] = "Path of the credentials file (%s) is longer than (%u) characters, increase MAX_CREDENTIAL_FILE_PATH_LENGTH accordingly";
+
+
+/// @brief ICredential_Store implementation that uses the c fopen function (https://cplusplus.com/reference/cstdio/fopen/),
+/// under the hood to persist the credentials in a text file, with the client id, username and password on seperate lines. Useful when running on a host operating system like Linux,
+/// or on an ESP32 with a mounted SPIFFS, LittleFS or FAT filesystem. The credentials are written into a temporary file first, which then replaces the previous file,
+/// so that a power loss while writing never leaves behind a partially written file. The temporary file is flushed to the storage device before it replaces the previous file,
+/// if the platform supports fsync (THINGSBOARD_USE_FSYNC), otherwise the written content might still only be cached by the operating system when the file is replaced
+/// @tparam Logger Implementation that should be used to print error messages generated by internal processes and additional debugging messages if THINGSBOARD_ENABLE_DEBUG is set, default = DefaultLogger
+template <typename Logger = DefaultLogger>
+class File_Credential_Store : public ICredential_Store {
+  public:
+    /// @brief Constructor
+    /// @param file_path Path of the file the credentials are stored in, not copied meaning it has to stay valid for the lifetime of this instance
+    File_Credential_Store(char const * file_path)
+      : m_path(file_path)
+    {
+        // Nothing to do
+    }
+
+    bool load(Device_Credentials & credentials) override {
+        FILE * file = fopen(m_path, "r");
+        if (file == nullptr) {
+            return false;
+        }
+        char header[sizeof(CREDENTIAL_FILE_HEADER) + 1U] = {};
+        bool const result = read_line(file, header) && strcmp(header, CREDENTIAL_FILE_HEADER) == 0
+          && read_line(file, credentials.client_id) && read_line(file, credentials.username) && read_line(file, credentials.password);
+        (void)fclose(file);
+        if (!result) {
+            Logger::printfln(CREDENTIAL_FILE_INVALID, m_path);
+        }
+        return result;
+    }
+
+    bool store(Device_Credentials const & credentials) override {
+        if (strchr(credentials.client_id, '\n') != nullptr || strchr(credentials.username, '\n') != nullptr || strchr(credentials.password, '\n') != nullptr) {
+            Logger::printfln(CREDENTIAL_CONTAINS_NEW_LINE);
+            return false;
+        }
+        if (strlen(m_path) > MAX_CREDENTIAL_FILE_PATH_LENGTH) {
+            Logger::printfln(CREDENTIAL_FILE_PATH_TOO_LONG, m_path, MAX_CREDENTIAL_FILE_PATH_LENGTH);
+            return false;
+        }
+        char temporary_path[MAX_CREDENTIAL_FILE_PATH_LENGTH + sizeof(CREDENTIAL_FILE_TEMPORARY_SUFFIX)] = {};
+        (void)snprintf(temporary_path, sizeof(temporary_path), "%s%s", m_path, CREDENTIAL_FILE_TEMPORARY_SUFFIX);
+
+        FILE * file = fopen(temporary_path, "w");
+        if (file == nullptr) {
+            Logger::printfln(CREDENTIAL_FILE_WRITE_FAILED, m_path);
+            return false;
+        }
+        bool result = fprintf(file, "%s\n%s\n%s\n%s\n", CREDENTIAL_FILE_HEADER, credentials.client_id, credentials.username, credentials.password) > 0;
+        // Flushing the buffered content can fail as well if the filesystem is full, afterwards the content is synced so that it is on the storage device before the file replaces the previous one
+        result = result && fflush(file) == 0;
+#if THINGSBOARD_USE_FSYNC
+        result = result && fsync(fileno(file)) == 0;
+#endif // THINGSBOARD_USE_FSYNC
+        result = fclose(file) == 0 && result;
+        if (!result || rename(temporary_path, m_path) != 0) {
+            Logger::printfln(CREDENTIAL_FILE_WRITE_FAILED, m_path);
+            (void)remove(temporary_path);
+            return false;
+        }
+        sync_directory();
+        return true;
+    }
+
+    bool clear() override {
+        return remove(m_path) == 0 || errno == ENOENT;
+    }
+
+  private:
+    /// @brief Syncs the directory containing the credentials file, so that the replaced directory entry is persisted as well.
+    /// Failures are ignored, because not every filesystem supports opening directories, the credentials themselves have already been synced at that point
+    void sync_directory() const {
+#if THINGSBOARD_USE_FSYNC && defined(O_DIRECTORY)
+        char directory[MAX_CREDENTIAL_FILE_PATH_LENGTH + 1U] = ".";
+        char const * const separator = strrchr(m_path, '/');
+        if (separator != nullptr) {
+            size_t const length = (separator == m_path) ? 1U : static_cast<size_t>(separator - m_path);
+            (void)memcpy(directory, m_path, length);
+            directory[length] = '\0';
+        }
+        int const descriptor = open(directory, O_RDONLY | O_DIRECTORY);
+        if (descriptor < 0) {
+            return;
+        }
+        (void)fsync(descriptor);
+        (void)close(descriptor);
+#endif // THINGSBOARD_USE_FSYNC && defined(O_DIRECTORY)
+    }
+
+    /// @brief Reads the next line of the given file into the given buffer without the line break
+    /// @tparam Size Size of the buffer the line is read into
+    /// @param file File the line should be read from
+    /// @param buffer Buffer the line is copied into
+    /// @return Whether a complete line could be read, fails if the line does not fit into the buffer or the end of the file has been reached before the line break
+    template<size_t Size>
+    static bool read_line(FILE * file, char (&buffer)[Size]) {
+        if (fgets(buffer, Size, file) == nullptr) {
+            return false;
+        }
+        char * const line_break = strchr(buffer, '\n');
+        if (line_break == nullptr) {
+            return false;
+        }
+        *line_break = '\0';
+        return true;
+    }
+
+    char const *m_path = {}; // Path of the file the credentials are stored in
+};
+
+#endif // File_Credential_Store_h
@@ -0,0 +1,75 @@
+// Header include.
+#include "HMAC_Firmware_Verifier.h"
+
+// Local include.
+#include "Helper.h"
+
+// Library include.
+#include <string.h>
+
+
+// Biggest block size of all supported hash algorithms, SHA-384 and SHA-512 process blocks of 128 bytes, MD5 and SHA-256 blocks of 64 bytes
+size_t constexpr HMAC_MAX_BLOCK_SIZE = 128U;
+// Value every byte of the padded key is combined with for the inner hash
+uint8_t constexpr HMAC_INNER_PAD = 0x36U;
+// Value every byte of the padded key is combined with for the outer hash
+uint8_t constexpr HMAC_OUTER_PAD = 0x5CU;
+
+HMAC_Firmware_Verifier::HMAC_Firmware_Verifier(uint8_t const * key, size_t const & key_length, mbedtls_md_type_t const & type)
+  : m_key(key)
+  , m_key_length(key_length)
+  , m_type(type)
+  , m_hash()
+  , m_signature()
+  , m_signature_set(false)
+{
+    // Nothing to do
+}
+
+bool HMAC_Firmware_Verifier::set_signature(char const * signature) {
+    m_signature_set = signature != nullptr && Helper::parseHexString(signature, m_signature, HashGenerator::mbedtls_type_to_size(m_type));
+    return m_signature_set;
+}
+
+bool HMAC_Firmware_Verifier::begin(size_t const & firmware_size) {
+    uint8_t block[HMAC_MAX_BLOCK_SIZE] = {};
+    size_t const block_size = Get_Padded_Key(HMAC_INNER_PAD, block);
+    return block_size != 0U && m_hash.start(m_type) && m_hash.update(block, block_size);
+}
+
+bool HMAC_Firmware_Verifier::update(uint8_t const * payload, size_t const & total_bytes) {
+    return m_hash.update(payload, total_bytes);
+}
+
+bool HMAC_Firmware_Verifier::verify() {
+    if (!m_signature_set) {
+        return false;
+    }
+    uint8_t inner_hash[MBEDTLS_MD_MAX_SIZE] = {};
+    if (!m_hash.finish(inner_hash)) {
+        return false;
+    }
+    uint8_t block[HMAC_MAX_BLOCK_SIZE] = {};
+    size_t const block_size = Get_Padded_Key(HMAC_OUTER_PAD, block);
+    uint8_t calculated_code[MBEDTLS_MD_MAX_SIZE] = {};
+    // The inner hash generator is not needed anymore and can therefore be reused for the outer hash
+    bool const result = block_size != 0U && m_hash.start(m_type) && m_hash.update(block, block_size) && m_hash.update(inner_hash, m_hash.get_size()) && m_hash.finish(calculated_code);
+    return result && Helper::constantTimeEquals(m_signature, calculated_code, m_hash.get_size());
+}
+
+size_t HMAC_Firmware_Verifier::Get_Padded_Key(uint8_t const & pad, uint8_t * block) {
+    size_t const block_size = (m_type == mbedtls_md_type_t::MBEDTLS_MD_SHA384 || m_type == mbedtls_md_type_t::MBEDTLS_MD_SHA512) ? 128U : 64U;
+    if (m_key_length > block_size) {
+        HashGenerator key_hash;
+        if (!key_hash.start(m_type) || !key_hash.update(m_key, m_key_length) || !key_hash.finish(block)) {
+            return 0U;
+        }
+    }
+    else if (m_key_length != 0U) {
+        (void)memcpy(block, m_key, m_key_length);
+    }
+    for (size_t i = 0U; i < block_size; i++) {
+        block[i] ^= pad;
+    }
+    return block_size;
+}
@@ -0,0 +1,46 @@
+#ifndef HMAC_Firmware_Verifier_h
+#define HMAC_Firmware_Verifier_h
+
+// Local includes.
+#include "IFirmware_Verifier.h"
+#include "HashGenerator.h"
+
+
+/// @brief IFirmware_Verifier implementation that verifies the received firmware binary with a keyed-hash message authentication code (HMAC, see RFC 2104),
+/// calculated over the complete firmware binary with a secret key that is shared between the device and the party that builds and uploads the firmware.
+/// The expected code has to be set as the hex representation in the fw_signature shared attribute of the device, before the firmware is assigned to it.
+/// Unlike the checksum sent by the server, the code can not be recreated by a 3rd party that replaces the firmware binary, as long as the key remains secret.
+/// The code can for example be created with the following command: openssl dgst -sha256 -hmac <key> firmware.bin
+class HMAC_Firmware_Verifier : public IFirmware_Verifier {
+  public:
+    /// @brief Constructor
+    /// @param key Secret key the code of the firmware binary was created with, is not copied and therefore needs to stay valid for as long as the verifier is used
+    /// @param key_length Amount of bytes in the given key
+    /// @param type Hash algorithm the code of the firmware binary was created with, default = MBEDTLS_MD_SHA256
+    HMAC_Firmware_Verifier(uint8_t const * key, size_t const & key_length, mbedtls_md_type_t const & type = mbedtls_md_type_t::MBEDTLS_MD_SHA256);
+
+    bool set_signature(char const * signature) override;
+
+    bool begin(size_t const & firmware_size) override;
+
+    bool update(uint8_t const * payload, size_t const & total_bytes) override;
+
+    bool verify() override;
+
+  private:
+    /// @brief Pads the key to the block size of the used hash algorithm and combines every byte of it with the given value,
+    /// keys that are bigger than the block size are hashed first, as required by RFC 2104
+    /// @param pad Value every byte of the padded key is combined with, 0x36 for the inner and 0x5C for the outer hash
+    /// @param block Output buffer the padded key will be copied into, needs to be big enough to hold the block size of the used hash algorithm
+    /// @return Block size of the used hash algorithm or 0 if hashing the key failed
+    size_t Get_Padded_Key(uint8_t const & pad, uint8_t * block);
+
+    uint8_t const     *m_key = {};                           // Secret key the code of the firmware binary was created with
+    size_t            m_key_length = {};                     // Amount of bytes in the secret key
+    mbedtls_md_type_t m_type = {};                           // Hash algorithm the code of the firmware binary was created with
+    HashGenerator     m_hash = {};                           // Inner hash over the padded key and the firmware binary, finished and used for the outer hash in verify()
+    uint8_t           m_signature[MBEDTLS_MD_MAX_SIZE] = {}; // Raw bytes of the expected code, parsed from the fw_signature shared attribute
+    bool              m_signature_set = {};                  // Whether a valid expected code has been set, verify() always fails if it has not
+};
+
+#endif // HMAC_Firmware_Verifier_h
@@ -1,13 +1,389 @@
 // Header include.
 #include "HashGenerator.h"
 
+#if THINGSBOARD_USE_BUILTIN_HASH
 // Library include.
-#include <stdio.h>
+#include <string.h>
+
+
+// Amount of bits each MD5 round rotates its result by, see https://www.rfc-editor.org/rfc/rfc1321 for more information
+uint8_t constexpr MD5_SHIFTS[64] = {
+    7U, 12U, 17U, 22U, 7U, 12U, 17U, 22U, 7U, 12U, 17U, 22U, 7U, 12U, 17U, 22U,
+    5U, 9U, 14U, 20U, 5U, 9U, 14U, 20U, 5U, 9U, 14U, 20U, 5U, 9U, 14U, 20U,
+    4U, 11U, 16U, 23U, 4U, 11U, 16U, 23U, 4U, 11U, 16U, 23U, 4U, 11U, 16U, 23U,
+    6U, 10U, 15U, 21U, 6U, 10U, 15U, 21U, 6U, 10U, 15U, 21U, 6U, 10U, 15U, 21U
+};
+// Constants added in each MD5 round, integer part of the sines of the round number multiplied with 2^32
+uint32_t constexpr MD5_CONSTANTS[64] = {
+    0xD76AA478U, 0xE8C7B756U, 0x242070DBU, 0xC1BDCEEEU, 0xF57C0FAFU, 0x4787C62AU, 0xA8304613U, 0xFD469501U,
+    0x698098D8U, 0x8B44F7AFU, 0xFFFF5BB1U, 0x895CD7BEU, 0x6B901122U, 0xFD987193U, 0xA679438EU, 0x49B40821U,
+    0xF61E2562U, 0xC040B340U, 0x265E5A51U, 0xE9B6C7AAU, 0xD62F105DU, 0x02441453U, 0xD8A1E681U, 0xE7D3FBC8U,
+    0x21E1CDE6U, 0xC33707D6U, 0xF4D50D87U, 0x455A14EDU, 0xA9E3E905U, 0xFCEFA3F8U, 0x676F02D9U, 0x8D2A4C8AU,
+    0xFFFA3942U, 0x8771F681U, 0x6D9D6122U, 0xFDE5380CU, 0xA4BEEA44U, 0x4BDECFA9U, 0xF6BB4B60U, 0xBEBFBC70U,
+    0x289B7EC6U, 0xEAA127FAU, 0xD4EF3085U, 0x04881D05U, 0xD9D4D039U, 0xE6DB99E5U, 0x1FA27CF8U, 0xC4AC5665U,
+    0xF4292244U, 0x432AFF97U, 0xAB9423A7U, 0xFC93A039U, 0x655B59C3U, 0x8F0CCC92U, 0xFFEFF47DU, 0x85845DD1U,
+    0x6FA87E4FU, 0xFE2CE6E0U, 0xA3014314U, 0x4E0811A1U, 0xF7537E82U, 0xBD3AF235U, 0x2AD7D2BBU, 0xEB86D391U
+};
+// Initial MD5 hash value
+uint32_t constexpr MD5_INITIAL_STATE[4] = {
+    0x67452301U, 0xEFCDAB89U, 0x98BADCFEU, 0x10325476U
+};
+// Constants added in each SHA-256 round, see https://www.rfc-editor.org/rfc/rfc6234 for more information
+uint32_t constexpr SHA256_CONSTANTS[64] = {
+    0x428A2F98U, 0x71374491U, 0xB5C0FBCFU, 0xE9B5DBA5U, 0x3956C25BU, 0x59F111F1U, 0x923F82A4U, 0xAB1C5ED5U,
+    0xD807AA98U, 0x12835B01U, 0x243185BEU, 0x550C7DC3U, 0x72BE5D74U, 0x80DEB1FEU, 0x9BDC06A7U, 0xC19BF174U,
+    0xE49B69C1U, 0xEFBE4786U, 0x0FC19DC6U, 0x240CA1CCU, 0x2DE92C6FU, 0x4A7484AAU, 0x5CB0A9DCU, 0x76F988DAU,
+    0x983E5152U, 0xA831C66DU, 0xB00327C8U, 0xBF597FC7U, 0xC6E00BF3U, 0xD5A79147U, 0x06CA6351U, 0x14292967U,
+    0x27B70A85U, 0x2E1B2138U, 0x4D2C6DFCU, 0x53380D13U, 0x650A7354U, 0x766A0ABBU, 0x81C2C92EU, 0x92722C85U,
+    0xA2BFE8A1U, 0xA81A664BU, 0xC24B8B70U, 0xC76C51A3U, 0xD192E819U, 0xD6990624U, 0xF40E3585U, 0x106AA070U,
+    0x19A4C116U, 0x1E376C08U, 0x2748774CU, 0x34B0BCB5U, 0x391C0CB3U, 0x4ED8AA4AU, 0x5B9CCA4FU, 0x682E6FF3U,
+    0x748F82EEU, 0x78A5636FU, 0x84C87814U, 0x8CC70208U, 0x90BEFFFAU, 0xA4506CEBU, 0xBEF9A3F7U, 0xC67178F2U
+};
+// Initial SHA-256 hash value
+uint32_t constexpr SHA256_INITIAL_STATE[8] = {
+    0x6A09E667U, 0xBB67AE85U, 0x3C6EF372U, 0xA54FF53AU, 0x510E527FU, 0x9B05688CU, 0x1F83D9ABU, 0x5BE0CD19U
+};
+// Constants added in each SHA-384 and SHA-512 round
+uint64_t constexpr SHA512_CONSTANTS[80] = {
+    0x428A2F98D728AE22ULL, 0x7137449123EF65CDULL, 0xB5C0FBCFEC4D3B2FULL, 0xE9B5DBA58189DBBCULL,
+    0x3956C25BF348B538ULL, 0x59F111F1B605D019ULL, 0x923F82A4AF194F9BULL, 0xAB1C5ED5DA6D8118ULL,
+    0xD807AA98A3030242ULL, 0x12835B0145706FBEULL, 0x243185BE4EE4B28CULL, 0x550C7DC3D5FFB4E2ULL,
+    0x72BE5D74F27B896FULL, 0x80DEB1FE3B1696B1ULL, 0x9BDC06A725C71235ULL, 0xC19BF174CF692694ULL,
+    0xE49B69C19EF14AD2ULL, 0xEFBE4786384F25E3ULL, 0x0FC19DC68B8CD5B5ULL, 0x240CA1CC77AC9C65ULL,
+    0x2DE92C6F592B0275ULL, 0x4A7484AA6EA6E483ULL, 0x5CB0A9DCBD41FBD4ULL, 0x76F988DA831153B5ULL,
+    0x983E5152EE66DFABULL, 0xA831C66D2DB43210ULL, 0xB00327C898FB213FULL, 0xBF597FC7BEEF0EE4ULL,
+    0xC6E00BF33DA88FC2ULL, 0xD5A79147930AA725ULL, 0x06CA6351E003826FULL, 0x142929670A0E6E70ULL,
+    0x27B70A8546D22FFCULL, 0x2E1B21385C26C926ULL, 0x4D2C6DFC5AC42AEDULL, 0x53380D139D95B3DFULL,
+    0x650A73548BAF63DEULL, 0x766A0ABB3C77B2A8ULL, 0x81C2C92E47EDAEE6ULL, 0x92722C851482353BULL,
+    0xA2BFE8A14CF10364ULL, 0xA81A664BBC423001ULL, 0xC24B8B70D0F89791ULL, 0xC76C51A30654BE30ULL,
+    0xD192E819D6EF5218ULL, 0xD69906245565A910ULL, 0xF40E35855771202AULL, 0x106AA07032BBD1B8ULL,
+    0x19A4C116B8D2D0C8ULL, 0x1E376C085141AB53ULL, 0x2748774CDF8EEB99ULL, 0x34B0BCB5E19B48A8ULL,
+    0x391C0CB3C5C95A63ULL, 0x4ED8AA4AE3418ACBULL, 0x5B9CCA4F7763E373ULL, 0x682E6FF3D6B2B8A3ULL,
+    0x748F82EE5DEFB2FCULL, 0x78A5636F43172F60ULL, 0x84C87814A1F0AB72ULL, 0x8CC702081A6439ECULL,
+    0x90BEFFFA23631E28ULL, 0xA4506CEBDE82BDE9ULL, 0xBEF9A3F7B2C67915ULL, 0xC67178F2E372532BULL,
+    0xCA273ECEEA26619CULL, 0xD186B8C721C0C207ULL, 0xEADA7DD6CDE0EB1EULL, 0xF57D4F7FEE6ED178ULL,
+    0x06F067AA72176FBAULL, 0x0A637DC5A2C898A6ULL, 0x113F9804BEF90DAEULL, 0x1B710B35131C471BULL,
+    0x28DB77F523047D84ULL, 0x32CAAB7B40C72493ULL, 0x3C9EBE0A15C9BEBCULL, 0x431D67C49C100D4CULL,
+    0x4CC5D4BECB3E42B6ULL, 0x597F299CFC657E2AULL, 0x5FCB6FAB3AD6FAECULL, 0x6C44198C4A475817ULL
+};
+// Initial SHA-384 hash value
+uint64_t constexpr SHA384_INITIAL_STATE[8] = {
+    0xCBBB9D5DC1059ED8ULL, 0x629A292A367CD507ULL, 0x9159015A3070DD17ULL, 0x152FECD8F70E5939ULL,
+    0x67332667FFC00B31ULL, 0x8EB44A8768581511ULL, 0xDB0C2E0D64F98FA7ULL, 0x47B5481DBEFA4FA4ULL
+};
+// Initial SHA-512 hash value
+uint64_t constexpr SHA512_INITIAL_STATE[8] = {
+    0x6A09E667F3BCC908ULL, 0xBB67AE8584CAA73BULL, 0x3C6EF372FE94F82BULL, 0xA54FF53A5F1D36F1ULL,
+    0x510E527FADE682D1ULL, 0x9B05688C2B3E6C1FULL, 0x1F83D9ABFB41BD6BULL, 0x5BE0CD19137E2179ULL
+};
+
+
+/// @brief Rotates the given value to the left
+/// @param value Value that should be rotated
+/// @param bits Amount of bits the value is rotated by, has to be between 1 and 31
+/// @return Rotated value
+static inline uint32_t rotate_left(uint32_t value, uint8_t bits) {
+    return (value << bits) | (value >> (32U - bits));
+}
+
+/// @brief Rotates the given value to the right
+/// @param value Value that should be rotated
+/// @param bits Amount of bits the value is rotated by, has to be between 1 and 31
+/// @return Rotated value
+static inline uint32_t rotate_right(uint32_t value, uint8_t bits) {
+    return (value >> bits) | (value << (32U - bits));
+}
+
+/// @brief Rotates the given value to the right
+/// @param value Value that should be rotated
+/// @param bits Amount of bits the value is rotated by, has to be between 1 and 63
+/// @return Rotated value
+static inline uint64_t rotate_right(uint64_t value, uint8_t bits) {
+    return (value >> bits) | (value << (64U - bits));
+}
+
+/// @brief Reads the given amount of bytes as a big endian number
+/// @tparam T Unsigned integer type that should be read
+/// @param bytes Bytes containing atleast sizeof(T) bytes
+/// @return Read number
+template<typename T>
+static inline T read_big_endian(uint8_t const * bytes) {
+    T value = 0U;
+    for (size_t i = 0U; i < sizeof(T); i++) {
+        value = (value << 8U) | bytes[i];
+    }
+    return value;
+}
+
+/// @brief Writes the given number as big endian bytes
+/// @tparam T Unsigned integer type that should be written
+/// @param value Number that should be written
+/// @param bytes Output buffer containing atleast sizeof(T) bytes
+template<typename T>
+static inline void write_big_endian(T value, uint8_t * bytes) {
+    for (size_t i = sizeof(T); i > 0U; i--) {
+        bytes[i - 1U] = static_cast<uint8_t>(value);
+        value >>= 8U;
+    }
+}
+
+/// @brief Updates the given MD5 state with the given block of 64 bytes
+/// @param state Intermediate hash value
+/// @param block Block that should be processed
+static void md5_process_block(uint32_t * state, uint8_t const * block) {
+    uint32_t words[16] = {};
+    for (size_t i = 0U; i < 16U; i++) {
+        words[i] = static_cast<uint32_t>(block[i * 4U]) | (static_cast<uint32_t>(block[i * 4U + 1U]) << 8U) | (static_cast<uint32_t>(block[i * 4U + 2U]) << 16U) | (static_cast<uint32_t>(block[i * 4U + 3U]) << 24U);
+    }
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    for (size_t i = 0U; i < 64U; i++) {
+        uint32_t f = 0U;
+        size_t g = 0U;
+        if (i < 16U) {
+            f = (b & c) | (~b & d);
+            g = i;
+        }
+        else if (i < 32U) {
+            f = (d & b) | (~d & c);
+            g = (5U * i + 1U) % 16U;
+        }
+        else if (i < 48U) {
+            f = b ^ c ^ d;
+            g = (3U * i + 5U) % 16U;
+        }
+        else {
+            f = c ^ (b | ~d);
+            g = (7U * i) % 16U;
+        }
+        f = f + a + MD5_CONSTANTS[i] + words[g];
+        a = d;
+        d = c;
+        c = b;
+        b = b + rotate_left(f, MD5_SHIFTS[i]);
+    }
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+}
+
+/// @brief Updates the given SHA-256 state with the given block of 64 bytes
+/// @param state Intermediate hash value
+/// @param block Block that should be processed
+static void sha256_process_block(uint32_t * state, uint8_t const * block) {
+    uint32_t schedule[64] = {};
+    for (size_t i = 0U; i < 16U; i++) {
+        schedule[i] = read_big_endian<uint32_t>(block + i * 4U);
+    }
+    for (size_t i = 16U; i < 64U; i++) {
+        uint32_t const s0 = rotate_right(schedule[i - 15U], 7U) ^ rotate_right(schedule[i - 15U], 18U) ^ (schedule[i - 15U] >> 3U);
+        uint32_t const s1 = rotate_right(schedule[i - 2U], 17U) ^ rotate_right(schedule[i - 2U], 19U) ^ (schedule[i - 2U] >> 10U);
+        schedule[i] = schedule[i - 16U] + s0 + schedule[i - 7U] + s1;
+    }
+    uint32_t working[8] = {};
+    (void)memcpy(working, state, sizeof(working));
+    for (size_t i = 0U; i < 64U; i++) {
+        uint32_t const s1 = rotate_right(working[4], 6U) ^ rotate_right(working[4], 11U) ^ rotate_right(working[4], 25U);
+        uint32_t const choose = (working[4] & working[5]) ^ (~working[4] & working[6]);
+        uint32_t const temp1 = working[7] + s1 + choose + SHA256_CONSTANTS[i] + schedule[i];
+        uint32_t const s0 = rotate_right(working[0], 2U) ^ rotate_right(working[0], 13U) ^ rotate_right(working[0], 22U);
+        uint32_t const majority = (working[0] & working[1]) ^ (working[0] & working[2]) ^ (working[1] & working[2]);
+        (void)memmove(working + 1, working, sizeof(working) - sizeof(working[0]));
+        working[4] += temp1;
+        working[0] = temp1 + s0 + majority;
+    }
+    for (size_t i = 0U; i < 8U; i++) {
+        state[i] += working[i];
+    }
+}
+
+/// @brief Updates the given SHA-384 or SHA-512 state with the given block of 128 bytes, both use the same compression function and only differ in the initial hash value and output size
+/// @param state Intermediate hash value
+/// @param block Block that should be processed
+static void sha512_process_block(uint64_t * state, uint8_t const * block) {
+    uint64_t schedule[80] = {};
+    for (size_t i = 0U; i < 16U; i++) {
+        schedule[i] = read_big_endian<uint64_t>(block + i * 8U);
+    }
+    for (size_t i = 16U; i < 80U; i++) {
+        uint64_t const s0 = rotate_right(schedule[i - 15U], 1U) ^ rotate_right(schedule[i - 15U], 8U) ^ (schedule[i - 15U] >> 7U);
+        uint64_t const s1 = rotate_right(schedule[i - 2U], 19U) ^ rotate_right(schedule[i - 2U], 61U) ^ (schedule[i - 2U] >> 6U);
+        schedule[i] = schedule[i - 16U] + s0 + schedule[i - 7U] + s1;
+    }
+    uint64_t working[8] = {};
+    (void)memcpy(working, state, sizeof(working));
+    for (size_t i = 0U; i < 80U; i++) {
+        uint64_t const s1 = rotate_right(working[4], 14U) ^ rotate_right(working[4], 18U) ^ rotate_right(working[4], 41U);
+        uint64_t const choose = (working[4] & working[5]) ^ (~working[4] & working[6]);
+        uint64_t const temp1 = working[7] + s1 + choose + SHA512_CONSTANTS[i] + schedule[i];
+        uint64_t const s0 = rotate_right(working[0], 28U) ^ rotate_right(working[0], 34U) ^ rotate_right(working[0], 39U);
+        uint64_t const majority = (working[0] & working[1]) ^ (working[0] & working[2]) ^ (working[1] & working[2]);
+        (void)memmove(working + 1, working, sizeof(working) - sizeof(working[0]));
+        working[4] += temp1;
+        working[0] = temp1 + s0 + majority;
+    }
+    for (size_t i = 0U; i < 8U; i++) {
+        state[i] += working[i];
+    }
+}
 
 HashGenerator::~HashGenerator(void) {
     free();
 }
 
+bool HashGenerator::start(mbedtls_md_type_t const & type) {
+    free();
+    m_size = mbedtls_type_to_size(type);
+    m_type = type;
+    switch (type) {
+        case mbedtls_md_type_t::MBEDTLS_MD_MD5:
+            (void)memcpy(m_state.words, MD5_INITIAL_STATE, sizeof(MD5_INITIAL_STATE));
+            break;
+        case mbedtls_md_type_t::MBEDTLS_MD_SHA256:
+            (void)memcpy(m_state.words, SHA256_INITIAL_STATE, sizeof(SHA256_INITIAL_STATE));
+            break;
+        case mbedtls_md_type_t::MBEDTLS_MD_SHA384:
+            (void)memcpy(m_state.long_words, SHA384_INITIAL_STATE, sizeof(SHA384_INITIAL_STATE));
+            break;
+        case mbedtls_md_type_t::MBEDTLS_MD_SHA512:
+            (void)memcpy(m_state.long_words, SHA512_INITIAL_STATE, sizeof(SHA512_INITIAL_STATE));
+            break;
+        case mbedtls_md_type_t::MBEDTLS_MD_NONE: // Fallthrough same behaviour
+        default:
+            return false;
+    }
+    return true;
+}
+
+bool HashGenerator::update(uint8_t const * data, size_t const & length) {
+    if (m_size == 0U) {
+        return false;
+    }
+    m_length += length;
+    size_t const block_size = get_block_size();
+    size_t remaining = length;
+    // Complete the partially filled block first, afterwards complete blocks are processed directly from the given data without copying them
+    if (m_block_length != 0U) {
+        size_t const copied = (remaining < block_size - m_block_length) ? remaining : block_size - m_block_length;
+        (void)memcpy(m_block + m_block_length, data, copied);
+        m_block_length += copied;
+        data += copied;
+        remaining -= copied;
+        if (m_block_length < block_size) {
+            return true;
+        }
+        process_block(m_block);
+        m_block_length = 0U;
+    }
+    for (; remaining >= block_size; data += block_size, remaining -= block_size) {
+        process_block(data);
+    }
+    (void)memcpy(m_block, data, remaining);
+    m_block_length = remaining;
+    return true;
+}
+
+bool HashGenerator::finish(uint8_t * hash) {
+    if (m_size == 0U) {
+        return false;
+    }
+    size_t const block_size = get_block_size();
+    // SHA-384 and SHA-512 append the length as a 128-bit number, the other hash types as a 64-bit number
+    size_t const length_size = (block_size == 128U) ? 16U : 8U;
+    uint64_t const length_bits = m_length * 8U;
+
+    // Padding consists of a single set bit followed by zeros, until the length fits into the end of the last block
+    m_block[m_block_length++] = 0x80U;
+    if (m_block_length > block_size - length_size) {
+        (void)memset(m_block + m_block_length, 0, block_size - m_block_length);
+        process_block(m_block);
+        m_block_length = 0U;
+    }
+    (void)memset(m_block + m_block_length, 0, block_size - m_block_length);
+
+    uint8_t * const length_position = m_block + block_size - 8U;
+    if (m_type == mbedtls_md_type_t::MBEDTLS_MD_MD5) {
+        for (size_t i = 0U; i < 8U; i++) {
+            length_position[i] = static_cast<uint8_t>(length_bits >> (i * 8U));
+        }
+    }
+    else {
+        if (length_size == 16U) {
+            // Upper half of the 128-bit length only contains the bits shifted out of the 64-bit length in bits, which are only set for more than 2^61 bytes
+            write_big_endian<uint64_t>(m_length >> 61U, length_position - 8U);
+        }
+        write_big_endian<uint64_t>(length_bits, length_position);
+    }
+    process_block(m_block);
+
+    if (m_type == mbedtls_md_type_t::MBEDTLS_MD_MD5) {
+        for (size_t i = 0U; i < m_size; i++) {
+            hash[i] = static_cast<uint8_t>(m_state.words[i / 4U] >> ((i % 4U) * 8U));
+        }
+    }
+    else if (m_type == mbedtls_md_type_t::MBEDTLS_MD_SHA256) {
+        for (size_t i = 0U; i < m_size / 4U; i++) {
+            write_big_endian<uint32_t>(m_state.words[i], hash + i * 4U);
+        }
+    }
+    else {
+        for (size_t i = 0U; i < m_size / 8U; i++) {
+            write_big_endian<uint64_t>(m_state.long_words[i], hash + i * 8U);
+        }
+    }
+    free();
+    return true;
+}
+
+size_t const & HashGenerator::get_size() const {
+    return m_size;
+}
+
+void HashGenerator::free() {
+    // Does not reset the size, because it is still needed after finish() to compare the calculated hash
+    m_state = Hash_State();
+    (void)memset(m_block, 0, sizeof(m_block));
+    m_block_length = 0U;
+    m_length = 0U;
+}
+
+void HashGenerator::process_block(uint8_t const * block) {
+    if (m_type == mbedtls_md_type_t::MBEDTLS_MD_MD5) {
+        md5_process_block(m_state.words, block);
+    }
+    else if (m_type == mbedtls_md_type_t::MBEDTLS_MD_SHA256) {
+        sha256_process_block(m_state.words, block);
+    }
+    else {
+        sha512_process_block(m_state.long_words, block);
+    }
+}
+
+size_t HashGenerator::get_block_size() const {
+    return (m_type == mbedtls_md_type_t::MBEDTLS_MD_SHA384 || m_type == mbedtls_md_type_t::MBEDTLS_MD_SHA512) ? 128U : 64U;
+}
+
+size_t HashGenerator::mbedtls_type_to_size(mbedtls_md_type_t const & type) {
+    switch (type) {
+        case mbedtls_md_type_t::MBEDTLS_MD_MD5:
+            return 16U;
+        case mbedtls_md_type_t::MBEDTLS_MD_SHA256:
+            return 32U;
+        case mbedtls_md_type_t::MBEDTLS_MD_SHA384:
+            return 48U;
+        case mbedtls_md_type_t::MBEDTLS_MD_SHA512:
+            return 64U;
+        case mbedtls_md_type_t::MBEDTLS_MD_NONE: // Fallthrough same behaviour
+        default:
+            return 0U;
+    }
+}
+
+#else
+HashGenerator::~HashGenerator(void) {
+    free();
+}
+
 bool HashGenerator::start(mbedtls_md_type_t const & type) {
     // Clear the internal structure of any previous attempt, because if we do not the init function will not work correctly
     free();
@@ -25,17 +401,12 @@ bool HashGenerator::update(uint8_t const * data, size_t const & length) {
     return mbedtls_md_update(&m_ctx, data, length) == 0;
 }
 
-bool HashGenerator::finish(char * hash_string) {
-    unsigned char byte_hash[m_size] = {};
-    bool const success = mbedtls_md_finish(&m_ctx, byte_hash) == 0;
-    if (!success) {
-        return success;
-    }
-    for (size_t i = 0; i < m_size; ++i) {
-        sprintf(hash_string + (i * 2), "%02x", byte_hash[i]);
-    }
-    hash_string[m_size * 2] = '\0';
-    return success;
+bool HashGenerator::finish(uint8_t * hash) {
+    return mbedtls_md_finish(&m_ctx, hash) == 0;
+}
+
+size_t const & HashGenerator::get_size() const {
+    return m_size;
 }
 
 void HashGenerator::free() {
@@ -84,3 +455,5 @@ size_t HashGenerator::mbedtls_type_to_size(mbedtls_md_type_t const & type) {
             return 0U;
     }
 }
+
+#endif // THINGSBOARD_USE_BUILTIN_HASH
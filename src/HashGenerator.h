@@ -7,21 +7,37 @@
 // Library includes.
 #if THINGSBOARD_USE_MBED_TLS
 #include <mbedtls/md.h>
-#else
+#elif !THINGSBOARD_USE_BUILTIN_HASH
 #include <Seeed_mbedtls.h>
 #endif // THINGSBOARD_USE_MBED_TLS
 #include <stdint.h>
 #include <stddef.h>
 
 
+#if THINGSBOARD_USE_BUILTIN_HASH
+// Amount of bytes of the biggest raw hash the built-in implementation can calculate, named the same as the Mbed TLS definition so buffers can be declared independent of the used implementation
+#define MBEDTLS_MD_MAX_SIZE 64
+
+/// @brief Types of hashes supported by the built-in implementation, named the same as the Mbed TLS enum so the rest of the library does not depend on the used implementation
+enum mbedtls_md_type_t : uint8_t {
+    MBEDTLS_MD_NONE,   // No hash type, not supported
+    MBEDTLS_MD_MD5,    // MD5 hash with 16 bytes
+    MBEDTLS_MD_SHA256, // SHA-256 hash with 32 bytes
+    MBEDTLS_MD_SHA384, // SHA-384 hash with 48 bytes
+    MBEDTLS_MD_SHA512  // SHA-512 hash with 64 bytes
+};
+#endif // THINGSBOARD_USE_BUILTIN_HASH
+
+
 /// @brief Wrapper class which allows generating a hash of the given type from any arbitrary byte payload, which is hashable in chunks.
 /// The class wraps around either the Arduino Seeed mbedtls library from Seed Studio (https://github.com/Seeed-Studio/Seeed_Arduino_mbedtls) or the offical ESP Mbed TLS implementation from Mbed TLS (https://github.com/Mbed-TLS/mbedtls), the latter takes precendence if it exists.
 /// This is done because it removes the need to include another library, because the component already exists on the system and we can therefore simply utilize that one.
 /// The ESP Mbed TLS implementationt works with both Espressif IDF v4.X and v5.X, meaning it is version idependent, this is the case
 /// because depending on the used version the implementation automatically adjusts to still initalize correctly.
 /// The class instance is meant to be started with start() which will then create the configuration for a hash of the given type
-/// and we then expect the complete binary payload to be called in multiple calls to update() and the final result to be read with get_hash_string()
+/// and we then expect the complete binary payload to be called in multiple calls to update() and the final raw result to be read with finish()
 /// Documentation about the specific use and caviates of the ESP Mbedt TLS implementation can be found here https://docs.espressif.com/projects/esp-idf/en/latest/esp32/api-reference/protocols/mbedtls.html
+/// If neither of the libraries exist, for example when running on a host operating system like Linux, the hashes are instead calculated by an implementation contained in the library itself
 class HashGenerator {
   public:
     /// @brief Constructor
@@ -41,29 +57,53 @@ class HashGenerator {
     /// @return Whether updating the hash for the given bytes was successful or not
     bool update(uint8_t const * data, size_t const & length);
 
-    /// @brief Calculates the final hash string representation and stops the hash calculation no further calls to update() will work,
+    /// @brief Calculates the final raw hash and stops the hash calculation no further calls to update() will work,
     /// instead the same context can be reused to start another hash calculation operation with start()
-    /// @param hash_string Output string that the hash string representation will be copied into, needs to be big enough to hold the string representation of the mbedtls_md_type_t
-    /// meaning we require 2 bytes for every single byte of hash data, therefore the biggest hash string representation has a size of 128 bytes.
-    /// For the actual hash being SHA256, requiring 256 bits = 64 bytes * 2 for the string representation resulting in 128 bytes + 1 byte for the null termination character.
-    /// Recommended size of the array to pass is simply (MBEDTLS_MD_MAX_SIZE * 2) + 1, which will result in 129 bytes, but additionally automatically update as well if the underlying max size changes
+    /// @param hash Output buffer that the raw hash bytes will be copied into, needs to be big enough to hold the amount of bytes returned by get_size().
+    /// Recommended size of the array to pass is simply MBEDTLS_MD_MAX_SIZE, which is big enough for every hash type and additionally automatically updates as well if the underlying max size changes
     /// @return Whether stopping and caculating the final hash for the given bytes was successful or not
-    bool finish(char * hash_string);
+    bool finish(uint8_t * hash);
+
+    /// @brief Gets the amount of bytes of the raw hash calculated by finish(), depends on the mbedtls_md_type_t given in the start method
+    /// @return Amount of bytes in the raw hash
+    size_t const & get_size() const;
+
+    /// @brief Calculates the amount of bytes needed for the raw hash output of the given type.
+    /// Allows to validate the size of an expected hash, before the hash calculation has been started
+    /// @param type Supported type of hash that should be generated from this class
+    /// @return Amount of bytes needed to be allocated by the buffer that will hold the final hash or 0 if the type is not supported
+    static size_t mbedtls_type_to_size(mbedtls_md_type_t const & type);
 
   private:
     /// @brief Frees all internally allocated memory to ensure no memory leak occurs, additionally check if a hash calculation was ever started,
     /// before freeing, because freeing without having started a hash calculation causes a crash.
     void free();
 
-    /// @brief Calculates the amount of bytes needed for the hash output.
-    /// Is used because we if we don't calculate the exact amount needed the final hash string representation, will always be filled up with hex 00 to the maximum size of the hash string representation being 129 bytes.
-    /// Which results in hash string representation with a lot of additional 00 at the end, which might make the further processing of those strings fail
-    /// @param type Supported type of hash that should be generated from this class
-    /// @return Amount of bytes needed to be allocated by the buffer that will hold the final hash that is then transformed into a string
-    size_t mbedtls_type_to_size(mbedtls_md_type_t const & type);
+#if THINGSBOARD_USE_BUILTIN_HASH
+    /// @brief Updates the internal state with the given complete block, with the compression function of the hash type given in the start method
+    /// @param block Block with exactly get_block_size() bytes
+    void process_block(uint8_t const * block);
 
+    /// @brief Gets the amount of bytes the compression function of the hash type given in the start method processes at once
+    /// @return Amount of bytes in one block
+    size_t get_block_size() const;
+
+    /// @brief Intermediate hash value, MD5 and SHA-256 use 32-bit words, whereas SHA-384 and SHA-512 use 64-bit words
+    union Hash_State {
+        uint32_t words[8];
+        uint64_t long_words[8];
+    };
+
+    size_t               m_size = {};         // Actual size in bytes, depend on the mbedtls_md_type_t given in the start method
+    mbedtls_md_type_t    m_type = {};         // Type of hash that is currently calculated
+    Hash_State           m_state = {};        // Intermediate hash value of all completely processed blocks
+    uint8_t              m_block[128] = {};   // Bytes of the not yet complete block, big enough for the biggest block size of all supported hash types
+    size_t               m_block_length = {}; // Amount of bytes currently contained in m_block
+    uint64_t             m_length = {};       // Amount of bytes added with update() since the hash calculation was started
+#else
     size_t               m_size = {}; // Actual size in bytes, depend on the mbedtls_md_type_t given in the start method
     mbedtls_md_context_t m_ctx = {};  // Context used to access the already written bytes and update them latter
+#endif // THINGSBOARD_USE_BUILTIN_HASH
 };
 
 #endif // Hash_Generator_h
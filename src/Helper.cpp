@@ -30,3 +30,52 @@ size_t Helper::parseRequestId(char const * base_topic, char const * received_top
     // Meaning the index we attempt to parse at, is simply the length of the base topic
     return atoi(received_topic + strlen(base_topic));
 }
+
+size_t Helper::writeNumber(char * buffer, size_t number) {
+    // Count the amount of digits first, this allows to write the digits from the back to the front,
+    // without having to reverse the written string afterwards or using an additional temporary buffer
+    size_t digits = 1U;
+    for (size_t remaining = number / 10U; remaining != 0U; remaining /= 10U) {
+        digits++;
+    }
+    for (size_t i = digits; i > 0U; i--) {
+        buffer[i - 1U] = static_cast<char>('0' + (number % 10U));
+        number /= 10U;
+    }
+    return digits;
+}
+
+bool Helper::parseHexString(char const * hex_string, uint8_t * bytes, size_t const & bytes_size) {
+    if (hex_string == nullptr || bytes == nullptr) {
+        return false;
+    }
+    for (size_t i = 0; i < bytes_size * 2U; ++i) {
+        char const character = hex_string[i];
+        uint8_t nibble = 0U;
+        if (character >= '0' && character <= '9') {
+            nibble = character - '0';
+        }
+        else if (character >= 'a' && character <= 'f') {
+            nibble = character - 'a' + 10U;
+        }
+        else if (character >= 'A' && character <= 'F') {
+            nibble = character - 'A' + 10U;
+        }
+        else {
+            // Invalid character or the null termination, because the string was shorter than expected
+            return false;
+        }
+        bytes[i / 2U] = (i % 2U == 0U) ? (nibble << 4U) : (bytes[i / 2U] | nibble);
+    }
+    // Ensure the string is not longer than expected either
+    return hex_string[bytes_size * 2U] == '\0';
+}
+
+bool Helper::constantTimeEquals(uint8_t const * first, uint8_t const * second, size_t const & length) {
+    // Accumulate all differences instead of returning early at the first one, volatile ensures the compiler does not optimize the loop into an early return
+    uint8_t volatile difference = 0U;
+    for (size_t i = 0; i < length; ++i) {
+        difference |= first[i] ^ second[i];
+    }
+    return difference == 0U;
+}
@@ -14,15 +14,98 @@
 #include <stdio.h>
 
 
+// Maximum amount of characters the decimal representation of a size_t can have, which is 20 for 64-bit integers,
+// used to size buffers that Helper::writeNumber writes into, without having to know the actual value beforehand
+size_t constexpr MAX_NUMBER_CHARACTERS = 20U;
+
+
+// Maximum amount of characters a string argument passed as a pointer can use, when it is inserted into a format string with the %s specifier,
+// longer strings are truncated by snprintf, because the actual length of the string is not known at compile time
+size_t constexpr MAX_FORMAT_STRING_CHARACTERS = 64U;
+
+
+/// @brief Maximum amount of characters the given argument type can need, once it is inserted into a format string with the matching format specifier.
+/// Calculated only from the type, so the result can be used at compile time to size the buffer the formatted string is written into
+/// @tparam T Type of the argument that should be inserted into the format string
+template<typename T>
+struct Formatted_Size {
+    // Integral types need atmost 2.5 characters per byte to represent their maximum value, with an additional character for the sign.
+    // Calculated from the size of the type, because it is the same for signed and unsigned types and the octal representation never needs more characters either
+    static constexpr size_t value = ((sizeof(T) * 5U) / 2U) + 2U;
+};
+
+template<typename T>
+struct Formatted_Size<T const> : public Formatted_Size<T> {};
+
+template<typename T>
+struct Formatted_Size<T &> : public Formatted_Size<T> {};
+
+template<>
+struct Formatted_Size<float> {
+    // Maximum value printed with %f is 39 digits, followed by the decimal point, 6 decimal places and the sign
+    static constexpr size_t value = 47U;
+};
+
+template<>
+struct Formatted_Size<double> {
+    // Maximum value printed with %f is 309 digits, followed by the decimal point, 6 decimal places and the sign
+    static constexpr size_t value = 317U;
+};
+
+template<>
+struct Formatted_Size<char *> {
+    static constexpr size_t value = MAX_FORMAT_STRING_CHARACTERS;
+};
+
+template<>
+struct Formatted_Size<char const *> {
+    static constexpr size_t value = MAX_FORMAT_STRING_CHARACTERS;
+};
+
+template<size_t N>
+struct Formatted_Size<char[N]> {
+    // Size of character arrays is known at compile time, therefore the string can be inserted completly without having to truncate it
+    static constexpr size_t value = N - 1U;
+};
+
+/// @brief Sum of the maximum amount of characters all the given argument types can need, once they are inserted into a format string
+/// @tparam ...Args Types of the arguments that should be inserted into the format string
+template<typename... Args>
+struct Formatted_Arguments_Size {
+    static constexpr size_t value = 0U;
+};
+
+template<typename T, typename... Args>
+struct Formatted_Arguments_Size<T, Args...> {
+    static constexpr size_t value = Formatted_Size<T>::value + Formatted_Arguments_Size<Args...>::value;
+};
+
+
 /// @brief Static helper class that includes some uniliterally used functionalities in multiple places, especially the ThingsBoardHttp and ThingsBoard implementations
 class Helper {
   public:
+    /// @brief Returns the maximum amount of bytes needed to store the formatted string that will be created if a format string of the given size and arguments of the given types are passed to snprintf.
+    /// Calculated at compile time from the size of the format string and the maximum amount of characters each argument type can need (see Formatted_Size),
+    /// which allows to use the result as the size of a fixed size array instead of a variable length array and to format the string in a single pass.
+    /// Because the specifiers themselves are counted as part of the format string the result is an upper bound and not the exact size, strings passed as pointers are bounded by MAX_FORMAT_STRING_CHARACTERS,
+    /// meaning snprintf will truncate them, if they are longer, instead of the buffer on the stack growing with a length that might be controlled by the server
+    /// @tparam ...Args Types of the arguments that will be inserted into the format string, in the same order they are passed to snprintf
+    /// @param format_size Size of the format string including the null termination, should be calculated with sizeof() on the constant format string
+    /// @return Maximum amount of bytes in characters, needed for the formatted string with the given arguments inserted, including the null termination
+    template<typename... Args>
+    static constexpr size_t calculateFormatSize(size_t const & format_size) {
+        return format_size + Formatted_Arguments_Size<Args...>::value;
+    }
+
     /// @brief Returns the total amount of bytes needed to store the formatted string that will be created if the given format string and the arguments are passed to snprintf.
+    /// Deprecated, because the result is only known at runtime, meaning it can only be used to size a variable length array, whose size might be controlled by the server if string arguments are received from it.
+    /// Use calculateFormatSize instead, which calculates an upper bound at compile time and can therefore be used to size a fixed size array
     /// @tparam ...Args Holds the multiple arguments that will simply be forwarded to the snprintf method, allowing any arbitrary amount of combinations without having to rely on va_list
     /// @param format Formatting message that the given arguments will be inserted into
     /// @param ...args Arguments that will be forwarded into the snprintf method see https://cplusplus.com/reference/cstdio/snprintf/ for more information
     /// @return Amount of bytes in characters, needed for the formatted string with the given arguments inserted, to be displayed completly
     template<typename... Args>
+    [[deprecated("Use Helper::calculateFormatSize instead, to size a fixed size array at compile time")]]
     static int detectSize(char const * format, Args const &... args) {
         // Result is what would have been written if the passed buffer would have been large enough not counting null character,
         // or if an error occured while creating the string a negative number is returned instead. To ensure this will not crash the system
@@ -54,6 +137,30 @@ class Helper {
     /// @return Converted integral request id if possible or 0 if parsing as an integer failed
     static size_t parseRequestId(char const * base_topic, char const * received_topic);
 
+    /// @brief Writes the decimal representation of the given number into the given buffer, without any null termination.
+    /// Used instead of snprintf with the %u format specifier, when a number simply has to be appended to an already existing string,
+    /// because it only needs a single pass, does not have to parse a format string and writes the digits directly into an already existing buffer
+    /// @param buffer Output buffer the digits will be written into, needs to be big enough to hold atleast MAX_NUMBER_CHARACTERS characters
+    /// @param number Number we want to write the decimal representation of
+    /// @return Amount of characters that were written into the buffer
+    static size_t writeNumber(char * buffer, size_t number);
+
+    /// @brief Parses the given hex string representation into its raw bytes, two hex characters are parsed into one byte.
+    /// Fails if the string does not contain exactly the amount of hex characters needed to fill the given amount of bytes, meaning empty or truncated strings are rejected
+    /// @param hex_string Hex string representation that should be parsed, can contain upper and lower case characters
+    /// @param bytes Output buffer the parsed bytes will be copied into, needs to be big enough to hold the given amount of bytes
+    /// @param bytes_size Exact amount of bytes the given hex string has to contain
+    /// @return Whether the given hex string could be parsed into exactly the given amount of bytes or not
+    static bool parseHexString(char const * hex_string, uint8_t * bytes, size_t const & bytes_size);
+
+    /// @brief Compares the given amount of bytes of both buffers in constant time, meaning the time needed does not depend on the position of the first difference.
+    /// Ensures the comparison of secret or security relevant values can not be used to gain information about the expected value from the time the comparison took
+    /// @param first First buffer that should be compared, needs to contain atleast the given amount of bytes
+    /// @param second Second buffer that should be compared, needs to contain atleast the given amount of bytes
+    /// @param length Amount of bytes that should be compared
+    /// @return Whether the given amount of bytes in both buffers are the same or not
+    static bool constantTimeEquals(uint8_t const * first, uint8_t const * second, size_t const & length);
+
     /// @brief Calculates the total size of the string the serializeJson method would produce including the null end terminator.
     /// Be aware that null terminator will later not be serialied in the serializeJson() call,
     /// meaning the returned written amount of bytes is the return value of this method - 1.
@@ -80,6 +187,23 @@ class Helper {
         container.erase(iterator);
     }
 
+    /// @brief Removes the element with the given index by moving the last element into its place, which only requires a single move but does not keep the order of the remaining elements.
+    /// Should be used instead of remove() if the order of the elements is not relevant, for example for callbacks that are searched by their request id
+    /// @tparam DataContainer Class which allows to pass any arbitrary data container that contains the back() and pop_back() method
+    /// @tparam InputIterator Class that points to the iterator position that should be erased
+    /// in the given data container, allows for using / passing either std::vector or std::array.
+    /// See https://en.cppreference.com/w/cpp/iterator/input_iterator for more information on the requirements of the iterator
+    /// @param container Data container holding the elements we want to remove an element from
+    /// @param iterator Iterator position we want to remove the element at
+    template<typename DataContainer, typename InputIterator>
+    static void remove_unordered(DataContainer & container, InputIterator const & iterator) {
+        auto & last = container.back();
+        if (&*iterator != &last) {
+            *iterator = static_cast<typename DataContainer::value_type &&>(last);
+        }
+        container.pop_back();
+    }
+
     /// @brief Calculates the distance between two iterators
     /// @tparam InputIterator Class that points to the begin and end iterator
     /// of the given data container, allows for using / passing either std::vector or std::array.
@@ -6,6 +6,7 @@
 #include "Constants.h"
 #include "DefaultLogger.h"
 #include "API_Process_Type.h"
+#include "Metrics.h"
 
 // Library include.
 #if THINGSBOARD_ENABLE_STL
@@ -55,6 +56,18 @@ class IAPI_Implementation {
     /// @param data Payload sent by the server over our given topic, that contains our key value pairs
     virtual void Process_Json_Response(char const * topic, JsonDocument const & data) = 0;
 
+    /// @brief Process callback that will be called upon arrival of a fragment of a response, that is bigger than the receive buffer of the client and is therefore received in multiple fragments.
+    /// Only called for API implementations that process the response as raw bytes, because json can not be deserialized from only a fragment of the complete payload,
+    /// therefore fragments are ignored by default and only implementations that process raw bytes have to override this method
+    /// @param topic Previously subscribed topic, we got the response over
+    /// @param payload Fragment of the payload that was sent over the cloud and received over the given topic
+    /// @param length Length of the received fragment
+    /// @param offset Offset of the received fragment in the complete payload
+    /// @param total_length Total length of the complete payload
+    virtual void Process_Response_Fragment(char const * topic, uint8_t * payload, unsigned int length, unsigned int offset, unsigned int total_length) {
+        // Nothing to do
+    }
+
     /// @brief Compares received response topic and the topic this api implementation handles responses on,
     /// messages from all other topics are ignored and only messages from topics that match are handled.
     /// For the comparsion we either compare the full expected string with the null termination, if the response topic does not include additional parameters.
@@ -69,7 +82,9 @@ class IAPI_Implementation {
     virtual bool Unsubscribe() = 0;
 
     /// @brief Forwards the call to let the API clear up any ongoing single-event subscriptions (Provision, Attribute Request, RPC Request)
-    /// and simply resubscribes the topic for all permanent subscriptions (RPC, Shared Attribute Update)
+    /// and simply resubscribes the topic for all permanent subscriptions (RPC, Shared Attribute Update).
+    /// Topics subscribed with the subscribe topic callback while this method is called are collected and sent in a single SUBSCRIBE packet once all API implementations have been resubscribed,
+    /// therefore the passed topic has to stay valid after this method returns, which is the case for the constant topic strings used by all API implementations
     /// @return Whether resubscribing was successfull or not
     virtual bool Resubscribe_Topic() = 0;
 
@@ -86,14 +101,31 @@ class IAPI_Implementation {
     /// in this method instead, because it ensures all member methods are instantiated already
     virtual void Initialize() = 0;
 
+#if THINGSBOARD_ENABLE_METRICS
+    /// @brief Passes the metrics of the ThingsBoard client the API implementation has been subscribed to, so that it can record metrics about its own internal processes as well.
+    /// Optional, because the ThingsBoard client already records the time each API implementation needs to process received messages, therefore the default implementation ignores the metrics
+    /// @param metrics Metrics that are published by the ThingsBoard client, stay valid for the lifetime of the client
+    virtual void Set_Metrics(Metrics & metrics) {
+        // Nothing to do
+    }
+#endif // THINGSBOARD_ENABLE_METRICS
+
+    /// @brief Sets the method which allows to get whether the client receives messages bigger than its receive buffer in fragments, points to m_client.supports_fragmented_receive per default.
+    /// Optional, because only API implementations that receive big messages need to know about it, therefore the default implementation ignores the callback
+    /// @param get_fragmented_receive_callback Method which allows to get whether the client receives messages bigger than its receive buffer in fragments
+    virtual void Set_Fragmented_Receive_Callback(Callback<bool>::function get_fragmented_receive_callback) {
+        // Nothing to do
+    }
+
     /// @brief Sets the underlying callbacks that are required for the different API Implementation to communicate with the cloud.
     /// Directly set by the used ThingsBoard client to its internal methods, therefore calling again and overriding
     /// as a user ist not recommended, unless you know what you are doing
     /// @param subscribe_api_callback Method which allows to subscribe additional API endpoints, points to Subscribe_API_Implementation per default
     /// @param send_json_callback Method which allows to send arbitrary JSON payload, points to Send_Json per default
     /// @param send_json_string_callback Method which allows to send arbitrary JSON string payload, points to Send_Json_String per default
-    /// @param subscribe_topic_callback Method which allows to subscribe to arbitrary topics, points to m_client.subscribe per default
-    /// @param unsubscribe_topic_callback Method which allows to unsubscribe from arbitrary topics, points to m_client.unsubscribe per default
+    /// @param subscribe_topic_callback Method which allows to subscribe to arbitrary topics, points to m_client.subscribe per default.
+    /// Topics are reference counted, because multiple API implementations can share the same topic, therefore each call has to be matched by exactly one call to unsubscribe_topic_callback
+    /// @param unsubscribe_topic_callback Method which allows to unsubscribe from arbitrary topics, points to m_client.unsubscribe per default, only actually unsubscribes once the last reference has been removed
     /// @param get_receive_size_callback Method which allows to get the current underlying receive size of the buffer, points to m_client.get_receive_buffer_size per default
     /// @param get_send_size_callback Method which allows to get the current underlying send size of the buffer, points to m_client.get_send_buffer_size per default
     /// @param set_buffer_size_callback Method which allows to set the current underlying size of the buffer, points to m_client.set_buffer_size per default
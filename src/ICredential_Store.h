@@ -0,0 +1,44 @@
+#ifndef ICredential_Store_h
+#define ICredential_Store_h
+
+// Local include.
+#include "Configuration.h"
+
+// Library include.
+#include <stddef.h>
+
+
+// Maximum size of each cached credential including the null termination, access tokens generated by ThingsBoard have 20 characters
+size_t constexpr MAX_CREDENTIAL_SIZE = 128U;
+
+
+/// @brief Credentials the device connects to ThingsBoard with, received as the response to a successful provisioning request.
+/// Access tokens are stored as the username, the same way they are passed to the MQTT broker when connecting
+struct Device_Credentials {
+    char client_id[MAX_CREDENTIAL_SIZE] = {}; // MQTT client id, empty if the username should be used as the client id instead
+    char username[MAX_CREDENTIAL_SIZE] = {};  // Access token or username of the basic MQTT credentials
+    char password[MAX_CREDENTIAL_SIZE] = {};  // Password of the basic MQTT credentials, empty if no password is required
+};
+
+
+/// @brief Credential store interface that contains the methods that a class that can be used to persist the credentials received from a successful provisioning request has to implement.
+/// Allows the device to connect directly with the cached credentials on the next startup, instead of sending a provisioning request on every startup,
+/// the storage itself depends on the device, for example a file on a host operating system or the non-volatile storage of an ESP32
+class ICredential_Store {
+  public:
+    /// @brief Reads the previously stored credentials
+    /// @param credentials Credentials the stored values are copied into
+    /// @return Whether credentials were stored and could be read successfully or not
+    virtual bool load(Device_Credentials & credentials) = 0;
+
+    /// @brief Persists the given credentials, replacing any previously stored credentials
+    /// @param credentials Credentials that should be stored
+    /// @return Whether the credentials were stored successfully or not
+    virtual bool store(Device_Credentials const & credentials) = 0;
+
+    /// @brief Removes the stored credentials, called if the server rejected them so that the device is provisioned again
+    /// @return Whether the credentials were removed successfully or no credentials were stored
+    virtual bool clear() = 0;
+};
+
+#endif // ICredential_Store_h
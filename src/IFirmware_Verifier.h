@@ -0,0 +1,45 @@
+#ifndef IFirmware_Verifier_h
+#define IFirmware_Verifier_h
+
+// Local include.
+#include "Configuration.h"
+
+// Library include.
+#include <stddef.h>
+#include <stdint.h>
+
+
+/// @brief Firmware verifier interface that contains the method that a class that can be used to verify the authenticity of the received binary firmware data has to implement.
+/// The firmware binary is passed to the verifier in the same packets it is written into flash memory and into the checksum hash,
+/// meaning the verification runs incrementally alongside the download and does not require a second pass over the flash partition once the update has been finished.
+/// Allows to only accept signed firmware images, for example with an ECDSA P-256 or Ed25519 signature over the hash of the image, because unlike the checksum sent by the server,
+/// a valid signature can not be created by a 3rd party that does not have access to the private key
+class IFirmware_Verifier {
+  public:
+    /// @brief Sets the signature of the firmware binary, which is received as the optional fw_signature shared attribute together with the remaining firmware information.
+    /// Called once before the update is started and before begin(), meaning implementations have to copy or parse the given string, because it is only valid during this call.
+    /// Ignored by default, which is correct for verifiers that do not use a signature sent by the server, for example because they compare against a value embedded into the firmware
+    /// @param signature Value of the fw_signature shared attribute or nullptr if the attribute does not exist
+    /// @return Whether the given signature is valid and can be used to verify the firmware binary, returning false aborts the update before it is started
+    virtual bool set_signature(char const * signature) {
+        return true;
+    }
+
+    /// @brief Initalizes the verification of the given data
+    /// @param firmware_size Total size of the data that should be verified, is done in multiple packets
+    /// @return Whether initalizing the verification was successful or not
+    virtual bool begin(size_t const & firmware_size) = 0;
+
+    /// @brief Updates the verification with the given amount of bytes of the packet data
+    /// @param payload Firmware packet data that should be verified
+    /// @param total_bytes Amount of bytes in the current firmware packet data
+    /// @return Whether updating the verification with the given bytes was successful or not
+    virtual bool update(uint8_t const * payload, size_t const & total_bytes) = 0;
+
+    /// @brief Ends the verification and returns whether the complete firmware binary is authentic,
+    /// is only called once all bytes have been passed to update() and the checksum of the firmware binary has already been verified successfully
+    /// @return Whether the signature of the complete firmware binary is valid or not
+    virtual bool verify() = 0;
+};
+
+#endif // IFirmware_Verifier_h
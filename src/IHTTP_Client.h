@@ -56,6 +56,16 @@ class IHTTP_Client {
     /// @return Whether the request was successful or not, returns 0 if successful or if not the internal error code
     virtual int get(const char *url_path) = 0;
 
+    /// @brief Reads the next bytes of the response body of a previously sent message directly into the given buffer,
+    /// skips any response headers if they have not been read already, should be called after calling get_response_status_code().
+    /// Allows to process the response body in a streaming way, without having to copy the complete body into a string object first.
+    /// Additionally has to be used to read the remaining response body before the next request is sent, if the connection is kept alive and reused for that request.
+    /// Should wait until atleast one byte has been received, the end of the response body has been reached or the response timed out
+    /// @param buffer Buffer the read bytes of the response body will be copied into
+    /// @param size Maximum amount of bytes that should be read into the buffer
+    /// @return Amount of bytes that have actually been read, 0 if the end of the response body has been reached or no further data was received in time
+    virtual size_t read_response_body(uint8_t * buffer, size_t size) = 0;
+
     /// @brief Returns the response body of a previously sent message as a string object,
     /// skips any response headers if they have not been read already,
     /// should be called after calling get_response_status_code() and ensuring the request was successful
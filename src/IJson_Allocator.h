@@ -0,0 +1,80 @@
+#ifndef IJson_Allocator_h
+#define IJson_Allocator_h
+
+// Local include.
+#include "Constants.h"
+
+#if THINGSBOARD_ENABLE_DYNAMIC
+
+// Library include.
+#include <stddef.h>
+
+
+/// @brief Json allocator interface that contains the methods that a class that can be used to allocate the memory of the JsonDocument used to deserialize received messages has to implement.
+/// Allows to replace the general heap allocation done for every received message with a custom strategy, for example with blocks reserved once at startup, to prevent fragmenting the heap on long running devices.
+/// See https://arduinojson.org/v6/api/basicjsondocument/ for more information on the allocator contract
+class IJson_Allocator {
+  public:
+    /// @brief Allocates a block of memory with the given size
+    /// @param size Amount of bytes the JsonDocument requires
+    /// @return Pointer to the allocated memory or nullptr if no memory with the given size could be allocated
+    virtual void * allocate(size_t size) = 0;
+
+    /// @brief Frees a block of memory previously returned by allocate() or reallocate()
+    /// @param pointer Pointer to the memory that should be freed, is never nullptr
+    virtual void deallocate(void * pointer) = 0;
+
+    /// @brief Resizes a block of memory previously returned by allocate() or reallocate(), only called if the JsonDocument is shrunk
+    /// @param pointer Pointer to the memory that should be resized
+    /// @param new_size New amount of bytes the JsonDocument requires
+    /// @return Pointer to the resized memory or nullptr if the memory could not be resized, in which case the original memory has to stay valid
+    virtual void * reallocate(void * pointer, size_t new_size) = 0;
+};
+
+
+/// @brief Allocator passed to the JsonDocument, copied into each JsonDocument and therefore only contains a pointer to the actual IJson_Allocator implementation.
+/// Forwards to the TBJsonAllocator (heap or psram), if no IJson_Allocator implementation has been set, meaning the behaviour is the same as with the TBJsonDocument
+class Json_Allocator_Handle {
+  public:
+    /// @brief Constructor
+    /// @param allocator Pointer to the IJson_Allocator implementation that should be used, nullptr to use the TBJsonAllocator instead, default = nullptr
+    Json_Allocator_Handle(IJson_Allocator * allocator = nullptr)
+      : m_allocator(allocator)
+      , m_fallback()
+    {
+        // Nothing to do
+    }
+
+    void * allocate(size_t size) {
+        if (m_allocator == nullptr) {
+            return m_fallback.allocate(size);
+        }
+        return m_allocator->allocate(size);
+    }
+
+    void deallocate(void * pointer) {
+        if (m_allocator == nullptr) {
+            m_fallback.deallocate(pointer);
+            return;
+        }
+        m_allocator->deallocate(pointer);
+    }
+
+    void * reallocate(void * pointer, size_t new_size) {
+        if (m_allocator == nullptr) {
+            return m_fallback.reallocate(pointer, new_size);
+        }
+        return m_allocator->reallocate(pointer, new_size);
+    }
+
+  private:
+    IJson_Allocator *m_allocator = {}; // Pointer to the IJson_Allocator implementation the allocations are forwarded to
+    TBJsonAllocator m_fallback = {};   // Allocator that is used if no IJson_Allocator implementation has been set
+};
+
+
+using TBPooledJsonDocument = BasicJsonDocument<Json_Allocator_Handle>;
+
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+
+#endif // IJson_Allocator_h
@@ -36,6 +36,33 @@ class IMQTT_Client {
     /// @param callback Method that should be called on received MQTT response
     virtual void set_data_callback(Callback<void, char *, uint8_t *, unsigned int>::function callback) = 0;
 
+    /// @brief Sets the callback that is called, if a message is received by the MQTT broker that is bigger than the internal receive buffer and is therefore received in multiple fragments.
+    /// Is called once for every fragment in the order they were received, including the topic string that the message was received over, the payload data of the fragment and the size of that payload data,
+    /// as well as the offset of the fragment in the complete message and the total size of the complete message. The topic has to be passed with every fragment, even if the underlying client only receives it with the first one.
+    /// Directly set by the used ThingsBoard client to its internal methods, therefore calling again and overriding as a user ist not recommended, unless you know what you are doing.
+    /// Does nothing by default, which is correct for implementations that discard messages bigger than their receive buffer and never receive them in fragments
+    /// @param callback Method that should be called on received MQTT response fragment
+    virtual void set_data_fragment_callback(Callback<void, char *, uint8_t *, unsigned int, unsigned int, unsigned int>::function callback) {
+        // Nothing to do
+    }
+
+    /// @brief Gets whether the client is able to receive messages that are bigger than its internal receive buffer in multiple fragments, which are then passed to the callback set with set_data_fragment_callback().
+    /// If that is the case the receive buffer does not have to be increased to receive bigger messages, as long as they are handled by an API implementation that can process fragments (OTA Firmware Update)
+    /// Returns false by default, implementations that call the callback set with set_data_fragment_callback() have to override this method
+    /// @return Whether messages bigger than the receive buffer are received in fragments or discarded instead
+    virtual bool supports_fragmented_receive() {
+        return false;
+    }
+
+    /// @brief Sets the callback that is called, if the MQTT broker acknowledged a message that was previously published with QoS level 1 (PUBACK),
+    /// including the packet identifier that was returned by the publish() call that sent the message. Implementations that do not support publishing with QoS level 1 never call the callback.
+    /// Directly set by the used ThingsBoard client to its internal methods, therefore calling again and overriding as a user ist not recommended, unless you know what you are doing
+    /// Does nothing by default, which is correct for implementations that can only publish with QoS level 0 and therefore never receive an acknowledgement
+    /// @param callback Method that should be called on received MQTT publish acknowledgement
+    virtual void set_publish_acknowledged_callback(Callback<void, uint16_t>::function callback) {
+        // Nothing to do
+    }
+
     /// @brief Sets the callback that is called, if we have successfully established a connection with the MQTT broker.
     /// Directly set by the used ThingsBoard client to its internal methods, therefore calling again and overriding as a user ist not recommended, unless you know what you are doing
     /// @param callback Method that should be called on established MQTT connection
@@ -97,12 +124,44 @@ class IMQTT_Client {
     /// @return Whether publishing the payload on the given topic was successful or not
     virtual bool publish(char const * topic, uint8_t const * payload, size_t const & length) = 0;
 
+    /// @brief Sends the given payload with the given QoS level over the previously established connection with connect.
+    /// Messages sent with QoS level 1 are acknowledged by the broker, which calls the callback previously configured with set_publish_acknowledged_callback() with the returned packet identifier.
+    /// Implementations that can only send messages with QoS level 0 should return false if a higher QoS level is requested, instead of silently downgrading the message
+    /// Publishes messages with QoS level 0 with the publish() method without a QoS level and fails messages with a higher QoS level by default, which is correct for implementations that can only publish with QoS level 0
+    /// @param topic Topic that the message is sent over, where different MQTT topics expect a different kind of payload
+    /// @param payload Payload containg the json data that should be sent
+    /// @param length Length of the payload in bytes
+    /// @param qos QoS level the message should be sent with, 0 means at most once and 1 means at least once
+    /// @param packet_id Packet identifier the message was sent with, is only valid if the message was sent with QoS level 1 and publishing was successful
+    /// @return Whether publishing the payload on the given topic was successful or not
+    virtual bool publish(char const * topic, uint8_t const * payload, size_t const & length, uint8_t qos, uint16_t & packet_id) {
+        packet_id = 0U;
+        return qos == 0U && publish(topic, payload, length);
+    }
+
     /// @brief Subscribes to MQTT message on the given topic, which will cause an internal callback to be called for each message received on that topic from the server,
     /// it should then, call the previously configured callback with set_data_callback() with the received data
     /// @param topic Topic we want to receive a notification about if messages are sent by the server
     /// @return Wheter subscribing the given topic was possible or not, should return false and a warning should be printed,
     /// if the connection has been lost or the topic does not exist
     virtual bool subscribe(char const * topic) = 0;
+
+    /// @brief Subscribes to MQTT messages on all the given topics at once, the same way subscribe() does for a single topic.
+    /// Implementations should send all topic filters in a single SUBSCRIBE packet, so that the server acknowledges them with a single SUBACK packet,
+    /// instead of sending one packet and waiting for one acknowledgement per topic, which is used to resubscribe all topics at once after a reconnect.
+    /// Subscribes each topic seperately by default, which is correct for implementations that can only subscribe one topic per packet
+    /// @param topics Topics we want to receive a notification about if messages are sent by the server
+    /// @param count Amount of topics in the given array
+    /// @return Wheter subscribing all given topics was possible or not, should return false and a warning should be printed,
+    /// if the connection has been lost or a topic does not exist
+    virtual bool subscribe(char const * const * topics, size_t const & count) {
+        for (size_t i = 0U; i < count; i++) {
+            if (!subscribe(topics[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
   
     /// @brief Unsubscribes to previously subscribed MQTT message on the given topic
     /// @param topic Topic we want to stop receiving a notification about if messages are sent by the server
@@ -115,6 +174,15 @@ class IMQTT_Client {
     /// @return Whether the client is currently connected or not
     virtual bool connected() = 0;
 
+    /// @brief Returns whether the last connection attempt was refused by the server because of the given credentials,
+    /// meaning the CONNACK packet contained either the return code 4 (bad username or password) or 5 (not authorized).
+    /// Allows to differentiate between credentials that have been deleted or changed on the server and should therefore not be used again and temporary issues like a lost network connection
+    /// Returns false by default, in which case stored credentials are never cleared because of a rejection, implementations that receive the return code of the CONNACK packet should override this method
+    /// @return Whether the server rejected the credentials used in the last call to connect()
+    virtual bool authentication_rejected() {
+        return false;
+    }
+
 #if THINGSBOARD_ENABLE_STREAM_UTILS
 
     /// @brief Start to publish a message over a given topic, without being restricted to the internal buffer size.
@@ -0,0 +1,240 @@
+#ifndef Inplace_Function_h
+#define Inplace_Function_h
+
+// Local include.
+#include "Constants.h"
+
+#if THINGSBOARD_ENABLE_STL
+
+// Library includes.
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+
+template<typename Signature, size_t Capacity = Default_Callback_Size>
+class Inplace_Function;
+
+/// @brief Replacement for std::function, which stores the wrapped callable directly inside of the object instead of allocating it on the heap if it is bigger than the internal buffer of std::function.
+/// The capacity is fixed at compile time and is enough to hold the std::bind of a member method and the instance pointer used internally, or a lambda that captures up to four pointers or references.
+/// Callables that are bigger, for example lambdas capturing more variables or big objects by value, fail to compile instead of silently being allocated on the heap once for every copy.
+/// To still use them either capture a pointer to a struct containing the needed variables instead, or increase Default_Callback_Size by defining it before including the library.
+/// Copying or moving the function copies or moves the stored callable into the other buffer, therefore copying callbacks into the data containers of the API implementations never allocates.
+/// Calling the function only requires a single indirect call to the invoker that was generated for the stored callable type, which calls the callable directly and allows the compiler to inline it
+/// @tparam R Type the wrapped callable should return
+/// @tparam ...Args Types the wrapped callable should receive
+/// @tparam Capacity Amount of bytes available to store the callable, default = Default_Callback_Size (4 pointers)
+template<typename R, typename... Args, size_t Capacity>
+class Inplace_Function<R(Args...), Capacity> {
+  public:
+    /// @brief Constructs an empty function, that can not be called, operator bool() returns false
+    Inplace_Function()
+      : m_storage()
+      , m_invoke(nullptr)
+      , m_manage(nullptr)
+    {
+        // Nothing to do
+    }
+
+    /// @brief Constructs an empty function, allows to pass nullptr wherever a function is expected, the same as with std::function
+    Inplace_Function(std::nullptr_t)
+      : Inplace_Function()
+    {
+        // Nothing to do
+    }
+
+    /// @brief Constructs the function from the given callable, which is moved into the internal buffer. Is empty if the given callable is a function pointer that is nullptr or an empty std::function
+    /// @tparam Functor Type of the callable (function pointer, lambda, std::bind, functor class, ...), has to fit into the internal buffer and has to be callable with the arguments
+    /// @param functor Callable that should be called
+    template<typename Functor, typename Decayed = typename std::decay<Functor>::type, typename = typename std::enable_if<!std::is_same<Decayed, Inplace_Function>::value>::type, typename = decltype(std::declval<Decayed &>()(std::declval<Args>()...))>
+    Inplace_Function(Functor && functor)
+      : Inplace_Function()
+    {
+        if (!Is_Null(functor)) {
+            Emplace(std::forward<Functor>(functor));
+        }
+    }
+
+    /// @brief Copy constructor, copies the stored callable into the internal buffer
+    /// @param other Function whose callable should be copied
+    Inplace_Function(Inplace_Function const & other)
+      : Inplace_Function()
+    {
+        if (other.m_manage != nullptr) {
+            other.m_manage(Operation::COPY, m_storage, const_cast<unsigned char *>(other.m_storage));
+        }
+        m_invoke = other.m_invoke;
+        m_manage = other.m_manage;
+    }
+
+    /// @brief Move constructor, moves the stored callable into the internal buffer, the other function is empty afterwards
+    /// @param other Function whose callable should be moved
+    Inplace_Function(Inplace_Function && other)
+      : Inplace_Function()
+    {
+        Take(other);
+    }
+
+    /// @brief Copy assignment operator, destroys the currently stored callable and copies the callable of the other function
+    /// @param other Function whose callable should be copied
+    /// @return Reference to this function
+    Inplace_Function & operator=(Inplace_Function const & other) {
+        if (this != &other) {
+            Inplace_Function copy(other);
+            Reset();
+            Take(copy);
+        }
+        return *this;
+    }
+
+    /// @brief Move assignment operator, destroys the currently stored callable and moves the callable of the other function
+    /// @param other Function whose callable should be moved, is empty afterwards
+    /// @return Reference to this function
+    Inplace_Function & operator=(Inplace_Function && other) {
+        if (this != &other) {
+            Reset();
+            Take(other);
+        }
+        return *this;
+    }
+
+    /// @brief Destroys the currently stored callable and leaves the function empty
+    /// @return Reference to this function
+    Inplace_Function & operator=(std::nullptr_t) {
+        Reset();
+        return *this;
+    }
+
+    /// @brief Destructor
+    ~Inplace_Function() {
+        Reset();
+    }
+
+    /// @brief Returns whether a callable is stored and the function can therefore be called
+    /// @return Whether the function is not empty
+    explicit operator bool() const {
+        return m_invoke != nullptr;
+    }
+
+    /// @brief Calls the stored callable with the given arguments, has to be checked with operator bool() beforehand, because calling an empty function is undefined behaviour
+    /// @param ...args Arguments that are forwarded to the stored callable
+    /// @return Value returned by the stored callable
+    R operator()(Args... args) const {
+        return m_invoke(const_cast<unsigned char *>(m_storage), std::forward<Args>(args)...);
+    }
+
+  private:
+    /// @brief Operations that are executed by the manager generated for the stored callable type
+    enum class Operation : uint8_t {
+        COPY,    ///< Copy constructs the callable from the source into the destination buffer
+        MOVE,    ///< Move constructs the callable from the source into the destination buffer and destroys the source
+        DESTROY  ///< Destroys the callable in the destination buffer
+    };
+
+    using Invoker = R (*)(void * storage, Args &&... args);
+    using Manager = void (*)(Operation operation, void * destination, void * source);
+
+    /// @brief Calls the callable of the given type stored in the given buffer
+    /// @tparam Functor Type of the stored callable
+    /// @param storage Buffer the callable is stored in
+    /// @param ...args Arguments that are forwarded to the stored callable
+    /// @return Value returned by the stored callable
+    template<typename Functor>
+    static R Invoke(void * storage, Args &&... args) {
+        return (*static_cast<Functor *>(storage))(std::forward<Args>(args)...);
+    }
+
+    /// @brief Copies, moves or destroys the callable of the given type stored in the given buffers
+    /// @tparam Functor Type of the stored callable
+    /// @param operation Operation that should be executed
+    /// @param destination Buffer the callable is copied or moved into, or the buffer of the callable that should be destroyed
+    /// @param source Buffer the callable is copied or moved from, unused if the callable is destroyed
+    template<typename Functor>
+    static void Manage(Operation operation, void * destination, void * source) {
+        switch (operation) {
+            case Operation::COPY:
+                new (destination) Functor(*static_cast<Functor const *>(source));
+                break;
+            case Operation::MOVE:
+                new (destination) Functor(std::move(*static_cast<Functor *>(source)));
+                static_cast<Functor *>(source)->~Functor();
+                break;
+            case Operation::DESTROY:
+                static_cast<Functor *>(destination)->~Functor();
+                break;
+            default:
+                // Nothing to do
+                break;
+        }
+    }
+
+    /// @brief Returns whether the given callable is empty, which is possible for callables that are explicitly convertible to bool, like std::function
+    /// @tparam Functor Type of the callable
+    /// @param functor Callable that should be checked
+    /// @return Whether the callable converts to false
+    template<typename Functor>
+    static typename std::enable_if<std::is_constructible<bool, Functor const &>::value, bool>::type Is_Null(Functor const & functor) {
+        return !static_cast<bool>(functor);
+    }
+
+    /// @brief Returns whether the given callable is empty, which is not possible for callables that are not convertible to bool, like lambdas capturing variables or std::bind
+    /// @tparam Functor Type of the callable
+    /// @return Always false, because the callable can not be empty
+    template<typename Functor>
+    static typename std::enable_if<!std::is_constructible<bool, Functor const &>::value, bool>::type Is_Null(Functor const &) {
+        return false;
+    }
+
+    /// @brief Returns whether the given function pointer is a nullptr
+    /// @tparam Function Signature of the function pointer
+    /// @param function Function pointer that should be checked
+    /// @return Whether the function pointer is a nullptr
+    template<typename Function>
+    static bool Is_Null(Function * function) {
+        return function == nullptr;
+    }
+
+    /// @brief Constructs the given callable inside of the internal buffer. The function has to be empty
+    /// @tparam Functor Type of the callable, has to fit into the internal buffer
+    /// @param functor Callable that should be stored
+    template<typename Functor>
+    void Emplace(Functor && functor) {
+        using Decayed = typename std::decay<Functor>::type;
+        static_assert(sizeof(Decayed) <= Capacity, "Callable does not fit into the callback, capture a pointer to a struct containing the needed variables instead or increase Default_Callback_Size");
+        static_assert(alignof(Decayed) <= alignof(std::max_align_t), "Callable requires a bigger alignment than the callback provides, capture a pointer to the over-aligned variable instead");
+        new (m_storage) Decayed(std::forward<Functor>(functor));
+        m_invoke = &Invoke<Decayed>;
+        m_manage = &Manage<Decayed>;
+    }
+
+    /// @brief Moves the callable of the given function into the internal buffer, this function has to be empty and the other function is empty afterwards
+    /// @param other Function whose callable should be moved
+    void Take(Inplace_Function & other) {
+        if (other.m_manage != nullptr) {
+            other.m_manage(Operation::MOVE, m_storage, other.m_storage);
+        }
+        m_invoke = other.m_invoke;
+        m_manage = other.m_manage;
+        other.m_invoke = nullptr;
+        other.m_manage = nullptr;
+    }
+
+    /// @brief Destroys the currently stored callable and leaves the function empty
+    void Reset() {
+        if (m_manage != nullptr) {
+            m_manage(Operation::DESTROY, m_storage, nullptr);
+        }
+        m_invoke = nullptr;
+        m_manage = nullptr;
+    }
+
+    alignas(std::max_align_t) unsigned char m_storage[Capacity] = {}; // Buffer the callable is stored in
+    Invoker                                 m_invoke = {};            // Calls the stored callable, nullptr if the function is empty
+    Manager                                 m_manage = {};            // Copies, moves or destroys the stored callable, nullptr if the function is empty
+};
+
+#endif // THINGSBOARD_ENABLE_STL
+
+#endif // Inplace_Function_h
@@ -0,0 +1,150 @@
+#ifndef Json_Block_Allocator_h
+#define Json_Block_Allocator_h
+
+// Local include.
+#include "IJson_Allocator.h"
+
+#if THINGSBOARD_ENABLE_DYNAMIC
+
+// Library includes.
+#include <stdint.h>
+
+
+/// @brief Json allocator that reserves a fixed set of blocks with the given sizes once at startup, with a single allocation from the TBJsonAllocator (heap or psram if THINGSBOARD_ENABLE_PSRAM is set).
+/// Each JsonDocument then receives the smallest free block that is big enough to hold it, meaning blocks with different sizes act as size classes, for example a few small blocks for attribute updates and RPC requests
+/// and a single big block for shared attribute responses. Because the blocks are never freed and only reused, receiving messages does not fragment the heap even on devices that run for months.
+/// If no free block is big enough the allocation falls back to the TBJsonAllocator, the amount of those fallback allocations can be read to increase the block sizes or amounts accordingly
+/// @tparam BlockAmount Amount of blocks that are reserved, limits how many JsonDocuments can be allocated from the reserved blocks at the same time
+template<size_t BlockAmount>
+class Json_Block_Allocator : public IJson_Allocator {
+  public:
+    /// @brief Constructs the allocator and reserves the memory for all blocks at once
+    /// @param block_sizes Size in bytes of each block, the JsonDocument used to deserialize a received message requires JSON_OBJECT_SIZE(amount of key value pairs) bytes
+    explicit Json_Block_Allocator(size_t const (&block_sizes)[BlockAmount])
+      : m_memory(nullptr)
+      , m_blocks()
+      , m_fallback_allocations(0U)
+      , m_allocator()
+    {
+        size_t total_size = 0U;
+        for (size_t i = 0U; i < BlockAmount; i++) {
+            // Aligned so that each block can hold the pointers and numbers inside the JsonDocument
+            m_blocks[i].size = Align(block_sizes[i]);
+            m_blocks[i].offset = total_size;
+            m_blocks[i].used = false;
+            total_size += m_blocks[i].size;
+        }
+        m_memory = static_cast<uint8_t *>(m_allocator.allocate(total_size));
+    }
+
+    /// @brief Copying is not allowed, because the copy would free the same reserved memory again
+    Json_Block_Allocator(Json_Block_Allocator const &) = delete;
+
+    /// @brief Copying is not allowed, because the copy would free the same reserved memory again
+    Json_Block_Allocator & operator=(Json_Block_Allocator const &) = delete;
+
+    /// @brief Destructor, frees the reserved memory of all blocks
+    ~Json_Block_Allocator() {
+        if (m_memory != nullptr) {
+            m_allocator.deallocate(m_memory);
+        }
+    }
+
+    /// @brief Returns whether reserving the memory for the blocks was successful, if it was not every allocation falls back to the TBJsonAllocator
+    /// @return Whether the memory for the blocks has been reserved
+    bool reserved() const {
+        return m_memory != nullptr;
+    }
+
+    /// @brief Returns the amount of allocations that did not fit into any free block and therefore had to be allocated from the TBJsonAllocator
+    /// @return Amount of fallback allocations
+    size_t const & get_fallback_allocations() const {
+        return m_fallback_allocations;
+    }
+
+    void * allocate(size_t size) override {
+        Block * const block = Find_Free_Block(size);
+        if (block == nullptr) {
+            m_fallback_allocations++;
+            return m_allocator.allocate(size);
+        }
+        block->used = true;
+        return m_memory + block->offset;
+    }
+
+    void deallocate(void * pointer) override {
+        Block * const block = Find_Owning_Block(pointer);
+        if (block == nullptr) {
+            m_allocator.deallocate(pointer);
+            return;
+        }
+        block->used = false;
+    }
+
+    void * reallocate(void * pointer, size_t new_size) override {
+        Block * const block = Find_Owning_Block(pointer);
+        if (block == nullptr) {
+            return m_allocator.reallocate(pointer, new_size);
+        }
+        // Blocks can not be resized, but shrinking is the only case the JsonDocument reallocates, which fits into the same block
+        return new_size <= block->size ? pointer : nullptr;
+    }
+
+  private:
+    /// @brief Block of the reserved memory
+    struct Block {
+        size_t offset = {}; // Offset of the first byte of the block in the reserved memory
+        size_t size = {};   // Size of the block in bytes
+        bool   used = {};   // Whether the block is currently used by a JsonDocument
+    };
+
+    /// @brief Rounds the given size up to the alignment of pointers
+    /// @param size Size that should be aligned
+    /// @return Aligned size
+    static size_t Align(size_t const & size) {
+        return (size + sizeof(void *) - 1U) & ~(sizeof(void *) - 1U);
+    }
+
+    /// @brief Returns the smallest free block that is big enough to hold the given size
+    /// @param size Amount of bytes the block has to hold
+    /// @return Pointer to the found block or nullptr if no free block is big enough
+    Block * Find_Free_Block(size_t const & size) {
+        if (m_memory == nullptr) {
+            return nullptr;
+        }
+        Block * found = nullptr;
+        for (auto & block : m_blocks) {
+            if (block.used || block.size < size) {
+                continue;
+            }
+            else if (found == nullptr || block.size < found->size) {
+                found = &block;
+            }
+        }
+        return found;
+    }
+
+    /// @brief Returns the block the given pointer points to
+    /// @param pointer Pointer that was previously returned by allocate()
+    /// @return Pointer to the owning block or nullptr if the pointer was allocated by the TBJsonAllocator instead
+    Block * Find_Owning_Block(void const * pointer) {
+        if (m_memory == nullptr) {
+            return nullptr;
+        }
+        for (auto & block : m_blocks) {
+            if (block.used && pointer == m_memory + block.offset) {
+                return &block;
+            }
+        }
+        return nullptr;
+    }
+
+    uint8_t         *m_memory = {};              // Reserved memory of all blocks
+    Block           m_blocks[BlockAmount] = {};  // Size and state of each block
+    size_t          m_fallback_allocations = {}; // Amount of allocations that did not fit into any free block
+    TBJsonAllocator m_allocator = {};            // Allocator the blocks are reserved with and fallback allocations are done with
+};
+
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+
+#endif // Json_Block_Allocator_h
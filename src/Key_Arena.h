@@ -0,0 +1,80 @@
+#ifndef Key_Arena_h
+#define Key_Arena_h
+
+// Local includes.
+#include "Callback.h"
+#include "Helper.h"
+
+
+/// @brief Range of keys stored inside of a Key_Arena, references the keys by their index instead of a pointer, so it stays valid even if the arena has to grow
+struct Key_Range {
+    size_t offset = {}; // Index of the first key of the range in the arena
+    size_t size = {};   // Amount of keys in the range
+};
+
+
+/// @brief Contiguous storage for the keys of all callbacks subscribed to one API implementation, each callback then only references its keys with a Key_Range.
+/// Copying or storing the subscribed callback therefore does not copy its keys, and checking which keys are contained in a received message only reads memory that lies next to each other.
+/// Only the pointers to the keys are stored, meaning the strings themselves still need to stay valid for the lifetime of the subscription, the same as with the keys stored in the callbacks
+#if !THINGSBOARD_ENABLE_DYNAMIC
+/// @tparam MaxKeys Maximum amount of keys that can be stored at once over all ranges, allows to use an array on the stack in the background
+template<size_t MaxKeys>
+#endif // !THINGSBOARD_ENABLE_DYNAMIC
+class Key_Arena {
+  public:
+    /// @brief Constructor
+    Key_Arena() = default;
+
+    /// @brief Appends copies of the given keys to the end of the arena
+    /// @tparam InputIterator Class that points to the begin and end iterator
+    /// of the given data container, allows for using / passing either std::vector or std::array.
+    /// See https://en.cppreference.com/w/cpp/iterator/input_iterator for more information on the requirements of the iterator
+    /// @param first Iterator pointing to the first key that should be stored
+    /// @param last Iterator pointing to the end of the keys that should be stored (last element + 1)
+    /// @param range Range the stored keys can be accessed with afterwards
+    /// @return Whether all keys could be stored, fails if the arena does not have enough space left, in which case the arena is not changed
+    template<typename InputIterator>
+    bool intern(InputIterator const & first, InputIterator const & last, Key_Range & range) {
+        size_t const size = Helper::distance(first, last);
+#if THINGSBOARD_ENABLE_DYNAMIC
+        m_keys.reserve(m_keys.size() + size);
+#else
+        if (m_keys.size() + size > m_keys.capacity()) {
+            return false;
+        }
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+        range.offset = m_keys.size();
+        range.size = size;
+        for (auto it = first; it != last; ++it) {
+            m_keys.push_back(*it);
+        }
+        return true;
+    }
+
+    /// @brief Returns the key at the given index, the index of the keys of a range are range.offset until (range.offset + range.size - 1)
+    /// @param index Index of the key in the arena
+    /// @return Key at the given index
+    char const * const & operator[](size_t const & index) const {
+        return m_keys[index];
+    }
+
+    /// @brief Returns the amount of keys stored over all ranges
+    /// @return Amount of stored keys
+    size_t size() const {
+        return m_keys.size();
+    }
+
+    /// @brief Removes all stored keys, which invalidates all previously returned ranges, but keeps the already allocated memory for the next keys
+    void clear() {
+        m_keys.clear();
+    }
+
+  private:
+#if THINGSBOARD_ENABLE_DYNAMIC
+    Vector<char const *>         m_keys = {}; // Keys of all ranges, stored directly after each other
+#else
+    Array<char const *, MaxKeys> m_keys = {}; // Keys of all ranges, stored directly after each other
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+};
+
+#endif // Key_Arena_h
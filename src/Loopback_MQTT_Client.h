@@ -0,0 +1,705 @@
+#ifndef Loopback_MQTT_Client_h
+#define Loopback_MQTT_Client_h
+
+// Local includes.
+#include "IMQTT_Client.h"
+
+// Library includes.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+// Topics the loopback client answers on behalf of the ThingsBoard server, requests are published by the device with the request id (and chunk index) appended
+constexpr char LOOPBACK_ATTRIBUTE_REQUEST_TOPIC[] = "v1/devices/me/attributes/request/";
+constexpr char LOOPBACK_ATTRIBUTE_RESPONSE_TOPIC[] = "v1/devices/me/attributes/response/%u";
+constexpr char LOOPBACK_RPC_REQUEST_TOPIC[] = "v1/devices/me/rpc/request/";
+constexpr char LOOPBACK_RPC_RESPONSE_TOPIC[] = "v1/devices/me/rpc/response/%u";
+constexpr char LOOPBACK_FIRMWARE_REQUEST_TOPIC[] = "v2/fw/request/";
+constexpr char LOOPBACK_FIRMWARE_RESPONSE_TOPIC[] = "v2/fw/response/%u/chunk/%u";
+// Maximum length of a topic that can be queued or subscribed, big enough to hold any topic used by the ThingsBoard client + 1 for null termination
+constexpr size_t MAX_LOOPBACK_TOPIC_SIZE = 64U;
+// Log messages.
+constexpr char LOOPBACK_QUEUE_FULL[] = "Pending message queue is full (%u), discarding message on topic (%s)";
+constexpr char LOOPBACK_TOPIC_EXCEEDS_BUFFER[] = "Topic (%s) is bigger than the internal topic buffer size (%u), discarding message";
+constexpr char LOOPBACK_DATA_EXCEEDS_BUFFER[] = "Received amount of data (%u) is bigger than current buffer size (%u), increase accordingly";
+constexpr char LOOPBACK_FIRMWARE_READ_FAILED[] = "Reading (%u) bytes of firmware at offset (%u) failed";
+#if THINGSBOARD_ENABLE_DEBUG
+constexpr char LOOPBACK_DROPPED_MESSAGE[] = "Simulated loss of message on topic (%s)";
+constexpr char LOOPBACK_SIMULATED_DISCONNECT[] = "Simulated disconnect after (%u) published messages";
+#endif // THINGSBOARD_ENABLE_DEBUG
+
+
+/// @brief MQTT Client interface implementation that does not communicate over any network, but instead stands in for the ThingsBoard server in the same process.
+/// Allows to run the ThingsBoard client and all IAPI_Implementation instances deterministically, for example to measure the performance of changes to the over the air update or the message dispatching reproducibly.
+/// Messages published by the device are answered the same way the ThingsBoard server would: attribute requests are answered with a configurable response, client-side RPC requests are echoed back
+/// and firmware chunk requests are answered with the requested part of a configured firmware binary, either from memory or read from a file. Any other server-side message can be queued with inject().
+/// Responses are only delivered to subscribed topics and only in the loop() method, where latency is counted in loop() calls instead of time, to keep the behaviour independent of the speed of the host.
+/// Loss and reconnects can be simulated as well, the loss uses a seeded pseudo random number generator, meaning the same seed always drops the same messages
+/// @tparam MaxPendingMessages Maximum amount of messages that can be queued for delivery at once, each message additionally reserves the receive buffer size of memory once set_buffer_size() is called, default = 8
+/// @tparam MaxSubscriptions Maximum amount of topic filters that can be subscribed at once, default = 8
+/// @tparam Logger Implementation that should be used to print error messages generated by internal processes and additional debugging messages if THINGSBOARD_ENABLE_DEBUG is set, default = DefaultLogger
+template <size_t MaxPendingMessages = 8U, size_t MaxSubscriptions = 8U, typename Logger = DefaultLogger>
+class Loopback_MQTT_Client : public IMQTT_Client {
+  public:
+    /// @brief Constructs a IMQTT_Client implementation without any allocated buffers, meaning set_buffer_size() has to be called before connecting, which the ThingsBoard client does in its constructor
+    Loopback_MQTT_Client()
+      : m_received_data_callback()
+      , m_received_data_fragment_callback()
+      , m_publish_acknowledged_callback()
+      , m_connected_callback()
+      , m_published_callback()
+      , m_connected(false)
+      , m_reject_credentials(false)
+      , m_authentication_rejected(false)
+      , m_fragmented_receive(false)
+      , m_receive_buffer_size(0U)
+      , m_send_buffer_size(0U)
+      , m_payload_pool(nullptr)
+      , m_send_buffer(nullptr)
+      , m_pending_messages()
+      , m_pending_head(0U)
+      , m_pending_count(0U)
+      , m_packet_id(0U)
+      , m_subscriptions()
+      , m_attribute_response(nullptr)
+      , m_echo_rpc(true)
+      , m_firmware(nullptr)
+      , m_firmware_file(nullptr)
+      , m_firmware_size(0U)
+      , m_latency(0U)
+      , m_loss_percentage(0U)
+      , m_random_state(1U)
+      , m_disconnect_interval(0U)
+      , m_tick(0U)
+      , m_published_count(0U)
+      , m_published_since_connect(0U)
+      , m_delivered_count(0U)
+      , m_dropped_count(0U)
+#if THINGSBOARD_ENABLE_STREAM_UTILS
+      , m_stream_topic()
+      , m_stream_length(0U)
+#endif // THINGSBOARD_ENABLE_STREAM_UTILS
+    {
+        // Nothing to do
+    }
+
+    /// @brief Destructor
+    ~Loopback_MQTT_Client() {
+        if (m_firmware_file != nullptr) {
+            (void)fclose(m_firmware_file);
+        }
+        free(m_payload_pool);
+        free(m_send_buffer);
+    }
+
+    /// @brief Sets whether messages bigger than the receive buffer are delivered in fragments, the same way the Espressif_MQTT_Client does,
+    /// or whether they are discarded instead, the same way the Arduino_MQTT_Client does. The default value is false
+    /// @param fragmented_receive Whether messages bigger than the receive buffer are delivered in fragments or discarded instead
+    void set_fragmented_receive(bool fragmented_receive) {
+        m_fragmented_receive = fragmented_receive;
+    }
+
+    /// @brief Sets the callback that is called for every message the device publishes, before it is handled by the loopback client. Allows to check the sent payloads or to count them for benchmarks
+    /// @param callback Method that should be called with the topic, payload and payload size of every published message
+    void set_published_callback(Callback<void, char const *, uint8_t const *, size_t>::function callback) {
+        m_published_callback.Set_Callback(callback);
+    }
+
+    /// @brief Sets the response sent for every attribute request (v1/devices/me/attributes/request/$request_id) the device publishes, the requested keys are not checked,
+    /// meaning the response should already contain the client and or shared attributes the test expects, for example {"shared":{"fw_title":"test"}}
+    /// @param attribute_response Null-terminated json string that is sent as the response, not copied meaning it has to stay valid, nullptr disables answering attribute requests
+    void set_attribute_response(char const * attribute_response) {
+        m_attribute_response = attribute_response;
+    }
+
+    /// @brief Sets whether client-side RPC requests (v1/devices/me/rpc/request/$request_id) the device publishes are echoed back as the response with the same payload. The default value is true
+    /// @param echo_rpc Whether client-side RPC requests are echoed back or ignored
+    void set_echo_rpc(bool echo_rpc) {
+        m_echo_rpc = echo_rpc;
+    }
+
+    /// @brief Sets the firmware binary, which is used to answer firmware chunk requests (v2/fw/request/$request_id/chunk/$chunk) the device publishes,
+    /// the chunk size is parsed from the request payload the same way the ThingsBoard server does. Overrides any firmware previously set with set_firmware_file()
+    /// @param firmware Firmware binary data, not copied meaning it has to stay valid, nullptr disables answering firmware chunk requests
+    /// @param firmware_size Size of the firmware binary data in bytes
+    void set_firmware(uint8_t const * firmware, size_t const & firmware_size) {
+        close_firmware_file();
+        m_firmware = firmware;
+        m_firmware_size = firmware_size;
+    }
+
+    /// @brief Sets the file containing the firmware binary, which is used to answer firmware chunk requests (v2/fw/request/$request_id/chunk/$chunk) the device publishes,
+    /// the requested chunk is only read from the file once it is delivered, meaning even big firmware binaries do not have to be kept in memory. Overrides any firmware previously set with set_firmware()
+    /// @param path Path to the file containing the firmware binary
+    /// @return Whether the file could be opened and its size could be determined or not
+    bool set_firmware_file(char const * path) {
+        set_firmware(nullptr, 0U);
+        m_firmware_file = fopen(path, "rb");
+        if (m_firmware_file == nullptr) {
+            return false;
+        }
+        long size = -1;
+        if (fseek(m_firmware_file, 0, SEEK_END) == 0) {
+            size = ftell(m_firmware_file);
+        }
+        if (size < 0) {
+            close_firmware_file();
+            return false;
+        }
+        m_firmware_size = size;
+        return true;
+    }
+
+    /// @brief Gets the size of the previously set firmware binary, allows to create the matching fw_size shared attribute for injected firmware update messages
+    /// @return Size of the firmware binary in bytes, 0 if no firmware has been set
+    size_t const & get_firmware_size() const {
+        return m_firmware_size;
+    }
+
+    /// @brief Sets the latency of every response or injected message, meaning how many loop() calls have to happen after it was queued until it is delivered. The default value is 0,
+    /// meaning it is delivered in the next loop() call. Counting calls instead of time keeps the results reproducible independent of the speed of the host running the test
+    /// @param latency Amount of loop() calls until a queued message is delivered
+    void set_latency(uint32_t latency) {
+        m_latency = latency;
+    }
+
+    /// @brief Sets the percentage of responses and injected messages that are lost instead of being delivered, which messages are lost is decided by a pseudo random number generator with the given seed,
+    /// meaning the same seed and the same sequence of messages always results in the same messages being lost. The default value is 0, meaning no message is lost
+    /// @param loss_percentage Percentage of messages that are lost, 100 or more means every message is lost
+    /// @param seed Non zero start value of the pseudo random number generator
+    void set_loss(uint8_t loss_percentage, uint32_t seed = 1U) {
+        m_loss_percentage = loss_percentage;
+        m_random_state = (seed != 0U) ? seed : 1U;
+    }
+
+    /// @brief Sets after how many published messages since the last call to connect() the connection is dropped, the same way it would be if the network connection was lost.
+    /// Dropping the connection discards all pending messages and subscriptions, meaning the device has to call connect() and resubscribe again. The default value is 0, meaning the connection is never dropped
+    /// @param disconnect_interval Amount of published messages after which the connection is dropped
+    void set_disconnect_interval(size_t disconnect_interval) {
+        m_disconnect_interval = disconnect_interval;
+    }
+
+    /// @brief Sets whether following calls to connect() are refused, the same way they would be if the server responded with the CONNACK return code 5 (not authorized),
+    /// because the device has been deleted or its credentials have been changed on the server. The default value is false, meaning every connection attempt succeeds
+    /// @param reject_credentials Whether connection attempts are refused because of the sent credentials
+    void set_reject_credentials(bool reject_credentials) {
+        m_reject_credentials = reject_credentials;
+    }
+
+    /// @brief Immediately drops the connection, the same way it would be if the network connection was lost.
+    /// Discards all pending messages and subscriptions, meaning the device has to call connect() and resubscribe again
+    void drop_connection() {
+        m_connected = false;
+        m_pending_count = 0U;
+        for (auto & subscription : m_subscriptions) {
+            subscription[0U] = '\0';
+        }
+    }
+
+    /// @brief Queues a message that is delivered to the device as if the ThingsBoard server had sent it, allows to simulate any server-side message,
+    /// for example a shared attribute update (v1/devices/me/attributes) or a server-side RPC request (v1/devices/me/rpc/request/$request_id)
+    /// @param topic Topic the message is delivered on, only delivered if the device is subscribed to it once it is due
+    /// @param payload Payload of the message, copied into the internal pending message
+    /// @param length Size of the payload in bytes, messages bigger than the receive buffer are rejected, because their payload would not fit into the internal pending message
+    /// @return Whether the message could be queued or not
+    bool inject(char const * topic, uint8_t const * payload, size_t const & length) {
+        Pending_Message * message = enqueue(topic, length, false);
+        if (message == nullptr) {
+            return false;
+        }
+        if (length != 0U) {
+            (void)memcpy(get_payload(*message), payload, length);
+        }
+        return true;
+    }
+
+    /// @brief Gets the amount of messages the device has published since the client was created
+    /// @return Amount of published messages
+    size_t const & get_published_count() const {
+        return m_published_count;
+    }
+
+    /// @brief Gets the amount of messages that have been delivered to the device since the client was created, messages delivered in fragments count once
+    /// @return Amount of delivered messages
+    size_t const & get_delivered_count() const {
+        return m_delivered_count;
+    }
+
+    /// @brief Gets the amount of messages that have been lost since the client was created, because of the simulated loss, because the device was not subscribed or because they did not fit into the buffer
+    /// @return Amount of lost messages
+    size_t const & get_dropped_count() const {
+        return m_dropped_count;
+    }
+
+    /// @brief Gets the amount of messages that are currently queued and have not been delivered yet
+    /// @return Amount of pending messages
+    size_t const & get_pending_count() const {
+        return m_pending_count;
+    }
+
+    void set_data_callback(Callback<void, char *, uint8_t *, unsigned int>::function callback) override {
+        m_received_data_callback.Set_Callback(callback);
+    }
+
+    void set_data_fragment_callback(Callback<void, char *, uint8_t *, unsigned int, unsigned int, unsigned int>::function callback) override {
+        m_received_data_fragment_callback.Set_Callback(callback);
+    }
+
+    bool supports_fragmented_receive() override {
+        return m_fragmented_receive;
+    }
+
+    void set_publish_acknowledged_callback(Callback<void, uint16_t>::function callback) override {
+        m_publish_acknowledged_callback.Set_Callback(callback);
+    }
+
+    void set_connect_callback(Callback<void>::function callback) override {
+        m_connected_callback.Set_Callback(callback);
+    }
+
+    bool set_buffer_size(uint16_t receive_buffer_size, uint16_t send_buffer_size) override {
+        if (receive_buffer_size == 0U || send_buffer_size == 0U) {
+            return false;
+        }
+        // Pending messages keep their payload in the pool, changing its layout would corrupt them, therefore they are discarded the same way a real client would discard partially received data
+        uint8_t * payload_pool = static_cast<uint8_t *>(realloc(m_payload_pool, MaxPendingMessages * receive_buffer_size));
+        if (payload_pool == nullptr) {
+            return false;
+        }
+        m_payload_pool = payload_pool;
+        m_receive_buffer_size = receive_buffer_size;
+        m_pending_count = 0U;
+        uint8_t * send_buffer = static_cast<uint8_t *>(realloc(m_send_buffer, send_buffer_size));
+        if (send_buffer == nullptr) {
+            return false;
+        }
+        m_send_buffer = send_buffer;
+        m_send_buffer_size = send_buffer_size;
+        return true;
+    }
+
+    uint16_t get_receive_buffer_size() override {
+        return m_receive_buffer_size;
+    }
+
+    uint16_t get_send_buffer_size() override {
+        return m_send_buffer_size;
+    }
+
+    void set_server(char const * domain, uint16_t port) override {
+        // Nothing to do, because the messages never leave the process
+    }
+
+    bool connect(char const * client_id, char const * user_name, char const * password) override {
+        if (m_payload_pool == nullptr || m_send_buffer == nullptr) {
+            return false;
+        }
+        // Connecting with a clean session, the same way the other clients do, discards everything from the previous session
+        drop_connection();
+        m_authentication_rejected = m_reject_credentials;
+        if (m_authentication_rejected) {
+            return false;
+        }
+        m_connected = true;
+        m_published_since_connect = 0U;
+        m_connected_callback.Call_Callback();
+        return true;
+    }
+
+    void disconnect() override {
+        drop_connection();
+    }
+
+    bool loop() override {
+        if (!m_connected) {
+            return false;
+        }
+        m_tick++;
+        // Only deliver the messages that were already queued before this call, because delivering a message might queue the next response,
+        // which would otherwise be delivered in the same call if the latency is 0, making the loop() call never return during an over the air update
+        size_t deliverable = m_pending_count;
+        while (m_connected && deliverable > 0U && m_pending_count > 0U && m_pending_messages[m_pending_head].due_tick <= m_tick) {
+            deliver(m_pending_messages[m_pending_head]);
+            // Delivering might have dropped the connection and therefore cleared the queue already
+            if (m_pending_count > 0U) {
+                m_pending_head = (m_pending_head + 1U) % MaxPendingMessages;
+                m_pending_count--;
+            }
+            deliverable--;
+        }
+        return m_connected;
+    }
+
+    bool publish(char const * topic, uint8_t const * payload, size_t const & length) override {
+        uint16_t packet_id = 0U;
+        return publish(topic, payload, length, 0U, packet_id);
+    }
+
+    bool publish(char const * topic, uint8_t const * payload, size_t const & length, uint8_t qos, uint16_t & packet_id) override {
+        if (!m_connected || qos > 1U) {
+            return false;
+        }
+        else if (length > m_send_buffer_size) {
+            return false;
+        }
+        packet_id = 0U;
+        if (qos != 0U) {
+            // Packet identifier 0 is not allowed by the MQTT specification
+            m_packet_id = (m_packet_id == UINT16_MAX) ? 1U : m_packet_id + 1U;
+            packet_id = m_packet_id;
+            // The acknowledgement is queued like any other message, meaning it is delayed by the configured latency and can be lost as well
+            Pending_Message * acknowledgement = enqueue(topic, 0U, false);
+            if (acknowledgement != nullptr) {
+                acknowledgement->acknowledgement = true;
+                acknowledgement->packet_id = packet_id;
+            }
+        }
+        handle_publish(topic, payload, length);
+        return true;
+    }
+
+    bool subscribe(char const * topic) override {
+        if (!m_connected || strlen(topic) >= MAX_LOOPBACK_TOPIC_SIZE) {
+            return false;
+        }
+        for (auto & subscription : m_subscriptions) {
+            if (subscription[0U] == '\0' || strncmp(subscription, topic, MAX_LOOPBACK_TOPIC_SIZE) == 0) {
+                (void)strncpy(subscription, topic, MAX_LOOPBACK_TOPIC_SIZE);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Messages are not sent over any network, therefore the default implementation subscribing each topic seperately is used
+    using IMQTT_Client::subscribe;
+
+    bool unsubscribe(char const * topic) override {
+        if (!m_connected) {
+            return false;
+        }
+        for (auto & subscription : m_subscriptions) {
+            if (strncmp(subscription, topic, MAX_LOOPBACK_TOPIC_SIZE) == 0) {
+                subscription[0U] = '\0';
+            }
+        }
+        return true;
+    }
+
+    bool connected() override {
+        return m_connected;
+    }
+
+    bool authentication_rejected() override {
+        return m_authentication_rejected;
+    }
+
+#if THINGSBOARD_ENABLE_STREAM_UTILS
+
+    bool begin_publish(char const * topic, size_t const & length) override {
+        if (!m_connected || length > m_send_buffer_size || strlen(topic) >= MAX_LOOPBACK_TOPIC_SIZE) {
+            return false;
+        }
+        (void)strncpy(m_stream_topic, topic, MAX_LOOPBACK_TOPIC_SIZE);
+        m_stream_length = 0U;
+        return true;
+    }
+
+    bool end_publish() override {
+        if (!m_connected) {
+            return false;
+        }
+        handle_publish(m_stream_topic, m_send_buffer, m_stream_length);
+        return true;
+    }
+
+    //----------------------------------------------------------------------------
+    // Print interface
+    //----------------------------------------------------------------------------
+
+    size_t write(uint8_t payload_byte) override {
+        return write(&payload_byte, 1U);
+    }
+
+    size_t write(uint8_t const * buffer, size_t const & size) override {
+        if (m_stream_length + size > m_send_buffer_size) {
+            return 0U;
+        }
+        (void)memcpy(m_send_buffer + m_stream_length, buffer, size);
+        m_stream_length += size;
+        return size;
+    }
+
+#endif // THINGSBOARD_ENABLE_STREAM_UTILS
+
+  private:
+    /// @brief Message that has been queued and is delivered to the device once it is due, the payload is kept in the part of the payload pool with the same index
+    struct Pending_Message {
+        char     topic[MAX_LOOPBACK_TOPIC_SIZE] = {}; // Topic the message is delivered on
+        size_t   length = {};                         // Size of the payload or of the requested firmware chunk
+        bool     firmware_chunk = {};                 // Whether the payload is read from the firmware binary once the message is delivered, instead of from the payload pool
+        size_t   firmware_offset = {};                // Offset of the requested firmware chunk in the firmware binary
+        bool     acknowledgement = {};                // Whether the message is the acknowledgement of a message published with QoS level 1 instead of a message on the topic
+        uint16_t packet_id = {};                      // Packet identifier of the acknowledged message
+        uint64_t due_tick = {};                       // Value of the loop() call counter at which the message is delivered
+    };
+
+    /// @brief Gets the part of the payload pool reserved for the given pending message
+    /// @param message Pending message we want to get the payload memory for
+    /// @return Pointer to the receive buffer size amount of bytes reserved for the given pending message
+    uint8_t * get_payload(Pending_Message const & message) {
+        return m_payload_pool + ((&message - m_pending_messages) * m_receive_buffer_size);
+    }
+
+    /// @brief Closes the previously opened firmware file if there is one
+    void close_firmware_file() {
+        if (m_firmware_file != nullptr) {
+            (void)fclose(m_firmware_file);
+        }
+        m_firmware_file = nullptr;
+        m_firmware_size = 0U;
+    }
+
+    /// @brief Decides with the seeded pseudo random number generator (xorshift32) whether the next message is lost or not
+    /// @return Whether the next message should be lost or not
+    bool simulate_loss() {
+        if (m_loss_percentage == 0U) {
+            return false;
+        }
+        m_random_state ^= m_random_state << 13U;
+        m_random_state ^= m_random_state >> 17U;
+        m_random_state ^= m_random_state << 5U;
+        return (m_random_state % 100U) < m_loss_percentage;
+    }
+
+    /// @brief Queues a message with the given topic, that is delivered once the configured latency has passed
+    /// @param topic Topic the message is delivered on
+    /// @param length Size of the payload that will be copied into the reserved payload memory, or of the requested firmware chunk
+    /// @param firmware_chunk Whether the payload is read from the firmware binary once the message is delivered, only those messages can be bigger than the receive buffer
+    /// if they are delivered in fragments, because every other payload is copied into the reserved payload memory, which is only receive buffer size bytes big
+    /// @return Pointer to the queued message, or nullptr if the message could not be queued or was lost
+    Pending_Message * enqueue(char const * topic, size_t const & length, bool firmware_chunk) {
+        if (m_payload_pool == nullptr) {
+            return nullptr;
+        }
+        else if (m_pending_count >= MaxPendingMessages) {
+            Logger::printfln(LOOPBACK_QUEUE_FULL, MaxPendingMessages, topic);
+            m_dropped_count++;
+            return nullptr;
+        }
+        else if (strlen(topic) >= MAX_LOOPBACK_TOPIC_SIZE) {
+            Logger::printfln(LOOPBACK_TOPIC_EXCEEDS_BUFFER, topic, MAX_LOOPBACK_TOPIC_SIZE);
+            m_dropped_count++;
+            return nullptr;
+        }
+        else if (simulate_loss()) {
+#if THINGSBOARD_ENABLE_DEBUG
+            Logger::printfln(LOOPBACK_DROPPED_MESSAGE, topic);
+#endif // THINGSBOARD_ENABLE_DEBUG
+            m_dropped_count++;
+            return nullptr;
+        }
+        Pending_Message & message = m_pending_messages[(m_pending_head + m_pending_count) % MaxPendingMessages];
+        (void)strncpy(message.topic, topic, MAX_LOOPBACK_TOPIC_SIZE);
+        message.length = length;
+        message.firmware_chunk = firmware_chunk;
+        message.firmware_offset = 0U;
+        message.acknowledgement = false;
+        message.packet_id = 0U;
+        message.due_tick = m_tick + m_latency + 1U;
+        if (length > m_receive_buffer_size && !(firmware_chunk && m_fragmented_receive)) {
+            Logger::printfln(LOOPBACK_DATA_EXCEEDS_BUFFER, length, m_receive_buffer_size);
+            m_dropped_count++;
+            return nullptr;
+        }
+        m_pending_count++;
+        return &message;
+    }
+
+    /// @brief Handles a message published by the device, answering it the same way the ThingsBoard server would if it is a request
+    /// @param topic Topic the message was published on
+    /// @param payload Payload of the published message
+    /// @param length Size of the payload in bytes
+    void handle_publish(char const * topic, uint8_t const * payload, size_t const & length) {
+        m_published_count++;
+        m_published_callback.Call_Callback(topic, payload, length);
+        char response_topic[MAX_LOOPBACK_TOPIC_SIZE] = {};
+
+        if (m_attribute_response != nullptr && strncmp(topic, LOOPBACK_ATTRIBUTE_REQUEST_TOPIC, strlen(LOOPBACK_ATTRIBUTE_REQUEST_TOPIC)) == 0) {
+            (void)snprintf(response_topic, sizeof(response_topic), LOOPBACK_ATTRIBUTE_RESPONSE_TOPIC, static_cast<unsigned int>(Helper::parseRequestId(LOOPBACK_ATTRIBUTE_REQUEST_TOPIC, topic)));
+            (void)inject(response_topic, reinterpret_cast<uint8_t const *>(m_attribute_response), strlen(m_attribute_response));
+        }
+        else if (m_echo_rpc && strncmp(topic, LOOPBACK_RPC_REQUEST_TOPIC, strlen(LOOPBACK_RPC_REQUEST_TOPIC)) == 0) {
+            (void)snprintf(response_topic, sizeof(response_topic), LOOPBACK_RPC_RESPONSE_TOPIC, static_cast<unsigned int>(Helper::parseRequestId(LOOPBACK_RPC_REQUEST_TOPIC, topic)));
+            (void)inject(response_topic, payload, length);
+        }
+        else if ((m_firmware != nullptr || m_firmware_file != nullptr) && strncmp(topic, LOOPBACK_FIRMWARE_REQUEST_TOPIC, strlen(LOOPBACK_FIRMWARE_REQUEST_TOPIC)) == 0) {
+            queue_firmware_chunk(topic, payload, length);
+        }
+
+        m_published_since_connect++;
+        if (m_disconnect_interval != 0U && m_published_since_connect >= m_disconnect_interval) {
+#if THINGSBOARD_ENABLE_DEBUG
+            Logger::printfln(LOOPBACK_SIMULATED_DISCONNECT, m_published_since_connect);
+#endif // THINGSBOARD_ENABLE_DEBUG
+            drop_connection();
+        }
+    }
+
+    /// @brief Queues the response to a firmware chunk request (v2/fw/request/$request_id/chunk/$chunk), where the payload contains the requested chunk size
+    /// @param topic Topic the request was published on
+    /// @param payload Payload of the request containing the chunk size as a string
+    /// @param length Size of the payload in bytes
+    void queue_firmware_chunk(char const * topic, uint8_t const * payload, size_t const & length) {
+        char const * request_id = topic + strlen(LOOPBACK_FIRMWARE_REQUEST_TOPIC);
+        char const * chunk_separator = strstr(request_id, "/chunk/");
+        if (chunk_separator == nullptr) {
+            return;
+        }
+        char chunk_size_string[12U] = {};
+        (void)memcpy(chunk_size_string, payload, length < sizeof(chunk_size_string) ? length : sizeof(chunk_size_string) - 1U);
+        size_t const chunk_size = strtoul(chunk_size_string, nullptr, 10);
+        size_t const chunk = strtoul(chunk_separator + strlen("/chunk/"), nullptr, 10);
+        size_t const offset = chunk * chunk_size;
+        // The ThingsBoard server responds with an empty payload once the chunk would be after the end of the firmware binary
+        size_t const chunk_length = (offset >= m_firmware_size) ? 0U : ((m_firmware_size - offset) < chunk_size ? (m_firmware_size - offset) : chunk_size);
+
+        char response_topic[MAX_LOOPBACK_TOPIC_SIZE] = {};
+        (void)snprintf(response_topic, sizeof(response_topic), LOOPBACK_FIRMWARE_RESPONSE_TOPIC, static_cast<unsigned int>(strtoul(request_id, nullptr, 10)), static_cast<unsigned int>(chunk));
+        Pending_Message * message = enqueue(response_topic, chunk_length, true);
+        if (message == nullptr) {
+            return;
+        }
+        message->firmware_offset = offset;
+    }
+
+    /// @brief Copies the given part of the firmware binary into the given buffer, either from memory or from the firmware file
+    /// @param buffer Buffer the firmware data should be copied into
+    /// @param offset Offset of the data in the firmware binary
+    /// @param length Amount of bytes that should be copied
+    /// @return Whether the given part of the firmware binary could be copied or not
+    bool read_firmware(uint8_t * buffer, size_t const & offset, size_t const & length) {
+        if (m_firmware != nullptr) {
+            (void)memcpy(buffer, m_firmware + offset, length);
+            return true;
+        }
+        else if (m_firmware_file != nullptr && fseek(m_firmware_file, offset, SEEK_SET) == 0 && fread(buffer, 1U, length, m_firmware_file) == length) {
+            return true;
+        }
+        Logger::printfln(LOOPBACK_FIRMWARE_READ_FAILED, length, offset);
+        return false;
+    }
+
+    /// @brief Checks whether the given topic matches the given topic filter, supporting the single level (+) and multi level (#) wildcards
+    /// @param filter Subscribed topic filter
+    /// @param topic Topic of the message that should be delivered
+    /// @return Whether the topic matches the filter or not
+    static bool topic_matches(char const * filter, char const * topic) {
+        while (*filter != '\0') {
+            if (*filter == '#') {
+                return true;
+            }
+            // ThingsBoard delivers the firmware chunks (v2/fw/response/$request_id/chunk/$chunk) to the v2/fw/response/+ subscription,
+            // therefore a single level wildcard at the end of the filter matches all remaining levels as well to behave the same way
+            else if (*filter == '+' && filter[1U] == '\0') {
+                return true;
+            }
+            else if (*filter == '+') {
+                while (*topic != '\0' && *topic != '/') {
+                    topic++;
+                }
+                filter++;
+                continue;
+            }
+            else if (*filter != *topic) {
+                return false;
+            }
+            filter++;
+            topic++;
+        }
+        return *topic == '\0';
+    }
+
+    /// @brief Delivers the given message to the device, if it is subscribed to its topic. Messages bigger than the receive buffer are delivered in fragments, if that has been enabled.
+    /// Acknowledgements of messages published with QoS level 1 do not require a subscription and are passed to the publish acknowledged callback instead
+    /// @param message Message that should be delivered
+    void deliver(Pending_Message & message) {
+        if (message.acknowledgement) {
+            m_delivered_count++;
+            m_publish_acknowledged_callback.Call_Callback(message.packet_id);
+            return;
+        }
+
+        bool subscribed = false;
+        for (auto const & subscription : m_subscriptions) {
+            if (subscription[0U] != '\0' && topic_matches(subscription, message.topic)) {
+                subscribed = true;
+                break;
+            }
+        }
+        if (!subscribed) {
+            m_dropped_count++;
+            return;
+        }
+
+        uint8_t * payload = get_payload(message);
+        m_delivered_count++;
+        if (message.length <= m_receive_buffer_size) {
+            if (message.firmware_chunk && !read_firmware(payload, message.firmware_offset, message.length)) {
+                return;
+            }
+            m_received_data_callback.Call_Callback(message.topic, payload, message.length);
+            return;
+        }
+
+        // Only firmware chunks can be bigger than the receive buffer, because enqueue() rejects every other message that would not fit into its payload memory
+        for (size_t fragment_offset = 0U; m_connected && fragment_offset < message.length; fragment_offset += m_receive_buffer_size) {
+            size_t const remaining = message.length - fragment_offset;
+            size_t const fragment_size = remaining < m_receive_buffer_size ? remaining : m_receive_buffer_size;
+            if (!read_firmware(payload, message.firmware_offset + fragment_offset, fragment_size)) {
+                return;
+            }
+            m_received_data_fragment_callback.Call_Callback(message.topic, payload, fragment_size, fragment_offset, message.length);
+        }
+    }
+
+    Callback<void, char *, uint8_t *, unsigned int>                             m_received_data_callback = {};                              // Callback that will be called as soon as the mqtt client receives any data
+    Callback<void, char *, uint8_t *, unsigned int, unsigned int, unsigned int> m_received_data_fragment_callback = {};                     // Callback that will be called for every fragment of data that is bigger than the receive buffer
+    Callback<void, uint16_t>                                                    m_publish_acknowledged_callback = {};                       // Callback that will be called as soon as the acknowledgement of a message published with QoS level 1 is delivered
+    Callback<void>                                                              m_connected_callback = {};                                  // Callback that will be called as soon as the mqtt client has connected
+    Callback<void, char const *, uint8_t const *, size_t>                       m_published_callback = {};                                  // Callback that will be called for every message published by the device
+    bool                                                                        m_connected = {};                                           // Whether connect() has been called and the connection has not been dropped since
+    bool                                                                        m_reject_credentials = {};                                  // Whether connection attempts are refused because of the sent credentials
+    bool                                                                        m_authentication_rejected = {};                             // Whether the last connection attempt has been refused because of the sent credentials
+    bool                                                                        m_fragmented_receive = {};                                  // Whether messages bigger than the receive buffer are delivered in fragments or discarded
+    uint16_t                                                                    m_receive_buffer_size = {};                                 // Maximum size of a message that is delivered at once
+    uint16_t                                                                    m_send_buffer_size = {};                                    // Maximum size of a message that can be published at once
+    uint8_t                                                                     *m_payload_pool = {};                                       // Preallocated memory holding the payload of every pending message, receive buffer size bytes each
+    uint8_t                                                                     *m_send_buffer = {};                                        // Preallocated buffer the payload is collected in when using begin_publish()
+    Pending_Message                                                             m_pending_messages[MaxPendingMessages];                     // Ring buffer of messages that are queued for delivery
+    size_t                                                                      m_pending_head = {};                                        // Index of the oldest pending message in the ring buffer
+    size_t                                                                      m_pending_count = {};                                       // Amount of pending messages in the ring buffer
+    uint16_t                                                                    m_packet_id = {};                                           // Packet identifier of the last message published with QoS level 1
+    char                                                                        m_subscriptions[MaxSubscriptions][MAX_LOOPBACK_TOPIC_SIZE]; // Subscribed topic filters, empty strings are unused entries
+    char const                                                                  *m_attribute_response = {};                                 // Json response sent for every attribute request
+    bool                                                                        m_echo_rpc = {};                                            // Whether client-side RPC requests are echoed back
+    uint8_t const                                                               *m_firmware = {};                                           // Firmware binary in memory used to answer firmware chunk requests
+    FILE                                                                        *m_firmware_file = {};                                      // File containing the firmware binary used to answer firmware chunk requests
+    size_t                                                                      m_firmware_size = {};                                       // Size of the firmware binary in bytes
+    uint32_t                                                                    m_latency = {};                                             // Amount of loop() calls until a queued message is delivered
+    uint8_t                                                                     m_loss_percentage = {};                                     // Percentage of messages that are lost instead of being queued
+    uint32_t                                                                    m_random_state = {};                                        // State of the pseudo random number generator used to decide which messages are lost
+    size_t                                                                      m_disconnect_interval = {};                                 // Amount of published messages after which the connection is dropped
+    uint64_t                                                                    m_tick = {};                                                // Amount of loop() calls since the client was created
+    size_t                                                                      m_published_count = {};                                     // Amount of messages published by the device
+    size_t                                                                      m_published_since_connect = {};                             // Amount of messages published by the device since the last call to connect()
+    size_t                                                                      m_delivered_count = {};                                     // Amount of messages delivered to the device
+    size_t                                                                      m_dropped_count = {};                                       // Amount of messages that were lost or could not be delivered
+#if THINGSBOARD_ENABLE_STREAM_UTILS
+    char                                                                        m_stream_topic[MAX_LOOPBACK_TOPIC_SIZE];                    // Topic of the message started with begin_publish()
+    size_t                                                                      m_stream_length = {};                                       // Amount of payload bytes written since begin_publish()
+#endif // THINGSBOARD_ENABLE_STREAM_UTILS
+};
+
+#endif // Loopback_MQTT_Client_h
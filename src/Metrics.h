@@ -0,0 +1,228 @@
+#ifndef Metrics_h
+#define Metrics_h
+
+// Local include.
+#include "Configuration.h"
+
+#if THINGSBOARD_ENABLE_METRICS
+
+// Library includes.
+#if THINGSBOARD_ENABLE_STL
+#include <atomic>
+#endif // THINGSBOARD_ENABLE_STL
+#if THINGSBOARD_USE_ESP_TIMER
+#include <esp_timer.h>
+#elif !defined(ARDUINO)
+#include <time.h>
+#endif // THINGSBOARD_USE_ESP_TIMER
+#include <stdint.h>
+#include <stddef.h>
+
+
+// Upper bounds in microseconds of the buckets of each latency histogram, values bigger than the last bound are counted in an additional last bucket
+uint32_t constexpr LATENCY_BUCKET_BOUNDS[] = { 100U, 500U, 1000U, 5000U, 10000U, 50000U, 100000U, 500000U, 1000000U };
+size_t constexpr LATENCY_BUCKET_AMOUNT = (sizeof(LATENCY_BUCKET_BOUNDS) / sizeof(LATENCY_BUCKET_BOUNDS[0])) + 1U;
+// Percentile that is published for each latency histogram
+uint8_t constexpr LATENCY_PERCENTILE = 90U;
+
+
+/// @brief Counter that can be increased from multiple tasks without a lock, uses 32-bit values, because bigger atomics are not lock-free on most 32-bit microcontrollers.
+/// Counters are reset each time the metrics are published, meaning they only have to count the events of one interval and will not overflow in practice
+#if THINGSBOARD_ENABLE_STL
+using Metric_Counter = std::atomic<uint32_t>;
+#else
+using Metric_Counter = uint32_t;
+#endif // THINGSBOARD_ENABLE_STL
+
+
+/// @brief Static helper class for reading and writing metric counters, used so the same code works with atomic and plain counters
+class Metric {
+  public:
+    /// @brief Increases the given counter by the given amount
+    /// @param counter Counter that should be increased
+    /// @param amount Amount the counter should be increased by, default = 1
+    static void increment(Metric_Counter & counter, uint32_t amount = 1U) {
+#if THINGSBOARD_ENABLE_STL
+        (void)counter.fetch_add(amount, std::memory_order_relaxed);
+#else
+        counter += amount;
+#endif // THINGSBOARD_ENABLE_STL
+    }
+
+    /// @brief Sets the given counter to the given value, if the value is bigger than the current value of the counter
+    /// @param counter Counter that should hold the maximum value
+    /// @param value Value that should be compared with the current maximum
+    static void update_maximum(Metric_Counter & counter, uint32_t value) {
+#if THINGSBOARD_ENABLE_STL
+        uint32_t current = counter.load(std::memory_order_relaxed);
+        while (value > current && !counter.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+            // Nothing to do, current has been updated with the value set by the other task, therefore we simply compare again
+        }
+#else
+        if (value > counter) {
+            counter = value;
+        }
+#endif // THINGSBOARD_ENABLE_STL
+    }
+
+    /// @brief Returns the current value of the given counter without resetting it
+    /// @param counter Counter that should be read
+    /// @return Current value of the counter
+    static uint32_t read(Metric_Counter const & counter) {
+#if THINGSBOARD_ENABLE_STL
+        return counter.load(std::memory_order_relaxed);
+#else
+        return counter;
+#endif // THINGSBOARD_ENABLE_STL
+    }
+
+    /// @brief Returns the current value of the given counter and resets it to 0 in the same operation, so that no event is lost between reading and resetting
+    /// @param counter Counter that should be read and reset
+    /// @return Value of the counter before it was reset
+    static uint32_t take(Metric_Counter & counter) {
+#if THINGSBOARD_ENABLE_STL
+        return counter.exchange(0U, std::memory_order_relaxed);
+#else
+        uint32_t const value = counter;
+        counter = 0U;
+        return value;
+#endif // THINGSBOARD_ENABLE_STL
+    }
+
+    /// @brief Gets the current time in microseconds, used to measure the latencies recorded in the histograms
+    /// @return Current time in microseconds
+    static uint64_t get_time_microseconds() {
+#if THINGSBOARD_USE_ESP_TIMER
+        return esp_timer_get_time();
+#elif defined(ARDUINO)
+        return micros();
+#else
+        timespec time = {};
+        (void)clock_gettime(CLOCK_MONOTONIC, &time);
+        return (static_cast<uint64_t>(time.tv_sec) * 1000000U) + (time.tv_nsec / 1000U);
+#endif // THINGSBOARD_USE_ESP_TIMER
+    }
+};
+
+
+/// @brief Snapshot of a latency histogram, taken once the metrics are published, contains the aggregated values of all latencies recorded in the last interval
+struct Latency_Snapshot {
+    uint32_t count;      // Amount of recorded latencies
+    uint32_t average;    // Average of the recorded latencies in microseconds
+    uint32_t maximum;    // Biggest recorded latency in microseconds
+    uint32_t percentile; // Upper bound of the bucket that contains the LATENCY_PERCENTILE of the recorded latencies in microseconds, or the maximum if it is in the last bucket
+};
+
+
+/// @brief Histogram with fixed buckets that counts how many recorded latencies were in the range of each bucket.
+/// Recording a latency only increases lock-free counters, meaning it can be done from any task without blocking
+class Latency_Histogram {
+  public:
+    /// @brief Constructor
+    Latency_Histogram()
+      : m_buckets()
+      , m_count(0U)
+      , m_sum(0U)
+      , m_maximum(0U)
+    {
+        // Nothing to do
+    }
+
+    /// @brief Records the time that has passed since the given start time
+    /// @param start_time Time in microseconds returned by Metric::get_time_microseconds() when the measured operation was started
+    void record_since(uint64_t const & start_time) {
+        record(Metric::get_time_microseconds() - start_time);
+    }
+
+    /// @brief Records the given latency in the bucket it falls into
+    /// @param latency Latency in microseconds, values that do not fit into 32-bit are clamped
+    void record(uint64_t const & latency) {
+        uint32_t const value = latency > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(latency);
+        size_t bucket = 0U;
+        while (bucket < LATENCY_BUCKET_AMOUNT - 1U && value > LATENCY_BUCKET_BOUNDS[bucket]) {
+            bucket++;
+        }
+        Metric::increment(m_buckets[bucket]);
+        Metric::increment(m_count);
+        Metric::increment(m_sum, value);
+        Metric::update_maximum(m_maximum, value);
+    }
+
+    /// @brief Aggregates the latencies recorded since the last snapshot and resets the histogram
+    /// @return Aggregated values of the latencies recorded since the last snapshot
+    Latency_Snapshot take_snapshot() {
+        uint32_t buckets[LATENCY_BUCKET_AMOUNT] = {};
+        for (size_t i = 0U; i < LATENCY_BUCKET_AMOUNT; i++) {
+            buckets[i] = Metric::take(m_buckets[i]);
+        }
+        Latency_Snapshot snapshot = {};
+        snapshot.count = Metric::take(m_count);
+        uint32_t const sum = Metric::take(m_sum);
+        snapshot.average = snapshot.count == 0U ? 0U : sum / snapshot.count;
+        snapshot.maximum = Metric::take(m_maximum);
+        snapshot.percentile = snapshot.maximum;
+
+        // The percentile is the upper bound of the first bucket, where the amount of latencies up to and including that bucket exceeds the percentile of all latencies
+        uint32_t const percentile_count = static_cast<uint32_t>((static_cast<uint64_t>(snapshot.count) * LATENCY_PERCENTILE + 99U) / 100U);
+        uint32_t cumulative = 0U;
+        for (size_t i = 0U; i < LATENCY_BUCKET_AMOUNT - 1U; i++) {
+            cumulative += buckets[i];
+            if (cumulative >= percentile_count && cumulative != 0U) {
+                snapshot.percentile = LATENCY_BUCKET_BOUNDS[i] < snapshot.maximum ? LATENCY_BUCKET_BOUNDS[i] : snapshot.maximum;
+                break;
+            }
+        }
+        return snapshot;
+    }
+
+  private:
+    Metric_Counter m_buckets[LATENCY_BUCKET_AMOUNT]; // Amount of latencies recorded in each bucket
+    Metric_Counter m_count;                          // Amount of recorded latencies
+    Metric_Counter m_sum;                            // Sum of the recorded latencies in microseconds
+    Metric_Counter m_maximum;                        // Biggest recorded latency in microseconds
+};
+
+
+/// @brief Metrics recorded by the ThingsBoard client and the API implementations, only exists if THINGSBOARD_ENABLE_METRICS is set.
+/// Members are public, because they are only counters, that are increased from the places where the event they count occurs
+struct Metrics {
+    Metric_Counter    publishes = {};            // Amount of successfully published messages
+    Metric_Counter    publish_failures = {};     // Amount of messages that could not be published by the underlying client
+    Metric_Counter    bytes_sent = {};           // Amount of payload bytes of the successfully published messages
+    Metric_Counter    messages_received = {};    // Amount of received messages, messages received in fragments are only counted once
+    Metric_Counter    bytes_received = {};       // Amount of received payload bytes
+    Metric_Counter    allocation_failures = {};  // Amount of failed allocations of json documents or client buffers
+    Metric_Counter    max_document_size = {};    // Biggest size of the json document allocated to deserialize a received message
+    Latency_Histogram serialization = {};        // Time needed to serialize json documents before they are published
+    Latency_Histogram deserialization = {};      // Time needed to deserialize received messages into json documents
+    Latency_Histogram ota_chunk_round_trip = {}; // Time between requesting and completly receiving a firmware chunk
+};
+
+
+/// @brief Peak memory requirements of the json documents and buffers used to send and receive messages, only exists if THINGSBOARD_ENABLE_METRICS is set.
+/// In comparison to the Metrics they are not reset when the metrics are published, because they should show the biggest requirement since the device started,
+/// which allows to right-size max_stack_size, max_response_size, the payload sizes and the MaxResponse template argument for each device class instead of guessing them
+struct Memory_High_Water_Marks {
+    Metric_Counter    max_required_document_size = {};  // Biggest size the JsonDocument used to deserialize a received message needed, even if the message was discarded because the size was bigger than allowed
+    Metric_Counter    max_allocated_document_size = {}; // Biggest capacity of the JsonDocument actually allocated to deserialize a received message
+    Metric_Counter    max_received_document_usage = {}; // Biggest amount of bytes actually used in the JsonDocument after deserializing a received message
+    Metric_Counter    max_sent_document_usage = {};     // Biggest amount of bytes used in a JsonDocument that was serialized to be sent
+    Metric_Counter    max_stack_json_size = {};         // Biggest serialized json message that was allocated on the stack, because it was smaller than max_stack_size
+    Metric_Counter    max_heap_json_size = {};          // Biggest serialized json message that was allocated on the heap, because it was bigger than max_stack_size
+    Metric_Counter    max_streamed_json_size = {};      // Biggest serialized json message that was directly streamed into the client, because it was bigger than the client buffer
+    Metric_Counter    stack_serializations = {};        // Amount of json messages that were serialized into a buffer on the stack
+    Metric_Counter    heap_serializations = {};         // Amount of json messages that were serialized into a buffer on the heap
+    Metric_Counter    streamed_serializations = {};     // Amount of json messages that were directly streamed into the client
+    Metric_Counter    allocation_failures = {};         // Amount of failed allocations of json documents or client buffers since the device started
+};
+
+
+/// @brief Metrics recorded for each API implementation, that has been subscribed to the ThingsBoard client
+struct API_Metrics {
+    Metric_Counter    dispatches = {};           // Amount of received messages that were passed to the API implementation
+    Latency_Histogram handler = {};              // Time the API implementation needed to process the received messages, contains the time the user callbacks needed as well (server-side RPC, shared attribute update, ...)
+};
+
+#endif // THINGSBOARD_ENABLE_METRICS
+
+#endif // Metrics_h
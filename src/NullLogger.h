@@ -0,0 +1,21 @@
+#ifndef Null_Logger_h
+#define Null_Logger_h
+
+
+/// @brief Logger class that discards all messages, can be passed instead of the DefaultLogger to remove all logging from the library at compile time.
+/// Because the methods are empty and inlined, the compiler removes the calls completly, including the log messages themselves if they are not referenced anywhere else.
+/// Debug messages can additionally be removed, without removing error messages, by not setting THINGSBOARD_ENABLE_DEBUG
+class NullLogger {
+  public:
+    /// @brief Discards the given format message and arguments
+    /// @tparam ...Args Additional arguments that would have been inserted into the format message
+    /// @param format Formatting message that is discarded
+    /// @param ...args Arguments that are discarded
+    /// @return Always 0, because nothing was printed
+    template<typename ...Args>
+    static int printfln(char const * format, Args const &... args) {
+        return 0;
+    }
+};
+
+#endif // Null_Logger_h
@@ -6,15 +6,20 @@
 #include "Shared_Attribute_Update.h"
 #include "OTA_Handler.h"
 #include "IAPI_Implementation.h"
+#include "Topic_Builder.h"
 
 
-uint8_t constexpr MAX_FW_TOPIC_SIZE = 33U;
-uint8_t constexpr OTA_ATTRIBUTE_KEYS_AMOUNT = 5U;
+uint8_t constexpr OTA_ATTRIBUTE_KEYS_AMOUNT = 6U;
 char constexpr NO_FW_REQUEST_RESPONSE[] = "Did not receive requested shared attribute firmware keys. Ensure keys exist and device is connected";
 // Firmware topics.
-char constexpr FIRMWARE_RESPONSE_TOPIC[] = "v2/fw/response/%u/chunk/";
+char constexpr FIRMWARE_RESPONSE_TOPIC[] = "v2/fw/response/";
 char constexpr FIRMWARE_RESPONSE_SUBSCRIBE_TOPIC[] = "v2/fw/response/+";
-char constexpr FIRMWARE_REQUEST_TOPIC[] = "v2/fw/request/%u/chunk/%u";
+char constexpr FIRMWARE_REQUEST_TOPIC[] = "v2/fw/request/";
+char constexpr FIRMWARE_CHUNK_TOPIC[] = "/chunk/";
+// Amount of bytes the receive buffer needs additionally to the chunk itself, to hold the MQTT header and the response topic
+uint8_t constexpr FIRMWARE_RESPONSE_OVERHEAD = 50U;
+// Size of the firmware topics, big enough to hold the request id, the chunk topic part and the chunk index
+size_t constexpr MAX_FW_TOPIC_SIZE = sizeof(FIRMWARE_RESPONSE_TOPIC) + sizeof(FIRMWARE_CHUNK_TOPIC) + (2U * MAX_NUMBER_CHARACTERS);
 // Firmware data keys.
 char constexpr CURR_FW_TITLE_KEY[] = "current_fw_title";
 char constexpr CURR_FW_VER_KEY[] = "current_fw_version";
@@ -25,16 +30,23 @@ char constexpr FW_TITLE_KEY[] = "fw_title";
 char constexpr FW_CHKS_KEY[] = "fw_checksum";
 char constexpr FW_CHKS_ALGO_KEY[] = "fw_checksum_algorithm";
 char constexpr FW_SIZE_KEY[] = "fw_size";
+// Optional shared attribute that is not set by the server itself, contains the signature of the firmware binary, which is passed to the firmware verifier if one is set
+char constexpr FW_SIGNATURE_KEY[] = "fw_signature";
+// Biggest signature that can be cached including the null terminator, enough for the hex representation of HMAC codes of all supported algorithms, as well as ECDSA P-256 or P-384 and Ed25519 signatures
+size_t constexpr MAX_FW_SIGNATURE_SIZE = 256U;
 char constexpr CHECKSUM_AGORITM_MD5[] = "MD5";
 char constexpr CHECKSUM_AGORITM_SHA256[] = "SHA256";
 char constexpr CHECKSUM_AGORITM_SHA384[] = "SHA384";
 char constexpr CHECKSUM_AGORITM_SHA512[] = "SHA512";
 // Log messages.
-char constexpr NUMBER_PRINTF[] = "%u";
 char constexpr NO_FW[] = "Missing shared attribute firmware keys. Ensure you assigned an OTA update with binary";
 char constexpr EMPTY_FW[] = "Received shared attribute firmware keys were NULL";
 char constexpr FW_NOT_FOR_US[] = "Received firmware title (%s) is different and not meant for this device (%s)";
 char constexpr FW_CHKS_ALGO_NOT_SUPPORTED[] = "Received checksum algorithm (%s) is not supported";
+char constexpr FW_SIGNATURE_TOO_LONG[] = "Received signature is longer than (%u) characters and has been ignored";
+char constexpr FW_SIGNATURE_INVALID[] = "Firmware verifier rejected the missing or invalid fw_signature shared attribute";
+char constexpr FW_CHKS_INVALID[] = "Received checksum (%s) is not a valid hex representation of a (%s) hash";
+char constexpr CHUNK_SIZE_EXCEEDS_BUFFER[] = "Chunk size (%u) together with the response overhead (%u) exceeds the biggest possible receive buffer size (%u), decrease OTA chunk size";
 char constexpr NOT_ENOUGH_RAM[] = "Temporary allocating more internal client buffer failed, decrease OTA chunk size or decrease overall heap usage";
 char constexpr RESETTING_FAILED[] = "Preparing for OTA firmware updates failed, attributes might be NULL";
 #if THINGSBOARD_ENABLE_DEBUG
@@ -62,22 +74,26 @@ class OTA_Firmware_Update : public IAPI_Implementation {
       , m_get_send_size_callback()
       , m_set_buffer_size_callback()
       , m_get_request_id_callback()
+      , m_get_fragmented_receive_callback()
       , m_fw_callback()
       , m_previous_buffer_size(0U)
       , m_changed_buffer_size(false)
+      , m_response_subscribed(false)
+      , m_fw_signature()
 #if THINGSBOARD_ENABLE_STL
-      , m_ota(std::bind(&OTA_Firmware_Update::Publish_Chunk_Request, this, std::placeholders::_1, std::placeholders::_2), std::bind(&OTA_Firmware_Update::Firmware_Send_State, this, std::placeholders::_1, std::placeholders::_2), std::bind(&OTA_Firmware_Update::Firmware_OTA_Unsubscribe, this))
+      , m_ota(std::bind(&OTA_Firmware_Update::Publish_Chunk_Request, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3), std::bind(&OTA_Firmware_Update::Firmware_Send_State, this, std::placeholders::_1, std::placeholders::_2), std::bind(&OTA_Firmware_Update::Firmware_OTA_Unsubscribe, this), std::bind(&OTA_Firmware_Update::Firmware_Resize_Buffer, this, std::placeholders::_1))
 #else
-      , m_ota(OTA_Firmware_Update::staticPublishChunk, OTA_Firmware_Update::staticFirmwareSend, OTA_Firmware_Update::staticUnsubscribe)
+      , m_ota(OTA_Firmware_Update::staticPublishChunk, OTA_Firmware_Update::staticFirmwareSend, OTA_Firmware_Update::staticUnsubscribe, OTA_Firmware_Update::staticResizeBuffer)
 #endif // THINGSBOARD_ENABLE_STL
       , m_response_topic()
+      , m_request_topic()
       , m_fw_attribute_update()
       , m_fw_attribute_request()
     {
         // Can be ignored, because the topic is set correctly once we start an update anyway, therefore we simply insert 0 as the request id for now.
         // It just has to be set to an actual value that is not an empty string, because that would make the internal callback receive all other responses from the server as well,
         // even if they are not meant for this class and we are not currently updating the device
-        (void)snprintf(m_response_topic, sizeof(m_response_topic), FIRMWARE_RESPONSE_TOPIC, 0U);
+        (void)m_response_topic.set_prefix(FIRMWARE_RESPONSE_TOPIC, 0U, FIRMWARE_CHUNK_TOPIC);
 #if !THINGSBOARD_ENABLE_STL
         m_subscribedInstance = nullptr;
 #endif // !THINGSBOARD_ENABLE_STL
@@ -97,7 +113,7 @@ class OTA_Firmware_Update : public IAPI_Implementation {
         }
 
         // Request the firmware information
-        constexpr char const * array[OTA_ATTRIBUTE_KEYS_AMOUNT] = {FW_CHKS_KEY, FW_CHKS_ALGO_KEY, FW_SIZE_KEY, FW_TITLE_KEY, FW_VER_KEY};
+        constexpr char const * array[OTA_ATTRIBUTE_KEYS_AMOUNT] = {FW_CHKS_KEY, FW_CHKS_ALGO_KEY, FW_SIZE_KEY, FW_TITLE_KEY, FW_VER_KEY, FW_SIGNATURE_KEY};
 #if THINGSBOARD_ENABLE_DYNAMIC
 #if THINGSBOARD_ENABLE_STL
         const Attribute_Request_Callback fw_request_callback(std::bind(&OTA_Firmware_Update::Firmware_Shared_Attribute_Received, this, std::placeholders::_1), callback.Get_Timeout(), std::bind(&OTA_Firmware_Update::Request_Timeout, this), array + 0U, array + OTA_ATTRIBUTE_KEYS_AMOUNT);
@@ -135,7 +151,7 @@ class OTA_Firmware_Update : public IAPI_Implementation {
         }
 
         // Subscribes to changes of the firmware information
-        char const * array[OTA_ATTRIBUTE_KEYS_AMOUNT] = {FW_CHKS_KEY, FW_CHKS_ALGO_KEY, FW_SIZE_KEY, FW_TITLE_KEY, FW_VER_KEY};
+        char const * array[OTA_ATTRIBUTE_KEYS_AMOUNT] = {FW_CHKS_KEY, FW_CHKS_ALGO_KEY, FW_SIZE_KEY, FW_TITLE_KEY, FW_VER_KEY, FW_SIGNATURE_KEY};
 #if THINGSBOARD_ENABLE_DYNAMIC
 #if THINGSBOARD_ENABLE_STL
         const Shared_Attribute_Callback fw_update_callback(std::bind(&OTA_Firmware_Update::Firmware_Shared_Attribute_Received, this, std::placeholders::_1), array + 0U, array + OTA_ATTRIBUTE_KEYS_AMOUNT);
@@ -182,10 +198,10 @@ class OTA_Firmware_Update : public IAPI_Implementation {
     }
 
     void Process_Response(char const * topic, uint8_t * payload, unsigned int length) override {
-        size_t const & request_id = m_fw_callback.Get_Request_ID();
-        char response_topic[Helper::detectSize(FIRMWARE_RESPONSE_TOPIC, request_id)] = {};
-        (void)snprintf(response_topic, sizeof(response_topic), FIRMWARE_RESPONSE_TOPIC, request_id);
-        size_t const chunk = Helper::parseRequestId(response_topic, topic);
+        // The response topic already contains the request id of the current update and has been checked to be the prefix of the received topic in Compare_Response_Topic,
+        // therefore the chunk index can be parsed directly from the remaining topic suffix, without formatting the response topic again for every received chunk.
+        // The payload is passed as is, so it is written from the receive buffer of the client directly into the updater and the hash without any intermediate copies
+        size_t const chunk = m_response_topic.parse_number(topic);
         m_ota.Process_Firmware_Packet(chunk, payload, length);
     }
 
@@ -193,8 +209,13 @@ class OTA_Firmware_Update : public IAPI_Implementation {
         // Nothing to do
     }
 
+    void Process_Response_Fragment(char const * topic, uint8_t * payload, unsigned int length, unsigned int offset, unsigned int total_length) override {
+        size_t const chunk = m_response_topic.parse_number(topic);
+        m_ota.Process_Firmware_Fragment(chunk, payload, length, offset, total_length);
+    }
+
     bool Compare_Response_Topic(char const * topic) const override {
-        return strncmp(m_response_topic, topic, strlen(m_response_topic)) == 0;
+        return m_response_topic.matches_prefix(topic);
     }
 
     bool Unsubscribe() override {
@@ -203,6 +224,11 @@ class OTA_Firmware_Update : public IAPI_Implementation {
     }
 
     bool Resubscribe_Topic() override {
+        // The firmware response topic is only needed while an update is ongoing, the new session has to subscribe it again in that case
+        if (!m_response_subscribed) {
+            return true;
+        }
+        m_response_subscribed = false;
         return Firmware_OTA_Subscribe();
     }
 
@@ -217,6 +243,12 @@ class OTA_Firmware_Update : public IAPI_Implementation {
         m_subscribe_api_callback.Call_Callback(m_fw_attribute_request);
     }
 
+#if THINGSBOARD_ENABLE_METRICS
+    void Set_Metrics(Metrics & metrics) override {
+        m_ota.Set_Metrics(&metrics);
+    }
+#endif // THINGSBOARD_ENABLE_METRICS
+
     void Set_Client_Callbacks(Callback<void, IAPI_Implementation &>::function subscribe_api_callback, Callback<bool, char const * const, JsonDocument const &, size_t const &>::function send_json_callback, Callback<bool, char const * const, char const * const>::function send_json_string_callback, Callback<bool, char const * const>::function subscribe_topic_callback, Callback<bool, char const * const>::function unsubscribe_topic_callback, Callback<uint16_t>::function get_receive_size_callback, Callback<uint16_t>::function get_send_size_callback, Callback<bool, uint16_t, uint16_t>::function set_buffer_size_callback, Callback<size_t *>::function get_request_id_callback) override {
         m_subscribe_api_callback.Set_Callback(subscribe_api_callback);
         m_send_json_callback.Set_Callback(send_json_callback);
@@ -229,6 +261,10 @@ class OTA_Firmware_Update : public IAPI_Implementation {
         m_get_request_id_callback.Set_Callback(get_request_id_callback);
     }
 
+    void Set_Fragmented_Receive_Callback(Callback<bool>::function get_fragmented_receive_callback) override {
+        m_get_fragmented_receive_callback.Set_Callback(get_fragmented_receive_callback);
+    }
+
   private:
     /// @brief Checks the included information in the callback,
     /// and attempts to sends the current device firmware information to the cloud
@@ -254,20 +290,26 @@ class OTA_Firmware_Update : public IAPI_Implementation {
 
         m_fw_callback = callback;
         m_fw_callback.Set_Request_ID(++request_id);
-        (void)snprintf(m_response_topic, sizeof(m_response_topic), FIRMWARE_RESPONSE_TOPIC, request_id);
+        // Both topics only change once per update, therefore the request id is formatted into their prefix once here, so each chunk request only has to append the chunk index
+        (void)m_response_topic.set_prefix(FIRMWARE_RESPONSE_TOPIC, request_id, FIRMWARE_CHUNK_TOPIC);
+        (void)m_request_topic.set_prefix(FIRMWARE_REQUEST_TOPIC, request_id, FIRMWARE_CHUNK_TOPIC);
         return true;
     }
 
     /// @brief Subscribes to the firmware response topic
     /// @return Whether subscribing to the firmware response topic was successful or not
     bool Firmware_OTA_Subscribe() {
+        if (m_response_subscribed) {
+            return true;
+        }
         if (!m_subscribe_topic_callback.Call_Callback(FIRMWARE_RESPONSE_SUBSCRIBE_TOPIC)) {
-            char message[strlen(SUBSCRIBE_TOPIC_FAILED) + strlen(FIRMWARE_RESPONSE_SUBSCRIBE_TOPIC) + 2] = {};
+            char message[Helper::calculateFormatSize<decltype(FIRMWARE_RESPONSE_SUBSCRIBE_TOPIC)>(sizeof(SUBSCRIBE_TOPIC_FAILED))] = {};
             (void)snprintf(message, sizeof(message), SUBSCRIBE_TOPIC_FAILED, FIRMWARE_RESPONSE_SUBSCRIBE_TOPIC);
             Logger::printfln(message);
             Firmware_Send_State(FW_STATE_FAILED, message);
             return false;
         }
+        m_response_subscribed = true;
         return true;
     }
 
@@ -280,29 +322,57 @@ class OTA_Firmware_Update : public IAPI_Implementation {
         // buffer size would allow, therefore we return to the previous value to decrease overall memory usage
         if (m_changed_buffer_size) {
             (void)m_set_buffer_size_callback.Call_Callback(m_previous_buffer_size, m_get_send_size_callback.Call_Callback());
+            m_changed_buffer_size = false;
         }
         // Reset now not needed private member variables
         m_fw_callback = OTA_Update_Callback();
-        // Unsubscribe from the topic
+        // Unsubscribe from the topic, if it was subscribed at all. Stopping an update that never started calls this method as well
+        if (!m_response_subscribed) {
+            return true;
+        }
+        m_response_subscribed = false;
         return m_unsubscribe_topic_callback.Call_Callback(FIRMWARE_RESPONSE_SUBSCRIBE_TOPIC);
     }
 
+    /// @brief Increases the receive buffer size of the underlying client, if it is too small to receive chunks with the given size and the client can not receive them in fragments instead.
+    /// The previous buffer size is cached the first time it is changed, so it can be restored once the update has been finished
+    /// @param chunk_size Size of the chunks that will be requested from the server
+    /// @return Whether the receive buffer is big enough to receive chunks with the given size or not
+    bool Firmware_Resize_Buffer(uint16_t const & chunk_size) {
+        // Calculated with a bigger type than the buffer size, because the chunk size together with the overhead might not fit into it anymore
+        size_t const required_buffer_size = static_cast<size_t>(chunk_size) + FIRMWARE_RESPONSE_OVERHEAD;
+        // Clients that receive messages bigger than their receive buffer in fragments, allow to stream the chunk into the updater and the hash in pieces,
+        // therefore the receive buffer can keep its fixed size, no matter how big the requested chunks are
+        if (m_get_fragmented_receive_callback.Call_Callback() || m_get_receive_size_callback.Call_Callback() >= required_buffer_size) {
+            return true;
+        }
+        if (required_buffer_size > UINT16_MAX) {
+            Logger::printfln(CHUNK_SIZE_EXCEEDS_BUFFER, chunk_size, FIRMWARE_RESPONSE_OVERHEAD, UINT16_MAX);
+            return false;
+        }
+        uint16_t const previous_buffer_size = m_get_receive_size_callback.Call_Callback();
+        if (!m_set_buffer_size_callback.Call_Callback(static_cast<uint16_t>(required_buffer_size), m_get_send_size_callback.Call_Callback())) {
+            return false;
+        }
+        // Only cache the buffer size the first time it is changed, because that is the value configured by the user before the update
+        if (!m_changed_buffer_size) {
+            m_previous_buffer_size = previous_buffer_size;
+            m_changed_buffer_size = true;
+        }
+        return true;
+    }
+
     /// @brief Publishes a request for the given firmware chunk
-    /// @param request_id Request ID corresponding to the extact OTA update package we want to request chunks from
+    /// @param request_id Request ID corresponding to the extact OTA update package we want to request chunks from, is already contained in the prefix of the request topic,
+    /// because the OTA handler always passes the request id of the update callback that set that prefix
     /// @param request_chunck Chunk index that should be requested from the server
+    /// @param chunk_size Size of the chunk that should be requested from the server, the index is relative to this size
     /// @return Whether publishing the message was successful or not
-    bool Publish_Chunk_Request(size_t const & request_id, size_t const & request_chunck) {
-        // Calculate the number of chuncks we need to request,
-        // in order to download the complete firmware binary
-        uint16_t const & chunk_size = m_fw_callback.Get_Chunk_Size();
-
+    bool Publish_Chunk_Request(size_t const & request_id, size_t const & request_chunck, uint16_t const & chunk_size) {
         // Convert the interger size into a readable string
-        char size[Helper::detectSize(NUMBER_PRINTF, chunk_size)] = {};
-        (void)snprintf(size, sizeof(size), NUMBER_PRINTF, chunk_size);
-
-        char topic[Helper::detectSize(FIRMWARE_REQUEST_TOPIC, request_id, request_chunck)] = {};
-        (void)snprintf(topic, sizeof(topic), FIRMWARE_REQUEST_TOPIC, request_id, request_chunck);
-        return m_send_json_string_callback.Call_Callback(topic, size);
+        char size[MAX_NUMBER_CHARACTERS + 1U] = {};
+        size[Helper::writeNumber(size, chunk_size)] = '\0';
+        return m_send_json_string_callback.Call_Callback(m_request_topic.build(request_chunck), size);
     }
 
     /// @brief Handler if the firmware shared attribute request times out without getting a response.
@@ -312,10 +382,35 @@ class OTA_Firmware_Update : public IAPI_Implementation {
         Firmware_Send_State(FW_STATE_FAILED, NO_FW_REQUEST_RESPONSE);
     }
 
+    /// @brief Copies the given value of the fw_signature shared attribute, so it can be passed to the firmware verifier once the firmware information is received.
+    /// Signatures that do not fit into the internal buffer are discarded, which causes verifiers that require a signature to reject the update
+    /// @param signature Received value of the fw_signature shared attribute, nullptr if the attribute was set to null
+    void Cache_Firmware_Signature(char const * signature) {
+        m_fw_signature[0] = '\0';
+        if (signature == nullptr) {
+            return;
+        }
+        size_t const length = strlen(signature);
+        if (length >= sizeof(m_fw_signature)) {
+            Logger::printfln(FW_SIGNATURE_TOO_LONG, MAX_FW_SIGNATURE_SIZE - 1U);
+            return;
+        }
+        (void)memcpy(m_fw_signature, signature, length + 1U);
+    }
+
     /// @brief Callback that will be called upon firmware shared attribute arrival
     /// @param data Json data containing key-value pairs for the needed firmware information,
     /// to ensure we have a firmware assigned and can start the update over MQTT
     void Firmware_Shared_Attribute_Received(JsonObjectConst const & data) {
+        // The signature is cached, because it is set by the user and therefore most likely updated seperately before the firmware is assigned to the device,
+        // updates that only changed the signature do not contain any firmware information and therefore only update the cached value
+        if (data.containsKey(FW_SIGNATURE_KEY)) {
+            Cache_Firmware_Signature(data[FW_SIGNATURE_KEY]);
+            if (!data.containsKey(FW_VER_KEY)) {
+                return;
+            }
+        }
+
         // Check if firmware is available for our device
         if (!data.containsKey(FW_VER_KEY) || !data.containsKey(FW_TITLE_KEY) || !data.containsKey(FW_CHKS_KEY) || !data.containsKey(FW_CHKS_ALGO_KEY) || !data.containsKey(FW_SIZE_KEY)) {
             Logger::printfln(NO_FW);
@@ -346,7 +441,7 @@ class OTA_Firmware_Update : public IAPI_Implementation {
         // If firmware title is not the same, we do not initiate an update, because we expect the binary to be for another type of device
         // and downloading it on this device could possibly cause hardware issues or even destroy the device
         else if (strncmp(curr_fw_title, fw_title, strlen(curr_fw_title)) != 0) {
-            char message[strlen(FW_NOT_FOR_US) + strlen(fw_title) + strlen(curr_fw_title) + 3] = {};
+            char message[Helper::calculateFormatSize<char const *, char const *>(sizeof(FW_NOT_FOR_US))] = {};
             (void)snprintf(message, sizeof(message), FW_NOT_FOR_US, fw_title, curr_fw_title);
             Logger::printfln(message);
             Firmware_Send_State(FW_STATE_FAILED, message);
@@ -368,13 +463,31 @@ class OTA_Firmware_Update : public IAPI_Implementation {
             fw_checksum_algorithm = mbedtls_md_type_t::MBEDTLS_MD_SHA512;
         }
         else {
-            char message[strlen(FW_CHKS_ALGO_NOT_SUPPORTED) + strlen(fw_algorithm) + 2] = {};
+            char message[Helper::calculateFormatSize<char const *>(sizeof(FW_CHKS_ALGO_NOT_SUPPORTED))] = {};
             (void)snprintf(message, sizeof(message), FW_CHKS_ALGO_NOT_SUPPORTED, fw_algorithm);
             Logger::printfln(message);
             Firmware_Send_State(FW_STATE_FAILED, message);
             return;
         }
 
+        // Parse the expected checksum into its raw bytes once, so the final verification can compare exactly the digest length of the algorithm,
+        // additionally ensures that an empty or truncated checksum is rejected, before the update is even started
+        uint8_t fw_checksum_bytes[MBEDTLS_MD_MAX_SIZE] = {};
+        if (!Helper::parseHexString(fw_checksum, fw_checksum_bytes, HashGenerator::mbedtls_type_to_size(fw_checksum_algorithm))) {
+            char message[Helper::calculateFormatSize<char const *, char const *>(sizeof(FW_CHKS_INVALID))] = {};
+            (void)snprintf(message, sizeof(message), FW_CHKS_INVALID, fw_checksum, fw_algorithm);
+            Logger::printfln(message);
+            Firmware_Send_State(FW_STATE_FAILED, message);
+            return;
+        }
+
+        IFirmware_Verifier * verifier = m_fw_callback.Get_Verifier();
+        if (verifier != nullptr && !verifier->set_signature(Helper::stringIsNullorEmpty(m_fw_signature) ? nullptr : m_fw_signature)) {
+            Logger::printfln(FW_SIGNATURE_INVALID);
+            Firmware_Send_State(FW_STATE_FAILED, FW_SIGNATURE_INVALID);
+            return;
+        }
+
         m_fw_callback.Call_Update_Starting_Callback();
         bool const result = Firmware_OTA_Subscribe();
         if (!result) {
@@ -385,29 +498,26 @@ class OTA_Firmware_Update : public IAPI_Implementation {
 #if THINGSBOARD_ENABLE_DEBUG
         Logger::printfln(PAGE_BREAK);
         Logger::printfln(NEW_FW);
-        char firmware[strlen(FROM_TOO) + strlen(curr_fw_version) + strlen(fw_version) + 3] = {};
+        char firmware[Helper::calculateFormatSize<char const *, char const *>(sizeof(FROM_TOO))] = {};
         (void)snprintf(firmware, sizeof(firmware), FROM_TOO, curr_fw_version, fw_version);
         Logger::printfln(firmware);
         Logger::printfln(DOWNLOADING_FW);
 #endif // THINGSBOARD_ENABLE_DEBUG
 
-        // Calculate the number of chuncks we need to request,
-        // in order to download the complete firmware binary
-        const uint16_t& chunk_size = m_fw_callback.Get_Chunk_Size();
-
-        // Get the previous buffer size and cache it so the previous settings can be restored.
-        m_previous_buffer_size = m_get_receive_size_callback.Call_Callback();
-        m_changed_buffer_size = m_previous_buffer_size < (chunk_size + 50U);
+        // Adaptive updates start with the minimum chunk size and increase the receive buffer on demand,
+        // otherwise the buffer has to be big enough to receive the fixed chunk size for the whole update
+        uint16_t const chunk_size = m_fw_callback.Get_Adaptive_Chunk_Size() ? m_fw_callback.Get_Min_Chunk_Size() : m_fw_callback.Get_Chunk_Size();
+        m_changed_buffer_size = false;
 
         // Increase size of receive buffer
-        if (m_changed_buffer_size && !m_set_buffer_size_callback.Call_Callback(chunk_size + 50U, m_get_send_size_callback.Call_Callback())) {
+        if (!Firmware_Resize_Buffer(chunk_size)) {
             Logger::printfln(NOT_ENOUGH_RAM);
             Firmware_Send_State(FW_STATE_FAILED, NOT_ENOUGH_RAM);
             m_fw_callback.Call_Callback(false);
             return;
         }
 
-        m_ota.Start_Firmware_Update(m_fw_callback, fw_size, fw_checksum, fw_checksum_algorithm);
+        m_ota.Start_Firmware_Update(m_fw_callback, fw_size, fw_checksum_bytes, fw_checksum_algorithm);
     }
 
 #if !THINGSBOARD_ENABLE_STL
@@ -425,11 +535,18 @@ class OTA_Firmware_Update : public IAPI_Implementation {
         m_subscribedInstance->Request_Timeout();
     }
 
-    static bool staticPublishChunk(size_t const & request_id, size_t const & request_chunck) {
+    static bool staticPublishChunk(size_t const & request_id, size_t const & request_chunck, uint16_t const & chunk_size) {
+        if (m_subscribedInstance == nullptr) {
+            return false;
+        }
+        return m_subscribedInstance->Publish_Chunk_Request(request_id, request_chunck, chunk_size);
+    }
+
+    static bool staticResizeBuffer(uint16_t const & chunk_size) {
         if (m_subscribedInstance == nullptr) {
             return false;
         }
-        return m_subscribedInstance->Publish_Chunk_Request(request_id, request_chunck);
+        return m_subscribedInstance->Firmware_Resize_Buffer(chunk_size);
     }
 
     static bool staticFirmwareSend(char const * current_fw_state, char const * fw_error = nullptr) {
@@ -461,12 +578,16 @@ class OTA_Firmware_Update : public IAPI_Implementation {
     Callback<uint16_t>                                                       m_get_send_size_callback = {};            // Get client send buffer size callback
     Callback<bool, uint16_t, uint16_t>                                       m_set_buffer_size_callback = {};          // Set client buffer size callback
     Callback<size_t *>                                                       m_get_request_id_callback = {};           // Get internal request id callback
+    Callback<bool>                                                           m_get_fragmented_receive_callback = {};   // Get whether the client receives messages bigger than the receive buffer in fragments callback
 
     OTA_Update_Callback                                                      m_fw_callback = {};                       // OTA update response callback
     uint16_t                                                                 m_previous_buffer_size = {};              // Previous buffer size of the underlying client, used to revert to the previously configured buffer size if it was temporarily increased by the OTA update
     bool                                                                     m_changed_buffer_size = {};               // Whether the buffer size had to be changed, because the previous internal buffer size was to small to hold the firmware chunks
+    bool                                                                     m_response_subscribed = {};               // Whether the firmware response topic is currently subscribed, because an update is ongoing
+    char                                                                     m_fw_signature[MAX_FW_SIGNATURE_SIZE] = {}; // Last received value of the optional fw_signature shared attribute, empty if it was never received
     OTA_Handler<Logger>                                                      m_ota = {};                               // Class instance that handles the flashing and creating a hash from the given received binary firmware data
-    char                                                                     m_response_topic[MAX_FW_TOPIC_SIZE] = {}; // Firmware response topic that contains the specific request ID of the firmware we actually want to download
+    Topic_Builder<MAX_FW_TOPIC_SIZE>                                         m_response_topic;                         // Firmware response topic prefix that contains the specific request ID of the firmware we actually want to download
+    Topic_Builder<MAX_FW_TOPIC_SIZE>                                         m_request_topic;                          // Firmware chunk request topic with the specific request ID as part of the prefix and the requested chunk index appended
 #if !THINGSBOARD_ENABLE_DYNAMIC
     Shared_Attribute_Update<1U, OTA_ATTRIBUTE_KEYS_AMOUNT, Logger>           m_fw_attribute_update = {};               // API implementation to be informed if needed fw attributes have been updated
     Attribute_Request<1U, OTA_ATTRIBUTE_KEYS_AMOUNT, Logger>                 m_fw_attribute_request = {};              // API implementation to request the needed fw attributes to start updating
@@ -10,9 +10,18 @@
 #include "OTA_Update_Callback.h"
 #include "OTA_Failure_Response.h"
 #include "Helper.h"
+#include "Metrics.h"
 
 // Library includes.
 #include <string.h>
+#if THINGSBOARD_USE_ESP_TIMER
+#include <esp_timer.h>
+#elif THINGSBOARD_USE_POSIX_TIMER
+#include <time.h>
+#endif // THINGSBOARD_USE_ESP_TIMER
+#if THINGSBOARD_USE_ESP_HEAP
+#include <esp_heap_caps.h>
+#endif // THINGSBOARD_USE_ESP_HEAP
 
 
 // Firmware data keys.
@@ -27,20 +36,32 @@ char constexpr OTA_CB_IS_NULL[] = "OTA update callback is NULL, has it been dele
 char constexpr UNABLE_TO_REQUEST_CHUNCKS[] = "Unable to request firmware chunk";
 char constexpr RECEIVED_UNEXPECTED_CHUNK[] = "Received chunk (%u), not the same as requested chunk (%u)";
 char constexpr RECEIVED_UNEXPECTED_CHUNK_SIZE[] = "Received chunk size (%u), not the same as expected chunk size (%u)";
+char constexpr RECEIVED_UNEXPECTED_FRAGMENT[] = "Received fragment at offset (%u), not the same as expected offset (%u)";
 char constexpr ERROR_UPDATE_BEGIN[] = "Failed to initalize flash updater, ensure that the partition scheme has two app sections";
 char constexpr ERROR_UPDATE_WRITE[] = "Only wrote (%u) bytes of binary data instead of expected (%u)";
 char constexpr ERROR_UPDATE_END[] = "Error during flash updater not all bytes written";
-char constexpr CHECKSUM_VERIFICATION_FAILED[] = "Calculated checksum (%s), not the same as expected checksum (%s)";
+char constexpr CHECKSUM_VERIFICATION_FAILED[] = "Calculated checksum is not the same as expected checksum";
+char constexpr ERROR_VERIFIER_BEGIN[] = "Failed to initalize firmware verifier";
+char constexpr ERROR_VERIFIER_UPDATE[] = "Failed to update firmware verifier with (%u) bytes of binary data";
+char constexpr SIGNATURE_VERIFICATION_FAILED[] = "Signature verification of the received firmware failed";
 char constexpr FW_UPDATE_ABORTED[] = "Firmware update aborted";
 char constexpr CHUNK_REQUEST_TIMED_OUT[] = "Failed to receive requested chunk (%u) in (%llu) us. Internet connection might have been lost";
 #if THINGSBOARD_ENABLE_DEBUG
 char constexpr FW_CHUNK[] = "Receive chunk (%u), with size (%u) bytes";
-char constexpr HASH_EXPECTED[] = "Expected checksum: (%s)";
+char constexpr FW_CHUNK_SIZE_CHANGED[] = "Adapted chunk size from (%u) to (%u) bytes, after round trip time of (%llu) us";
 char constexpr CHECKSUM_VERIFICATION_SUCCESS[] = "Checksum is the same as expected";
+char constexpr SIGNATURE_VERIFICATION_SUCCESS[] = "Signature is valid";
 char constexpr FW_UPDATE_SUCCESS[] = "Update success";
 #endif // THINGSBOARD_ENABLE_DEBUG
-// Maximum size consists of size required for byte representation of the hash * 2 because every byte is 2 hex characters + 1 for null termination
-size_t constexpr FIRMWARE_HASH_SIZE = (MBEDTLS_MD_MAX_SIZE * 2U) + 1;
+// Adaptive chunk size tuning values, the chunk size is only increased if the round trip time of the last chunk was below the given fraction of the timeout
+// and is decreased if it was above the given fraction of the timeout or if the throughput dropped below the given percentage of the previous measurement
+uint8_t constexpr ADAPTIVE_GROW_TIMEOUT_DIVISOR = 4U;
+uint8_t constexpr ADAPTIVE_SHRINK_TIMEOUT_DIVISOR = 2U;
+uint8_t constexpr ADAPTIVE_SHRINK_THROUGHPUT_PERCENTAGE = 75U;
+// Amount of heap in bytes that always has to remain free, additionally to twice the size of the next chunk, before the chunk size is increased
+size_t constexpr ADAPTIVE_HEAP_RESERVE = (16U * 1024U);
+// Biggest chunk size the adaptive chunk size grows to on devices where the free heap memory can not be queried, no matter the configured maximum chunk size
+uint16_t constexpr ADAPTIVE_UNCHECKED_MAX_CHUNK_SIZE = MAX_CHUNK_SIZE;
 
 
 /// @brief Handles the complete processing of received binary firmware data, including flashing it onto the device,
@@ -50,38 +71,57 @@ template <typename Logger>
 class OTA_Handler {
   public:
     /// @brief Constructor
-    /// @param publish_callback Callback that is used to request the firmware chunk of the firmware binary with the given chunk number
+    /// @param publish_callback Callback that is used to request the firmware chunk of the firmware binary with the given chunk number and chunk size
     /// @param send_fw_state_callback Callback that is used to send information about the current state of the over the air update
     /// @param finish_callback Callback that is called once the update has been finished and the user should be informed of the failure or success of the over the air update
-    OTA_Handler(Callback<bool, size_t const &, size_t const &>::function publish_callback, Callback<bool, char const * const, char const * const>::function send_fw_state_callback, Callback<bool>::function finish_callback)
+    /// @param resize_buffer_callback Callback that is used to ensure the underlying client can receive chunks of the given size, before a bigger chunk size is requested
+    OTA_Handler(Callback<bool, size_t const &, size_t const &, uint16_t const &>::function publish_callback, Callback<bool, char const * const, char const * const>::function send_fw_state_callback, Callback<bool>::function finish_callback, Callback<bool, uint16_t const &>::function resize_buffer_callback)
       : m_fw_callback(nullptr)
       , m_publish_callback(publish_callback)
       , m_send_fw_state_callback(send_fw_state_callback)
       , m_finish_callback(finish_callback)
+      , m_resize_buffer_callback(resize_buffer_callback)
       , m_fw_size(0U)
       , m_fw_checksum()
       , m_fw_checksum_algorithm()
+      , m_fw_verifier(nullptr)
       , m_hash()
-      , m_total_chunks(0U)
-      , m_requested_chunks(0U)
+      , m_chunk_size(0U)
+      , m_received_bytes(0U)
+      , m_received_chunk_bytes(0U)
+      , m_request_timestamp(0U)
+      , m_previous_throughput(0U)
       , m_retries(0U)
       , m_watchdog(std::bind(&OTA_Handler::Handle_Request_Timeout, this))
+#if THINGSBOARD_ENABLE_METRICS
+      , m_metrics(nullptr)
+#endif // THINGSBOARD_ENABLE_METRICS
     {
         // Nothing to do
     }
 
+#if THINGSBOARD_ENABLE_METRICS
+    /// @brief Sets the metrics the round trip time of each completly received firmware chunk is recorded in
+    /// @param metrics Metrics of the ThingsBoard client, nullptr if the round trip times should not be recorded
+    void Set_Metrics(Metrics * metrics) {
+        m_metrics = metrics;
+    }
+#endif // THINGSBOARD_ENABLE_METRICS
+
     /// @brief Starts the firmware update with requesting the first firmware packet and initalizes the underlying needed components
     /// @param fw_callback Callback method that contains configuration information, about the over the air update
     /// @param fw_size Complete size of the firmware binary that will be downloaded and flashed onto this device
-    /// @param fw_checksum Checksum of the complete firmware binary, should be the same as the actually written data in the end
+    /// @param fw_checksum Raw checksum bytes of the complete firmware binary, should be the same as the actually written data in the end, has to contain the amount of bytes the given algorithm produces
     /// @param fw_checksum_algorithm Algorithm type used to hash the firmware binary
-    void Start_Firmware_Update(OTA_Update_Callback const & fw_callback, size_t const & fw_size, char const * fw_checksum, mbedtls_md_type_t const & fw_checksum_algorithm) {
+    void Start_Firmware_Update(OTA_Update_Callback const & fw_callback, size_t const & fw_size, uint8_t const * fw_checksum, mbedtls_md_type_t const & fw_checksum_algorithm) {
         m_fw_callback = &fw_callback;
         m_fw_size = fw_size;
-        m_total_chunks = (m_fw_size / m_fw_callback->Get_Chunk_Size()) + 1U;
-        (void)strncpy(m_fw_checksum, fw_checksum, sizeof(m_fw_checksum));
+        // Adaptive updates start with the smallest allowed chunk size and increase it once the link has proven to be fast and stable enough
+        m_chunk_size = m_fw_callback->Get_Adaptive_Chunk_Size() ? m_fw_callback->Get_Min_Chunk_Size() : m_fw_callback->Get_Chunk_Size();
+        (void)memcpy(m_fw_checksum, fw_checksum, HashGenerator::mbedtls_type_to_size(fw_checksum_algorithm));
         m_fw_checksum_algorithm = fw_checksum_algorithm;
         m_fw_updater = m_fw_callback->Get_Updater();
+        m_fw_verifier = m_fw_callback->Get_Verifier();
         Request_First_Firmware_Packet();
         (void)m_send_fw_state_callback.Call_Callback(FW_STATE_DOWNLOADING, "");
     }
@@ -99,12 +139,25 @@ class OTA_Handler {
 
     /// @brief Uses the given firmware packet data and process it. Starting with writing the given amount of bytes of the packet data into flash memory and
     /// into a hash function that will be used to compare the expected complete binary file and the actually received binary file
-    /// @param current_chunk Index of the chunk we recieved the binary data for
+    /// @param current_chunk Index of the chunk we recieved the binary data for, relative to the chunk size it was requested with
     /// @param payload Firmware packet data of the current chunk
     /// @param total_bytes Amount of bytes in the current firmware packet data
     void Process_Firmware_Packet(size_t const & current_chunk, uint8_t * payload, size_t const & total_bytes)  {
-        if (current_chunk != m_requested_chunks) {
-            Logger::printfln(RECEIVED_UNEXPECTED_CHUNK, current_chunk, m_requested_chunks);
+        Process_Firmware_Fragment(current_chunk, payload, total_bytes, 0U, total_bytes);
+    }
+
+    /// @brief Uses the given fragment of the firmware packet data and process it, is used if the firmware packet is bigger than the receive buffer of the client and therefore received in multiple fragments.
+    /// Each fragment is directly written into flash memory and into the hash function, meaning the complete chunk never has to be held in memory at once.
+    /// Once the last fragment of the firmware packet has been processed, the next firmware packet is requested
+    /// @param current_chunk Index of the chunk we recieved the binary data for, relative to the chunk size it was requested with
+    /// @param payload Fragment of the firmware packet data of the current chunk
+    /// @param length Amount of bytes in the current fragment
+    /// @param offset Offset of the current fragment in the firmware packet data
+    /// @param total_bytes Amount of bytes in the complete firmware packet data
+    void Process_Firmware_Fragment(size_t const & current_chunk, uint8_t * payload, size_t const & length, size_t const & offset, size_t const & total_bytes)  {
+        size_t const requested_chunk = Get_Requested_Chunk();
+        if (current_chunk != requested_chunk) {
+            Logger::printfln(RECEIVED_UNEXPECTED_CHUNK, current_chunk, requested_chunk);
             return;
         }
         size_t expected_chunk_size = 0U;
@@ -112,35 +165,74 @@ class OTA_Handler {
             Logger::printfln(RECEIVED_UNEXPECTED_CHUNK_SIZE, expected_chunk_size, total_bytes);
             return;
         }
+        // Fragments of a chunk have to be received in order and without any gaps, because they are directly written into flash memory
+        if (offset != m_received_chunk_bytes) {
+            Logger::printfln(RECEIVED_UNEXPECTED_FRAGMENT, offset, m_received_chunk_bytes);
+            return;
+        }
 
-        m_watchdog.detach();
+        bool const is_last_fragment = offset + length >= total_bytes;
+        uint64_t round_trip_time = 0U;
+        if (is_last_fragment) {
+            m_watchdog.detach();
+            round_trip_time = Get_Time_Microseconds() - m_request_timestamp;
+#if THINGSBOARD_ENABLE_METRICS
+            if (m_metrics != nullptr) {
+                m_metrics->ota_chunk_round_trip.record(round_trip_time);
+            }
+#endif // THINGSBOARD_ENABLE_METRICS
     #if THINGSBOARD_ENABLE_DEBUG
-        Logger::printfln(FW_CHUNK, current_chunk, total_bytes);
+            Logger::printfln(FW_CHUNK, current_chunk, total_bytes);
     #endif // THINGSBOARD_ENABLE_DEBUG
+        }
 
-        if (current_chunk == 0U) {
+        if (m_received_bytes == 0U && offset == 0U) {
             // Initialize Flash
             if (!m_fw_updater->begin(m_fw_size)) {
                 Logger::printfln(ERROR_UPDATE_BEGIN);
                 return Handle_Failure(OTA_Failure_Response::RETRY_UPDATE, ERROR_UPDATE_BEGIN);
             }
+            // Initialize the optional verifier, which is passed the same packets as the updater and the hash
+            if (m_fw_verifier != nullptr && !m_fw_verifier->begin(m_fw_size)) {
+                Logger::printfln(ERROR_VERIFIER_BEGIN);
+                return Handle_Failure(OTA_Failure_Response::RETRY_UPDATE, ERROR_VERIFIER_BEGIN);
+            }
         }
 
         // Write received binary data to flash partition
-        size_t const written_bytes = m_fw_updater->write(payload, total_bytes);
-        if (written_bytes != total_bytes) {
-            char message[Helper::detectSize(ERROR_UPDATE_WRITE, written_bytes, total_bytes)] = {};
-            (void)snprintf(message, sizeof(message), ERROR_UPDATE_WRITE, written_bytes, total_bytes);
+        size_t const written_bytes = m_fw_updater->write(payload, length);
+        if (written_bytes != length) {
+            char message[Helper::calculateFormatSize<unsigned int, unsigned int>(sizeof(ERROR_UPDATE_WRITE))] = {};
+            (void)snprintf(message, sizeof(message), ERROR_UPDATE_WRITE, static_cast<unsigned int>(written_bytes), static_cast<unsigned int>(length));
             Logger::printfln(message);
             return Handle_Failure(OTA_Failure_Response::RETRY_UPDATE, message);
         }
 
         // Update value only if writing to flash was a success, result is ignored,
         // because it can only fail if the input parameters are invalid
-        (void)m_hash.update(payload, total_bytes);
+        (void)m_hash.update(payload, length);
 
-        m_requested_chunks = current_chunk + 1;
-        m_fw_callback->Call_Progress_Callback(m_requested_chunks, m_total_chunks);
+        if (m_fw_verifier != nullptr && !m_fw_verifier->update(payload, length)) {
+            char message[Helper::calculateFormatSize<unsigned int>(sizeof(ERROR_VERIFIER_UPDATE))] = {};
+            (void)snprintf(message, sizeof(message), ERROR_VERIFIER_UPDATE, static_cast<unsigned int>(length));
+            Logger::printfln(message);
+            return Handle_Failure(OTA_Failure_Response::RETRY_UPDATE, message);
+        }
+
+        if (!is_last_fragment) {
+            m_received_chunk_bytes += length;
+            return;
+        }
+        m_received_chunk_bytes = 0U;
+
+        m_received_bytes += total_bytes;
+        if (m_fw_callback->Get_Adaptive_Chunk_Size()) {
+            // Amount of chunks changes with every adaption of the chunk size, therefore the progress is reported in bytes instead
+            m_fw_callback->Call_Progress_Callback(m_received_bytes, m_fw_size);
+        }
+        else {
+            m_fw_callback->Call_Progress_Callback(Get_Requested_Chunk(), Get_Total_Chunks());
+        }
 
         // Ensure to check if the update was cancelled during the progress callback,
         // if it was the callback variable was reset and there is no need to request the next firmware packet
@@ -151,6 +243,9 @@ class OTA_Handler {
 
         // Reset retries as the current chunk has been downloaded and handled successfully
         m_retries = m_fw_callback->Get_Chunk_Retries();
+        if (m_fw_callback->Get_Adaptive_Chunk_Size()) {
+            Adapt_Chunk_Size(total_bytes, round_trip_time);
+        }
         Request_Next_Firmware_Packet();
     }
 
@@ -163,26 +258,108 @@ class OTA_Handler {
 #endif // !THINGSBOARD_USE_ESP_TIMER
 
   private:
-    /// @brief Checks whether the received chunk size matches the expected chunk size, should be the configured chunk size of the OTA_Update_Callback, CHUNK_SIZE (4096) per default
+    /// @brief Gets the index of the currently requested chunk. Because the server splits the firmware binary into chunks of the size passed in the request payload,
+    /// the index is always relative to the current chunk size. The amount of already received bytes is always a multiple of the current chunk size,
+    /// because the chunk size is only ever doubled or halved if the offset is aligned to the new size
+    /// @return Index of the currently requested chunk
+    size_t Get_Requested_Chunk() const {
+        return m_received_bytes / m_chunk_size;
+    }
+
+    /// @brief Gets the total amount of chunks that need to be received to get the complete firmware binary with the current chunk size
+    /// @return Total amount of chunks
+    size_t Get_Total_Chunks() const {
+        return (m_fw_size + m_chunk_size - 1U) / m_chunk_size;
+    }
+
+    /// @brief Checks whether the received chunk size matches the expected chunk size, should be the currently used chunk size, CHUNK_SIZE (4096) per default
     /// and it should be the remaining bytes to fill the total firmware size with the last received chunk. If that is not the case then something went wrong with the request and we have to rerequest that specific chunk,
     /// because if we do not do that we would write missing or only partial binary data to flash and into the hash, meaning the complete OTA update will be invalidated at the end and has to be restarted
     /// @param received_chunk_size Size in bytes of the received chunk
     /// @param expected_chunk_size Variable the expected chunk size for the currently requested chunk will be copied into
     /// @return Whether the received chunk has the expected size or not
-    bool Received_Valid_Chunk_Size(size_t const & received_chunk_size, size_t & expected_chunk_size) {
-        bool const is_last_chunk = m_requested_chunks + 1 >= m_total_chunks;
-        if (is_last_chunk) {
-            size_t const last_chunk_expected_size = m_fw_size % m_fw_callback->Get_Chunk_Size();
-            expected_chunk_size = last_chunk_expected_size;
-            return received_chunk_size == last_chunk_expected_size;
+    bool Received_Valid_Chunk_Size(size_t const & received_chunk_size, size_t & expected_chunk_size) const {
+        size_t const remaining_bytes = m_fw_size - m_received_bytes;
+        expected_chunk_size = remaining_bytes < m_chunk_size ? remaining_bytes : m_chunk_size;
+        return received_chunk_size == expected_chunk_size;
+    }
+
+    /// @brief Gets the current time in microseconds, used to measure the round trip time of each requested chunk
+    /// @return Current time in microseconds
+    static uint64_t Get_Time_Microseconds() {
+#if THINGSBOARD_USE_ESP_TIMER
+        return esp_timer_get_time();
+#elif THINGSBOARD_USE_POSIX_TIMER
+        timespec time = {};
+        (void)clock_gettime(CLOCK_MONOTONIC, &time);
+        return (static_cast<uint64_t>(time.tv_sec) * 1000000U) + (time.tv_nsec / 1000U);
+#else
+        return micros();
+#endif // THINGSBOARD_USE_ESP_TIMER
+    }
+
+    /// @brief Checks whether there is enough free heap memory to receive chunks with the given size.
+    /// If the free heap can not be queried, chunks are instead never grown beyond ADAPTIVE_UNCHECKED_MAX_CHUNK_SIZE,
+    /// because the resize buffer callback might succeed even if the remaining heap memory is not enough for the update to continue
+    /// @param chunk_size Size of the chunks we would like to receive
+    /// @return Whether there is enough free heap memory left
+    static bool Has_Heap_For_Chunk_Size(uint16_t const & chunk_size) {
+#if THINGSBOARD_USE_ESP_HEAP
+        return heap_caps_get_free_size(MALLOC_CAP_8BIT) > (static_cast<size_t>(chunk_size) * 2U) + ADAPTIVE_HEAP_RESERVE;
+#else
+        return chunk_size <= ADAPTIVE_UNCHECKED_MAX_CHUNK_SIZE;
+#endif // THINGSBOARD_USE_ESP_HEAP
+    }
+
+    /// @brief Adapts the chunk size used for the next requests, depending on the round trip time and throughput of the last received chunk and the free heap memory.
+    /// The chunk size is doubled if the link is fast, the throughput did not decrease and there is enough memory to receive the bigger chunk
+    /// and halved if the link is slow or the throughput dropped. Sizes always stay in the range configured in the OTA_Update_Callback
+    /// @param received_bytes Amount of bytes in the last received chunk
+    /// @param round_trip_time Time in microseconds between requesting and receiving the last chunk
+    void Adapt_Chunk_Size(size_t const & received_bytes, uint64_t const & round_trip_time) {
+        uint16_t const previous_chunk_size = m_chunk_size;
+        uint64_t const & timeout = m_fw_callback->Get_Timeout();
+        uint64_t const throughput = round_trip_time == 0U ? UINT64_MAX : (static_cast<uint64_t>(received_bytes) * 1000U * 1000U) / round_trip_time;
+        bool const throughput_dropped = throughput < (m_previous_throughput * ADAPTIVE_SHRINK_THROUGHPUT_PERCENTAGE) / 100U;
+        m_previous_throughput = throughput;
+
+        if (round_trip_time > timeout / ADAPTIVE_SHRINK_TIMEOUT_DIVISOR || throughput_dropped) {
+            Shrink_Chunk_Size();
         }
-        expected_chunk_size = m_fw_callback->Get_Chunk_Size();
-        return received_chunk_size == m_fw_callback->Get_Chunk_Size();
+        else if (round_trip_time < timeout / ADAPTIVE_GROW_TIMEOUT_DIVISOR) {
+            uint32_t const next_chunk_size = static_cast<uint32_t>(m_chunk_size) * 2U;
+            // The offset has to be aligned to the next chunk size, because the server calculates the offset of the requested chunk by multiplying the index with the size
+            if (next_chunk_size <= m_fw_callback->Get_Max_Chunk_Size() && (m_received_bytes % next_chunk_size) == 0U && Has_Heap_For_Chunk_Size(static_cast<uint16_t>(next_chunk_size)) && m_resize_buffer_callback.Call_Callback(static_cast<uint16_t>(next_chunk_size))) {
+                m_chunk_size = static_cast<uint16_t>(next_chunk_size);
+            }
+        }
+
+#if THINGSBOARD_ENABLE_DEBUG
+        if (previous_chunk_size != m_chunk_size) {
+            Logger::printfln(FW_CHUNK_SIZE_CHANGED, previous_chunk_size, m_chunk_size, round_trip_time);
+        }
+#else
+        (void)previous_chunk_size;
+#endif // THINGSBOARD_ENABLE_DEBUG
+    }
+
+    /// @brief Halves the currently used chunk size, as long as it does not fall below the minimum chunk size configured in the OTA_Update_Callback.
+    /// The offset has to stay aligned to the halved size, which is not the case for odd chunk sizes, because the integer division rounds down. In that case the chunk size is kept instead
+    void Shrink_Chunk_Size() {
+        uint16_t const next_chunk_size = m_chunk_size / 2U;
+        if (next_chunk_size == 0U || next_chunk_size < m_fw_callback->Get_Min_Chunk_Size() || (m_received_bytes % next_chunk_size) != 0U) {
+            return;
+        }
+        m_chunk_size = next_chunk_size;
+        // Reset the measured throughput, because the throughput of smaller chunks is expected to be lower, which would otherwise immediately shrink the chunk size again
+        m_previous_throughput = 0U;
     }
 
     /// @brief Restarts or starts the firmware update and its needed components and then requests the first firmware chunk
     void Request_First_Firmware_Packet()  {
-        m_requested_chunks = 0U;
+        m_received_bytes = 0U;
+        m_received_chunk_bytes = 0U;
+        m_previous_throughput = 0U;
         m_retries = m_fw_callback->Get_Chunk_Retries();
         // Hash start result is ignored, because it can only fail if the input parameters are invalid
         (void)m_hash.start(m_fw_checksum_algorithm);
@@ -195,12 +372,13 @@ class OTA_Handler {
     /// and starts the timer that ensures we request the same chunk again if we have not received a response yet
     void Request_Next_Firmware_Packet()  {
         // Check if we have already requested and handled the last remaining chunk
-        if (m_requested_chunks >= m_total_chunks) {
+        if (m_received_bytes >= m_fw_size) {
             Finish_Firmware_Update();   
             return;
         }
 
-        if (!m_publish_callback.Call_Callback(m_fw_callback->Get_Request_ID(), m_requested_chunks)) {
+        m_request_timestamp = Get_Time_Microseconds();
+        if (!m_publish_callback.Call_Callback(m_fw_callback->Get_Request_ID(), Get_Requested_Chunk(), m_chunk_size)) {
             Logger::printfln(UNABLE_TO_REQUEST_CHUNCKS);
         }
 
@@ -217,22 +395,30 @@ class OTA_Handler {
     void Finish_Firmware_Update()  {
         (void)m_send_fw_state_callback.Call_Callback(FW_STATE_DOWNLOADED, "");
 
-        char calculated_checksum[FIRMWARE_HASH_SIZE] = {};
-        // Result of calculating final hash result is ignored,
-        // because it can only fail if the input parameters are invalid and we check it afterwards anyway
-        (void)m_hash.finish(calculated_checksum);
+        uint8_t calculated_checksum[MBEDTLS_MD_MAX_SIZE] = {};
+        bool const finished_hash = m_hash.finish(calculated_checksum);
 
-        if (strncmp(m_fw_checksum, calculated_checksum, strlen(m_fw_checksum)) != 0) {
-            char message[Helper::detectSize(CHECKSUM_VERIFICATION_FAILED, calculated_checksum, m_fw_checksum)] = {};
-            (void)snprintf(message, sizeof(message), CHECKSUM_VERIFICATION_FAILED, calculated_checksum, m_fw_checksum);
-            Logger::printfln(message);
-            return Handle_Failure(OTA_Failure_Response::RETRY_UPDATE, message);
+        // Compare exactly the amount of bytes the used algorithm produces in constant time, the expected checksum has already been validated to contain that many bytes
+        if (!finished_hash || !Helper::constantTimeEquals(m_fw_checksum, calculated_checksum, m_hash.get_size())) {
+            Logger::printfln(CHECKSUM_VERIFICATION_FAILED);
+            return Handle_Failure(OTA_Failure_Response::RETRY_UPDATE, CHECKSUM_VERIFICATION_FAILED);
         }
 
     #if THINGSBOARD_ENABLE_DEBUG
         Logger::printfln(CHECKSUM_VERIFICATION_SUCCESS);
     #endif // THINGSBOARD_ENABLE_DEBUG
 
+        // Signature is only verified once the checksum matched, because the verifier has been passed the exact same data as the hash
+        if (m_fw_verifier != nullptr) {
+            if (!m_fw_verifier->verify()) {
+                Logger::printfln(SIGNATURE_VERIFICATION_FAILED);
+                return Handle_Failure(OTA_Failure_Response::RETRY_UPDATE, SIGNATURE_VERIFICATION_FAILED);
+            }
+    #if THINGSBOARD_ENABLE_DEBUG
+            Logger::printfln(SIGNATURE_VERIFICATION_SUCCESS);
+    #endif // THINGSBOARD_ENABLE_DEBUG
+        }
+
         if (!m_fw_updater->end()) {
             Logger::printfln(ERROR_UPDATE_END);
             return Handle_Failure(OTA_Failure_Response::RETRY_UPDATE, ERROR_UPDATE_END);
@@ -284,25 +470,40 @@ class OTA_Handler {
     /// @brief Callback that will be called if we did not receive the firmware chunk response in the given timeout time
     void Handle_Request_Timeout()  {
         uint64_t const & timeout = m_fw_callback->Get_Timeout();
-        char message[Helper::detectSize(CHUNK_REQUEST_TIMED_OUT, m_requested_chunks, timeout)] = {};
-        (void)snprintf(message, sizeof(message), CHUNK_REQUEST_TIMED_OUT, m_requested_chunks, timeout);
+        size_t const requested_chunk = Get_Requested_Chunk();
+        char message[Helper::calculateFormatSize<unsigned int, unsigned long long>(sizeof(CHUNK_REQUEST_TIMED_OUT))] = {};
+        (void)snprintf(message, sizeof(message), CHUNK_REQUEST_TIMED_OUT, static_cast<unsigned int>(requested_chunk), static_cast<unsigned long long>(timeout));
         Logger::printfln(message);
-        Handle_Failure(OTA_Failure_Response::RETRY_CHUNK, message);
+        // Smaller chunks are more likely to arrive in time on slow or unstable connections
+        if (m_fw_callback->Get_Adaptive_Chunk_Size()) {
+            Shrink_Chunk_Size();
+        }
+        // If only some fragments of the chunk have been received, they have already been written into flash memory and into the hash,
+        // which can not be reverted, therefore the complete update has to be restarted instead of only the current chunk
+        Handle_Failure(m_received_chunk_bytes != 0U ? OTA_Failure_Response::RETRY_UPDATE : OTA_Failure_Response::RETRY_CHUNK, message);
     }
 
-    const OTA_Update_Callback                              *m_fw_callback = {};                    // Callback method that contains configuration information, about the over the air update
-    Callback<bool, size_t const &, size_t const &>         m_publish_callback = {};                // Callback that is used to request the firmware chunk of the firmware binary with the given chunk number
-    Callback<bool, char const * const, char const * const> m_send_fw_state_callback = {};          // Callback that is used to send information about the current state of the over the air update
-    Callback<bool>                                         m_finish_callback = {};                 // Callback that is called once the update has been finished and the user should be informed of the failure or success of the over the air update
-    size_t                                                 m_fw_size = {};                         // Total size of the firmware binary we will receive. Allows for a binary size of up to theoretically 4 GB
-    char                                                   m_fw_checksum[FIRMWARE_HASH_SIZE] = {}; // Checksum of the complete firmware binary, should be the same as the actually written data in the end
-    mbedtls_md_type_t                                      m_fw_checksum_algorithm = {};           // Algorithm type used to hash the firmware binary
-    IUpdater                                               *m_fw_updater = {};                     // Interface implementation that writes received firmware binary data onto the given device
-    HashGenerator                                          m_hash = {};                            // Class instance that allows to generate a hash from received firmware binary data
-    size_t                                                 m_total_chunks = {};                    // Total amount of chunks that need to be received to get the complete firmware binary
-    size_t                                                 m_requested_chunks = {};                // Amount of successfully requested and received firmware binary chunks
-    uint8_t                                                m_retries = {};                         // Amount of request retries we attempt for each chunk, increasing makes the connection more stable
-    Callback_Watchdog                                      m_watchdog = {};                        // Class instances that allows to timeout if we do not receive a response for a requested chunk in the given time
+    const OTA_Update_Callback                                        *m_fw_callback = {};                     // Callback method that contains configuration information, about the over the air update
+    Callback<bool, size_t const &, size_t const &, uint16_t const &> m_publish_callback = {};                 // Callback that is used to request the firmware chunk of the firmware binary with the given chunk number and chunk size
+    Callback<bool, char const * const, char const * const>           m_send_fw_state_callback = {};           // Callback that is used to send information about the current state of the over the air update
+    Callback<bool>                                                   m_finish_callback = {};                  // Callback that is called once the update has been finished and the user should be informed of the failure or success of the over the air update
+    Callback<bool, uint16_t const &>                                 m_resize_buffer_callback = {};           // Callback that is used to ensure the underlying client can receive chunks of the given size
+    size_t                                                           m_fw_size = {};                          // Total size of the firmware binary we will receive. Allows for a binary size of up to theoretically 4 GB
+    uint8_t                                                          m_fw_checksum[MBEDTLS_MD_MAX_SIZE] = {}; // Raw checksum bytes of the complete firmware binary, should be the same as the actually written data in the end
+    mbedtls_md_type_t                                                m_fw_checksum_algorithm = {};            // Algorithm type used to hash the firmware binary
+    IUpdater                                                         *m_fw_updater = {};                      // Interface implementation that writes received firmware binary data onto the given device
+    IFirmware_Verifier                                               *m_fw_verifier = {};                     // Optional interface implementation that verifies the authenticity of the received firmware binary data
+    HashGenerator                                                    m_hash = {};                             // Class instance that allows to generate a hash from received firmware binary data
+    uint16_t                                                         m_chunk_size = {};                       // Size of the currently requested chunks, only changes during the update if the adaptive chunk size is enabled
+    size_t                                                           m_received_bytes = {};                   // Amount of successfully received and handled bytes, offset of the next requested chunk in the firmware binary
+    size_t                                                           m_received_chunk_bytes = {};             // Amount of bytes of the currently requested chunk that have already been received in fragments and handled
+    uint64_t                                                         m_request_timestamp = {};                // Time in microseconds when the currently requested chunk was requested, used to measure the round trip time
+    uint64_t                                                         m_previous_throughput = {};              // Throughput in bytes per second measured for the previously received chunk
+    uint8_t                                                          m_retries = {};                          // Amount of request retries we attempt for each chunk, increasing makes the connection more stable
+    Callback_Watchdog                                                m_watchdog = {};                         // Class instances that allows to timeout if we do not receive a response for a requested chunk in the given time
+#if THINGSBOARD_ENABLE_METRICS
+    Metrics                                                          *m_metrics = {};                         // Metrics of the ThingsBoard client the round trip time of each received chunk is recorded in
+#endif // THINGSBOARD_ENABLE_METRICS
 };
 
 #endif // OTA_Handler_h
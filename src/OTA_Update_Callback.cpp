@@ -6,10 +6,14 @@ OTA_Update_Callback::OTA_Update_Callback(char const * current_fw_title, char con
   , m_current_fw_title(current_fw_title)
   , m_current_fw_version(current_fw_version)
   , m_updater(updater)
+  , m_verifier(nullptr)
   , m_progress_callback(progress_callback)
   , m_update_starting_callback(update_starting_callback)
   , m_chunk_retries(chunk_retries)
   , m_chunk_size(chunk_size)
+  , m_adaptive_chunk_size(false)
+  , m_min_chunk_size(MIN_CHUNK_SIZE)
+  , m_max_chunk_size(MAX_CHUNK_SIZE)
   , m_timeout_microseconds(timeout_microseconds)
 {
     // Nothing to do
@@ -39,6 +43,14 @@ void OTA_Update_Callback::Set_Updater(IUpdater* updater) {
     m_updater = updater;
 }
 
+IFirmware_Verifier * OTA_Update_Callback::Get_Verifier() const {
+    return m_verifier;
+}
+
+void OTA_Update_Callback::Set_Verifier(IFirmware_Verifier* verifier) {
+    m_verifier = verifier;
+}
+
 size_t const & OTA_Update_Callback::Get_Request_ID() const {
     return m_request_id;
 }
@@ -79,6 +91,38 @@ void OTA_Update_Callback::Set_Chunk_Size(uint16_t chunk_size) {
     m_chunk_size = chunk_size;
 }
 
+bool OTA_Update_Callback::Get_Adaptive_Chunk_Size() const {
+    return m_adaptive_chunk_size;
+}
+
+void OTA_Update_Callback::Set_Adaptive_Chunk_Size(bool adaptive_chunk_size) {
+    m_adaptive_chunk_size = adaptive_chunk_size;
+}
+
+uint16_t OTA_Update_Callback::Get_Min_Chunk_Size() const {
+    return m_min_chunk_size;
+}
+
+bool OTA_Update_Callback::Set_Min_Chunk_Size(uint16_t min_chunk_size) {
+    if (min_chunk_size == 0U || min_chunk_size > m_max_chunk_size) {
+        return false;
+    }
+    m_min_chunk_size = min_chunk_size;
+    return true;
+}
+
+uint16_t OTA_Update_Callback::Get_Max_Chunk_Size() const {
+    return m_max_chunk_size;
+}
+
+bool OTA_Update_Callback::Set_Max_Chunk_Size(uint16_t max_chunk_size) {
+    if (max_chunk_size < m_min_chunk_size) {
+        return false;
+    }
+    m_max_chunk_size = max_chunk_size;
+    return true;
+}
+
 uint64_t const & OTA_Update_Callback::Get_Timeout() const {
     return m_timeout_microseconds;
 }
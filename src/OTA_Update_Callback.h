@@ -6,11 +6,14 @@
 
 // Local includes.
 #include "IUpdater.h"
+#include "IFirmware_Verifier.h"
 
 
 // OTA default values.
 uint8_t constexpr CHUNK_RETRIES = 12U;
 uint16_t constexpr CHUNK_SIZE = (4U * 1024U);
+uint16_t constexpr MIN_CHUNK_SIZE = 512U;
+uint16_t constexpr MAX_CHUNK_SIZE = (16U * 1024U);
 uint64_t constexpr REQUEST_TIMEOUT = (5U * 1000U * 1000U);
 
 
@@ -77,6 +80,16 @@ class OTA_Update_Callback : public Callback<void, bool const &> {
     /// @param updater Updater implementation that writes the given firmware data
     void Set_Updater(IUpdater *updater);
 
+    /// @brief Gets the verifier implementation, used to verify the authenticity of the received firmware data, before the update is accepted.
+    /// If no verifier is set, the firmware data is only compared to the checksum sent by the server
+    /// @return Verifier implementation that verifies the given firmware data or nullptr if none has been set
+    IFirmware_Verifier * Get_Verifier() const;
+
+    /// @brief Sets the verifier implementation, used to verify the authenticity of the received firmware data, before the update is accepted.
+    /// The verifier is passed the firmware data in the same packets it is written with, meaning it does not require a second pass over the flash partition, default = nullptr
+    /// @param verifier Verifier implementation that verifies the given firmware data
+    void Set_Verifier(IFirmware_Verifier *verifier);
+
     /// @brief Gets the unique request identifier that is connected to the original request,
     /// and will be later used to verifiy which OTA_Update_Callback
     /// is connected to which received OTA firmware chunk update
@@ -90,8 +103,8 @@ class OTA_Update_Callback : public Callback<void, bool const &> {
     void Set_Request_ID(size_t const & request_id);
 
     /// @brief Calls the progress callback that was subscribed, when this class instance was initally created
-    /// @param current Already received and processs amount of chunks
-    /// @param total Total amount of chunks we need to receive and process until the update has completed
+    /// @param current Already received and processs amount of chunks, or amount of bytes if the adaptive chunk size is enabled
+    /// @param total Total amount of chunks we need to receive and process until the update has completed, or the firmware size in bytes if the adaptive chunk size is enabled
     void Call_Progress_Callback(size_t const & current, size_t const & total) const;
 
     /// @brief Sets the progress callback method.
@@ -135,6 +148,42 @@ class OTA_Update_Callback : public Callback<void, bool const &> {
     /// @param chunk_size Size of each single chunk to be downloaded
     void Set_Chunk_Size(uint16_t chunk_size);
 
+    /// @brief Gets whether the chunk size is adapted during the update instead of using the fixed chunk size.
+    /// If enabled the update starts with the minimum chunk size and measures the round trip time and throughput of each received chunk as well as the free heap memory,
+    /// the chunk size is then doubled if the connection is fast enough and there is enough memory left or halved if the connection is slow, but always stays in the range of the minimum and maximum chunk size
+    /// @return Whether the chunk size is adapted during the update
+    bool Get_Adaptive_Chunk_Size() const;
+
+    /// @brief Sets whether the chunk size is adapted during the update instead of using the fixed chunk size.
+    /// If enabled the update starts with the minimum chunk size and measures the round trip time and throughput of each received chunk as well as the free heap memory,
+    /// the chunk size is then doubled if the connection is fast enough and there is enough memory left or halved if the connection is slow, but always stays in the range of the minimum and maximum chunk size
+    /// @param adaptive_chunk_size Whether the chunk size is adapted during the update
+    void Set_Adaptive_Chunk_Size(bool adaptive_chunk_size);
+
+    /// @brief Gets the smallest chunk size that is used if the adaptive chunk size is enabled, the update will start with this chunk size
+    /// @return Smallest size of each single chunk to be downloaded
+    uint16_t Get_Min_Chunk_Size() const;
+
+    /// @brief Sets the smallest chunk size that is used if the adaptive chunk size is enabled, the update will start with this chunk size.
+    /// Has to be bigger than 0 and can not be bigger than the maximum chunk size, meaning the maximum chunk size has to be increased first, if both are increased
+    /// @param min_chunk_size Smallest size of each single chunk to be downloaded
+    /// @return Whether the given size is valid and has been set, if not the previous size is kept
+    bool Set_Min_Chunk_Size(uint16_t min_chunk_size);
+
+    /// @brief Gets the biggest chunk size that is used if the adaptive chunk size is enabled,
+    /// the internal receive buffer of the client might be increased up to this size during the update
+    /// @return Biggest size of each single chunk to be downloaded
+    uint16_t Get_Max_Chunk_Size() const;
+
+    /// @brief Sets the biggest chunk size that is used if the adaptive chunk size is enabled,
+    /// the internal receive buffer of the client might be increased up to this size during the update.
+    /// On devices where the free heap memory can not be queried (every device where the esp_heap_caps header is not available), the chunk size never grows beyond MAX_CHUNK_SIZE even if a bigger value is set.
+    /// Chunk sizes that together with the response overhead of 50 bytes do not fit into the maximum receive buffer size of 65535 bytes, are only supported by clients that receive messages in fragments.
+    /// Can not be smaller than the minimum chunk size, meaning the minimum chunk size has to be decreased first, if both are decreased
+    /// @param max_chunk_size Biggest size of each single chunk to be downloaded
+    /// @return Whether the given size is valid and has been set, if not the previous size is kept
+    bool Set_Max_Chunk_Size(uint16_t max_chunk_size);
+
     /// @brief Gets the time in microseconds we wait until we declare a single chunk we attempted to download as a failure
     /// @return Timeout time until we expect a response from the server
     uint64_t const & Get_Timeout() const;
@@ -147,11 +196,15 @@ class OTA_Update_Callback : public Callback<void, bool const &> {
     char const                                     *m_current_fw_title = {};        // Current firmware title of device
     char const                                     *m_current_fw_version = {};      // Current firmware version of device
     IUpdater                                       *m_updater = {};                 // Updater implementation used to write firmware data
+    IFirmware_Verifier                             *m_verifier = {};                // Verifier implementation used to verify the authenticity of the firmware data
     size_t                                         m_request_id = {};               // Id the request was called with
     Callback<void, size_t const &, size_t const &> m_progress_callback = {};        // Callback called when amount of downloaded chunks increased
     Callback<void>                                 m_update_starting_callback = {}; // Callback called when update is about to start (moment before topic subscription)
     uint8_t                                        m_chunk_retries = {};            // Maximum amount of retries for a single chunk to be downloaded and flashed successfully
     uint16_t                                       m_chunk_size = {};               // Size of chunks the firmware data will be split into
+    bool                                           m_adaptive_chunk_size = {};      // Whether the chunk size is adapted to the measured connection speed and free heap during the update
+    uint16_t                                       m_min_chunk_size = {};           // Smallest and starting size of chunks if the chunk size is adapted
+    uint16_t                                       m_max_chunk_size = {};           // Biggest size of chunks if the chunk size is adapted
     uint64_t                                       m_timeout_microseconds = {};     // How long we wait for each chunck to arrive before declaring it as failed
 };
 
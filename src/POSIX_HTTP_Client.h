@@ -0,0 +1,695 @@
+#ifndef POSIX_HTTP_Client_h
+#define POSIX_HTTP_Client_h
+
+// Local include.
+#include "Configuration.h"
+
+#if THINGSBOARD_USE_POSIX_SOCKET
+
+// Local includes.
+#include "Constants.h"
+#include "DefaultLogger.h"
+#include "IHTTP_Client.h"
+
+// Library includes.
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+
+constexpr uint32_t POSIX_HTTP_DEFAULT_NETWORK_TIMEOUT_MILLISECONDS = 15000U;
+// Size of the buffer the status line and the headers of a response are read into, has to be big enough to hold the longest single header line.
+// Bytes of the body that are received together with the headers are kept in the same buffer, every other byte of the body is received directly into the buffer passed by the caller
+constexpr size_t POSIX_HTTP_RECEIVE_BUFFER_SIZE = 512U;
+// Maximum size of the request line and the headers of a sent request, the body is sent directly from the string passed by the caller
+constexpr size_t POSIX_HTTP_MAX_REQUEST_HEADER_SIZE = 512U;
+// Amount of bytes read at once when the response body is discarded or copied into a string object
+constexpr size_t POSIX_HTTP_BODY_CHUNK_SIZE = 128U;
+// Return codes, use the same values as the ArduinoHttpClient so the results can be handled the same way
+constexpr int POSIX_HTTP_SUCCESS = 0;
+constexpr int POSIX_HTTP_ERROR_CONNECTION_FAILED = -1;
+constexpr int POSIX_HTTP_ERROR_API = -2;
+constexpr int POSIX_HTTP_ERROR_TIMED_OUT = -3;
+constexpr int POSIX_HTTP_ERROR_INVALID_RESPONSE = -4;
+// Status codes of responses that never contain a body, see https://www.rfc-editor.org/rfc/rfc9112#section-6.3
+constexpr int POSIX_HTTP_STATUS_NO_CONTENT = 204;
+constexpr int POSIX_HTTP_STATUS_NOT_MODIFIED = 304;
+constexpr char POSIX_HTTP_POST[] = "POST";
+constexpr char POSIX_HTTP_GET[] = "GET";
+constexpr char POSIX_HTTP_VERSION_PREFIX[] = "HTTP/1.";
+constexpr char POSIX_HTTP_CONTENT_LENGTH_HEADER[] = "content-length";
+constexpr char POSIX_HTTP_TRANSFER_ENCODING_HEADER[] = "transfer-encoding";
+constexpr char POSIX_HTTP_CONNECTION_HEADER[] = "connection";
+constexpr char POSIX_HTTP_CHUNKED[] = "chunked";
+constexpr char POSIX_HTTP_CLOSE[] = "close";
+constexpr char POSIX_HTTP_KEEP_ALIVE[] = "keep-alive";
+// Log messages.
+constexpr char POSIX_HTTP_RESOLVE_FAILED[] = "Resolving server (%s) failed with error (%s)";
+constexpr char POSIX_HTTP_SOCKET_FAILED[] = "Establishing connection with server (%s:%u) failed with error (%s)";
+constexpr char POSIX_HTTP_NOT_CONFIGURED[] = "Server has not been set, call connect() before sending a request";
+constexpr char POSIX_HTTP_REQUEST_TOO_BIG[] = "Request line and headers for path (%s) exceed the maximum size of (%u) bytes";
+constexpr char POSIX_HTTP_RESPONSE_TIMEOUT[] = "Server did not respond in time (%u ms)";
+constexpr char POSIX_HTTP_INVALID_RESPONSE[] = "Received invalid response, closing connection";
+#if THINGSBOARD_ENABLE_DEBUG
+constexpr char POSIX_HTTP_SOCKET_CLOSED[] = "Connection closed with error (%s)";
+constexpr char POSIX_HTTP_RECONNECTING[] = "Kept alive connection has been closed by the server, reconnecting";
+#endif // THINGSBOARD_ENABLE_DEBUG
+
+
+/// @brief HTTP Client interface implementation that uses POSIX sockets under the hood to send HTTP/1.1 requests and receive their responses,
+/// useful when running on a host operating system like Linux, where neither Arduino nor Espressif IDF is available. Has no dependencies besides the C standard and POSIX socket headers.
+/// If keep alive is enabled the connection is reused for all requests and only re-established if the server closed it in the meantime.
+/// The request line and headers are written into a small buffer on the stack and sent together with the unmodified body in a single call, without concatenating them into another buffer first.
+/// Response bodies with a content length, chunked transfer encoding or delimited by closing the connection are supported and can be read directly into buffers passed by the caller
+/// @tparam Logger Implementation that should be used to print error messages generated by internal processes and additional debugging messages if THINGSBOARD_ENABLE_DEBUG is set, default = DefaultLogger
+template <typename Logger = DefaultLogger>
+class POSIX_HTTP_Client : public IHTTP_Client {
+  public:
+    /// @brief Constructs a IHTTP_Client implementation without a connection, meaning connect() has to be called before sending a request, which the ThingsBoardHttp client does in its constructor
+    POSIX_HTTP_Client()
+      : m_host(nullptr)
+      , m_port(0U)
+      , m_socket(-1)
+      , m_keep_alive(false)
+      , m_network_timeout(POSIX_HTTP_DEFAULT_NETWORK_TIMEOUT_MILLISECONDS)
+      , m_response_state(Response_State::NONE)
+      , m_body_mode(Body_Mode::LENGTH)
+      , m_status_code(POSIX_HTTP_ERROR_API)
+      , m_body_remaining(0U)
+      , m_chunk_end_pending(false)
+      , m_close_after_response(false)
+      , m_buffer()
+      , m_buffer_start(0U)
+      , m_buffer_end(0U)
+    {
+        // Nothing to do
+    }
+
+    /// @brief Destructor
+    ~POSIX_HTTP_Client() {
+        close_socket();
+    }
+
+    /// @brief Sets the maximum time in milliseconds we wait for the connection to be established, the request to be sent or the next bytes of the response to be received,
+    /// before the request is failed and the connection closed. The default value is 15 seconds
+    /// @param network_timeout_milliseconds Timeout for a single network operation
+    void set_network_timeout(uint32_t network_timeout_milliseconds) {
+        m_network_timeout = network_timeout_milliseconds;
+    }
+
+    void set_keep_alive(bool keep_alive) override {
+        m_keep_alive = keep_alive;
+    }
+
+    int connect(char const * host, uint16_t port) override {
+        close_socket();
+        m_host = host;
+        m_port = port;
+        return open_socket() ? POSIX_HTTP_SUCCESS : POSIX_HTTP_ERROR_CONNECTION_FAILED;
+    }
+
+    void stop() override {
+        close_socket();
+    }
+
+    int post(char const * url_path, char const * content_type, char const * request_body) override {
+        return send_request(POSIX_HTTP_POST, url_path, content_type, request_body);
+    }
+
+    int get_response_status_code() override {
+        if (m_response_state != Response_State::STATUS_LINE) {
+            return m_status_code;
+        }
+        m_status_code = read_response_head();
+        if (m_status_code < 0) {
+            close_socket();
+        }
+        return m_status_code;
+    }
+
+    int get(char const * url_path) override {
+        return send_request(POSIX_HTTP_GET, url_path, nullptr, nullptr);
+    }
+
+    size_t read_response_body(uint8_t * buffer, size_t size) override {
+        if (buffer == nullptr || size == 0U || (m_response_state == Response_State::STATUS_LINE && get_response_status_code() < 0)) {
+            return 0U;
+        }
+        while (m_response_state == Response_State::BODY) {
+            size_t received = 0U;
+            switch (m_body_mode) {
+                case Body_Mode::LENGTH:
+                    received = read_body_bytes(buffer, size < m_body_remaining ? size : m_body_remaining);
+                    if (received == 0U) {
+                        close_socket();
+                        return 0U;
+                    }
+                    m_body_remaining -= received;
+                    if (m_body_remaining == 0U) {
+                        finish_response();
+                    }
+                    return received;
+                case Body_Mode::CHUNKED:
+                    if (m_body_remaining == 0U) {
+                        // Reads the size of the next chunk or finishes the response if it was the last chunk, therefore we have to check the state again afterwards
+                        if (!read_chunk_size()) {
+                            close_socket();
+                            return 0U;
+                        }
+                        continue;
+                    }
+                    received = read_body_bytes(buffer, size < m_body_remaining ? size : m_body_remaining);
+                    if (received == 0U) {
+                        close_socket();
+                        return 0U;
+                    }
+                    m_body_remaining -= received;
+                    return received;
+                case Body_Mode::UNTIL_CLOSE:
+                    received = read_body_bytes(buffer, size);
+                    if (received == 0U) {
+                        finish_response();
+                    }
+                    return received;
+                default:
+                    // Nothing to do
+                    break;
+            }
+        }
+        return 0U;
+    }
+
+#if THINGSBOARD_ENABLE_STL
+    std::string get_response_body() override {
+        std::string body;
+        if (get_response_status_code() >= 0 && m_response_state == Response_State::BODY && m_body_mode == Body_Mode::LENGTH) {
+            body.reserve(m_body_remaining);
+        }
+        uint8_t chunk[POSIX_HTTP_BODY_CHUNK_SIZE] = {};
+        for (size_t received = read_response_body(chunk, sizeof(chunk)); received != 0U; received = read_response_body(chunk, sizeof(chunk))) {
+            body.append(reinterpret_cast<char const *>(chunk), received);
+        }
+        return body;
+    }
+#else
+    String get_response_body() override {
+        String body;
+        // Reserve one byte for the null terminator, because the String can only append null terminated strings
+        uint8_t chunk[POSIX_HTTP_BODY_CHUNK_SIZE + 1U] = {};
+        for (size_t received = read_response_body(chunk, POSIX_HTTP_BODY_CHUNK_SIZE); received != 0U; received = read_response_body(chunk, POSIX_HTTP_BODY_CHUNK_SIZE)) {
+            chunk[received] = '\0';
+            body += reinterpret_cast<char const *>(chunk);
+        }
+        return body;
+    }
+#endif // THINGSBOARD_ENABLE_STL
+
+  private:
+    /// @brief State of the response to the last sent request
+    enum class Response_State : uint8_t {
+        NONE,        // No request has been sent or its response has been read completly
+        STATUS_LINE, // Request has been sent, but the status line and headers of the response have not been read yet
+        BODY         // Status line and headers have been read, but the body has not been read completly yet
+    };
+
+    /// @brief How the end of the response body is determined
+    enum class Body_Mode : uint8_t {
+        LENGTH,     // Body has the size given in the Content-Length header
+        CHUNKED,    // Body is split into chunks that are each preceded by their size, the last chunk has a size of 0
+        UNTIL_CLOSE // Body ends once the server closes the connection, meaning the connection can not be reused
+    };
+
+    /// @brief Discards the remaining response of the previous request, if there is any and makes sure the connection is open.
+    /// Reconnects if the server closed the connection that was kept alive since the previous request
+    /// @return Whether the connection is open and ready to send the next request
+    bool prepare_connection() {
+        if (m_response_state != Response_State::NONE) {
+            uint8_t discarded[POSIX_HTTP_BODY_CHUNK_SIZE] = {};
+            while (read_response_body(discarded, sizeof(discarded)) != 0U) {
+                // Nothing to do, the response body is simply discarded
+            }
+        }
+        if (m_socket >= 0 && !peer_closed()) {
+            return true;
+        }
+#if THINGSBOARD_ENABLE_DEBUG
+        if (m_socket >= 0) {
+            Logger::printfln(POSIX_HTTP_RECONNECTING);
+        }
+#endif // THINGSBOARD_ENABLE_DEBUG
+        close_socket();
+        return open_socket();
+    }
+
+    /// @brief Sends a request with the given method, the request line and headers are written into a buffer on the stack and sent together with the unmodified body
+    /// @param method HTTP method of the request (GET or POST)
+    /// @param url_path URL the request should be sent too
+    /// @param content_type Type of the content that is sent, nullptr if the request has no body
+    /// @param request_body Request body containing data of the given content type, nullptr if the request has no body
+    /// @return Whether the request was sent successfully with return code 0 or failed with error code otherwise
+    int send_request(char const * method, char const * url_path, char const * content_type, char const * request_body) {
+        if (m_host == nullptr || url_path == nullptr) {
+            Logger::printfln(POSIX_HTTP_NOT_CONFIGURED);
+            return POSIX_HTTP_ERROR_API;
+        }
+        else if (!prepare_connection()) {
+            return POSIX_HTTP_ERROR_CONNECTION_FAILED;
+        }
+
+        char header[POSIX_HTTP_MAX_REQUEST_HEADER_SIZE] = {};
+        char const * connection = m_keep_alive ? POSIX_HTTP_KEEP_ALIVE : POSIX_HTTP_CLOSE;
+        size_t const body_length = request_body != nullptr ? strlen(request_body) : 0U;
+        int written = 0;
+        if (content_type != nullptr) {
+            written = snprintf(header, sizeof(header), "%s %s HTTP/1.1\r\nHost: %s:%u\r\nConnection: %s\r\nContent-Type: %s\r\nContent-Length: %zu\r\n\r\n", method, url_path, m_host, m_port, connection, content_type, body_length);
+        }
+        else {
+            written = snprintf(header, sizeof(header), "%s %s HTTP/1.1\r\nHost: %s:%u\r\nConnection: %s\r\n\r\n", method, url_path, m_host, m_port, connection);
+        }
+        if (written < 0 || static_cast<size_t>(written) >= sizeof(header)) {
+            Logger::printfln(POSIX_HTTP_REQUEST_TOO_BIG, url_path, POSIX_HTTP_MAX_REQUEST_HEADER_SIZE);
+            return POSIX_HTTP_ERROR_API;
+        }
+
+        iovec vectors[2U] = {};
+        vectors[0U].iov_base = header;
+        vectors[0U].iov_len = written;
+        vectors[1U].iov_base = const_cast<char *>(request_body);
+        vectors[1U].iov_len = body_length;
+        if (!write_all(vectors, body_length != 0U ? 2U : 1U)) {
+            return POSIX_HTTP_ERROR_CONNECTION_FAILED;
+        }
+        m_response_state = Response_State::STATUS_LINE;
+        m_status_code = POSIX_HTTP_ERROR_INVALID_RESPONSE;
+        return POSIX_HTTP_SUCCESS;
+    }
+
+    /// @brief Reads the status line and headers of the response and decides how the end of the body is determined, informational responses (1xx) are skipped
+    /// @return Status code of the response or a negative error code if the response could not be read
+    int read_response_head() {
+        int status_code = 0;
+        bool http_1_0 = false;
+        do {
+            char * line = nullptr;
+            if (!read_line(line)) {
+                return POSIX_HTTP_ERROR_TIMED_OUT;
+            }
+            size_t const prefix_length = strlen(POSIX_HTTP_VERSION_PREFIX);
+            char * status_end = nullptr;
+            if (strncmp(line, POSIX_HTTP_VERSION_PREFIX, prefix_length) != 0 || line[prefix_length] == '\0' || line[prefix_length + 1U] != ' ') {
+                Logger::printfln(POSIX_HTTP_INVALID_RESPONSE);
+                return POSIX_HTTP_ERROR_INVALID_RESPONSE;
+            }
+            http_1_0 = line[prefix_length] == '0';
+            status_code = static_cast<int>(strtol(line + prefix_length + 2U, &status_end, 10));
+            if (status_end == line + prefix_length + 2U || status_code < 100 || status_code > 999) {
+                Logger::printfln(POSIX_HTTP_INVALID_RESPONSE);
+                return POSIX_HTTP_ERROR_INVALID_RESPONSE;
+            }
+            if (!read_headers(http_1_0)) {
+                return POSIX_HTTP_ERROR_INVALID_RESPONSE;
+            }
+        } while (status_code < 200);
+
+        if (status_code == POSIX_HTTP_STATUS_NO_CONTENT || status_code == POSIX_HTTP_STATUS_NOT_MODIFIED) {
+            m_body_mode = Body_Mode::LENGTH;
+            m_body_remaining = 0U;
+        }
+        m_response_state = Response_State::BODY;
+        if (m_body_mode == Body_Mode::UNTIL_CLOSE) {
+            m_close_after_response = true;
+        }
+        else if (m_body_mode == Body_Mode::LENGTH && m_body_remaining == 0U) {
+            finish_response();
+        }
+        return status_code;
+    }
+
+    /// @brief Reads all headers of the response until the empty line that seperates them from the body, only the headers that decide how the body is read and whether the connection can be reused are handled
+    /// @param http_1_0 Whether the server responded with HTTP/1.0, where the connection is closed after the response unless explicitly kept alive
+    /// @return Whether all headers could be read or not
+    bool read_headers(bool const & http_1_0) {
+        bool content_length_received = false;
+        bool chunked = false;
+        bool close = false;
+        bool keep_alive = false;
+        m_body_remaining = 0U;
+        while (true) {
+            char * line = nullptr;
+            if (!read_line(line)) {
+                return false;
+            }
+            else if (line[0U] == '\0') {
+                break;
+            }
+            char * value = strchr(line, ':');
+            if (value == nullptr) {
+                continue;
+            }
+            *value++ = '\0';
+            while (*value == ' ' || *value == '\t') {
+                value++;
+            }
+            // Header names and the values we compare are case-insensitive, see https://www.rfc-editor.org/rfc/rfc9110#section-5.1
+            for (char * character = value; *character != '\0'; character++) {
+                *character = static_cast<char>(tolower(static_cast<unsigned char>(*character)));
+            }
+            if (strcasecmp(line, POSIX_HTTP_CONTENT_LENGTH_HEADER) == 0) {
+                char * length_end = nullptr;
+                m_body_remaining = strtoull(value, &length_end, 10);
+                if (length_end == value) {
+                    Logger::printfln(POSIX_HTTP_INVALID_RESPONSE);
+                    return false;
+                }
+                content_length_received = true;
+            }
+            else if (strcasecmp(line, POSIX_HTTP_TRANSFER_ENCODING_HEADER) == 0) {
+                chunked = strstr(value, POSIX_HTTP_CHUNKED) != nullptr;
+            }
+            else if (strcasecmp(line, POSIX_HTTP_CONNECTION_HEADER) == 0) {
+                close = strstr(value, POSIX_HTTP_CLOSE) != nullptr;
+                keep_alive = strstr(value, POSIX_HTTP_KEEP_ALIVE) != nullptr;
+            }
+        }
+
+        // Chunked transfer encoding takes precedence over the content length, see https://www.rfc-editor.org/rfc/rfc9112#section-6.3
+        if (chunked) {
+            m_body_mode = Body_Mode::CHUNKED;
+            m_body_remaining = 0U;
+            m_chunk_end_pending = false;
+        }
+        else if (content_length_received) {
+            m_body_mode = Body_Mode::LENGTH;
+        }
+        else {
+            m_body_mode = Body_Mode::UNTIL_CLOSE;
+        }
+        m_close_after_response = http_1_0 ? !keep_alive : close;
+        return true;
+    }
+
+    /// @brief Reads the size line of the next chunk, if the previous chunk was the last chunk, the trailing headers are read and the response is finished instead
+    /// @return Whether the size line could be read or not
+    bool read_chunk_size() {
+        char * line = nullptr;
+        // Each chunk is followed by an empty line, before the size of the next chunk
+        if (m_chunk_end_pending && (!read_line(line) || line[0U] != '\0')) {
+            Logger::printfln(POSIX_HTTP_INVALID_RESPONSE);
+            return false;
+        }
+        m_chunk_end_pending = false;
+        if (!read_line(line)) {
+            return false;
+        }
+        // Chunk extensions after the size are allowed but ignored, see https://www.rfc-editor.org/rfc/rfc9112#section-7.1.1
+        char * size_end = nullptr;
+        m_body_remaining = strtoull(line, &size_end, 16);
+        if (size_end == line) {
+            Logger::printfln(POSIX_HTTP_INVALID_RESPONSE);
+            return false;
+        }
+        else if (m_body_remaining != 0U) {
+            m_chunk_end_pending = true;
+            return true;
+        }
+        // Last chunk is followed by optional trailing headers and an empty line
+        do {
+            if (!read_line(line)) {
+                return false;
+            }
+        } while (line[0U] != '\0');
+        finish_response();
+        return true;
+    }
+
+    /// @brief Marks the response as completly read and closes the connection, if it can not be reused for the next request
+    void finish_response() {
+        m_response_state = Response_State::NONE;
+        if (m_close_after_response || !m_keep_alive) {
+            close_socket();
+        }
+    }
+
+    /// @brief Reads the next line of the status line or headers into the internal buffer, waiting for more data if the line has not been received completly yet
+    /// @param line Pointer to the null terminated line without the line ending, only valid until the next line is read
+    /// @return Whether a complete line has been read or not
+    bool read_line(char * & line) {
+        while (true) {
+            for (size_t i = m_buffer_start; i + 1U < m_buffer_end; i++) {
+                if (m_buffer[i] != '\r' || m_buffer[i + 1U] != '\n') {
+                    continue;
+                }
+                m_buffer[i] = '\0';
+                line = m_buffer + m_buffer_start;
+                m_buffer_start = i + 2U;
+                return true;
+            }
+            if (!fill_buffer()) {
+                return false;
+            }
+        }
+    }
+
+    /// @brief Moves the unread bytes to the start of the internal buffer and waits until more bytes have been received after them
+    /// @return Whether any bytes have been received or not, fails if the line is too long for the internal buffer, the connection was closed or the network timeout has passed
+    bool fill_buffer() {
+        if (m_socket < 0) {
+            return false;
+        }
+        if (m_buffer_start != 0U) {
+            (void)memmove(m_buffer, m_buffer + m_buffer_start, m_buffer_end - m_buffer_start);
+            m_buffer_end -= m_buffer_start;
+            m_buffer_start = 0U;
+        }
+        if (m_buffer_end == sizeof(m_buffer)) {
+            Logger::printfln(POSIX_HTTP_INVALID_RESPONSE);
+            return false;
+        }
+        size_t const received = receive(reinterpret_cast<uint8_t *>(m_buffer + m_buffer_end), sizeof(m_buffer) - m_buffer_end);
+        m_buffer_end += received;
+        return received != 0U;
+    }
+
+    /// @brief Reads up to the given amount of bytes of the body, bytes that are still in the internal buffer are returned first, afterwards the bytes are received directly into the given buffer
+    /// @param buffer Buffer the bytes of the body should be copied into
+    /// @param size Maximum amount of bytes that should be read
+    /// @return Amount of bytes that have been read, 0 if the connection was closed or the network timeout has passed
+    size_t read_body_bytes(uint8_t * buffer, size_t size) {
+        size_t const buffered = m_buffer_end - m_buffer_start;
+        if (buffered == 0U) {
+            return m_socket >= 0 ? receive(buffer, size) : 0U;
+        }
+        size_t const copied = buffered < size ? buffered : size;
+        (void)memcpy(buffer, m_buffer + m_buffer_start, copied);
+        m_buffer_start += copied;
+        return copied;
+    }
+
+    /// @brief Waits until data is available on the socket and then reads up to the given amount of bytes, closes the socket if the connection failed
+    /// @param buffer Buffer the received bytes should be written into
+    /// @param size Maximum amount of bytes that should be read
+    /// @return Amount of bytes that have been read, 0 if the connection was closed or the network timeout has passed
+    size_t receive(uint8_t * buffer, size_t size) {
+        while (true) {
+            ssize_t const result = recv(m_socket, buffer, size, 0);
+            if (result > 0) {
+                return result;
+            }
+            else if (result < 0 && errno == EINTR) {
+                continue;
+            }
+            else if (result < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                if (wait_for_socket(POLLIN, m_network_timeout)) {
+                    continue;
+                }
+                Logger::printfln(POSIX_HTTP_RESPONSE_TIMEOUT, m_network_timeout);
+            }
+#if THINGSBOARD_ENABLE_DEBUG
+            else {
+                Logger::printfln(POSIX_HTTP_SOCKET_CLOSED, result == 0 ? "Closed by server" : strerror(errno));
+            }
+#endif // THINGSBOARD_ENABLE_DEBUG
+            // Keep the bytes that are still in the internal buffer, because a body delimited by closing the connection might still be read from it
+            if (m_socket >= 0) {
+                (void)close(m_socket);
+            }
+            m_socket = -1;
+            return 0U;
+        }
+    }
+
+    /// @brief Checks whether the server closed the connection, that has been kept alive since the previous request, without waiting
+    /// @return Whether the connection has been closed or contains unexpected data and therefore can not be reused
+    bool peer_closed() {
+        if (!wait_for_socket(POLLIN, 0U)) {
+            return false;
+        }
+        uint8_t peeked = 0U;
+        ssize_t const result = recv(m_socket, &peeked, sizeof(peeked), MSG_PEEK);
+        return !(result < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR));
+    }
+
+    /// @brief Resolves the previously set server and establishes a non-blocking TCP connection with the first address that accepts it
+    /// @return Whether the connection could be established in the network timeout or not
+    bool open_socket() {
+        if (m_host == nullptr) {
+            Logger::printfln(POSIX_HTTP_NOT_CONFIGURED);
+            return false;
+        }
+        char port[6U] = {};
+        (void)snprintf(port, sizeof(port), "%u", m_port);
+        addrinfo hints = {};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo * addresses = nullptr;
+        int const error = getaddrinfo(m_host, port, &hints, &addresses);
+        if (error != 0) {
+            Logger::printfln(POSIX_HTTP_RESOLVE_FAILED, m_host, gai_strerror(error));
+            return false;
+        }
+
+        for (addrinfo * address = addresses; address != nullptr; address = address->ai_next) {
+            m_socket = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+            if (m_socket < 0) {
+                continue;
+            }
+            int const socket_flags = fcntl(m_socket, F_GETFL, 0);
+            if (socket_flags >= 0 && fcntl(m_socket, F_SETFL, socket_flags | O_NONBLOCK) >= 0 && connect_socket(address)) {
+                break;
+            }
+            (void)close(m_socket);
+            m_socket = -1;
+        }
+        freeaddrinfo(addresses);
+
+        if (m_socket < 0) {
+            Logger::printfln(POSIX_HTTP_SOCKET_FAILED, m_host, m_port, strerror(errno));
+            return false;
+        }
+        // Disable Nagle's algorithm, because the complete request is always written at once and should be sent immediately
+        int const no_delay = 1;
+        (void)setsockopt(m_socket, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+#ifdef SO_NOSIGPIPE
+        int const no_sigpipe = 1;
+        (void)setsockopt(m_socket, SOL_SOCKET, SO_NOSIGPIPE, &no_sigpipe, sizeof(no_sigpipe));
+#endif // SO_NOSIGPIPE
+        return true;
+    }
+
+    /// @brief Connects the non-blocking socket to the given address, waiting up to the network timeout for the connection to be established
+    /// @param address Resolved address of the server that we want to connect to
+    /// @return Whether the connection could be established or not
+    bool connect_socket(addrinfo const * address) {
+        if (::connect(m_socket, address->ai_addr, address->ai_addrlen) == 0) {
+            return true;
+        }
+        else if (errno != EINPROGRESS || !wait_for_socket(POLLOUT, m_network_timeout)) {
+            return false;
+        }
+        int socket_error = 0;
+        socklen_t length = sizeof(socket_error);
+        if (getsockopt(m_socket, SOL_SOCKET, SO_ERROR, &socket_error, &length) < 0) {
+            return false;
+        }
+        errno = socket_error;
+        return socket_error == 0;
+    }
+
+    /// @brief Closes the socket if it is open and discards the state of the current response, can be called multiple times
+    void close_socket() {
+        if (m_socket >= 0) {
+            (void)close(m_socket);
+        }
+        m_socket = -1;
+        m_response_state = Response_State::NONE;
+        m_buffer_start = 0U;
+        m_buffer_end = 0U;
+    }
+
+    /// @brief Waits until the socket is ready for the given events or the given timeout has passed
+    /// @param events Events we want to wait for (POLLIN or POLLOUT)
+    /// @param timeout_milliseconds Maximum time in milliseconds to wait for the events
+    /// @return Whether the socket became ready in the given time or not
+    bool wait_for_socket(short events, uint32_t timeout_milliseconds) {
+        pollfd poll_socket = {};
+        poll_socket.fd = m_socket;
+        poll_socket.events = events;
+        int result = 0;
+        do {
+            result = poll(&poll_socket, 1U, static_cast<int>(timeout_milliseconds));
+        } while (result < 0 && errno == EINTR);
+        return result > 0;
+    }
+
+    /// @brief Writes all the given buffers onto the socket in as few calls as possible, waiting for the socket to become writeable again if its send buffer is full.
+    /// If the data could not be written in the network timeout the connection is closed, because a partially sent request can not be recovered
+    /// @param vectors Buffers that should be written after each other, are modified to skip the already written bytes
+    /// @param count Amount of buffers that should be written
+    /// @return Whether all buffers have been written completly or not
+    bool write_all(iovec * vectors, size_t count) {
+#ifdef MSG_NOSIGNAL
+        int const send_flags = MSG_NOSIGNAL;
+#else
+        int const send_flags = 0;
+#endif // MSG_NOSIGNAL
+        while (count > 0U) {
+            msghdr message = {};
+            message.msg_iov = vectors;
+            message.msg_iovlen = count;
+            ssize_t written = sendmsg(m_socket, &message, send_flags);
+            if (written > 0) {
+                // Skip the buffers that have been written completly and the written part of the first buffer that has not
+                for (; count > 0U && static_cast<size_t>(written) >= vectors->iov_len; vectors++, count--) {
+                    written -= vectors->iov_len;
+                }
+                if (count > 0U) {
+                    vectors->iov_base = static_cast<uint8_t *>(vectors->iov_base) + written;
+                    vectors->iov_len -= written;
+                }
+                continue;
+            }
+            else if (written < 0 && errno == EINTR) {
+                continue;
+            }
+            else if (written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK) && wait_for_socket(POLLOUT, m_network_timeout)) {
+                continue;
+            }
+#if THINGSBOARD_ENABLE_DEBUG
+            Logger::printfln(POSIX_HTTP_SOCKET_CLOSED, strerror(errno));
+#endif // THINGSBOARD_ENABLE_DEBUG
+            close_socket();
+            return false;
+        }
+        return true;
+    }
+
+    char const     *m_host = {};                                 // Server instance name the client should connect too, not copied meaning it has to stay valid as long as requests are sent
+    uint16_t       m_port = {};                                  // Port that will be used to establish a connection
+    int            m_socket = {};                                // File descriptor of the non-blocking socket, -1 if no connection is open
+    bool           m_keep_alive = {};                            // Whether the connection is kept open and reused for the next request
+    uint32_t       m_network_timeout = {};                       // Time in milliseconds we wait for a network operation to finish, before the request is failed and the connection closed
+    Response_State m_response_state = {};                        // State of the response to the last sent request
+    Body_Mode      m_body_mode = {};                             // How the end of the body of the current response is determined
+    int            m_status_code = {};                           // Status code of the current response or a negative error code if it could not be read
+    size_t         m_body_remaining = {};                        // Amount of bytes remaining in the body with a content length or in the current chunk of a chunked body
+    bool           m_chunk_end_pending = {};                     // Whether the empty line after the data of the current chunk still has to be read
+    bool           m_close_after_response = {};                  // Whether the server closes the connection after the current response, meaning it can not be reused
+    char           m_buffer[POSIX_HTTP_RECEIVE_BUFFER_SIZE] = {}; // Received status line and headers, as well as bytes of the body that were received together with them
+    size_t         m_buffer_start = {};                          // Position of the first unread byte in the internal buffer
+    size_t         m_buffer_end = {};                            // Position after the last received byte in the internal buffer
+};
+
+#endif // THINGSBOARD_USE_POSIX_SOCKET
+
+#endif // POSIX_HTTP_Client_h
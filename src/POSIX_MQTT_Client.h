@@ -0,0 +1,980 @@
+#ifndef POSIX_MQTT_Client_h
+#define POSIX_MQTT_Client_h
+
+// Local include.
+#include "Configuration.h"
+
+#if THINGSBOARD_USE_POSIX_SOCKET
+
+// Local includes.
+#include "Constants.h"
+#include "IMQTT_Client.h"
+
+// Library includes.
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+
+// Protocol name and level sent in the CONNECT packet, level 4 means MQTT 3.1.1
+constexpr char POSIX_MQTT_PROTOCOL_NAME[] = "MQTT";
+constexpr uint8_t POSIX_MQTT_PROTOCOL_LEVEL = 4U;
+// Connect flags sent in the CONNECT packet, we always connect with a clean session, because the ThingsBoard client resubscribes all permanent topics on every connect
+constexpr uint8_t POSIX_MQTT_CONNECT_FLAG_CLEAN_SESSION = 0x02U;
+constexpr uint8_t POSIX_MQTT_CONNECT_FLAG_PASSWORD = 0x40U;
+constexpr uint8_t POSIX_MQTT_CONNECT_FLAG_USER_NAME = 0x80U;
+// Return codes of the CONNACK packet, that mean the server refused the connection because of the sent credentials
+constexpr uint8_t POSIX_MQTT_CONNACK_BAD_USER_NAME_OR_PASSWORD = 4U;
+constexpr uint8_t POSIX_MQTT_CONNACK_NOT_AUTHORIZED = 5U;
+// Fixed header is atleast 1 byte for the packet type and flags, followed by up to 4 bytes for the variable length encoded remaining length
+constexpr size_t POSIX_MQTT_MAX_HEADER_SIZE = 5U;
+// Biggest remaining length that can be encoded in the 4 bytes of the variable length encoding, see https://docs.oasis-open.org/mqtt/mqtt/v3.1.1/os/mqtt-v3.1.1-os.html#_Toc398718023
+constexpr size_t POSIX_MQTT_MAX_REMAINING_LENGTH = 268435455U;
+constexpr uint16_t POSIX_MQTT_DEFAULT_KEEP_ALIVE_SECONDS = 15U;
+constexpr uint32_t POSIX_MQTT_DEFAULT_NETWORK_TIMEOUT_MILLISECONDS = 15000U;
+// Log messages.
+constexpr char POSIX_MQTT_BUFFER_NOT_ALLOCATED[] = "Send and receive buffer have not been allocated, call set_buffer_size() before connecting";
+constexpr char POSIX_MQTT_RESOLVE_FAILED[] = "Resolving server (%s) failed with error (%s)";
+constexpr char POSIX_MQTT_SOCKET_FAILED[] = "Establishing connection with server (%s:%u) failed with error (%s)";
+constexpr char POSIX_MQTT_CONNACK_TIMEOUT[] = "Server did not respond to connection request in time (%u ms)";
+constexpr char POSIX_MQTT_CONNACK_REFUSED[] = "Server refused connection with return code (%u)";
+constexpr char POSIX_MQTT_PACKET_EXCEEDS_BUFFER[] = "Packet size (%u) is bigger than current send buffer size (%u), increase accordingly";
+constexpr char POSIX_MQTT_DATA_EXCEEDS_BUFFER[] = "Received amount of data (%u) is bigger than current buffer size (%u), increase accordingly";
+constexpr char POSIX_MQTT_MALFORMED_PACKET[] = "Received malformed packet with header (%u), closing connection";
+constexpr char POSIX_MQTT_KEEP_ALIVE_TIMEOUT[] = "Server did not respond to keep alive ping in time, closing connection";
+#if THINGSBOARD_ENABLE_DEBUG
+constexpr char POSIX_MQTT_SOCKET_CLOSED[] = "Connection closed with error (%s)";
+#endif // THINGSBOARD_ENABLE_DEBUG
+
+
+/// @brief MQTT control packet types, already shifted into the upper 4 bits of the first byte of the fixed header.
+/// See https://docs.oasis-open.org/mqtt/mqtt/v3.1.1/os/mqtt-v3.1.1-os.html#_Toc398718021 for more information on the different packets
+enum class MQTT_Packet_Type : uint8_t {
+    CONNECT = 0x10U,
+    CONNACK = 0x20U,
+    PUBLISH = 0x30U,
+    PUBACK = 0x40U,
+    SUBSCRIBE = 0x80U,
+    SUBACK = 0x90U,
+    UNSUBSCRIBE = 0xA0U,
+    UNSUBACK = 0xB0U,
+    PINGREQ = 0xC0U,
+    PINGRESP = 0xD0U,
+    DISCONNECT = 0xE0U
+};
+
+
+/// @brief MQTT Client interface implementation that uses POSIX sockets under the hood to establish and communicate over a MQTT 3.1.1 connection,
+/// useful when running on a host operating system like Linux, where neither Arduino nor Espressif IDF is available. Has no dependencies besides the C standard and POSIX socket headers.
+/// The socket is non-blocking and all received data is handled in the loop() method, which polls the socket and reads as much data as is available without waiting.
+/// Sending waits for the socket to become writeable again, but only up to the configured network timeout. Messages can be published with QoS level 0 or 1 and are always received with QoS level 0,
+/// because the connection uses a clean session, messages published with QoS level 1 that have not been acknowledged before the connection is lost are not retransmitted.
+/// The send and receive buffer are allocated once in set_buffer_size() and then reused for every packet, messages bigger than the receive buffer are received in fragments instead of being discarded
+/// @tparam Logger Implementation that should be used to print error messages generated by internal processes and additional debugging messages if THINGSBOARD_ENABLE_DEBUG is set, default = DefaultLogger
+template <typename Logger = DefaultLogger>
+class POSIX_MQTT_Client : public IMQTT_Client {
+  public:
+    /// @brief Constructs a IMQTT_Client implementation without any allocated buffers, meaning set_buffer_size() has to be called before connecting, which the ThingsBoard client does in its constructor
+    POSIX_MQTT_Client()
+      : m_received_data_callback()
+      , m_received_data_fragment_callback()
+      , m_publish_acknowledged_callback()
+      , m_connected_callback()
+      , m_domain(nullptr)
+      , m_port(0U)
+      , m_socket(-1)
+      , m_connected(false)
+      , m_keep_alive_seconds(POSIX_MQTT_DEFAULT_KEEP_ALIVE_SECONDS)
+      , m_network_timeout(POSIX_MQTT_DEFAULT_NETWORK_TIMEOUT_MILLISECONDS)
+      , m_loop_timeout(0U)
+      , m_receive_buffer(nullptr)
+      , m_receive_buffer_size(0U)
+      , m_send_buffer(nullptr)
+      , m_send_buffer_size(0U)
+      , m_receive_state(Receive_State::HEADER)
+      , m_packet_header(0U)
+      , m_packet_length(0U)
+      , m_length_multiplier(1U)
+      , m_packet_received(0U)
+      , m_receive_position(0U)
+      , m_payload_offset(0U)
+      , m_fragment_offset(0U)
+      , m_connack_received(false)
+      , m_connack_return_code(0U)
+      , m_packet_id(0U)
+      , m_ping_outstanding(false)
+      , m_last_inbound(0U)
+      , m_last_outbound(0U)
+#if THINGSBOARD_ENABLE_STREAM_UTILS
+      , m_stream_remaining(0U)
+#endif // THINGSBOARD_ENABLE_STREAM_UTILS
+    {
+        // Nothing to do
+    }
+
+    /// @brief Destructor
+    ~POSIX_MQTT_Client() {
+        close_socket();
+        free(m_receive_buffer);
+        free(m_send_buffer);
+    }
+
+    /// @brief Sets the keep alive timeout in seconds, if no packet has been sent or received in the given time a PINGREQ control packet is sent to the broker,
+    /// and if the broker does not respond in the same amount of time again the connection is closed. A value of 0 disables the keep alive mechanism. The default value is 15 seconds.
+    /// The default timeout value ThingsBoard expectes to receive any message including a keep alive to not show the device as inactive can be found here https://thingsboard.io/docs/user-guide/install/config/#mqtt-server-parameters
+    /// under the transport.sessions.inactivity_timeout section and is 300 seconds. Only applied once connect() is called the next time
+    /// @param keep_alive_timeout_seconds Timeout until we send another PINGREQ control packet to the broker to establish that we are still connected
+    void set_keep_alive_timeout(uint16_t keep_alive_timeout_seconds) {
+        m_keep_alive_seconds = keep_alive_timeout_seconds;
+    }
+
+    /// @brief Sets the amount of time in milliseconds that we wait for a network operation to finish, meaning establishing the connection, receiving the CONNACK response
+    /// or waiting for the socket to become writeable again while sending a packet. If the operation has not finished in the given time it is aborted and the connection closed. The default value is 15 seconds
+    /// @param network_timeout_milliseconds Time in milliseconds that we wait until we abort the network operation if it has not completed yet
+    void set_network_timeout(uint32_t network_timeout_milliseconds) {
+        m_network_timeout = network_timeout_milliseconds;
+    }
+
+    /// @brief Sets the amount of time in milliseconds the loop() method waits for data to be received, if no data is available yet. The default value is 0, meaning loop() never blocks.
+    /// Increasing the value allows applications that do nothing else but handle the ThingsBoard client in their main loop to sleep until data is received, instead of having to busy poll
+    /// @param loop_timeout_milliseconds Time in milliseconds that we wait in the loop() method for data to become available
+    void set_loop_timeout(uint32_t loop_timeout_milliseconds) {
+        m_loop_timeout = loop_timeout_milliseconds;
+    }
+
+    void set_data_callback(Callback<void, char *, uint8_t *, unsigned int>::function callback) override {
+        m_received_data_callback.Set_Callback(callback);
+    }
+
+    void set_data_fragment_callback(Callback<void, char *, uint8_t *, unsigned int, unsigned int, unsigned int>::function callback) override {
+        m_received_data_fragment_callback.Set_Callback(callback);
+    }
+
+    bool supports_fragmented_receive() override {
+        return true;
+    }
+
+    void set_publish_acknowledged_callback(Callback<void, uint16_t>::function callback) override {
+        m_publish_acknowledged_callback.Set_Callback(callback);
+    }
+
+    void set_connect_callback(Callback<void>::function callback) override {
+        m_connected_callback.Set_Callback(callback);
+    }
+
+    bool set_buffer_size(uint16_t receive_buffer_size, uint16_t send_buffer_size) override {
+        if (receive_buffer_size == 0U || send_buffer_size == 0U) {
+            return false;
+        }
+        if (receive_buffer_size != m_receive_buffer_size) {
+            uint8_t * receive_buffer = static_cast<uint8_t *>(realloc(m_receive_buffer, receive_buffer_size));
+            if (receive_buffer == nullptr) {
+                return false;
+            }
+            m_receive_buffer = receive_buffer;
+            m_receive_buffer_size = receive_buffer_size;
+            // If the buffer has been changed while we were in the middle of receiving a packet into it, the already received part might not fit anymore,
+            // to keep the connection in sync with the packet boundaries we simply discard the remaining bytes of the packet instead
+            if (m_receive_state == Receive_State::PACKET || m_receive_state == Receive_State::PUBLISH_HEADER || m_receive_state == Receive_State::FRAGMENT) {
+                m_receive_state = Receive_State::DISCARD;
+            }
+        }
+        if (send_buffer_size != m_send_buffer_size) {
+            uint8_t * send_buffer = static_cast<uint8_t *>(realloc(m_send_buffer, send_buffer_size));
+            if (send_buffer == nullptr) {
+                return false;
+            }
+            m_send_buffer = send_buffer;
+            m_send_buffer_size = send_buffer_size;
+        }
+        return true;
+    }
+
+    uint16_t get_receive_buffer_size() override {
+        return m_receive_buffer_size;
+    }
+
+    uint16_t get_send_buffer_size() override {
+        return m_send_buffer_size;
+    }
+
+    void set_server(char const * domain, uint16_t port) override {
+        m_domain = domain;
+        m_port = port;
+    }
+
+    bool connect(char const * client_id, char const * user_name, char const * password) override {
+        close_socket();
+        m_connack_return_code = 0U;
+        if (m_receive_buffer == nullptr || m_send_buffer == nullptr) {
+            Logger::printfln(POSIX_MQTT_BUFFER_NOT_ALLOCATED);
+            return false;
+        }
+        else if (m_domain == nullptr || !open_socket()) {
+            return false;
+        }
+
+        uint8_t flags = POSIX_MQTT_CONNECT_FLAG_CLEAN_SESSION;
+        size_t remaining_length = string_size(POSIX_MQTT_PROTOCOL_NAME) + 1U + 1U + 2U + string_size(client_id);
+        // The MQTT 3.1.1 specification only allows to send a password if a user name is sent as well
+        if (user_name != nullptr) {
+            flags |= POSIX_MQTT_CONNECT_FLAG_USER_NAME;
+            remaining_length += string_size(user_name);
+            if (password != nullptr) {
+                flags |= POSIX_MQTT_CONNECT_FLAG_PASSWORD;
+                remaining_length += string_size(password);
+            }
+        }
+
+        size_t position = 0U;
+        if (!write_fixed_header(MQTT_Packet_Type::CONNECT, 0U, remaining_length, position)) {
+            close_socket();
+            return false;
+        }
+        write_string(POSIX_MQTT_PROTOCOL_NAME, position);
+        m_send_buffer[position++] = POSIX_MQTT_PROTOCOL_LEVEL;
+        m_send_buffer[position++] = flags;
+        write_uint16(m_keep_alive_seconds, position);
+        write_string(client_id, position);
+        if (user_name != nullptr) {
+            write_string(user_name, position);
+            if (password != nullptr) {
+                write_string(password, position);
+            }
+        }
+        if (!write_all(m_send_buffer, position)) {
+            return false;
+        }
+
+        // Wait for the CONNACK response of the broker, because we are not allowed to send any other packets before the connection has been accepted
+        m_connack_received = false;
+        uint64_t const start = get_milliseconds();
+        while (!m_connack_received) {
+            uint64_t const elapsed = get_milliseconds() - start;
+            if (elapsed >= m_network_timeout) {
+                Logger::printfln(POSIX_MQTT_CONNACK_TIMEOUT, m_network_timeout);
+                close_socket();
+                return false;
+            }
+            if (!wait_for_socket(POLLIN, m_network_timeout - elapsed) || !receive_available()) {
+                close_socket();
+                return false;
+            }
+        }
+
+        if (m_connack_return_code != 0U) {
+            Logger::printfln(POSIX_MQTT_CONNACK_REFUSED, m_connack_return_code);
+            close_socket();
+            return false;
+        }
+        m_connected = true;
+        m_ping_outstanding = false;
+        m_connected_callback.Call_Callback();
+        return true;
+    }
+
+    void disconnect() override {
+        if (m_connected) {
+            uint8_t const packet[2U] = { static_cast<uint8_t>(MQTT_Packet_Type::DISCONNECT), 0U };
+            (void)write_all(packet, sizeof(packet));
+        }
+        close_socket();
+    }
+
+    bool loop() override {
+        if (!m_connected) {
+            return false;
+        }
+        // Waiting fails if the socket has been closed by the other side, which is then detected by the following receive call,
+        // because polling simply returns the socket as readable and the receive call returns 0 bytes
+        (void)wait_for_socket(POLLIN, m_loop_timeout);
+        if (!receive_available()) {
+            close_socket();
+            return false;
+        }
+
+        if (m_keep_alive_seconds == 0U) {
+            return m_connected;
+        }
+        uint64_t const now = get_milliseconds();
+        uint64_t const keep_alive_timeout = static_cast<uint64_t>(m_keep_alive_seconds) * MILLISECONDS_PER_SECOND;
+        if ((now - m_last_inbound) < keep_alive_timeout && (now - m_last_outbound) < keep_alive_timeout) {
+            return m_connected;
+        }
+        else if (m_ping_outstanding) {
+            Logger::printfln(POSIX_MQTT_KEEP_ALIVE_TIMEOUT);
+            close_socket();
+            return false;
+        }
+        uint8_t const packet[2U] = { static_cast<uint8_t>(MQTT_Packet_Type::PINGREQ), 0U };
+        m_ping_outstanding = write_all(packet, sizeof(packet));
+        // Reset the inbound timestamp as well, so the broker has the complete keep alive timeout to respond to our ping
+        m_last_inbound = now;
+        return m_connected;
+    }
+
+    bool publish(char const * topic, uint8_t const * payload, size_t const & length) override {
+        uint16_t packet_id = 0U;
+        return publish(topic, payload, length, 0U, packet_id);
+    }
+
+    bool publish(char const * topic, uint8_t const * payload, size_t const & length, uint8_t qos, uint16_t & packet_id) override {
+        if (!m_connected || qos > 1U) {
+            return false;
+        }
+        // Messages sent with QoS level 1 additionally contain the packet identifier after the topic, which the broker then acknowledges with a PUBACK packet
+        size_t const packet_id_size = (qos != 0U) ? 2U : 0U;
+        size_t position = 0U;
+        if (!write_fixed_header(MQTT_Packet_Type::PUBLISH, qos << 1U, string_size(topic) + packet_id_size + length, position)) {
+            return false;
+        }
+        write_string(topic, position);
+        packet_id = 0U;
+        if (qos != 0U) {
+            packet_id = next_packet_id();
+            write_uint16(packet_id, position);
+        }
+        if (length != 0U) {
+            (void)memcpy(m_send_buffer + position, payload, length);
+            position += length;
+        }
+        return write_all(m_send_buffer, position);
+    }
+
+    bool subscribe(char const * topic) override {
+        if (!m_connected) {
+            return false;
+        }
+        // Packet identifier, topic filter and the requested QoS level of 0
+        size_t position = 0U;
+        if (!write_fixed_header(MQTT_Packet_Type::SUBSCRIBE, 0x02U, 2U + string_size(topic) + 1U, position)) {
+            return false;
+        }
+        write_uint16(next_packet_id(), position);
+        write_string(topic, position);
+        m_send_buffer[position++] = 0U;
+        return write_all(m_send_buffer, position);
+    }
+
+    bool subscribe(char const * const * topics, size_t const & count) override {
+        if (!m_connected) {
+            return false;
+        }
+        else if (count == 0U) {
+            return true;
+        }
+        // Packet identifier, followed by each topic filter with its requested QoS level of 0
+        size_t remaining_length = 2U;
+        for (size_t i = 0U; i < count; i++) {
+            remaining_length += string_size(topics[i]) + 1U;
+        }
+        size_t position = 0U;
+        if (!write_fixed_header(MQTT_Packet_Type::SUBSCRIBE, 0x02U, remaining_length, position)) {
+            return false;
+        }
+        write_uint16(next_packet_id(), position);
+        for (size_t i = 0U; i < count; i++) {
+            write_string(topics[i], position);
+            m_send_buffer[position++] = 0U;
+        }
+        return write_all(m_send_buffer, position);
+    }
+
+    bool unsubscribe(char const * topic) override {
+        if (!m_connected) {
+            return false;
+        }
+        size_t position = 0U;
+        if (!write_fixed_header(MQTT_Packet_Type::UNSUBSCRIBE, 0x02U, 2U + string_size(topic), position)) {
+            return false;
+        }
+        write_uint16(next_packet_id(), position);
+        write_string(topic, position);
+        return write_all(m_send_buffer, position);
+    }
+
+    bool connected() override {
+        return m_connected;
+    }
+
+    bool authentication_rejected() override {
+        return m_connack_return_code == POSIX_MQTT_CONNACK_BAD_USER_NAME_OR_PASSWORD || m_connack_return_code == POSIX_MQTT_CONNACK_NOT_AUTHORIZED;
+    }
+
+#if THINGSBOARD_ENABLE_STREAM_UTILS
+
+    bool begin_publish(char const * topic, size_t const & length) override {
+        if (!m_connected) {
+            return false;
+        }
+        // Only the fixed header and the topic are written into the send buffer, the payload is then written directly onto the socket with the following write() calls
+        size_t position = 0U;
+        size_t const topic_size = string_size(topic);
+        size_t const remaining_length = topic_size + length;
+        size_t const header_size = fixed_header_size(remaining_length);
+        if (remaining_length > POSIX_MQTT_MAX_REMAINING_LENGTH || (header_size + topic_size) > m_send_buffer_size) {
+            Logger::printfln(POSIX_MQTT_PACKET_EXCEEDS_BUFFER, header_size + topic_size, m_send_buffer_size);
+            return false;
+        }
+        write_fixed_header_unchecked(MQTT_Packet_Type::PUBLISH, 0U, remaining_length, position);
+        write_string(topic, position);
+        m_stream_remaining = length;
+        return write_all(m_send_buffer, position);
+    }
+
+    bool end_publish() override {
+        bool const result = m_connected && m_stream_remaining == 0U;
+        m_stream_remaining = 0U;
+        return result;
+    }
+
+    //----------------------------------------------------------------------------
+    // Print interface
+    //----------------------------------------------------------------------------
+
+    size_t write(uint8_t payload_byte) override {
+        return write(&payload_byte, 1U);
+    }
+
+    size_t write(uint8_t const * buffer, size_t const & size) override {
+        // Writing more bytes than announced in begin_publish() would corrupt the packet boundaries for the broker
+        if (!m_connected || size > m_stream_remaining || !write_all(buffer, size)) {
+            return 0U;
+        }
+        m_stream_remaining -= size;
+        return size;
+    }
+
+#endif // THINGSBOARD_ENABLE_STREAM_UTILS
+
+  private:
+    /// @brief States of the internal receive state machine, which allows to handle packets that are only partially available on the non-blocking socket,
+    /// by continuing where we stopped in the previous call to receive_available()
+    enum class Receive_State : uint8_t {
+        HEADER,           // Waiting for the first byte of the fixed header, containing the packet type and flags
+        REMAINING_LENGTH, // Reading the variable length encoded remaining length of the packet
+        PACKET,           // Reading the complete packet into the receive buffer, because it fits
+        PUBLISH_HEADER,   // Reading the topic of a PUBLISH packet that is bigger than the receive buffer, before the payload is forwarded in fragments
+        FRAGMENT,         // Reading the payload of a PUBLISH packet that is bigger than the receive buffer and forwarding it in fragments
+        DISCARD           // Skipping the remaining bytes of a packet that can not be handled
+    };
+
+    /// @brief Gets the current time of the monotonic clock, which is not affected by changes to the system time
+    /// @return Current time in milliseconds
+    static uint64_t get_milliseconds() {
+        timespec time = {};
+        (void)clock_gettime(CLOCK_MONOTONIC, &time);
+        return (static_cast<uint64_t>(time.tv_sec) * MILLISECONDS_PER_SECOND) + (time.tv_nsec / NANOSECONDS_PER_MILLISECOND);
+    }
+
+    /// @brief Gets the amount of bytes the given string requires in an MQTT packet, which is the length prefix of 2 bytes followed by the characters without null termination
+    /// @param string String that should be written into the packet, nullptr is handled like an empty string
+    /// @return Amount of bytes the given string requires in an MQTT packet
+    static size_t string_size(char const * string) {
+        return 2U + (string != nullptr ? strlen(string) : 0U);
+    }
+
+    /// @brief Gets the amount of bytes the fixed header requires for the given remaining length
+    /// @param remaining_length Amount of bytes in the packet following the fixed header
+    /// @return Amount of bytes required for the packet type and the variable length encoded remaining length
+    static size_t fixed_header_size(size_t remaining_length) {
+        size_t size = 2U;
+        for (; remaining_length > 127U; remaining_length /= 128U) {
+            size++;
+        }
+        return size;
+    }
+
+    /// @brief Gets the next packet identifier, which has to be non zero for all packets that require one
+    /// @return Next packet identifier
+    uint16_t next_packet_id() {
+        if (++m_packet_id == 0U) {
+            m_packet_id = 1U;
+        }
+        return m_packet_id;
+    }
+
+    /// @brief Writes the fixed header of the given packet type into the beginning of the send buffer, if the complete packet fits into the send buffer
+    /// @param type Type of the packet that should be sent
+    /// @param flags Flags of the packet stored in the lower 4 bits of the first byte
+    /// @param remaining_length Amount of bytes in the packet following the fixed header
+    /// @param position Position in the send buffer after the fixed header, where the variable header should be written
+    /// @return Whether the complete packet fits into the send buffer or not
+    bool write_fixed_header(MQTT_Packet_Type const & type, uint8_t flags, size_t remaining_length, size_t & position) {
+        size_t const packet_size = fixed_header_size(remaining_length) + remaining_length;
+        if (remaining_length > POSIX_MQTT_MAX_REMAINING_LENGTH || packet_size > m_send_buffer_size) {
+            Logger::printfln(POSIX_MQTT_PACKET_EXCEEDS_BUFFER, packet_size, m_send_buffer_size);
+            return false;
+        }
+        write_fixed_header_unchecked(type, flags, remaining_length, position);
+        return true;
+    }
+
+    /// @brief Writes the fixed header of the given packet type into the beginning of the send buffer, without checking whether it fits
+    /// @param type Type of the packet that should be sent
+    /// @param flags Flags of the packet stored in the lower 4 bits of the first byte
+    /// @param remaining_length Amount of bytes in the packet following the fixed header
+    /// @param position Position in the send buffer after the fixed header, where the variable header should be written
+    void write_fixed_header_unchecked(MQTT_Packet_Type const & type, uint8_t flags, size_t remaining_length, size_t & position) {
+        position = 0U;
+        m_send_buffer[position++] = static_cast<uint8_t>(type) | flags;
+        do {
+            uint8_t encoded_byte = remaining_length % 128U;
+            remaining_length /= 128U;
+            if (remaining_length > 0U) {
+                encoded_byte |= 128U;
+            }
+            m_send_buffer[position++] = encoded_byte;
+        } while (remaining_length > 0U);
+    }
+
+    /// @brief Writes the given value in big endian into the send buffer
+    /// @param value Value that should be written
+    /// @param position Position in the send buffer the value should be written at, is increased by the written amount of bytes
+    void write_uint16(uint16_t value, size_t & position) {
+        m_send_buffer[position++] = value >> 8U;
+        m_send_buffer[position++] = value & 0xFFU;
+    }
+
+    /// @brief Writes the given string with its length prefix into the send buffer
+    /// @param string String that should be written, nullptr is handled like an empty string
+    /// @param position Position in the send buffer the string should be written at, is increased by the written amount of bytes
+    void write_string(char const * string, size_t & position) {
+        size_t const length = string_size(string) - 2U;
+        write_uint16(length, position);
+        if (length != 0U) {
+            (void)memcpy(m_send_buffer + position, string, length);
+            position += length;
+        }
+    }
+
+    /// @brief Resolves the previously set server and establishes a non-blocking TCP connection with the first address that accepts it
+    /// @return Whether the connection could be established in the network timeout or not
+    bool open_socket() {
+        char port[6U] = {};
+        (void)snprintf(port, sizeof(port), "%u", m_port);
+        addrinfo hints = {};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo * addresses = nullptr;
+        int const error = getaddrinfo(m_domain, port, &hints, &addresses);
+        if (error != 0) {
+            Logger::printfln(POSIX_MQTT_RESOLVE_FAILED, m_domain, gai_strerror(error));
+            return false;
+        }
+
+        for (addrinfo * address = addresses; address != nullptr; address = address->ai_next) {
+            m_socket = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+            if (m_socket < 0) {
+                continue;
+            }
+            int const socket_flags = fcntl(m_socket, F_GETFL, 0);
+            if (socket_flags >= 0 && fcntl(m_socket, F_SETFL, socket_flags | O_NONBLOCK) >= 0 && connect_socket(address)) {
+                break;
+            }
+            (void)close(m_socket);
+            m_socket = -1;
+        }
+        freeaddrinfo(addresses);
+
+        if (m_socket < 0) {
+            Logger::printfln(POSIX_MQTT_SOCKET_FAILED, m_domain, m_port, strerror(errno));
+            return false;
+        }
+        // Disable Nagle's algorithm, because MQTT packets are small and should be sent immediately instead of being delayed until more data is available
+        int const no_delay = 1;
+        (void)setsockopt(m_socket, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+#ifdef SO_NOSIGPIPE
+        int const no_sigpipe = 1;
+        (void)setsockopt(m_socket, SOL_SOCKET, SO_NOSIGPIPE, &no_sigpipe, sizeof(no_sigpipe));
+#endif // SO_NOSIGPIPE
+
+        m_receive_state = Receive_State::HEADER;
+        m_last_inbound = get_milliseconds();
+        m_last_outbound = m_last_inbound;
+        return true;
+    }
+
+    /// @brief Connects the non-blocking socket to the given address, waiting up to the network timeout for the connection to be established
+    /// @param address Resolved address of the server that we want to connect to
+    /// @return Whether the connection could be established or not
+    bool connect_socket(addrinfo const * address) {
+        if (::connect(m_socket, address->ai_addr, address->ai_addrlen) == 0) {
+            return true;
+        }
+        else if (errno != EINPROGRESS || !wait_for_socket(POLLOUT, m_network_timeout)) {
+            return false;
+        }
+        int socket_error = 0;
+        socklen_t length = sizeof(socket_error);
+        if (getsockopt(m_socket, SOL_SOCKET, SO_ERROR, &socket_error, &length) < 0) {
+            return false;
+        }
+        errno = socket_error;
+        return socket_error == 0;
+    }
+
+    /// @brief Closes the socket if it is open and resets the connection state, can be called multiple times
+    void close_socket() {
+        if (m_socket >= 0) {
+            (void)close(m_socket);
+        }
+        m_socket = -1;
+        m_connected = false;
+        m_receive_state = Receive_State::HEADER;
+#if THINGSBOARD_ENABLE_STREAM_UTILS
+        m_stream_remaining = 0U;
+#endif // THINGSBOARD_ENABLE_STREAM_UTILS
+    }
+
+    /// @brief Waits until the socket is ready for the given events or the given timeout has passed
+    /// @param events Events we want to wait for (POLLIN or POLLOUT)
+    /// @param timeout_milliseconds Maximum time in milliseconds to wait for the events
+    /// @return Whether the socket became ready in the given time or not
+    bool wait_for_socket(short events, uint64_t timeout_milliseconds) {
+        pollfd poll_socket = {};
+        poll_socket.fd = m_socket;
+        poll_socket.events = events;
+        int result = 0;
+        do {
+            result = poll(&poll_socket, 1U, static_cast<int>(timeout_milliseconds));
+        } while (result < 0 && errno == EINTR);
+        return result > 0;
+    }
+
+    /// @brief Writes the complete given data onto the socket, waiting for the socket to become writeable again if its send buffer is full.
+    /// If the data could not be written in the network timeout the connection is closed, because a partially sent packet can not be recovered
+    /// @param data Data that should be written
+    /// @param length Amount of bytes that should be written
+    /// @return Whether the complete data has been written or not
+    bool write_all(uint8_t const * data, size_t length) {
+        if (m_socket < 0) {
+            return false;
+        }
+#ifdef MSG_NOSIGNAL
+        int const send_flags = MSG_NOSIGNAL;
+#else
+        int const send_flags = 0;
+#endif // MSG_NOSIGNAL
+        while (length > 0U) {
+            ssize_t const written = send(m_socket, data, length, send_flags);
+            if (written > 0) {
+                data += written;
+                length -= written;
+                continue;
+            }
+            else if (written < 0 && errno == EINTR) {
+                continue;
+            }
+            else if (written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK) && wait_for_socket(POLLOUT, m_network_timeout)) {
+                continue;
+            }
+#if THINGSBOARD_ENABLE_DEBUG
+            Logger::printfln(POSIX_MQTT_SOCKET_CLOSED, strerror(errno));
+#endif // THINGSBOARD_ENABLE_DEBUG
+            close_socket();
+            return false;
+        }
+        m_last_outbound = get_milliseconds();
+        return true;
+    }
+
+    /// @brief Reads up to the given amount of bytes from the socket without blocking
+    /// @param data Buffer the received bytes should be written into
+    /// @param length Maximum amount of bytes that should be read
+    /// @param received Amount of bytes that have actually been read, 0 if no data is available at the moment
+    /// @return Whether reading was successful or the connection has been closed or failed
+    bool read_some(uint8_t * data, size_t length, size_t & received) {
+        received = 0U;
+        ssize_t result = 0;
+        do {
+            result = recv(m_socket, data, length, 0);
+        } while (result < 0 && errno == EINTR);
+
+        if (result > 0) {
+            received = result;
+            m_last_inbound = get_milliseconds();
+            return true;
+        }
+        else if (result < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return true;
+        }
+#if THINGSBOARD_ENABLE_DEBUG
+        Logger::printfln(POSIX_MQTT_SOCKET_CLOSED, result == 0 ? "Closed by server" : strerror(errno));
+#endif // THINGSBOARD_ENABLE_DEBUG
+        return false;
+    }
+
+    /// @brief Reads and handles all data that is currently available on the socket, without waiting for more data to arrive.
+    /// Partially received packets are continued in the next call, because the receive state is kept in the member variables
+    /// @return Whether the connection is still intact or not
+    bool receive_available() {
+        if (m_socket < 0) {
+            return false;
+        }
+        while (true) {
+            size_t received = 0U;
+            switch (m_receive_state) {
+                case Receive_State::HEADER:
+                    if (!read_some(&m_packet_header, 1U, received)) {
+                        return false;
+                    }
+                    else if (received == 0U) {
+                        break;
+                    }
+                    m_packet_length = 0U;
+                    m_length_multiplier = 1U;
+                    m_receive_state = Receive_State::REMAINING_LENGTH;
+                    break;
+                case Receive_State::REMAINING_LENGTH: {
+                    uint8_t encoded_byte = 0U;
+                    if (!read_some(&encoded_byte, 1U, received)) {
+                        return false;
+                    }
+                    else if (received == 0U) {
+                        break;
+                    }
+                    m_packet_length += (encoded_byte & 127U) * m_length_multiplier;
+                    m_length_multiplier *= 128U;
+                    if ((encoded_byte & 128U) == 0U) {
+                        begin_packet();
+                    }
+                    else if (m_length_multiplier > (128U * 128U * 128U)) {
+                        Logger::printfln(POSIX_MQTT_MALFORMED_PACKET, m_packet_header);
+                        return false;
+                    }
+                    break;
+                }
+                case Receive_State::PACKET:
+                    if (!read_some(m_receive_buffer + m_receive_position, m_packet_length - m_receive_position, received)) {
+                        return false;
+                    }
+                    m_receive_position += received;
+                    m_packet_received += received;
+                    if (m_receive_position == m_packet_length && !handle_packet()) {
+                        return false;
+                    }
+                    break;
+                case Receive_State::PUBLISH_HEADER:
+                    if (!read_some(m_receive_buffer + m_receive_position, publish_header_size() - m_receive_position, received)) {
+                        return false;
+                    }
+                    m_receive_position += received;
+                    m_packet_received += received;
+                    if (!continue_publish_header()) {
+                        return false;
+                    }
+                    break;
+                case Receive_State::FRAGMENT: {
+                    size_t const remaining = m_packet_length - m_packet_received;
+                    size_t const available = m_receive_buffer_size - m_receive_position;
+                    if (!read_some(m_receive_buffer + m_receive_position, remaining < available ? remaining : available, received)) {
+                        return false;
+                    }
+                    m_receive_position += received;
+                    m_packet_received += received;
+                    // Forward the payload once the receive buffer is full or the complete packet has been received, to keep the amount of fragments as small as possible
+                    if (received != 0U && (m_receive_position == m_receive_buffer_size || m_packet_received == m_packet_length)) {
+                        size_t const fragment_size = m_receive_position - m_payload_offset;
+                        size_t const total_size = m_packet_length - m_payload_offset;
+                        m_received_data_fragment_callback.Call_Callback(reinterpret_cast<char *>(m_receive_buffer), m_receive_buffer + m_payload_offset, fragment_size, m_fragment_offset, total_size);
+                        m_fragment_offset += fragment_size;
+                        m_receive_position = m_payload_offset;
+                    }
+                    if (m_packet_received == m_packet_length) {
+                        m_receive_state = Receive_State::HEADER;
+                    }
+                    break;
+                }
+                case Receive_State::DISCARD: {
+                    size_t const remaining = m_packet_length - m_packet_received;
+                    if (!read_some(m_receive_buffer, remaining < m_receive_buffer_size ? remaining : m_receive_buffer_size, received)) {
+                        return false;
+                    }
+                    m_packet_received += received;
+                    if (m_packet_received == m_packet_length) {
+                        m_receive_state = Receive_State::HEADER;
+                    }
+                    break;
+                }
+            }
+
+            // Stop once the connection has been closed while handling the received packet or once the socket has no more data available
+            if (m_socket < 0) {
+                return false;
+            }
+            else if (received == 0U) {
+                return true;
+            }
+        }
+    }
+
+    /// @brief Decides how the packet is received once its remaining length is known, depending on its type and whether it fits into the receive buffer
+    void begin_packet() {
+        m_receive_position = 0U;
+        m_packet_received = 0U;
+        if (m_packet_length == 0U) {
+            (void)handle_packet();
+            return;
+        }
+        else if (m_packet_length <= m_receive_buffer_size) {
+            m_receive_state = Receive_State::PACKET;
+            return;
+        }
+        // The length prefix of the topic has to fit into the receive buffer, so we know how big the complete variable header of the PUBLISH packet is
+        else if ((m_packet_header & 0xF0U) == static_cast<uint8_t>(MQTT_Packet_Type::PUBLISH) && m_receive_buffer_size > 2U) {
+            m_receive_state = Receive_State::PUBLISH_HEADER;
+            return;
+        }
+        Logger::printfln(POSIX_MQTT_DATA_EXCEEDS_BUFFER, m_packet_length, m_receive_buffer_size);
+        m_receive_state = Receive_State::DISCARD;
+    }
+
+    /// @brief Gets the size of the variable header of the received PUBLISH packet, consisting of the topic and the packet identifier if the QoS level is bigger than 0.
+    /// Only the length prefix of the topic is known until the first 2 bytes have been received
+    /// @return Amount of bytes in the variable header that are known to be needed so far
+    size_t publish_header_size() const {
+        if (m_receive_position < 2U) {
+            return 2U;
+        }
+        size_t const topic_length = (m_receive_buffer[0U] << 8U) | m_receive_buffer[1U];
+        size_t const packet_id_size = (((m_packet_header >> 1U) & 0x03U) != 0U) ? 2U : 0U;
+        return 2U + topic_length + packet_id_size;
+    }
+
+    /// @brief Checks whether the variable header of a PUBLISH packet that is bigger than the receive buffer has been received completly,
+    /// if it has the topic is prepared and the payload is forwarded in fragments from then on. If the variable header does not fit into the receive buffer the packet is discarded instead
+    /// @return Whether the connection is still intact or not
+    bool continue_publish_header() {
+        size_t const header_size = publish_header_size();
+        if (header_size > m_packet_length) {
+            Logger::printfln(POSIX_MQTT_MALFORMED_PACKET, m_packet_header);
+            return false;
+        }
+        // Atleast one byte of payload has to fit into the receive buffer after the variable header, otherwise we can not forward any fragments
+        else if (header_size >= m_receive_buffer_size) {
+            Logger::printfln(POSIX_MQTT_DATA_EXCEEDS_BUFFER, m_packet_length, m_receive_buffer_size);
+            m_receive_state = Receive_State::DISCARD;
+            return true;
+        }
+        else if (m_receive_position < header_size || m_receive_position < 2U) {
+            return true;
+        }
+        if (!prepare_publish(header_size)) {
+            return false;
+        }
+        m_payload_offset = header_size;
+        m_fragment_offset = 0U;
+        m_receive_state = (m_packet_received == m_packet_length) ? Receive_State::HEADER : Receive_State::FRAGMENT;
+        return true;
+    }
+
+    /// @brief Null terminates the topic of the received PUBLISH packet in place and acknowledges the packet if it was sent with QoS level 1.
+    /// The topic is moved to the start of the receive buffer, overwriting its 2 byte length prefix, which leaves enough space for the null termination before the rest of the variable header
+    /// @param header_size Size of the variable header of the PUBLISH packet
+    /// @return Whether the connection is still intact or not
+    bool prepare_publish(size_t const & header_size) {
+        size_t const topic_length = (m_receive_buffer[0U] << 8U) | m_receive_buffer[1U];
+        uint8_t const qos = (m_packet_header >> 1U) & 0x03U;
+        uint8_t packet_id[2U] = {};
+        if (qos != 0U) {
+            (void)memcpy(packet_id, m_receive_buffer + 2U + topic_length, sizeof(packet_id));
+        }
+        (void)memmove(m_receive_buffer, m_receive_buffer + 2U, topic_length);
+        m_receive_buffer[topic_length] = '\0';
+
+        // We always subscribe with QoS level 0, therefore the broker should never send with a higher QoS level, but if it does we still have to acknowledge the message to stay compliant
+        if (qos == 1U) {
+            uint8_t const packet[4U] = { static_cast<uint8_t>(MQTT_Packet_Type::PUBACK), 2U, packet_id[0U], packet_id[1U] };
+            return write_all(packet, sizeof(packet));
+        }
+        return true;
+    }
+
+    /// @brief Handles the packet that has been received completly into the receive buffer
+    /// @return Whether the connection is still intact or not
+    bool handle_packet() {
+        m_receive_state = Receive_State::HEADER;
+        switch (static_cast<MQTT_Packet_Type>(m_packet_header & 0xF0U)) {
+            case MQTT_Packet_Type::CONNACK:
+                if (m_packet_length < 2U) {
+                    Logger::printfln(POSIX_MQTT_MALFORMED_PACKET, m_packet_header);
+                    return false;
+                }
+                m_connack_return_code = m_receive_buffer[1U];
+                m_connack_received = true;
+                break;
+            case MQTT_Packet_Type::PUBLISH: {
+                size_t const header_size = m_packet_length < 2U ? 2U : publish_header_size();
+                if (header_size > m_packet_length) {
+                    Logger::printfln(POSIX_MQTT_MALFORMED_PACKET, m_packet_header);
+                    return false;
+                }
+                else if (!prepare_publish(header_size)) {
+                    return false;
+                }
+                m_received_data_callback.Call_Callback(reinterpret_cast<char *>(m_receive_buffer), m_receive_buffer + header_size, m_packet_length - header_size);
+                break;
+            }
+            case MQTT_Packet_Type::PUBACK:
+                if (m_packet_length < 2U) {
+                    Logger::printfln(POSIX_MQTT_MALFORMED_PACKET, m_packet_header);
+                    return false;
+                }
+                m_publish_acknowledged_callback.Call_Callback(static_cast<uint16_t>((m_receive_buffer[0U] << 8U) | m_receive_buffer[1U]));
+                break;
+            case MQTT_Packet_Type::PINGRESP:
+                m_ping_outstanding = false;
+                break;
+            default:
+                // Nothing to do, SUBACK and UNSUBACK are not checked, because the ThingsBoard client does not wait for them either
+                break;
+        }
+        return true;
+    }
+
+    Callback<void, char *, uint8_t *, unsigned int>                             m_received_data_callback = {};          // Callback that will be called as soon as the mqtt client receives any data
+    Callback<void, char *, uint8_t *, unsigned int, unsigned int, unsigned int> m_received_data_fragment_callback = {}; // Callback that will be called for every fragment of data that is bigger than the receive buffer
+    Callback<void, uint16_t>                                                    m_publish_acknowledged_callback = {};   // Callback that will be called as soon as the mqtt broker has acknowledged a message published with QoS level 1
+    Callback<void>                                                              m_connected_callback = {};              // Callback that will be called as soon as the mqtt client has connected
+    char const                                                                  *m_domain = {};                         // Server instance name the client should connect too, not copied meaning it has to stay valid until connect() is called
+    uint16_t                                                                    m_port = {};                            // Port that will be used to establish a connection
+    int                                                                         m_socket = {};                          // File descriptor of the non-blocking socket, -1 if no connection is open
+    bool                                                                        m_connected = {};                       // Whether the broker has accepted the connection and it has not been closed since
+    uint16_t                                                                    m_keep_alive_seconds = {};              // Keep alive timeout sent in the CONNECT packet and used to decide when to send a PINGREQ packet
+    uint32_t                                                                    m_network_timeout = {};                 // Time in milliseconds we wait for a network operation to finish, before the connection is closed
+    uint32_t                                                                    m_loop_timeout = {};                    // Time in milliseconds the loop() method waits for data to be received
+    uint8_t                                                                     *m_receive_buffer = {};                 // Preallocated buffer received packets are read into, reused for every packet
+    uint16_t                                                                    m_receive_buffer_size = {};             // Size of the preallocated receive buffer
+    uint8_t                                                                     *m_send_buffer = {};                    // Preallocated buffer sent packets are serialized into, reused for every packet
+    uint16_t                                                                    m_send_buffer_size = {};                // Size of the preallocated send buffer
+    Receive_State                                                               m_receive_state = {};                   // Current state of the receive state machine, allows to continue partially received packets
+    uint8_t                                                                     m_packet_header = {};                   // First byte of the fixed header of the currently received packet, containing its type and flags
+    size_t                                                                      m_packet_length = {};                   // Remaining length of the currently received packet, meaning the size without the fixed header
+    size_t                                                                      m_length_multiplier = {};               // Multiplier for the next byte of the variable length encoded remaining length
+    size_t                                                                      m_packet_received = {};                 // Amount of bytes of the remaining length that have already been received, if the packet is bigger than the receive buffer
+    size_t                                                                      m_receive_position = {};                // Position in the receive buffer the next received bytes are written to
+    size_t                                                                      m_payload_offset = {};                  // Position in the receive buffer where the payload of the fragmented PUBLISH packet starts
+    size_t                                                                      m_fragment_offset = {};                 // Offset of the current fragment in the complete payload of the fragmented PUBLISH packet
+    bool                                                                        m_connack_received = {};                // Whether the CONNACK packet has been received as a response to the last CONNECT packet
+    uint8_t                                                                     m_connack_return_code = {};             // Return code of the last received CONNACK packet, 0 means the connection has been accepted
+    uint16_t                                                                    m_packet_id = {};                       // Packet identifier of the last sent PUBLISH, SUBSCRIBE or UNSUBSCRIBE packet
+    bool                                                                        m_ping_outstanding = {};                // Whether we have sent a PINGREQ packet and are still waiting for the PINGRESP packet
+    uint64_t                                                                    m_last_inbound = {};                    // Time in milliseconds when data has last been received
+    uint64_t                                                                    m_last_outbound = {};                   // Time in milliseconds when data has last been sent
+#if THINGSBOARD_ENABLE_STREAM_UTILS
+    size_t                                                                      m_stream_remaining = {};                // Amount of payload bytes announced in begin_publish() that have not been written yet
+#endif // THINGSBOARD_ENABLE_STREAM_UTILS
+};
+
+#endif // THINGSBOARD_USE_POSIX_SOCKET
+
+#endif // POSIX_MQTT_Client_h
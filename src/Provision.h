@@ -4,6 +4,7 @@
 // Local includes.
 #include "Provision_Callback.h"
 #include "IAPI_Implementation.h"
+#include "ICredential_Store.h"
 
 
 // Provision topics.
@@ -19,6 +20,16 @@ char constexpr PROV_CRED_USERNAME[] = "username";
 char constexpr PROV_CRED_PASSWORD[] = "password";
 char constexpr PROV_CRED_CLIENT_ID[] = "clientId";
 char constexpr PROV_CRED_HASH[] = "hash";
+// Provision response keys.
+char constexpr PROV_STATUS_KEY[] = "status";
+char constexpr PROV_STATUS_SUCCESS[] = "SUCCESS";
+char constexpr PROV_CRED_VALUE_KEY[] = "credentialsValue";
+char constexpr PROV_CRED_USER_NAME[] = "userName";
+char constexpr PROV_CRED_TYPE_ACCESS_TOKEN[] = "ACCESS_TOKEN";
+char constexpr PROV_CRED_TYPE_MQTT_BASIC[] = "MQTT_BASIC";
+// Log messages.
+char constexpr PROV_CREDENTIAL_TOO_LONG[] = "Provisioned credential size (%u) is bigger than the maximum credential size (%u), it will not be stored";
+char constexpr PROV_STORING_CREDENTIALS_FAILED[] = "Failed to store provisioned credentials, device will have to be provisioned again on the next startup";
 
 
 /// @brief Handles the internal implementation of the ThingsBoard provision API.
@@ -28,7 +39,15 @@ template <typename Logger = DefaultLogger>
 class Provision : public IAPI_Implementation {
   public:
     /// @brief Constructor
-    Provision() = default;
+    /// @param credential_store Optional store the credentials received in a successful provisioning response are written into, before the callback is called.
+    /// Allows to connect with the cached credentials on the next startup with ThingsBoard::connect() instead of provisioning the device again.
+    /// Only access token and basic MQTT credentials are stored, because X.509 certificates are generated by the device itself, default = nullptr
+    Provision(ICredential_Store * credential_store = nullptr)
+      : m_credential_store(credential_store)
+      , m_response_subscribed(false)
+    {
+        // Nothing to do
+    }
 
     /// @brief Sends provisioning request for a new device, meaning we want to create a device that we can then connect over,
     /// where the given provision device key / secret decide which device profile is used to create the given device with.
@@ -101,6 +120,9 @@ class Provision : public IAPI_Implementation {
 
     void Process_Json_Response(char const * topic, JsonDocument const & data) override {
         m_provision_callback.Stop_Timeout_Timer();
+        if (m_credential_store != nullptr) {
+            Store_Credentials(data);
+        }
         m_provision_callback.Call_Callback(data);
         // Unsubscribe from the provision response topic,
         // Will be resubscribed if another request is sent anyway
@@ -141,19 +163,72 @@ private:
     /// @param callback Callback method that will be called
     /// @return Whether requesting the given callback was successful or not
     bool Provision_Subscribe(Provision_Callback const & callback) {
-        if (!m_subscribe_topic_callback.Call_Callback(PROV_RESPONSE_TOPIC)) {
+        // Sending another request while still waiting for the previous response, only replaces the callback and keeps the single reference to the topic
+        if (!m_response_subscribed && !m_subscribe_topic_callback.Call_Callback(PROV_RESPONSE_TOPIC)) {
             Logger::printfln(SUBSCRIBE_TOPIC_FAILED, PROV_RESPONSE_TOPIC);
             return false;
         }
+        m_response_subscribed = true;
         m_provision_callback = callback;
         return true;
     }
 
+    /// @brief Writes the credentials contained in a successful provisioning response into the credential store,
+    /// responses containing an error or X.509 certificate credentials are ignored
+    /// @param data Received provisioning response
+    void Store_Credentials(JsonDocument const & data) {
+        char const * status = data[PROV_STATUS_KEY];
+        char const * credentials_type = data[PROV_CRED_TYPE_KEY];
+        if (status == nullptr || credentials_type == nullptr || strcmp(status, PROV_STATUS_SUCCESS) != 0) {
+            return;
+        }
+
+        Device_Credentials credentials;
+        bool result = false;
+        if (strcmp(credentials_type, PROV_CRED_TYPE_ACCESS_TOKEN) == 0) {
+            result = Copy_Credential(credentials.username, data[PROV_CRED_VALUE_KEY]);
+        }
+        else if (strcmp(credentials_type, PROV_CRED_TYPE_MQTT_BASIC) == 0) {
+            JsonObjectConst const credentials_value = data[PROV_CRED_VALUE_KEY];
+            result = Copy_Credential(credentials.client_id, credentials_value[PROV_CRED_CLIENT_ID])
+              && Copy_Credential(credentials.username, credentials_value[PROV_CRED_USER_NAME])
+              && Copy_Credential(credentials.password, credentials_value[PROV_CRED_PASSWORD]);
+        }
+        else {
+            return;
+        }
+
+        if (!result || !m_credential_store->store(credentials)) {
+            Logger::printfln(PROV_STORING_CREDENTIALS_FAILED);
+        }
+    }
+
+    /// @brief Copies the given credential into the given buffer, missing credentials are copied as an empty string
+    /// @param buffer Buffer the credential is copied into
+    /// @param credential Credential that should be copied
+    /// @return Whether the credential fit into the given buffer or not
+    static bool Copy_Credential(char (&buffer)[MAX_CREDENTIAL_SIZE], char const * credential) {
+        if (credential == nullptr) {
+            return true;
+        }
+        size_t const length = strlen(credential);
+        if (length >= MAX_CREDENTIAL_SIZE) {
+            Logger::printfln(PROV_CREDENTIAL_TOO_LONG, length, MAX_CREDENTIAL_SIZE);
+            return false;
+        }
+        (void)memcpy(buffer, credential, length + 1U);
+        return true;
+    }
+
     /// @brief Unsubcribes the provision callback
     /// @return Whether unsubcribing the previously subscribed callback
     /// and from the provision response topic, was successful or not
     bool Provision_Unsubscribe() {
         m_provision_callback = Provision_Callback();
+        if (!m_response_subscribed) {
+            return true;
+        }
+        m_response_subscribed = false;
         return m_unsubscribe_topic_callback.Call_Callback(PROV_RESPONSE_TOPIC);
     }
 
@@ -162,6 +237,8 @@ private:
     Callback<bool, char const * const>                                       m_unsubscribe_topic_callback = {}; // Unubscribe mqtt topic client callback
 
     Provision_Callback                                                       m_provision_callback = {};         // Provision response callback
+    ICredential_Store                                                        *m_credential_store = {};          // Store the credentials of successful provisioning responses are written into
+    bool                                                                     m_response_subscribed = {};        // Whether the provision response topic is currently subscribed, because a request is still waiting for its response
 };
 
 #endif // Provision_h
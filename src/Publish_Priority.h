@@ -0,0 +1,18 @@
+#ifndef Publish_Priority_h
+#define Publish_Priority_h
+
+// Library include.
+#include <stdint.h>
+
+
+/// @brief Possible priorities of a message that is published over the publish queue of the ThingsBoard client.
+/// Messages with a higher priority are always sent before messages with a lower priority, messages with the same priority are sent in the order they were queued in.
+/// Responses of the API implementations (server-side RPC, attribute requests, over the air update chunk requests, ...) are sent as URGENT,
+/// so that they overtake telemetry and attribute data, which is sent as NORMAL by default, but can be sent as BULK if it is less important than any other message
+enum class Publish_Priority : uint8_t {
+    BULK,   ///< Data that can wait until everything else has been sent, for example periodically aggregated telemetry data
+    NORMAL, ///< Default priority of telemetry and attribute data
+    URGENT  ///< Messages another party is waiting for, used for the messages sent by API implementations
+};
+
+#endif // Publish_Priority_h
@@ -0,0 +1,274 @@
+#ifndef Publish_Queue_h
+#define Publish_Queue_h
+
+// Local includes.
+#include "Array.h"
+#include "Callback.h"
+#include "Publish_Priority.h"
+
+// Library includes.
+#include <stdlib.h>
+#include <string.h>
+
+
+// Log messages.
+char constexpr PUBLISH_QUEUE_FULL[] = "Publish queue is full with (%u) messages and (%u) of (%u) bytes used, discarding message on topic (%s)";
+char constexpr PUBLISH_QUEUE_EVICTED[] = "Publish queue is full, discarding queued message on topic (%s) with a lower priority";
+char constexpr PUBLISH_QUEUE_ALLOCATION_FAILED[] = "Allocating (%u) bytes of memory for the publish queue failed";
+char constexpr INVALID_PUBLISH_QUEUE_WATERMARKS[] = "Low watermark (%u) has to be smaller than high watermark (%u) and both have to be percentages between 0 and 100";
+
+
+/// @brief Bounded queue of messages that should be published, allows to publish without ever blocking on the network, because messages are only copied into the queue and sent later.
+/// Memory consumption is bounded by the amount of bytes allocated once with set_size() and by the maximum amount of messages, messages that would exceed either are rejected instead.
+/// Topic and payload of each message are copied into one contiguous buffer in the order they were queued in, removing a message moves all following messages to the front of the buffer,
+/// which is cheap for the small buffers used on embedded devices and removes the need for any fragmentation handling.
+/// Each message has a priority, where messages with a higher priority are always returned first and messages with the same priority in the order they were queued in.
+/// If the queue is full, the newest messages with a lower priority are discarded to make space for a message with a higher priority.
+/// To inform the caller when the queue fills up, the fill level is compared with a high and low watermark and the backpressure callback is called once the fill level crosses the high watermark (true)
+/// and once it falls back to the low watermark (false). The fill level is the percentage of the used bytes or of the used messages, whichever is higher
+/// @tparam MaxQueuedMessages Maximum amount of messages that can be queued at once
+/// @tparam Logger Implementation that should be used to print error messages generated by internal processes and additional debugging messages if THINGSBOARD_ENABLE_DEBUG is set
+template<size_t MaxQueuedMessages, typename Logger>
+class Publish_Queue {
+  public:
+    /// @brief Message that has been queued, the topic and payload are kept in the internal buffer of the queue at the given offset
+    struct Queued_Message {
+        size_t                         offset = {};                // Offset of the null terminated topic in the internal buffer, directly followed by the payload
+        size_t                         topic_size = {};            // Size of the topic including the null termination
+        size_t                         payload_size = {};          // Size of the payload in bytes
+        uint8_t                        qos = {};                   // QoS level the message should be published with
+        Publish_Priority               priority = {};              // Priority of the message, messages with a higher priority are returned first
+        Callback<void, uint16_t, bool> acknowledged_callback = {}; // Callback that is called once the message published with QoS level 1 has been acknowledged or lost
+    };
+
+    /// @brief Constructs an empty queue without any allocated memory, meaning every message is rejected until set_size() is called
+    Publish_Queue()
+      : m_buffer(nullptr)
+      , m_buffer_size(0U)
+      , m_used_bytes(0U)
+      , m_messages()
+      , m_high_watermark(75U)
+      , m_low_watermark(25U)
+      , m_congested(false)
+      , m_backpressure_callback()
+    {
+        // Nothing to do
+    }
+
+    /// @brief Destructor
+    ~Publish_Queue() {
+        free(m_buffer);
+    }
+
+    /// @brief Allocates the given amount of bytes once, which is used to copy the topic and payload of every queued message into.
+    /// Any previously queued messages are discarded, because they are contained in the old buffer
+    /// @param buffer_size Amount of bytes that should be allocated, 0 frees the buffer and disables the queue
+    /// @return Whether allocating the buffer was successful or not
+    bool set_size(size_t const & buffer_size) {
+        clear();
+        free(m_buffer);
+        m_buffer = nullptr;
+        m_buffer_size = 0U;
+        if (buffer_size == 0U) {
+            return true;
+        }
+        m_buffer = static_cast<uint8_t *>(malloc(buffer_size));
+        if (m_buffer == nullptr) {
+            Logger::printfln(PUBLISH_QUEUE_ALLOCATION_FAILED, buffer_size);
+            return false;
+        }
+        m_buffer_size = buffer_size;
+        return true;
+    }
+
+    /// @brief Gets whether memory has been allocated with set_size() and messages can therefore be queued
+    /// @return Whether the queue is enabled or not
+    bool enabled() const {
+        return m_buffer != nullptr;
+    }
+
+    /// @brief Sets the fill levels in percent, at which the backpressure callback is called, the default values are 75 and 25.
+    /// Having a gap between both values ensures the callback is not called for every message if the fill level stays close to one of them
+    /// @param high_watermark Fill level in percent, at which the queue is regarded as congested
+    /// @param low_watermark Fill level in percent, at which the queue is not regarded as congested anymore, has to be smaller than the high watermark
+    /// @return Whether the given watermarks are valid and have been set or not
+    bool set_watermarks(uint8_t high_watermark, uint8_t low_watermark) {
+        if (high_watermark > 100U || low_watermark >= high_watermark) {
+            Logger::printfln(INVALID_PUBLISH_QUEUE_WATERMARKS, low_watermark, high_watermark);
+            return false;
+        }
+        m_high_watermark = high_watermark;
+        m_low_watermark = low_watermark;
+        update_congestion();
+        return true;
+    }
+
+    /// @brief Sets the callback that is called with true once the fill level reaches the high watermark and with false once it falls back to the low watermark
+    /// @param callback Method that should be called once the congestion state of the queue changes
+    void set_backpressure_callback(typename Callback<void, bool>::function callback) {
+        m_backpressure_callback.Set_Callback(callback);
+    }
+
+    /// @brief Copies the given message into the queue, if there is enough space left or if enough space can be freed by discarding queued messages with a lower priority.
+    /// Discarded messages that were queued with QoS level 1 call their acknowledged callback with packet id 0 and false, because they will never be sent
+    /// @param topic Topic the message should be published on
+    /// @param payload Payload of the message
+    /// @param length Size of the payload in bytes
+    /// @param qos QoS level the message should be published with
+    /// @param priority Priority of the message, messages with a higher priority are returned first
+    /// @param acknowledged_callback Callback that is called once the message published with QoS level 1 has been acknowledged or lost
+    /// @return Whether the message has been queued or not
+    bool push(char const * topic, uint8_t const * payload, size_t const & length, uint8_t qos, Publish_Priority priority, typename Callback<void, uint16_t, bool>::function acknowledged_callback) {
+        size_t const topic_size = strlen(topic) + 1U;
+        if (!make_space(topic_size + length, priority)) {
+            Logger::printfln(PUBLISH_QUEUE_FULL, m_messages.size(), m_used_bytes, m_buffer_size, topic);
+            return false;
+        }
+        Queued_Message message;
+        message.offset = m_used_bytes;
+        message.topic_size = topic_size;
+        message.payload_size = length;
+        message.qos = qos;
+        message.priority = priority;
+        message.acknowledged_callback.Set_Callback(acknowledged_callback);
+        (void)memcpy(m_buffer + m_used_bytes, topic, topic_size);
+        (void)memcpy(m_buffer + m_used_bytes + topic_size, payload, length);
+        m_used_bytes += topic_size + length;
+        m_messages.push_back(message);
+        update_congestion();
+        return true;
+    }
+
+    /// @brief Gets the message that should be published next, meaning the oldest message with the highest priority
+    /// @return Pointer to the message that should be published next, or nullptr if the queue is empty. Is invalidated by any following push() or pop() call
+    Queued_Message const * peek() const {
+        Queued_Message const * next = nullptr;
+        for (auto const & message : m_messages) {
+            if (next == nullptr || message.priority > next->priority) {
+                next = &message;
+            }
+        }
+        return next;
+    }
+
+    /// @brief Gets the topic of the given message
+    /// @param message Message previously returned by peek()
+    /// @return Null terminated topic of the given message
+    char const * get_topic(Queued_Message const & message) const {
+        return reinterpret_cast<char const *>(m_buffer + message.offset);
+    }
+
+    /// @brief Gets the payload of the given message
+    /// @param message Message previously returned by peek()
+    /// @return Payload of the given message, containing payload size amount of bytes
+    uint8_t const * get_payload(Queued_Message const & message) const {
+        return m_buffer + message.offset + message.topic_size;
+    }
+
+    /// @brief Removes the given message from the queue, and moves the topic and payload of all following messages to the front of the buffer
+    /// @param message Message previously returned by peek()
+    void pop(Queued_Message const * message) {
+        size_t const removed_offset = message->offset;
+        size_t const removed_size = message->topic_size + message->payload_size;
+        (void)memmove(m_buffer + removed_offset, m_buffer + removed_offset + removed_size, m_used_bytes - removed_offset - removed_size);
+        m_used_bytes -= removed_size;
+        m_messages.erase(m_messages.begin() + (message - m_messages.cbegin()));
+        for (auto & following : m_messages) {
+            if (following.offset > removed_offset) {
+                following.offset -= removed_size;
+            }
+        }
+        update_congestion();
+    }
+
+    /// @brief Removes all queued messages
+    void clear() {
+        m_messages.clear();
+        m_used_bytes = 0U;
+        update_congestion();
+    }
+
+    /// @brief Gets the amount of messages that are currently queued
+    /// @return Amount of queued messages
+    size_t size() const {
+        return m_messages.size();
+    }
+
+    /// @brief Gets the amount of bytes of the buffer that are used by the topic and payload of the currently queued messages
+    /// @return Amount of used bytes
+    size_t const & get_used_bytes() const {
+        return m_used_bytes;
+    }
+
+    /// @brief Gets whether the fill level has reached the high watermark and not fallen back to the low watermark since
+    /// @return Whether the queue is congested or not
+    bool congested() const {
+        return m_congested;
+    }
+
+  private:
+    /// @brief Checks whether the given amount of bytes and one additional message fit into the queue, if they do not the newest messages with a lower priority than the given priority are discarded,
+    /// but only if discarding all of them would free enough space, otherwise messages would be discarded without making space for the new message
+    /// @param required_size Amount of bytes required for the topic and payload of the new message
+    /// @param priority Priority of the new message
+    /// @return Whether there is enough space for the new message or not
+    bool make_space(size_t const & required_size, Publish_Priority priority) {
+        size_t freeable_bytes = m_buffer_size - m_used_bytes;
+        size_t freeable_messages = m_messages.capacity() - m_messages.size();
+        if (freeable_messages > 0U && freeable_bytes >= required_size) {
+            return true;
+        }
+        for (auto const & message : m_messages) {
+            if (message.priority < priority) {
+                freeable_bytes += message.topic_size + message.payload_size;
+                freeable_messages++;
+            }
+        }
+        if (freeable_messages == 0U || freeable_bytes < required_size) {
+            return false;
+        }
+        while (m_messages.size() >= m_messages.capacity() || m_buffer_size - m_used_bytes < required_size) {
+            // Search for the newest message with the lowest priority, because it would be sent last
+            Queued_Message const * evicted = nullptr;
+            for (auto const & message : m_messages) {
+                if (message.priority < priority && (evicted == nullptr || message.priority <= evicted->priority)) {
+                    evicted = &message;
+                }
+            }
+            Logger::printfln(PUBLISH_QUEUE_EVICTED, get_topic(*evicted));
+            Callback<void, uint16_t, bool> const acknowledged_callback = evicted->acknowledged_callback;
+            bool const acknowledged = evicted->qos != 0U;
+            pop(evicted);
+            if (acknowledged) {
+                acknowledged_callback.Call_Callback(0U, false);
+            }
+        }
+        return true;
+    }
+
+    /// @brief Compares the current fill level with the watermarks and calls the backpressure callback if the congestion state changed
+    void update_congestion() {
+        size_t const byte_fill_level = (m_buffer_size == 0U) ? 0U : (m_used_bytes * 100U) / m_buffer_size;
+        size_t const message_fill_level = (m_messages.size() * 100U) / m_messages.capacity();
+        size_t const fill_level = (byte_fill_level > message_fill_level) ? byte_fill_level : message_fill_level;
+        if (!m_congested && fill_level >= m_high_watermark && fill_level != 0U) {
+            m_congested = true;
+            m_backpressure_callback.Call_Callback(true);
+        }
+        else if (m_congested && fill_level <= m_low_watermark) {
+            m_congested = false;
+            m_backpressure_callback.Call_Callback(false);
+        }
+    }
+
+    uint8_t                                  *m_buffer = {};               // Allocated buffer the topic and payload of every queued message is copied into
+    size_t                                   m_buffer_size = {};           // Size of the allocated buffer in bytes
+    size_t                                   m_used_bytes = {};            // Amount of bytes used by the currently queued messages, all of them are at the start of the buffer
+    Array<Queued_Message, MaxQueuedMessages> m_messages = {};              // Queued messages in the order they were queued in
+    uint8_t                                  m_high_watermark = {};        // Fill level in percent at which the queue is regarded as congested
+    uint8_t                                  m_low_watermark = {};         // Fill level in percent at which the queue is not regarded as congested anymore
+    bool                                     m_congested = {};             // Whether the fill level has reached the high watermark and not fallen back to the low watermark since
+    Callback<void, bool>                     m_backpressure_callback = {}; // Callback that is called once the congestion state changes
+};
+
+#endif // Publish_Queue_h
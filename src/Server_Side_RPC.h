@@ -4,12 +4,13 @@
 // Local includes.
 #include "RPC_Callback.h"
 #include "IAPI_Implementation.h"
+#include "Topic_Builder.h"
 
 
 // Server side RPC topics.
 char constexpr RPC_SUBSCRIBE_TOPIC[] = "v1/devices/me/rpc/request/+";
 char constexpr RPC_REQUEST_TOPIC[] = "v1/devices/me/rpc/request/";
-char constexpr RPC_SEND_RESPONSE_TOPIC[] = "v1/devices/me/rpc/response/%u";
+char constexpr RPC_SEND_RESPONSE_TOPIC[] = "v1/devices/me/rpc/response/";
 // Log messages.
 char constexpr RPC_RESPONSE_OVERFLOWED[] = "Server-side RPC response overflowed, increase MaxRPC (%u)";
 #if !THINGSBOARD_ENABLE_DYNAMIC
@@ -39,7 +40,12 @@ template<size_t MaxSubscriptions = Default_Subscriptions_Amount, size_t MaxRPC =
 class Server_Side_RPC : public IAPI_Implementation {
   public:
     /// @brief Constructor
-    Server_Side_RPC() = default;
+    Server_Side_RPC()
+      : m_response_topic(RPC_SEND_RESPONSE_TOPIC)
+      , m_topic_subscribed(false)
+    {
+        // Nothing to do
+    }
 
     /// @brief Subscribes multiple server side RPC callbacks,
     /// that will be called if a request from the server for the method with the given name is received.
@@ -64,7 +70,10 @@ class Server_Side_RPC : public IAPI_Implementation {
             return false;
         }
 #endif // !THINGSBOARD_ENABLE_DYNAMIC
-        (void)m_subscribe_topic_callback.Call_Callback(RPC_SUBSCRIBE_TOPIC);
+        // All callbacks share the same topic, therefore it is only subscribed once, but retried by later callbacks for as long as subscribing it did not succeed
+        if (!m_topic_subscribed && first != last) {
+            m_topic_subscribed = m_subscribe_topic_callback.Call_Callback(RPC_SUBSCRIBE_TOPIC);
+        }
         // Push back complete vector into our local m_rpc_callbacks vector.
         m_rpc_callbacks.insert(m_rpc_callbacks.end(), first, last);
         return true;
@@ -87,7 +96,10 @@ class Server_Side_RPC : public IAPI_Implementation {
             return false;
         }
 #endif // !THINGSBOARD_ENABLE_DYNAMIC
-        (void)m_subscribe_topic_callback.Call_Callback(RPC_SUBSCRIBE_TOPIC);
+        // All callbacks share the same topic, therefore it is only subscribed once, but retried by later callbacks for as long as subscribing it did not succeed
+        if (!m_topic_subscribed) {
+            m_topic_subscribed = m_subscribe_topic_callback.Call_Callback(RPC_SUBSCRIBE_TOPIC);
+        }
         m_rpc_callbacks.push_back(callback);
         return true;
     }
@@ -97,7 +109,14 @@ class Server_Side_RPC : public IAPI_Implementation {
     /// @return Whether unsubcribing all the previously subscribed callbacks
     /// and from the rpc topic, was successful or not
     bool RPC_Unsubscribe() {
+        if (m_rpc_callbacks.empty()) {
+            return true;
+        }
         m_rpc_callbacks.clear();
+        if (!m_topic_subscribed) {
+            return true;
+        }
+        m_topic_subscribed = false;
         return m_unsubscribe_topic_callback.Call_Callback(RPC_SUBSCRIBE_TOPIC);
     }
 
@@ -164,9 +183,7 @@ class Server_Side_RPC : public IAPI_Implementation {
             }
 
             size_t const request_id = Helper::parseRequestId(RPC_REQUEST_TOPIC, topic);
-            char responseTopic[Helper::detectSize(RPC_SEND_RESPONSE_TOPIC, request_id)] = {};
-            (void)snprintf(responseTopic, sizeof(responseTopic), RPC_SEND_RESPONSE_TOPIC, request_id);
-            (void)m_send_json_callback.Call_Callback(responseTopic, json_buffer, Helper::Measure_Json(json_buffer));
+            (void)m_send_json_callback.Call_Callback(m_response_topic.build(request_id), json_buffer, Helper::Measure_Json(json_buffer));
             return;
         }
     }
@@ -180,7 +197,13 @@ class Server_Side_RPC : public IAPI_Implementation {
     }
 
     bool Resubscribe_Topic() override {
-        if (!m_rpc_callbacks.empty() && !m_subscribe_topic_callback.Call_Callback(RPC_SUBSCRIBE_TOPIC)) {
+        // The reference to the topic was dropped together with the previous session
+        m_topic_subscribed = false;
+        if (m_rpc_callbacks.empty()) {
+            return true;
+        }
+        m_topic_subscribed = m_subscribe_topic_callback.Call_Callback(RPC_SUBSCRIBE_TOPIC);
+        if (!m_topic_subscribed) {
             Logger::printfln(SUBSCRIBE_TOPIC_FAILED, RPC_SUBSCRIBE_TOPIC);
             return false;
         }
@@ -207,6 +230,8 @@ class Server_Side_RPC : public IAPI_Implementation {
     Callback<bool, char const * const, JsonDocument const &, size_t const &> m_send_json_callback = {};         // Send json document callback
     Callback<bool, char const * const>                                       m_subscribe_topic_callback = {};   // Subscribe mqtt topic client callback
     Callback<bool, char const * const>                                       m_unsubscribe_topic_callback = {}; // Unubscribe mqtt topic client callback
+    Topic_Builder<sizeof(RPC_SEND_RESPONSE_TOPIC) + MAX_NUMBER_CHARACTERS>   m_response_topic;                  // Response topic with the request id of the received request appended
+    bool                                                                     m_topic_subscribed = {};           // Whether this instance holds a reference to the request topic, false if subscribing it failed and has to be retried
 
     // Vectors or array (depends on wheter if THINGSBOARD_ENABLE_DYNAMIC is set to 1 or 0), hold copy of the actual passed data, this is to ensure they stay valid,
     // even if the user only temporarily created the object before the method was called.
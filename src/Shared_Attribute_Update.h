@@ -4,6 +4,7 @@
 // Local includes.
 #include "Shared_Attribute_Callback.h"
 #include "IAPI_Implementation.h"
+#include "Key_Arena.h"
 
 
 // Log messages.
@@ -51,9 +52,13 @@ class Shared_Attribute_Update : public IAPI_Implementation {
             return false;
         }
 #endif // !THINGSBOARD_ENABLE_DYNAMIC
-        (void)m_subscribe_topic_callback.Call_Callback(ATTRIBUTE_TOPIC);
-        // Push back complete vector into our local m_shared_attribute_update_callbacks vector.
-        m_shared_attribute_update_callbacks.insert(m_shared_attribute_update_callbacks.end(), first, last);
+        // All callbacks share the same topic, therefore it is only subscribed once, but retried by later callbacks for as long as subscribing it did not succeed
+        if (!m_topic_subscribed && first != last) {
+            m_topic_subscribed = m_subscribe_topic_callback.Call_Callback(ATTRIBUTE_TOPIC);
+        }
+        for (auto it = first; it != last; ++it) {
+            Store_Subscription(*it);
+        }
         return true;
     }
 
@@ -78,8 +83,11 @@ class Shared_Attribute_Update : public IAPI_Implementation {
             return false;
         }
 #endif // !THINGSBOARD_ENABLE_DYNAMIC
-        (void)m_subscribe_topic_callback.Call_Callback(ATTRIBUTE_TOPIC);
-        m_shared_attribute_update_callbacks.push_back(callback);
+        // All callbacks share the same topic, therefore it is only subscribed once, but retried by later callbacks for as long as subscribing it did not succeed
+        if (!m_topic_subscribed) {
+            m_topic_subscribed = m_subscribe_topic_callback.Call_Callback(ATTRIBUTE_TOPIC);
+        }
+        Store_Subscription(callback);
         return true;
     }
 
@@ -88,7 +96,15 @@ class Shared_Attribute_Update : public IAPI_Implementation {
     /// @return Whether unsubcribing all the previously subscribed callbacks
     /// and from the attribute topic, was successful or not
     bool Shared_Attributes_Unsubscribe() {
+        if (m_shared_attribute_update_callbacks.empty()) {
+            return true;
+        }
         m_shared_attribute_update_callbacks.clear();
+        m_subscribed_keys.clear();
+        if (!m_topic_subscribed) {
+            return true;
+        }
+        m_topic_subscribed = false;
         return m_unsubscribe_topic_callback.Call_Callback(ATTRIBUTE_TOPIC);
     }
 
@@ -106,57 +122,13 @@ class Shared_Attribute_Update : public IAPI_Implementation {
             object = object[SHARED_RESPONSE_KEY];
         }
 
-#if THINGSBOARD_ENABLE_STL
-#if THINGSBOARD_ENABLE_CXX20
-#if THINGSBOARD_ENABLE_DYNAMIC
-        auto filtered_shared_attribute_update_callbacks = m_shared_attribute_update_callbacks | std::views::filter([&object](Shared_Attribute_Callback const & shared_attribute) {
-#else
-        auto filtered_shared_attribute_update_callbacks = m_shared_attribute_update_callbacks | std::views::filter([&object](Shared_Attribute_Callback<MaxAttributes> const & shared_attribute) {
-#endif // THINGSBOARD_ENABLE_DYNAMIC
-#else
-#if THINGSBOARD_ENABLE_DYNAMIC
-        Vector<Shared_Attribute_Callback> filtered_shared_attribute_update_callbacks = {};
-        std::copy_if(m_shared_attribute_update_callbacks.begin(), m_shared_attribute_update_callbacks.end(), std::back_inserter(filtered_shared_attribute_update_callbacks), [&object](Shared_Attribute_Callback const & shared_attribute) {
-#else
-        Array<Shared_Attribute_Callback<MaxAttributes>, MaxSubscriptions> filtered_shared_attribute_update_callbacks = {};
-        std::copy_if(m_shared_attribute_update_callbacks.begin(), m_shared_attribute_update_callbacks.end(), std::back_inserter(filtered_shared_attribute_update_callbacks), [&object](Shared_Attribute_Callback<MaxAttributes> const & shared_attribute) {
-#endif // THINGSBOARD_ENABLE_DYNAMIC
-#endif // THINGSBOARD_ENABLE_CXX20
-            return (shared_attribute.Get_Attributes().empty() || std::find_if(shared_attribute.Get_Attributes().begin(), shared_attribute.Get_Attributes().end(), [&object](const char * att) {
-                return object.containsKey(att);
-            }) != shared_attribute.Get_Attributes().end());
-        });
-
-        for (auto const & shared_attribute : filtered_shared_attribute_update_callbacks) {
-#else
-        for (auto const & shared_attribute : m_shared_attribute_update_callbacks) {
-            if (shared_attribute.Get_Attributes().empty()) {
-                // No specifc keys were subscribed so we call the callback anyway, assumed to be subscribed to any update
-                shared_attribute.Call_Callback(object);
-                continue;
-            }
-
-            char const * requested_att = nullptr;
-
-            for (auto const & att : shared_attribute.Get_Attributes()) {
-                if (Helper::stringIsNullorEmpty(att)) {
-                    continue;
-                }
-                // Check if the request contained any of our requested keys and
-                // break early if the key was requested from this callback.
-                if (object.containsKey(att)) {
-                    requested_att = att;
-                    break;
-                }
-            }
-
-            // Check if this callback did not request any keys that were in this response,
-            // if there were not we simply continue with the next subscribed callback.
-            if (requested_att == nullptr) {
+        for (auto const & subscription : m_shared_attribute_update_callbacks) {
+            // Check if this callback did not subscribe to any keys that were in this response,
+            // if it did not we simply continue with the next subscribed callback.
+            if (!Contains_Subscribed_Key(subscription.keys, object)) {
                 continue;
             }
-#endif // THINGSBOARD_ENABLE_STL
-            shared_attribute.Call_Callback(object);
+            subscription.callback.Call_Callback(object);
         }
     }
 
@@ -169,7 +141,13 @@ class Shared_Attribute_Update : public IAPI_Implementation {
     }
 
     bool Resubscribe_Topic() override {
-        if (!m_shared_attribute_update_callbacks.empty() && !m_subscribe_topic_callback.Call_Callback(ATTRIBUTE_TOPIC)) {
+        // The reference to the topic was dropped together with the previous session
+        m_topic_subscribed = false;
+        if (m_shared_attribute_update_callbacks.empty()) {
+            return true;
+        }
+        m_topic_subscribed = m_subscribe_topic_callback.Call_Callback(ATTRIBUTE_TOPIC);
+        if (!m_topic_subscribed) {
             Logger::printfln(SUBSCRIBE_TOPIC_FAILED, ATTRIBUTE_TOPIC);
             return false;
         }
@@ -192,21 +170,62 @@ class Shared_Attribute_Update : public IAPI_Implementation {
     }
 
   private:
+    /// @brief Subscribed shared attribute update callback, only references its keys in the shared m_subscribed_keys instead of holding its own copy,
+    /// therefore storing the subscription never allocates memory for the keys of the callback on its own
+    struct Subscription {
+        Callback<void, JsonObjectConst const &> callback = {}; // Callback method that will be called if any of the keys was updated
+        Key_Range                               keys = {};     // Keys the callback subscribed to in m_subscribed_keys, all keys are subscribed to if the range is empty
+    };
+
+    /// @brief Copies the given callback method into a new subscription and its keys into the key arena
+    /// @param callback Callback method and keys that should be subscribed
+#if THINGSBOARD_ENABLE_DYNAMIC
+    void Store_Subscription(Shared_Attribute_Callback const & callback) {
+#else
+    void Store_Subscription(Shared_Attribute_Callback<MaxAttributes> const & callback) {
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+        Subscription subscription = {};
+        subscription.callback = callback;
+        auto const & attributes = callback.Get_Attributes();
+        // Can not fail even if THINGSBOARD_ENABLE_DYNAMIC is not set, because the arena has enough space for the maximum amount of attributes of all subscriptions
+        (void)m_subscribed_keys.intern(attributes.begin(), attributes.end(), subscription.keys);
+        m_shared_attribute_update_callbacks.push_back(subscription);
+    }
+
+    /// @brief Checks if the given response contains any of the keys in the given range
+    /// @param keys Keys the callback subscribed to
+    /// @param object Received shared attribute update
+    /// @return Whether any subscribed key was updated or no specific keys were subscribed, in which case the callback is assumed to be subscribed to any update
+    bool Contains_Subscribed_Key(Key_Range const & keys, JsonObjectConst const & object) const {
+        if (keys.size == 0U) {
+            return true;
+        }
+        for (size_t i = keys.offset; i < keys.offset + keys.size; i++) {
+            char const * const att = m_subscribed_keys[i];
+            if (Helper::stringIsNullorEmpty(att)) {
+                continue;
+            }
+            // Break early if the key was subscribed to by this callback
+            else if (object.containsKey(att)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
     Callback<bool, char const * const>                                       m_subscribe_topic_callback = {};          // Subscribe mqtt topic client callback
     Callback<bool, char const * const>                                       m_unsubscribe_topic_callback = {};        // Unubscribe mqtt topic client callback
+    bool                                                                     m_topic_subscribed = {};                  // Whether this instance holds a reference to the attribute topic, false if subscribing it failed and has to be retried
 
-    // Vectors or array (depends on wheter if THINGSBOARD_ENABLE_DYNAMIC is set to 1 or 0), hold copy of the actual passed data, this is to ensure they stay valid,
+    // Vectors or array (depends on wheter if THINGSBOARD_ENABLE_DYNAMIC is set to 1 or 0), hold copy of the actual passed callback methods and keys, this is to ensure they stay valid,
     // even if the user only temporarily created the object before the method was called.
-    // This can be done because all Callback methods mostly consists of pointers to actual object so copying them
-    // does not require a huge memory overhead and is acceptable especially in comparsion to possible problems that could
-    // arise if references were used and the end user does not take care to ensure the Callbacks live on for the entirety
-    // of its usage, which will lead to dangling references and undefined behaviour.
-    // Therefore copy-by-value has been choosen as for this specific use case it is more advantageous,
-    // especially because at most we copy internal vectors or array, that will only ever contain a few pointers
+    // The keys of all subscriptions are stored after each other in one key arena, so subscribing does not copy the keys of each callback into their own vector or array
 #if THINGSBOARD_ENABLE_DYNAMIC
-    Vector<Shared_Attribute_Callback>                                        m_shared_attribute_update_callbacks = {}; // Shared attribute update callbacks vector
+    Vector<Subscription>                                                     m_shared_attribute_update_callbacks = {}; // Shared attribute update subscriptions vector
+    Key_Arena                                                                m_subscribed_keys = {};                   // Keys of all shared attribute update subscriptions
 #else
-    Array<Shared_Attribute_Callback<MaxAttributes>, MaxSubscriptions>        m_shared_attribute_update_callbacks = {}; // Shared attribute update callbacks array
+    Array<Subscription, MaxSubscriptions>                                    m_shared_attribute_update_callbacks = {}; // Shared attribute update subscriptions array
+    Key_Arena<MaxSubscriptions * MaxAttributes>                              m_subscribed_keys = {};                   // Keys of all shared attribute update subscriptions
 #endif // THINGSBOARD_ENABLE_DYNAMIC
 };
 
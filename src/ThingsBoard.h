@@ -2,16 +2,24 @@
 #define ThingsBoard_h
 
 // Local includes.
+#include "Array.h"
 #include "Constants.h"
 #include "IAPI_Implementation.h"
+#include "ICredential_Store.h"
+#include "IJson_Allocator.h"
 #include "IMQTT_Client.h"
 #include "DefaultLogger.h"
+#include "Publish_Queue.h"
 #include "Telemetry.h"
 
 // Library includes.
+#include <string.h>
 #if THINGSBOARD_ENABLE_STREAM_UTILS
 #include <StreamUtils.h>
 #endif // THINGSBOARD_ENABLE_STREAM_UTILS
+#if THINGSBOARD_USE_MUTEX
+#include <mutex>
+#endif // THINGSBOARD_USE_MUTEX
 
 
 uint16_t constexpr DEFAULT_MQTT_PORT = 1883U;
@@ -20,17 +28,57 @@ char constexpr PROV_ACCESS_TOKEN[] = "provision";
 char constexpr UNABLE_TO_DE_SERIALIZE_JSON[] = "Unable to de-serialize received json data with error (DeserializationError::%s)";
 char constexpr INVALID_BUFFER_SIZE[] = "Send buffer size (%u) to small for the given payloads size (%u), increase with setBufferSize accordingly or install the StreamUtils library";
 char constexpr UNABLE_TO_ALLOCATE_BUFFER[] = "Allocating memory for the internal MQTT buffer failed";
+char constexpr FRAGMENTED_MESSAGE_DISCARDED[] = "Received amount of data (%u) over topic (%s) is bigger than current buffer size (%u) and can not be processed in fragments, increase accordingly";
 char constexpr MAX_ENDPOINTS_AMOUNT_TEMPLATE_NAME[] = "MaxEndpointsAmount";
+char constexpr MAX_IN_FLIGHT_EXCEEDED[] = "Too many (%u) messages published with QoS level 1 are still waiting for their acknowledgement, wait for them to be acknowledged or increase the window with setMaxInFlightMessages";
+char constexpr INVALID_MAX_IN_FLIGHT[] = "Maximum amount of in-flight messages (%u) has to be between 1 and (%u), increase Default_Max_In_Flight_Amount accordingly";
+char constexpr RESUBSCRIBE_TOPICS_FAILED[] = "Resubscribing (%u) topics after connecting failed";
+char constexpr MAX_SUBSCRIBED_TOPICS_EXCEEDED[] = "Too many (%u) different topics subscribed, unable to subscribe (%s), increase MaxEndpointsAmount accordingly";
+char constexpr CACHED_CREDENTIALS_REJECTED[] = "Server rejected the cached credentials, clearing them so that the device is provisioned again";
+char constexpr INVALID_QOS_LEVEL[] = "Publishing with QoS level (%u) is not supported, only QoS level 0 and 1 are";
 #if THINGSBOARD_ENABLE_DYNAMIC
 char constexpr MAXIMUM_RESPONSE_EXCEEDED[] = "Prevented allocation on the heap (%u) for JsonDocument. Discarding message that is bigger than maximum response size (%u)";
 char constexpr HEAP_ALLOCATION_FAILED[] = "Failed allocating required size (%u) for JsonDocument. Ensure there is enough heap memory left";
 #endif // THINGSBOARD_ENABLE_DYNAMIC
 #if THINGSBOARD_ENABLE_DEBUG
 char constexpr RECEIVE_MESSAGE[] = "Received (%u) bytes of data from server over topic (%s)";
+char constexpr RECEIVE_MESSAGE_FRAGMENT[] = "Received (%u) bytes of data at offset (%u) of (%u) total bytes from server over topic (%s)";
 char constexpr ALLOCATING_JSON[] = "Allocated internal JsonDocument for MQTT server response with size (%u)";
 char constexpr SEND_MESSAGE[] = "Sending data to server over topic (%s) with data (%s)";
 char constexpr SEND_SERIALIZED[] = "Hidden, because json data is bigger than buffer, therefore showing in console is skipped";
+char constexpr PUBLISH_ACKNOWLEDGED[] = "Message with packet id (%u) has been acknowledged by the server";
 #endif // THINGSBOARD_ENABLE_DEBUG
+#if THINGSBOARD_ENABLE_METRICS
+// Metrics telemetry keys.
+char constexpr METRICS_PUBLISHES_KEY[] = "tb_publishes";
+char constexpr METRICS_PUBLISH_FAILURES_KEY[] = "tb_publish_failures";
+char constexpr METRICS_BYTES_SENT_KEY[] = "tb_bytes_sent";
+char constexpr METRICS_MESSAGES_RECEIVED_KEY[] = "tb_messages_received";
+char constexpr METRICS_BYTES_RECEIVED_KEY[] = "tb_bytes_received";
+char constexpr METRICS_ALLOCATION_FAILURES_KEY[] = "tb_allocation_failures";
+char constexpr METRICS_MAX_DOCUMENT_SIZE_KEY[] = "tb_max_document_size";
+char constexpr METRICS_SERIALIZATION_COUNT_KEY[] = "tb_serialization_count";
+char constexpr METRICS_SERIALIZATION_AVERAGE_KEY[] = "tb_serialization_avg_us";
+char constexpr METRICS_SERIALIZATION_MAXIMUM_KEY[] = "tb_serialization_max_us";
+char constexpr METRICS_SERIALIZATION_PERCENTILE_KEY[] = "tb_serialization_p90_us";
+char constexpr METRICS_DESERIALIZATION_COUNT_KEY[] = "tb_deserialization_count";
+char constexpr METRICS_DESERIALIZATION_AVERAGE_KEY[] = "tb_deserialization_avg_us";
+char constexpr METRICS_DESERIALIZATION_MAXIMUM_KEY[] = "tb_deserialization_max_us";
+char constexpr METRICS_DESERIALIZATION_PERCENTILE_KEY[] = "tb_deserialization_p90_us";
+char constexpr METRICS_OTA_CHUNK_COUNT_KEY[] = "tb_ota_chunk_count";
+char constexpr METRICS_OTA_CHUNK_AVERAGE_KEY[] = "tb_ota_chunk_rtt_avg_us";
+char constexpr METRICS_OTA_CHUNK_MAXIMUM_KEY[] = "tb_ota_chunk_rtt_max_us";
+char constexpr METRICS_OTA_CHUNK_PERCENTILE_KEY[] = "tb_ota_chunk_rtt_p90_us";
+char constexpr METRICS_API_DISPATCHES_KEY[] = "tb_api_dispatches";
+char constexpr METRICS_API_AVERAGE_KEY[] = "tb_api_avg_us";
+char constexpr METRICS_API_MAXIMUM_KEY[] = "tb_api_max_us";
+// Amount of keys in the metrics telemetry message, the per API implementation metrics are sent as arrays, where the index is the order the API implementations were subscribed in
+size_t constexpr METRICS_KEY_AMOUNT = 22U;
+size_t constexpr METRICS_API_KEY_AMOUNT = 3U;
+// High water mark log messages.
+char constexpr RECEIVE_HIGH_WATER_MARKS[] = "Received json document peaks: required (%u), allocated (%u), used (%u) bytes";
+char constexpr SEND_HIGH_WATER_MARKS[] = "Sent json peaks: document used (%u), stack (%u bytes, %u times), heap (%u bytes, %u times), streamed (%u bytes, %u times), allocation failures (%u)";
+#endif // THINGSBOARD_ENABLE_METRICS
 // Claim topics.
 char constexpr CLAIM_TOPIC[] = "v1/devices/me/claim";
 // Claim data keys.
@@ -116,8 +164,19 @@ class ThingsBoardSized {
 #endif // THINGSBOARD_ENABLE_STREAM_UTILS
 #if THINGSBOARD_ENABLE_DYNAMIC
        , m_max_response_size(max_response_size)
+      , m_json_allocator(nullptr)
 #endif // THINGSBOARD_ENABLE_DYNAMIC
       , m_api_implementations(args...)
+      , m_max_in_flight(Default_Max_In_Flight_Amount)
+      , m_in_flight_messages()
+      , m_early_acknowledgements()
+#if THINGSBOARD_USE_MUTEX
+      , m_in_flight_mutex()
+#endif // THINGSBOARD_USE_MUTEX
+      , m_publish_queue()
+      , m_resubscribing(false)
+      , m_resubscribe_topics()
+      , m_subscribed_topics()
     {
         for (auto & api : m_api_implementations) {
             if (api == nullptr) {
@@ -125,18 +184,27 @@ class ThingsBoardSized {
             }
 #if THINGSBOARD_ENABLE_STL
             api->Set_Client_Callbacks(std::bind(&ThingsBoardSized::Subscribe_API_Implementation, this, std::placeholders::_1), std::bind(&ThingsBoardSized::Send_Json, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3), std::bind(&ThingsBoardSized::Send_Json_String, this, std::placeholders::_1, std::placeholders::_2), std::bind(&ThingsBoardSized::clientSubscribe, this, std::placeholders::_1), std::bind(&ThingsBoardSized::clientUnsubscribe, this, std::placeholders::_1), std::bind(&ThingsBoardSized::getClientReceiveBufferSize, this), std::bind(&ThingsBoardSized::getClientSendBufferSize, this), std::bind(&ThingsBoardSized::setBufferSize, this, std::placeholders::_1, std::placeholders::_2), std::bind(&ThingsBoardSized::getRequestID, this));
+            api->Set_Fragmented_Receive_Callback(std::bind(&ThingsBoardSized::clientSupportsFragmentedReceive, this));
 #else
             api->Set_Client_Callbacks(ThingsBoardSized::staticSubscribeImplementation, ThingsBoardSized::staticSendJson, ThingsBoardSized::staticSendJsonString, ThingsBoardSized::staticClientSubscribe, ThingsBoardSized::staticClientUnsubscribe, ThingsBoardSized::staticGetClientReceiveBufferSize, ThingsBoardSized::staticGetClientSendBufferSize, ThingsBoardSized::staticSetBufferSize, ThingsBoardSized::staticGetRequestID);
+            api->Set_Fragmented_Receive_Callback(ThingsBoardSized::staticClientSupportsFragmentedReceive);
 #endif // THINGSBOARD_ENABLE_STL
+#if THINGSBOARD_ENABLE_METRICS
+            api->Set_Metrics(m_metrics);
+#endif // THINGSBOARD_ENABLE_METRICS
             api->Initialize();
         }
         (void)setBufferSize(receive_buffer_size, send_buffer_size);
         // Initialize callback.
 #if THINGSBOARD_ENABLE_STL
         m_client.set_data_callback(std::bind(&ThingsBoardSized::onMQTTMessage, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
-        m_client.set_connect_callback(std::bind(&ThingsBoardSized::Resubscribe_Topics, this));
+        m_client.set_data_fragment_callback(std::bind(&ThingsBoardSized::onMQTTMessageFragment, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4, std::placeholders::_5));
+        m_client.set_publish_acknowledged_callback(std::bind(&ThingsBoardSized::onMQTTPublishAcknowledged, this, std::placeholders::_1));
+        m_client.set_connect_callback(std::bind(&ThingsBoardSized::onMQTTConnect, this));
 #else
         m_client.set_data_callback(ThingsBoardSized::onStaticMQTTMessage);
+        m_client.set_data_fragment_callback(ThingsBoardSized::onStaticMQTTMessageFragment);
+        m_client.set_publish_acknowledged_callback(ThingsBoardSized::staticMQTTPublishAcknowledged);
         m_client.set_connect_callback(ThingsBoardSized::staticMQTTConnect);
         m_subscribedInstance = this;
 #endif // THINGSBOARD_ENABLE_STL
@@ -157,6 +225,148 @@ class ThingsBoardSized {
         m_max_stack = max_stack_size;
     }
 
+    /// @brief Sets the maximum amount of messages published with QoS level 1 that may wait for their acknowledgement from the server at once.
+    /// A bigger window allows to publish more messages without having to wait for the acknowledgement of the previous ones, but each waiting message has to be tracked until it is acknowledged
+    /// @param max_in_flight Maximum amount of messages waiting for their acknowledgement, has to be between 1 and Default_Max_In_Flight_Amount (8)
+    /// @return Whether the given amount is valid and has been set or not
+    bool setMaxInFlightMessages(size_t const & max_in_flight) {
+        if (max_in_flight == 0U || max_in_flight > m_in_flight_messages.capacity()) {
+            Logger::printfln(INVALID_MAX_IN_FLIGHT, max_in_flight, m_in_flight_messages.capacity());
+            return false;
+        }
+        m_max_in_flight = max_in_flight;
+        return true;
+    }
+
+    /// @brief Gets the amount of messages published with QoS level 1 that are still waiting for their acknowledgement from the server
+    /// @return Amount of messages waiting for their acknowledgement
+    size_t getInFlightMessages() const {
+#if THINGSBOARD_USE_MUTEX
+        std::lock_guard<std::mutex> const lock(m_in_flight_mutex);
+#endif // THINGSBOARD_USE_MUTEX
+        return m_in_flight_messages.size();
+    }
+
+    /// @brief Sets the amount of bytes allocated once for the publish queue. If the queue is enabled, telemetry, attributes and responses of the API implementations are not published directly,
+    /// but copied into the queue instead and published in the following loop() calls, meaning sending data never blocks on the network and messages are kept while the connection is lost.
+    /// Messages with a higher priority overtake messages with a lower priority, for example responses to server-side RPC requests overtake any queued telemetry data.
+    /// Messages that are bigger than the send buffer of the client and are therefore serialized directly into the client with the StreamUtils library are never queued.
+    /// Additionally the queue can hold at most Default_Publish_Queue_Amount (16) messages at once, if the queue is full sending data fails instead
+    /// @param queue_size Amount of bytes used to copy the topic and payload of queued messages into, 0 disables the queue and publishes every message directly, default = 0
+    /// @return Whether allocating the given amount of bytes was successful or not
+    bool setPublishQueueSize(size_t const & queue_size) {
+        return m_publish_queue.set_size(queue_size);
+    }
+
+    /// @brief Sets the fill levels of the publish queue in percent, at which the backpressure callback is called, the default values are 75 and 25
+    /// @param high_watermark Fill level in percent, at which the queue is regarded as congested and the callback is called with true
+    /// @param low_watermark Fill level in percent, at which the queue is not regarded as congested anymore and the callback is called with false, has to be smaller than the high watermark
+    /// @return Whether the given watermarks are valid and have been set or not
+    bool setPublishQueueWatermarks(uint8_t high_watermark, uint8_t low_watermark) {
+        return m_publish_queue.set_watermarks(high_watermark, low_watermark);
+    }
+
+    /// @brief Sets the callback that is called once the fill level of the publish queue reaches the high watermark (true) and once it falls back to the low watermark (false).
+    /// Allows to reduce the rate at which data is sent, before the queue is full and messages are rejected
+    /// @param callback Method that should be called once the publish queue becomes congested or is not congested anymore
+    void setPublishQueueBackpressureCallback(typename Callback<void, bool>::function callback) {
+        m_publish_queue.set_backpressure_callback(callback);
+    }
+
+    /// @brief Gets the amount of messages currently waiting in the publish queue
+    /// @return Amount of queued messages
+    size_t getPublishQueueDepth() const {
+        return m_publish_queue.size();
+    }
+
+    /// @brief Gets the amount of bytes of the publish queue used by the currently queued messages
+    /// @return Amount of used bytes
+    size_t const & getPublishQueueUsedBytes() const {
+        return m_publish_queue.get_used_bytes();
+    }
+
+    /// @brief Gets whether the fill level of the publish queue has reached the high watermark and not fallen back to the low watermark since
+    /// @return Whether the publish queue is congested or not
+    bool isPublishQueueCongested() const {
+        return m_publish_queue.congested();
+    }
+
+#if THINGSBOARD_ENABLE_METRICS
+    /// @brief Sets the interval the recorded metrics are published in as telemetry data, checked in each loop() call.
+    /// Published with the BULK priority if the publish queue is enabled, because they should not delay any other messages
+    /// @param interval_milliseconds Interval in milliseconds between publishing the metrics, 0 disables publishing them automatically, default = 0
+    void setMetricsInterval(uint32_t interval_milliseconds) {
+        m_metrics_interval = static_cast<uint64_t>(interval_milliseconds) * 1000U;
+        m_metrics_timestamp = Metric::get_time_microseconds();
+    }
+
+    /// @brief Returns the metrics recorded since they were last published, allows to read or publish them manually instead
+    /// @return Metrics recorded since they were last published
+    Metrics & getMetrics() {
+        return m_metrics;
+    }
+
+    /// @brief Returns the peak memory requirements of the json documents and buffers used to send and receive messages since the device started or they were last reset.
+    /// Allows to right-size max_stack_size, max_response_size, the buffer sizes and the MaxResponse template argument for the messages a device actually sends and receives
+    /// @return Peak memory requirements of the json documents and buffers
+    Memory_High_Water_Marks const & getHighWaterMarks() const {
+        return m_high_water_marks;
+    }
+
+    /// @brief Resets the peak memory requirements, for example to measure the requirements of a specific part of the program
+    void resetHighWaterMarks() {
+        Memory_High_Water_Marks & marks = m_high_water_marks;
+        Metric_Counter * const counters[] = { &marks.max_required_document_size, &marks.max_allocated_document_size, &marks.max_received_document_usage, &marks.max_sent_document_usage, &marks.max_stack_json_size, &marks.max_heap_json_size, &marks.max_streamed_json_size, &marks.stack_serializations, &marks.heap_serializations, &marks.streamed_serializations, &marks.allocation_failures };
+        for (auto & counter : counters) {
+            (void)Metric::take(*counter);
+        }
+    }
+
+    /// @brief Prints the peak memory requirements with the Logger, can be called once the device has sent and received the messages it normally does to see how big the buffers actually have to be
+    void printHighWaterMarks() {
+        Memory_High_Water_Marks & marks = m_high_water_marks;
+        Logger::printfln(RECEIVE_HIGH_WATER_MARKS, Metric::read(marks.max_required_document_size), Metric::read(marks.max_allocated_document_size), Metric::read(marks.max_received_document_usage));
+        Logger::printfln(SEND_HIGH_WATER_MARKS, Metric::read(marks.max_sent_document_usage), Metric::read(marks.max_stack_json_size), Metric::read(marks.stack_serializations), Metric::read(marks.max_heap_json_size), Metric::read(marks.heap_serializations), Metric::read(marks.max_streamed_json_size), Metric::read(marks.streamed_serializations), Metric::read(marks.allocation_failures));
+    }
+
+    /// @brief Publishes the metrics recorded since they were last published as telemetry data and resets them, meaning each published value only covers the last interval.
+    /// Latencies are published as the amount of recorded latencies, their average, maximum and LATENCY_PERCENTILE in microseconds.
+    /// Metrics of the API implementations are published as arrays, where the index is the order the API implementations were subscribed in
+    /// @return Whether publishing the metrics was successful or not
+    bool sendMetrics() {
+        // Amount of API implementations with metrics, API implementations subscribed after the metrics array has been filled are not recorded
+        size_t const api_amount = m_api_implementations.size() < API_METRICS_AMOUNT ? m_api_implementations.size() : API_METRICS_AMOUNT;
+        // char const * are stored as only a pointer inside the JsonDocument --> zero copy, meaning the size for the keys is 0 bytes.
+        // Data structure size, therefore only depends on the amount of key value pairs and array elements
+#if THINGSBOARD_ENABLE_DYNAMIC
+        TBJsonDocument json_buffer(JSON_OBJECT_SIZE(METRICS_KEY_AMOUNT) + (METRICS_API_KEY_AMOUNT * JSON_ARRAY_SIZE(api_amount)));
+#else
+        StaticJsonDocument<JSON_OBJECT_SIZE(METRICS_KEY_AMOUNT) + (METRICS_API_KEY_AMOUNT * JSON_ARRAY_SIZE(API_METRICS_AMOUNT))> json_buffer;
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+        json_buffer[METRICS_PUBLISHES_KEY] = Metric::take(m_metrics.publishes);
+        json_buffer[METRICS_PUBLISH_FAILURES_KEY] = Metric::take(m_metrics.publish_failures);
+        json_buffer[METRICS_BYTES_SENT_KEY] = Metric::take(m_metrics.bytes_sent);
+        json_buffer[METRICS_MESSAGES_RECEIVED_KEY] = Metric::take(m_metrics.messages_received);
+        json_buffer[METRICS_BYTES_RECEIVED_KEY] = Metric::take(m_metrics.bytes_received);
+        json_buffer[METRICS_ALLOCATION_FAILURES_KEY] = Metric::take(m_metrics.allocation_failures);
+        json_buffer[METRICS_MAX_DOCUMENT_SIZE_KEY] = Metric::take(m_metrics.max_document_size);
+        Add_Latency_Snapshot(json_buffer, m_metrics.serialization.take_snapshot(), METRICS_SERIALIZATION_COUNT_KEY, METRICS_SERIALIZATION_AVERAGE_KEY, METRICS_SERIALIZATION_MAXIMUM_KEY, METRICS_SERIALIZATION_PERCENTILE_KEY);
+        Add_Latency_Snapshot(json_buffer, m_metrics.deserialization.take_snapshot(), METRICS_DESERIALIZATION_COUNT_KEY, METRICS_DESERIALIZATION_AVERAGE_KEY, METRICS_DESERIALIZATION_MAXIMUM_KEY, METRICS_DESERIALIZATION_PERCENTILE_KEY);
+        Add_Latency_Snapshot(json_buffer, m_metrics.ota_chunk_round_trip.take_snapshot(), METRICS_OTA_CHUNK_COUNT_KEY, METRICS_OTA_CHUNK_AVERAGE_KEY, METRICS_OTA_CHUNK_MAXIMUM_KEY, METRICS_OTA_CHUNK_PERCENTILE_KEY);
+
+        JsonArray dispatches = json_buffer.createNestedArray(METRICS_API_DISPATCHES_KEY);
+        JsonArray averages = json_buffer.createNestedArray(METRICS_API_AVERAGE_KEY);
+        JsonArray maximums = json_buffer.createNestedArray(METRICS_API_MAXIMUM_KEY);
+        for (size_t i = 0U; i < api_amount; i++) {
+            Latency_Snapshot const snapshot = m_api_metrics[i].handler.take_snapshot();
+            dispatches.add(Metric::take(m_api_metrics[i].dispatches));
+            averages.add(snapshot.average);
+            maximums.add(snapshot.maximum);
+        }
+        return Publish_Json(TELEMETRY_TOPIC, json_buffer, Helper::Measure_Json(json_buffer), 0U, nullptr, Publish_Priority::BULK);
+    }
+#endif // THINGSBOARD_ENABLE_METRICS
+
 #if THINGSBOARD_ENABLE_STREAM_UTILS
     /// @brief Sets the amount of bytes that can be allocated to speed up fall back serialization with the StreamUtils class
     /// See https://github.com/bblanchon/ArduinoStreamUtils for more information on the underlying class used
@@ -177,6 +387,14 @@ class ThingsBoardSized {
     void setMaxResponseSize(size_t const & max_response_size) {
         m_max_response_size = max_response_size;
     }
+
+    /// @brief Sets the allocator used for the internal JsonDocument holding received payload from server responses, instead of allocating it from the general heap for every received message.
+    /// Allows to use a Json_Block_Allocator, which reserves blocks once at startup that are reused for every received message, to prevent fragmenting the heap on devices that run for a long time.
+    /// Ensure the allocator is kept alive for as long as the instance of this class
+    /// @param json_allocator Allocator used to allocate the memory of the internal JsonDocument, nullptr to allocate it with the TBJsonAllocator (heap or psram) again, default = nullptr
+    void setJsonAllocator(IJson_Allocator * json_allocator) {
+        m_json_allocator = json_allocator;
+    }
 #endif // THINGSBOARD_ENABLE_DYNAMIC
 
     /// @brief Sets the size of the buffer for the underlying network client that will be used to establish the connection to ThingsBoard.
@@ -196,6 +414,9 @@ class ThingsBoardSized {
         bool const result = m_client.set_buffer_size(receive_buffer_size, send_buffer_size);
         if (!result) {
             Logger::printfln(UNABLE_TO_ALLOCATE_BUFFER);
+#if THINGSBOARD_ENABLE_METRICS
+            Record_Allocation_Failure();
+#endif // THINGSBOARD_ENABLE_METRICS
         }
         return result;
     }
@@ -235,9 +456,35 @@ class ThingsBoardSized {
         return connectToHost(access_token, Helper::stringIsNullorEmpty(client_id) ? access_token : client_id, Helper::stringIsNullorEmpty(password) ? nullptr : password);
     }
 
-    /// @brief Disconnects any connection that has been established already
+    /// @brief Connects to the specified ThingsBoard server over the given port with the credentials cached in the given store, by a previous successful provisioning request.
+    /// Allows to skip provisioning on every startup and only send a provisioning request if no credentials are cached yet or the server rejected them.
+    /// If the server rejects the cached credentials, because the device has been deleted or its credentials have been changed, they are cleared from the store.
+    /// Clients that connect asynchronously like the Espressif_MQTT_Client only receive the rejection after connect() has returned,
+    /// in that case the credentials are cleared on the next call to this method instead. See Provision for how the credentials are written into the store
+    /// @param host ThingsBoard server instance we want to connect to
+    /// @param credential_store Store the previously provisioned credentials are read from
+    /// @param port Port that will be used to establish a connection and send / receive data from ThingsBoard over, default = DEFAULT_MQTT_PORT (1883)
+    /// @return Whether connecting to ThingsBoard was successful or not, false if no credentials are cached or they have been rejected, meaning the device should be provisioned again
+    bool connect(char const * host, ICredential_Store & credential_store, uint16_t port = DEFAULT_MQTT_PORT) {
+        Device_Credentials credentials;
+        if (!credential_store.load(credentials)) {
+            return false;
+        }
+        else if (!m_client.authentication_rejected() && connect(host, credentials.username, port, credentials.client_id, credentials.password)) {
+            return true;
+        }
+        else if (m_client.authentication_rejected()) {
+            Logger::printfln(CACHED_CREDENTIALS_REJECTED);
+            (void)credential_store.clear();
+        }
+        return false;
+    }
+
+    /// @brief Disconnects any connection that has been established already.
+    /// Messages published with QoS level 1 that have not been acknowledged yet are failed, because they are discarded on the MQTT broker once the connection is closed
     void disconnect() {
         m_client.disconnect();
+        Fail_In_Flight_Messages();
     }
 
     /// @brief Returns our current connection status to the cloud, true meaning we are connected,
@@ -247,7 +494,7 @@ class ThingsBoardSized {
         return m_client.connected();
     }
 
-    /// @brief Receives / sends any outstanding messages from and to the MQTT broker.
+    /// @brief Receives / sends any outstanding messages from and to the MQTT broker, including the messages waiting in the publish queue.
     /// Additionally when not being able to use the ESP Timer, it updates the internal timeout timers
     /// @return Whether sending or receiving the oustanding the messages was successful or not
     bool loop() {
@@ -259,89 +506,37 @@ class ThingsBoardSized {
             api->loop();
         }
 #endif // !THINGSBOARD_USE_ESP_TIMER
-        return m_client.loop();
+        bool const result = m_client.loop();
+        Retry_Failed_Subscriptions();
+#if THINGSBOARD_ENABLE_METRICS
+        if (m_metrics_interval != 0U && Metric::get_time_microseconds() - m_metrics_timestamp >= m_metrics_interval) {
+            m_metrics_timestamp = Metric::get_time_microseconds();
+            (void)sendMetrics();
+        }
+#endif // THINGSBOARD_ENABLE_METRICS
+        // Published after receiving, so that responses queued while handling the received messages are sent in the same call
+        Publish_Queued_Messages();
+        return result;
     }
 
-    /// @brief Attempts to send key value pairs from custom source over the given topic to the server
+    /// @brief Attempts to send key value pairs from custom source over the given topic to the server.
+    /// Sent with the URGENT priority if the publish queue is enabled, because it is used by the API implementations to send requests and responses
     /// @param topic Topic we want to send the data over
     /// @param source JsonDocument containing our json key value pairs we want to send,
     /// is checked before usage for any possible occuring internal errors. See https://arduinojson.org/v6/api/jsondocument/ for more information
     /// @param json_size Size of the data inside the source
     /// @return Whether sending the data was successful or not
     bool Send_Json(char const * topic, JsonDocument const & source, size_t const & json_size) {
-        // Check if allocating needed memory failed when trying to create the JsonDocument,
-        // if it did the isNull() method will return true. See https://arduinojson.org/v6/api/jsonvariant/isnull/ for more information
-        if (source.isNull()) {
-            Logger::printfln(UNABLE_TO_ALLOCATE_JSON);
-            return false;
-        }
-        // Check if inserting any of the internal values failed because the JsonDocument was too small,
-        // if it did the overflowed() method will return true. See https://arduinojson.org/v6/api/jsondocument/overflowed/ for more information
-        if (source.overflowed()) {
-            Logger::printfln(JSON_SIZE_TO_SMALL);
-            return false;
-        }
-        bool result = false;
-
-#if THINGSBOARD_ENABLE_STREAM_UTILS
-        // Check if the size of the given message would be too big for the actual client,
-        // if it is utilize the serialize json work around, so that the internal client buffer can be circumvented
-        if (m_client.get_buffer_size() < json_size)  {
-#if THINGSBOARD_ENABLE_DEBUG
-            Logger::printfln(SEND_MESSAGE, topic, SEND_SERIALIZED);
-#endif // THINGSBOARD_ENABLE_DEBUG
-            result = Serialize_Json(topic, source, json_size - 1);
-        }
-        // Check if the remaining stack size of the current task would overflow the stack,
-        // if it would allocate the memory on the heap instead to ensure no stack overflow occurs
-        else
-#endif // THINGSBOARD_ENABLE_STREAM_UTILS
-        if (json_size > getMaximumStackSize()) {
-            char* json = new char[json_size]();
-            if (serializeJson(source, json, json_size) < json_size - 1) {
-                Logger::printfln(UNABLE_TO_SERIALIZE_JSON);
-            }
-            else {
-                result = Send_Json_String(topic, json);
-            }
-            // Ensure to actually delete the memory placed onto the heap, to make sure we do not create a memory leak
-            // and set the pointer to null so we do not have a dangling reference.
-            delete[] json;
-            json = nullptr;
-        }
-        else {
-            char json[json_size] = {};
-            if (serializeJson(source, json, json_size) < json_size - 1) {
-                Logger::printfln(UNABLE_TO_SERIALIZE_JSON);
-                return result;
-            }
-            result = Send_Json_String(topic, json);
-        }
-
-        return result;
+        return Publish_Json(topic, source, json_size, 0U, nullptr, Publish_Priority::URGENT);
     }
 
-    /// @brief Attempts to send custom json string over the given topic to the server
+    /// @brief Attempts to send custom json string over the given topic to the server.
+    /// Sent with the URGENT priority if the publish queue is enabled, because it is used by the API implementations to send requests and responses
     /// @param topic Topic we want to send the data over
     /// @param json String containing our json key value pairs we want to attempt to send
     /// @return Whether sending the data was successful or not
     bool Send_Json_String(char const * topic, char const * json) {
-        if (json == nullptr) {
-            return false;
-        }
-
-        uint16_t current_send_buffer_size = m_client.get_send_buffer_size();
-        size_t const json_size = strlen(json);
-
-        if (current_send_buffer_size < json_size) {
-            Logger::printfln(INVALID_BUFFER_SIZE, current_send_buffer_size, json_size);
-            return false;
-        }
-
-#if THINGSBOARD_ENABLE_DEBUG
-        Logger::printfln(SEND_MESSAGE, topic, json);
-#endif // THINGSBOARD_ENABLE_DEBUG
-        return m_client.publish(topic, reinterpret_cast<uint8_t const *>(json), json_size);
+        return Publish_Json_String(topic, json, 0U, nullptr, Publish_Priority::URGENT);
     }
 
     /// @brief Copies a non-owning pointer to the given API implementation, into the local data container.
@@ -356,9 +551,14 @@ class ThingsBoardSized {
 #endif // !THINGSBOARD_ENABLE_DYNAMIC
 #if THINGSBOARD_ENABLE_STL
         api.Set_Client_Callbacks(std::bind(&ThingsBoardSized::Subscribe_API_Implementation, this, std::placeholders::_1), std::bind(&ThingsBoardSized::Send_Json, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3), std::bind(&ThingsBoardSized::Send_Json_String, this, std::placeholders::_1, std::placeholders::_2), std::bind(&ThingsBoardSized::clientSubscribe, this, std::placeholders::_1), std::bind(&ThingsBoardSized::clientUnsubscribe, this, std::placeholders::_1), std::bind(&ThingsBoardSized::getClientReceiveBufferSize, this), std::bind(&ThingsBoardSized::getClientSendBufferSize, this), std::bind(&ThingsBoardSized::setBufferSize, this, std::placeholders::_1, std::placeholders::_2), std::bind(&ThingsBoardSized::getRequestID, this));
+        api.Set_Fragmented_Receive_Callback(std::bind(&ThingsBoardSized::clientSupportsFragmentedReceive, this));
 #else
         api.Set_Client_Callbacks(ThingsBoardSized::staticSubscribeImplementation, ThingsBoardSized::staticSendJson, ThingsBoardSized::staticSendJsonString, ThingsBoardSized::staticClientSubscribe, ThingsBoardSized::staticClientUnsubscribe, ThingsBoardSized::staticGetClientReceiveBufferSize, ThingsBoardSized::staticGetClientSendBufferSize, ThingsBoardSized::staticSetBufferSize, ThingsBoardSized::staticGetRequestID);
+        api.Set_Fragmented_Receive_Callback(ThingsBoardSized::staticClientSupportsFragmentedReceive);
 #endif // THINGSBOARD_ENABLE_STL
+#if THINGSBOARD_ENABLE_METRICS
+        api.Set_Metrics(m_metrics);
+#endif // THINGSBOARD_ENABLE_METRICS
         api.Initialize();
         m_api_implementations.push_back(&api);
     }
@@ -387,9 +587,14 @@ class ThingsBoardSized {
             }
 #if THINGSBOARD_ENABLE_STL
             api->Set_Client_Callbacks(std::bind(&ThingsBoardSized::Subscribe_API_Implementation, this, std::placeholders::_1), std::bind(&ThingsBoardSized::Send_Json, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3), std::bind(&ThingsBoardSized::Send_Json_String, this, std::placeholders::_1, std::placeholders::_2), std::bind(&ThingsBoardSized::clientSubscribe, this, std::placeholders::_1), std::bind(&ThingsBoardSized::clientUnsubscribe, this, std::placeholders::_1), std::bind(&ThingsBoardSized::getClientReceiveBufferSize, this), std::bind(&ThingsBoardSized::getClientSendBufferSize, this), std::bind(&ThingsBoardSized::setBufferSize, this, std::placeholders::_1, std::placeholders::_2), std::bind(&ThingsBoardSized::getRequestID, this));
+            api->Set_Fragmented_Receive_Callback(std::bind(&ThingsBoardSized::clientSupportsFragmentedReceive, this));
 #else
             api->Set_Client_Callbacks(ThingsBoardSized::staticSubscribeImplementation, ThingsBoardSized::staticSendJson, ThingsBoardSized::staticSendJsonString, ThingsBoardSized::staticClientSubscribe, ThingsBoardSized::staticClientUnsubscribe, ThingsBoardSized::staticGetClientReceiveBufferSize, ThingsBoardSized::staticGetClientSendBufferSize, ThingsBoardSized::staticSetBufferSize, ThingsBoardSized::staticGetRequestID);
+            api->Set_Fragmented_Receive_Callback(ThingsBoardSized::staticClientSupportsFragmentedReceive);
 #endif // THINGSBOARD_ENABLE_STL
+#if THINGSBOARD_ENABLE_METRICS
+            api->Set_Metrics(m_metrics);
+#endif // THINGSBOARD_ENABLE_METRICS
             api->Initialize();
         }
         m_api_implementations.insert(m_api_implementations.end(), first, last);
@@ -424,10 +629,14 @@ class ThingsBoardSized {
     /// @tparam T Type of the passed value
     /// @param key Key of the key value pair we want to send
     /// @param value Value of the key value pair we want to send
+    /// @param qos QoS level the data is published with, QoS level 1 is only supported if the underlying MQTT client supports it and additionally requires the data to fit into the send buffer, default = 0
+    /// @param acknowledged_callback Callback that is called with the packet id and whether the data has been acknowledged by the server (true) or lost, because the connection was closed first (false).
+    /// Only called if the data was published with QoS level 1, default = nullptr
+    /// @param priority Priority the data is queued with if the publish queue has been enabled with setPublishQueueSize, messages with a higher priority overtake queued messages with a lower priority, default = Publish_Priority::NORMAL
     /// @return Whether sending the data was successful or not
     template<typename T>
-    bool sendTelemetryData(char const * key, T const & value) {
-        return sendKeyValue(key, value);
+    bool sendTelemetryData(char const * key, T const & value, uint8_t qos = 0U, typename Callback<void, uint16_t, bool>::function acknowledged_callback = nullptr, Publish_Priority priority = Publish_Priority::NORMAL) {
+        return sendKeyValue(key, value, true, qos, acknowledged_callback, priority);
     }
 
     /// @brief Attempts to send aggregated telemetry data, expects iterators to a container containing Telemetry class instances.
@@ -437,6 +646,10 @@ class ThingsBoardSized {
     /// See https://en.cppreference.com/w/cpp/iterator/input_iterator for more information on the requirements of the iterator
     /// @param first Iterator pointing to the first element in the data container
     /// @param last Iterator pointing to the end of the data container (last element + 1)
+    /// @param qos QoS level the data is published with, QoS level 1 is only supported if the underlying MQTT client supports it and additionally requires the data to fit into the send buffer, default = 0
+    /// @param acknowledged_callback Callback that is called with the packet id and whether the data has been acknowledged by the server (true) or lost, because the connection was closed first (false).
+    /// Only called if the data was published with QoS level 1, default = nullptr
+    /// @param priority Priority the data is queued with if the publish queue has been enabled with setPublishQueueSize, messages with a higher priority overtake queued messages with a lower priority, default = Publish_Priority::NORMAL
     /// @return Whether sending the aggregated telemetry data was successful or not
 #if THINGSBOARD_ENABLE_DYNAMIC
     template<typename InputIterator>
@@ -445,20 +658,24 @@ class ThingsBoardSized {
     /// Should simply be the biggest distance between first and last iterator this method is ever called with
     template<size_t MaxKeyValuePairAmount, typename InputIterator>
 #endif // THINGSBOARD_ENABLE_DYNAMIC
-    bool sendTelemetry(InputIterator const & first, InputIterator const & last) {
+    bool sendTelemetry(InputIterator const & first, InputIterator const & last, uint8_t qos = 0U, typename Callback<void, uint16_t, bool>::function acknowledged_callback = nullptr, Publish_Priority priority = Publish_Priority::NORMAL) {
 #if THINGSBOARD_ENABLE_DYNAMIC
-        return sendDataArray(first, last, true);
+        return sendDataArray(first, last, true, qos, acknowledged_callback, priority);
 #else
-        return sendDataArray<MaxKeyValuePairAmount>(first, last, true);
+        return sendDataArray<MaxKeyValuePairAmount>(first, last, true, qos, acknowledged_callback, priority);
 #endif // THINGSBOARD_ENABLE_DYNAMIC
     }
 
     /// @brief Attempts to send custom json telemetry string.
     /// See https://thingsboard.io/docs/user-guide/telemetry/ for more information
     /// @param json String containing our json key value pairs we want to attempt to send
+    /// @param qos QoS level the data is published with, QoS level 1 is only supported if the underlying MQTT client supports it and additionally requires the data to fit into the send buffer, default = 0
+    /// @param acknowledged_callback Callback that is called with the packet id and whether the data has been acknowledged by the server (true) or lost, because the connection was closed first (false).
+    /// Only called if the data was published with QoS level 1, default = nullptr
+    /// @param priority Priority the data is queued with if the publish queue has been enabled with setPublishQueueSize, messages with a higher priority overtake queued messages with a lower priority, default = Publish_Priority::NORMAL
     /// @return Whether sending the data was successful or not
-    bool sendTelemetryString(char const * json) {
-        return Send_Json_String(TELEMETRY_TOPIC, json);
+    bool sendTelemetryString(char const * json, uint8_t qos = 0U, typename Callback<void, uint16_t, bool>::function acknowledged_callback = nullptr, Publish_Priority priority = Publish_Priority::NORMAL) {
+        return Publish_Json_String(TELEMETRY_TOPIC, json, qos, acknowledged_callback, priority);
     }
 
     /// @brief Attempts to send telemetry key value pairs from custom source to the server.
@@ -466,9 +683,13 @@ class ThingsBoardSized {
     /// @param source JsonDocument containing our json key value pairs we want to send,
     /// is checked before usage for any possible occuring internal errors. See https://arduinojson.org/v6/api/jsondocument/ for more information
     /// @param json_size Size of the data inside the source
+    /// @param qos QoS level the data is published with, QoS level 1 is only supported if the underlying MQTT client supports it and additionally requires the data to fit into the send buffer, default = 0
+    /// @param acknowledged_callback Callback that is called with the packet id and whether the data has been acknowledged by the server (true) or lost, because the connection was closed first (false).
+    /// Only called if the data was published with QoS level 1, default = nullptr
+    /// @param priority Priority the data is queued with if the publish queue has been enabled with setPublishQueueSize, messages with a higher priority overtake queued messages with a lower priority, default = Publish_Priority::NORMAL
     /// @return Whether sending the data was successful or not
-    bool sendTelemetryJson(JsonDocument const & source, size_t const & json_size) {
-        return Send_Json(TELEMETRY_TOPIC, source, json_size);
+    bool sendTelemetryJson(JsonDocument const & source, size_t const & json_size, uint8_t qos = 0U, typename Callback<void, uint16_t, bool>::function acknowledged_callback = nullptr, Publish_Priority priority = Publish_Priority::NORMAL) {
+        return Publish_Json(TELEMETRY_TOPIC, source, json_size, qos, acknowledged_callback, priority);
     }
 
     //----------------------------------------------------------------------------
@@ -479,10 +700,14 @@ class ThingsBoardSized {
     /// @tparam T Type of the passed value
     /// @param key Key of the key value pair we want to send
     /// @param value Value of the key value pair we want to send
+    /// @param qos QoS level the data is published with, QoS level 1 is only supported if the underlying MQTT client supports it and additionally requires the data to fit into the send buffer, default = 0
+    /// @param acknowledged_callback Callback that is called with the packet id and whether the data has been acknowledged by the server (true) or lost, because the connection was closed first (false).
+    /// Only called if the data was published with QoS level 1, default = nullptr
+    /// @param priority Priority the data is queued with if the publish queue has been enabled with setPublishQueueSize, messages with a higher priority overtake queued messages with a lower priority, default = Publish_Priority::NORMAL
     /// @return Whether sending the data was successful or not
     template<typename T>
-    bool sendAttributeData(char const * key, T const & value) {
-        return sendKeyValue(key, value, false);
+    bool sendAttributeData(char const * key, T const & value, uint8_t qos = 0U, typename Callback<void, uint16_t, bool>::function acknowledged_callback = nullptr, Publish_Priority priority = Publish_Priority::NORMAL) {
+        return sendKeyValue(key, value, false, qos, acknowledged_callback, priority);
     }
 
     /// @brief Attempts to send aggregated attribute data, expects iterators to a container containing Attribute class instances.
@@ -492,6 +717,10 @@ class ThingsBoardSized {
     /// See https://en.cppreference.com/w/cpp/iterator/input_iterator for more information on the requirements of the iterator
     /// @param first Iterator pointing to the first element in the data container
     /// @param last Iterator pointing to the end of the data container (last element + 1)
+    /// @param qos QoS level the data is published with, QoS level 1 is only supported if the underlying MQTT client supports it and additionally requires the data to fit into the send buffer, default = 0
+    /// @param acknowledged_callback Callback that is called with the packet id and whether the data has been acknowledged by the server (true) or lost, because the connection was closed first (false).
+    /// Only called if the data was published with QoS level 1, default = nullptr
+    /// @param priority Priority the data is queued with if the publish queue has been enabled with setPublishQueueSize, messages with a higher priority overtake queued messages with a lower priority, default = Publish_Priority::NORMAL
     /// @return Whether sending the aggregated attribute data was successful or not
 #if THINGSBOARD_ENABLE_DYNAMIC
     template<typename InputIterator>
@@ -500,20 +729,24 @@ class ThingsBoardSized {
     /// Should simply be the biggest distance between first and last iterator this method is ever called with
     template<size_t MaxKeyValuePairAmount, typename InputIterator>
 #endif // THINGSBOARD_ENABLE_DYNAMIC
-    bool sendAttributes(InputIterator const & first, InputIterator const & last) {
+    bool sendAttributes(InputIterator const & first, InputIterator const & last, uint8_t qos = 0U, typename Callback<void, uint16_t, bool>::function acknowledged_callback = nullptr, Publish_Priority priority = Publish_Priority::NORMAL) {
 #if THINGSBOARD_ENABLE_DYNAMIC
-        return sendDataArray(first, last, false);
+        return sendDataArray(first, last, false, qos, acknowledged_callback, priority);
 #else
-        return sendDataArray<MaxKeyValuePairAmount>(first, last, false);
+        return sendDataArray<MaxKeyValuePairAmount>(first, last, false, qos, acknowledged_callback, priority);
 #endif // THINGSBOARD_ENABLE_DYNAMIC
     }
 
     /// @brief Attempts to send custom json attribute string.
     /// See https://thingsboard.io/docs/user-guide/attributes/ for more information
     /// @param json String containing our json key value pairs we want to attempt to send
+    /// @param qos QoS level the data is published with, QoS level 1 is only supported if the underlying MQTT client supports it and additionally requires the data to fit into the send buffer, default = 0
+    /// @param acknowledged_callback Callback that is called with the packet id and whether the data has been acknowledged by the server (true) or lost, because the connection was closed first (false).
+    /// Only called if the data was published with QoS level 1, default = nullptr
+    /// @param priority Priority the data is queued with if the publish queue has been enabled with setPublishQueueSize, messages with a higher priority overtake queued messages with a lower priority, default = Publish_Priority::NORMAL
     /// @return Whether sending the data was successful or not
-    bool sendAttributeString(char const * json) {
-        return Send_Json_String(ATTRIBUTE_TOPIC, json);
+    bool sendAttributeString(char const * json, uint8_t qos = 0U, typename Callback<void, uint16_t, bool>::function acknowledged_callback = nullptr, Publish_Priority priority = Publish_Priority::NORMAL) {
+        return Publish_Json_String(ATTRIBUTE_TOPIC, json, qos, acknowledged_callback, priority);
     }
 
     /// @brief Attempts to send attribute key value pairs from custom source to the server.
@@ -521,12 +754,294 @@ class ThingsBoardSized {
     /// @param source JsonDocument containing our json key value pairs we want to send,
     /// is checked before usage for any possible occuring internal errors. See https://arduinojson.org/v6/api/jsondocument/ for more information
     /// @param json_size Size of the data inside the source
+    /// @param qos QoS level the data is published with, QoS level 1 is only supported if the underlying MQTT client supports it and additionally requires the data to fit into the send buffer, default = 0
+    /// @param acknowledged_callback Callback that is called with the packet id and whether the data has been acknowledged by the server (true) or lost, because the connection was closed first (false).
+    /// Only called if the data was published with QoS level 1, default = nullptr
+    /// @param priority Priority the data is queued with if the publish queue has been enabled with setPublishQueueSize, messages with a higher priority overtake queued messages with a lower priority, default = Publish_Priority::NORMAL
     /// @return Whether sending the data was successful or not
-    bool sendAttributeJson(JsonDocument const & source, size_t const & json_size) {
-        return Send_Json(ATTRIBUTE_TOPIC, source, json_size);
+    bool sendAttributeJson(JsonDocument const & source, size_t const & json_size, uint8_t qos = 0U, typename Callback<void, uint16_t, bool>::function acknowledged_callback = nullptr, Publish_Priority priority = Publish_Priority::NORMAL) {
+        return Publish_Json(ATTRIBUTE_TOPIC, source, json_size, qos, acknowledged_callback, priority);
     }
 
   private:
+#if THINGSBOARD_ENABLE_METRICS
+#if !THINGSBOARD_ENABLE_DYNAMIC
+    static size_t constexpr API_METRICS_AMOUNT = MaxEndpointsAmount;
+#else
+    static size_t constexpr API_METRICS_AMOUNT = Default_Endpoints_Amount;
+#endif // !THINGSBOARD_ENABLE_DYNAMIC
+#endif // THINGSBOARD_ENABLE_METRICS
+
+    /// @brief Message published with QoS level 1, that is waiting for its acknowledgement from the server
+    struct In_Flight_Message {
+        uint16_t                       packet_id = {};            // Packet identifier the message was published with, the acknowledgement of the server contains the same identifier. 0 while the message is still being published, because that identifier is never used by MQTT
+        Callback<void, uint16_t, bool> acknowledged_callback = {}; // Callback that is called once the message has been acknowledged or lost
+    };
+
+    /// @brief Topic filter subscribed with the underlying client interface, together with the amount of references API implementations hold on it
+    struct Subscribed_Topic {
+        char const *topic = {};      // Topic filter, not copied because all API implementations subscribe constant topic strings
+        size_t     references = {};  // Amount of times the topic has been subscribed by API implementations without being unsubscribed again
+        bool       subscribed = {};  // Whether the underlying client interface subscribed the topic, false if subscribing all collected topics failed, in which case it is retried in the following loop() calls
+    };
+
+    /// @brief Attempts to send key value pairs from custom source over the given topic to the server
+    /// @param topic Topic we want to send the data over
+    /// @param source JsonDocument containing our json key value pairs we want to send,
+    /// is checked before usage for any possible occuring internal errors. See https://arduinojson.org/v6/api/jsondocument/ for more information
+    /// @param json_size Size of the data inside the source
+    /// @param qos QoS level the message is published with, messages that are bigger than the internal buffer of the client can only be sent with QoS level 0
+    /// @param acknowledged_callback Callback that is called with the packet id and whether the message has been acknowledged by the server (true) or lost, because the connection was closed first (false).
+    /// Only called if the message was published with QoS level 1
+    /// @param priority Priority the message is queued with if the publish queue is enabled, messages with a higher priority overtake queued messages with a lower priority
+    /// @return Whether sending the data was successful or not
+    bool Publish_Json(char const * topic, JsonDocument const & source, size_t const & json_size, uint8_t qos, typename Callback<void, uint16_t, bool>::function acknowledged_callback, Publish_Priority priority) {
+        // Check if allocating needed memory failed when trying to create the JsonDocument,
+        // if it did the isNull() method will return true. See https://arduinojson.org/v6/api/jsonvariant/isnull/ for more information
+        if (source.isNull()) {
+            Logger::printfln(UNABLE_TO_ALLOCATE_JSON);
+#if THINGSBOARD_ENABLE_METRICS
+            Record_Allocation_Failure();
+#endif // THINGSBOARD_ENABLE_METRICS
+            return false;
+        }
+        // Check if inserting any of the internal values failed because the JsonDocument was too small,
+        // if it did the overflowed() method will return true. See https://arduinojson.org/v6/api/jsondocument/overflowed/ for more information
+        if (source.overflowed()) {
+            Logger::printfln(JSON_SIZE_TO_SMALL);
+            return false;
+        }
+#if THINGSBOARD_ENABLE_METRICS
+        Metric::update_maximum(m_high_water_marks.max_sent_document_usage, source.memoryUsage());
+#endif // THINGSBOARD_ENABLE_METRICS
+        bool result = false;
+
+#if THINGSBOARD_ENABLE_STREAM_UTILS
+        // Check if the size of the given message would be too big for the actual client,
+        // if it is utilize the serialize json work around, so that the internal client buffer can be circumvented, which is only possible for messages that do not need to be acknowledged.
+        // Because the message is serialized directly into the client, it is sent immediately even if the publish queue is enabled
+        if (qos == 0U && m_client.get_buffer_size() < json_size)  {
+#if THINGSBOARD_ENABLE_DEBUG
+            Logger::printfln(SEND_MESSAGE, topic, SEND_SERIALIZED);
+#endif // THINGSBOARD_ENABLE_DEBUG
+#if THINGSBOARD_ENABLE_METRICS
+            Metric::increment(m_high_water_marks.streamed_serializations);
+            Metric::update_maximum(m_high_water_marks.max_streamed_json_size, json_size);
+#endif // THINGSBOARD_ENABLE_METRICS
+            result = Serialize_Json(topic, source, json_size - 1);
+        }
+        // Check if the remaining stack size of the current task would overflow the stack,
+        // if it would allocate the memory on the heap instead to ensure no stack overflow occurs
+        else
+#endif // THINGSBOARD_ENABLE_STREAM_UTILS
+        if (json_size > getMaximumStackSize()) {
+#if THINGSBOARD_ENABLE_METRICS
+            Metric::increment(m_high_water_marks.heap_serializations);
+            Metric::update_maximum(m_high_water_marks.max_heap_json_size, json_size);
+#endif // THINGSBOARD_ENABLE_METRICS
+            char* json = new char[json_size]();
+            if (Serialize_Json_Buffer(source, json, json_size) < json_size - 1) {
+                Logger::printfln(UNABLE_TO_SERIALIZE_JSON);
+            }
+            else {
+                result = Publish_Json_String(topic, json, qos, acknowledged_callback, priority);
+            }
+            // Ensure to actually delete the memory placed onto the heap, to make sure we do not create a memory leak
+            // and set the pointer to null so we do not have a dangling reference.
+            delete[] json;
+            json = nullptr;
+        }
+        else {
+#if THINGSBOARD_ENABLE_METRICS
+            Metric::increment(m_high_water_marks.stack_serializations);
+            Metric::update_maximum(m_high_water_marks.max_stack_json_size, json_size);
+#endif // THINGSBOARD_ENABLE_METRICS
+            char json[json_size] = {};
+            if (Serialize_Json_Buffer(source, json, json_size) < json_size - 1) {
+                Logger::printfln(UNABLE_TO_SERIALIZE_JSON);
+                return result;
+            }
+            result = Publish_Json_String(topic, json, qos, acknowledged_callback, priority);
+        }
+
+        return result;
+    }
+
+    /// @brief Serializes the given json document into the given buffer and records how long the serialization took, if THINGSBOARD_ENABLE_METRICS is set
+    /// @param source JsonDocument containing our json key value pairs we want to serialize
+    /// @param json Buffer the serialized json is written into
+    /// @param json_size Size of the buffer including the null termination
+    /// @return Amount of bytes that were written into the buffer, not including the null termination
+    size_t Serialize_Json_Buffer(JsonDocument const & source, char * json, size_t const & json_size) {
+#if THINGSBOARD_ENABLE_METRICS
+        uint64_t const start_time = Metric::get_time_microseconds();
+        size_t const bytes_serialized = serializeJson(source, json, json_size);
+        m_metrics.serialization.record_since(start_time);
+        return bytes_serialized;
+#else
+        return serializeJson(source, json, json_size);
+#endif // THINGSBOARD_ENABLE_METRICS
+    }
+
+    /// @brief Attempts to send custom json string over the given topic to the server
+    /// @param topic Topic we want to send the data over
+    /// @param json String containing our json key value pairs we want to attempt to send
+    /// @param qos QoS level the message is published with
+    /// @param acknowledged_callback Callback that is called with the packet id and whether the message has been acknowledged by the server (true) or lost, because the connection was closed first (false).
+    /// Only called if the message was published with QoS level 1
+    /// @param priority Priority the message is queued with if the publish queue is enabled, messages with a higher priority overtake queued messages with a lower priority
+    /// @return Whether sending the data was successful or not
+    bool Publish_Json_String(char const * topic, char const * json, uint8_t qos, typename Callback<void, uint16_t, bool>::function acknowledged_callback, Publish_Priority priority) {
+        if (json == nullptr) {
+            return false;
+        }
+        else if (qos > 1U) {
+            Logger::printfln(INVALID_QOS_LEVEL, qos);
+            return false;
+        }
+
+        uint16_t current_send_buffer_size = m_client.get_send_buffer_size();
+        size_t const json_size = strlen(json);
+
+        if (current_send_buffer_size < json_size) {
+            Logger::printfln(INVALID_BUFFER_SIZE, current_send_buffer_size, json_size);
+            return false;
+        }
+
+#if THINGSBOARD_ENABLE_DEBUG
+        Logger::printfln(SEND_MESSAGE, topic, json);
+#endif // THINGSBOARD_ENABLE_DEBUG
+        if (m_publish_queue.enabled()) {
+            return m_publish_queue.push(topic, reinterpret_cast<uint8_t const *>(json), json_size, qos, priority, acknowledged_callback);
+        }
+        return Publish_Message(topic, reinterpret_cast<uint8_t const *>(json), json_size, qos, Callback<void, uint16_t, bool>(acknowledged_callback));
+    }
+
+    /// @brief Publishes the given message with the underlying client and keeps track of it until it is acknowledged, if it is published with QoS level 1
+    /// @param topic Topic we want to send the data over
+    /// @param payload Payload we want to send
+    /// @param length Size of the payload in bytes
+    /// @param qos QoS level the message is published with
+    /// @param acknowledged_callback Callback that is called once the message published with QoS level 1 has been acknowledged or lost
+    /// @return Whether publishing the message was successful or not
+    bool Publish_Message(char const * topic, uint8_t const * payload, size_t const & length, uint8_t qos, Callback<void, uint16_t, bool> const & acknowledged_callback) {
+        // The slot is reserved before the message is published, because some clients receive the acknowledgement on another task, which could otherwise arrive before the message is tracked
+        if (qos != 0U && !Reserve_In_Flight_Message(acknowledged_callback)) {
+            Logger::printfln(MAX_IN_FLIGHT_EXCEEDED, m_max_in_flight);
+            return false;
+        }
+        uint16_t packet_id = 0U;
+        if (!m_client.publish(topic, payload, length, qos, packet_id)) {
+#if THINGSBOARD_ENABLE_METRICS
+            Metric::increment(m_metrics.publish_failures);
+#endif // THINGSBOARD_ENABLE_METRICS
+            if (qos != 0U) {
+                (void)Remove_Reserved_In_Flight_Message();
+            }
+            return false;
+        }
+#if THINGSBOARD_ENABLE_METRICS
+        Metric::increment(m_metrics.publishes);
+        Metric::increment(m_metrics.bytes_sent, length);
+#endif // THINGSBOARD_ENABLE_METRICS
+        if (qos != 0U) {
+            Complete_In_Flight_Message(packet_id);
+        }
+        return true;
+    }
+
+    /// @brief Reserves a slot for a message that is about to be published with QoS level 1, the reserved slot keeps the packet identifier 0 until the message has been published
+    /// @param acknowledged_callback Callback that is called once the message has been acknowledged or lost
+    /// @return Whether a slot was reserved or the maximum amount of in-flight messages has already been reached
+    bool Reserve_In_Flight_Message(Callback<void, uint16_t, bool> const & acknowledged_callback) {
+#if THINGSBOARD_USE_MUTEX
+        std::lock_guard<std::mutex> const lock(m_in_flight_mutex);
+#endif // THINGSBOARD_USE_MUTEX
+        if (m_in_flight_messages.size() >= m_max_in_flight) {
+            return false;
+        }
+        In_Flight_Message message;
+        message.packet_id = 0U;
+        message.acknowledged_callback = acknowledged_callback;
+        m_in_flight_messages.push_back(message);
+        return true;
+    }
+
+    /// @brief Removes the slot reserved for the message that is currently being published
+    /// @return Whether the reserved slot still existed, it does not if all in-flight messages were failed while the message was being published
+    bool Remove_Reserved_In_Flight_Message() {
+#if THINGSBOARD_USE_MUTEX
+        std::lock_guard<std::mutex> const lock(m_in_flight_mutex);
+#endif // THINGSBOARD_USE_MUTEX
+        for (auto it = m_in_flight_messages.begin(); it != m_in_flight_messages.end(); ++it) {
+            if (it->packet_id == 0U) {
+                m_in_flight_messages.erase(it);
+                m_early_acknowledgements.clear();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// @brief Assigns the packet identifier to the slot reserved for the message that has just been published.
+    /// If the acknowledgement for that packet identifier has already been received in the meantime, the slot is released and its callback called directly instead
+    /// @param packet_id Packet identifier the message was published with
+    void Complete_In_Flight_Message(uint16_t const & packet_id) {
+        In_Flight_Message acknowledged_message;
+        {
+#if THINGSBOARD_USE_MUTEX
+            std::lock_guard<std::mutex> const lock(m_in_flight_mutex);
+#endif // THINGSBOARD_USE_MUTEX
+            auto reserved = m_in_flight_messages.end();
+            for (auto it = m_in_flight_messages.begin(); it != m_in_flight_messages.end(); ++it) {
+                if (it->packet_id == 0U) {
+                    reserved = it;
+                    break;
+                }
+            }
+            // All in-flight messages, including the reserved one, were failed while the message was being published
+            if (reserved == m_in_flight_messages.end()) {
+                return;
+            }
+            auto early = m_early_acknowledgements.begin();
+            for (; early != m_early_acknowledgements.end(); ++early) {
+                if (*early == packet_id) {
+                    break;
+                }
+            }
+            // Only one message is published at once, therefore any other remembered identifier belongs to a duplicated or unknown acknowledgement and can be discarded
+            bool const acknowledged = early != m_early_acknowledgements.end();
+            m_early_acknowledgements.clear();
+            if (!acknowledged) {
+                reserved->packet_id = packet_id;
+                return;
+            }
+            acknowledged_message = *reserved;
+            m_in_flight_messages.erase(reserved);
+        }
+        // Called without holding the lock, so that the callback can directly publish another message
+        acknowledged_message.acknowledged_callback.Call_Callback(packet_id, true);
+    }
+
+    /// @brief Publishes the messages waiting in the publish queue, in the order of their priority, for as long as we are connected.
+    /// Stops at the first message that can not be published yet and keeps it, so that it is retried in the next loop() call
+    void Publish_Queued_Messages() {
+        while (m_client.connected()) {
+            auto const * message = m_publish_queue.peek();
+            if (message == nullptr) {
+                return;
+            }
+            // Messages published with QoS level 1 wait until the in-flight window has space again, checked beforehand to not log an error on every loop() call
+            else if (message->qos != 0U && getInFlightMessages() >= m_max_in_flight) {
+                return;
+            }
+            else if (!Publish_Message(m_publish_queue.get_topic(*message), m_publish_queue.get_payload(*message), message->payload_size, message->qos, message->acknowledged_callback)) {
+                return;
+            }
+            m_publish_queue.pop(message);
+        }
+    }
+
 #if THINGSBOARD_ENABLE_STREAM_UTILS
     /// @brief Serialize the custom attribute source into the underlying client.
     /// Sends the given bytes to the client without requiring any temporary buffer at the cost of hugely increased send times
@@ -541,13 +1056,26 @@ class ThingsBoardSized {
             return false;
         }
         BufferingPrint buffered_print(m_client, getBufferingSize());
+#if THINGSBOARD_ENABLE_METRICS
+        uint64_t const start_time = Metric::get_time_microseconds();
+#endif // THINGSBOARD_ENABLE_METRICS
         size_t const bytes_serialized = serializeJson(source, buffered_print);
+#if THINGSBOARD_ENABLE_METRICS
+        m_metrics.serialization.record_since(start_time);
+#endif // THINGSBOARD_ENABLE_METRICS
         if (bytes_serialized < json_size) {
             Logger::printfln(UNABLE_TO_SERIALIZE_JSON);
             return false;
         }
         buffered_print.flush();
-        return m_client.end_publish();
+        bool const result = m_client.end_publish();
+#if THINGSBOARD_ENABLE_METRICS
+        Metric::increment(result ? m_metrics.publishes : m_metrics.publish_failures);
+        if (result) {
+            Metric::increment(m_metrics.bytes_sent, bytes_serialized);
+        }
+#endif // THINGSBOARD_ENABLE_METRICS
+        return result;
     }
 #endif // THINGSBOARD_ENABLE_STREAM_UTILS
 
@@ -569,18 +1097,96 @@ class ThingsBoardSized {
         return m_client.get_send_buffer_size();
     }
 
-    /// @brief Subscribes the given topic with the underlying client interface
+    /// @brief Returns whether the underlying client interface receives messages bigger than its receive buffer in fragments
+    /// @return Whether messages bigger than the receive buffer are received in fragments or discarded instead
+    bool clientSupportsFragmentedReceive() {
+        return m_client.supports_fragmented_receive();
+    }
+
+    /// @brief Subscribes the given topic with the underlying client interface, if it is not already subscribed.
+    /// Multiple API implementations can share the same topic, for example the shared attribute update embedded in the OTA firmware update and the one registered by the user,
+    /// therefore the amount of references to each topic is counted and the SUBSCRIBE packet is only sent for the first reference
     /// @param topic Topic that should be subscribed
     /// @return Whether subscribing was successfull or not
     bool clientSubscribe(char const * topic) {
-        return m_client.subscribe(topic);
+        Subscribed_Topic * const subscribed_topic = Find_Subscribed_Topic(topic);
+        if (subscribed_topic != nullptr) {
+            subscribed_topic->references++;
+            // Topics whose subscription failed are kept with their references and retried, directly if another reference is added or otherwise in the next loop() call
+            if (!subscribed_topic->subscribed && !m_resubscribing) {
+                subscribed_topic->subscribed = m_client.subscribe(topic);
+            }
+            return true;
+        }
+#if !THINGSBOARD_ENABLE_DYNAMIC
+        if (m_subscribed_topics.size() == m_subscribed_topics.capacity()) {
+            Logger::printfln(MAX_SUBSCRIBED_TOPICS_EXCEEDED, m_subscribed_topics.size(), topic);
+            return false;
+        }
+#endif // !THINGSBOARD_ENABLE_DYNAMIC
+        // Topics subscribed while resubscribing all API implementations after connecting, are collected and sent in a single SUBSCRIBE packet instead,
+        // which the server acknowledges with a single SUBACK packet as well. Whether subscribing actually succeeded is only known once all topics have been collected and sent
+        if (m_resubscribing) {
+#if !THINGSBOARD_ENABLE_DYNAMIC
+            if (m_resubscribe_topics.size() == m_resubscribe_topics.capacity() && !Subscribe_Collected_Topics()) {
+                return false;
+            }
+#endif // !THINGSBOARD_ENABLE_DYNAMIC
+            m_resubscribe_topics.push_back(topic);
+        }
+        else if (!m_client.subscribe(topic)) {
+            return false;
+        }
+        Subscribed_Topic subscribed;
+        subscribed.topic = topic;
+        subscribed.references = 1U;
+        subscribed.subscribed = true;
+        m_subscribed_topics.push_back(subscribed);
+        return true;
     }
 
-    /// @brief Unsubscribes the given topic with the underlying client interface
+    /// @brief Removes one reference to the given topic and unsubscribes it with the underlying client interface, once no API implementation references it anymore
     /// @param topic Topic that should be unsubscribed
-    /// @return Whether unsubscribing was successfull or not
+    /// @return Whether unsubscribing was successfull or not, topics that are not subscribed are seen as successfully unsubscribed
     bool clientUnsubscribe(char const * topic) {
-        return m_client.unsubscribe(topic);
+        // Searched with an iterator instead of Find_Subscribed_Topic, because removing the element requires an iterator if THINGSBOARD_ENABLE_STL is set
+        auto subscribed_topic = m_subscribed_topics.begin();
+        for (; subscribed_topic != m_subscribed_topics.end() && strcmp(subscribed_topic->topic, topic) != 0; ++subscribed_topic) {}
+        if (subscribed_topic == m_subscribed_topics.end()) {
+            return true;
+        }
+        if (--subscribed_topic->references > 0U) {
+            return true;
+        }
+        bool const subscribed = subscribed_topic->subscribed;
+        // Order of the subscribed topics is not relevant, because they are only ever searched by their topic
+        Helper::remove_unordered(m_subscribed_topics, subscribed_topic);
+        return !subscribed || m_client.unsubscribe(topic);
+    }
+
+    /// @brief Attempts to subscribe all referenced topics again, whose subscription failed previously, for as long as we are connected
+    void Retry_Failed_Subscriptions() {
+        for (auto & subscribed_topic : m_subscribed_topics) {
+            if (subscribed_topic.subscribed) {
+                continue;
+            }
+            else if (!m_client.connected()) {
+                return;
+            }
+            subscribed_topic.subscribed = m_client.subscribe(subscribed_topic.topic);
+        }
+    }
+
+    /// @brief Searches for the given topic in the currently subscribed topics
+    /// @param topic Topic filter that should be searched for
+    /// @return Pointer to the subscribed topic or nullptr if the topic is not subscribed
+    Subscribed_Topic * Find_Subscribed_Topic(char const * topic) {
+        for (auto & subscribed_topic : m_subscribed_topics) {
+            if (strcmp(subscribed_topic.topic, topic) == 0) {
+                return &subscribed_topic;
+            }
+        }
+        return nullptr;
     }
 
     /// @brief Gets a mutable pointer to the request id, the current value is the id of the last sent request.
@@ -620,13 +1226,100 @@ class ThingsBoardSized {
     // once we establish a connection again. This is the case because we connect with the cleanSession attribute set to true.
     // Therefore we can also clear the buffer of all non-permanent topics.
     void Resubscribe_Topics() {
+        // The new session does not contain any subscriptions, API implementations that still need a topic subscribe it again and therefore reference it again
+        m_subscribed_topics.clear();
         // Results are ignored, because the important part of clearing internal data structures always succeeds
+        m_resubscribing = true;
         for (auto & api : m_api_implementations) {
             if (api == nullptr) {
                 continue;
             }
             (void)api->Resubscribe_Topic();
         }
+        m_resubscribing = false;
+        (void)Subscribe_Collected_Topics();
+    }
+
+    /// @brief Subscribes all topics collected while resubscribing the API implementations at once, with a single SUBSCRIBE packet containing all topic filters
+    /// @return Whether subscribing all collected topics was successful or not
+    bool Subscribe_Collected_Topics() {
+        if (m_resubscribe_topics.empty()) {
+            return true;
+        }
+        bool const result = m_client.subscribe(&*m_resubscribe_topics.begin(), m_resubscribe_topics.size());
+        if (!result) {
+            Logger::printfln(RESUBSCRIBE_TOPICS_FAILED, m_resubscribe_topics.size());
+            // Keep the failed topics with their references, because the API implementations still expect to receive messages on them, instead they are retried in the following loop() calls
+            for (auto const & topic : m_resubscribe_topics) {
+                Subscribed_Topic * const subscribed_topic = Find_Subscribed_Topic(topic);
+                if (subscribed_topic != nullptr) {
+                    subscribed_topic->subscribed = false;
+                }
+            }
+        }
+        m_resubscribe_topics.clear();
+        return result;
+    }
+
+    /// @brief Fails all messages published with QoS level 1 that are still waiting for their acknowledgement, because they will never be acknowledged anymore.
+    /// Messages are removed before their callback is called, so that the callback can directly publish the message again
+    void Fail_In_Flight_Messages() {
+        while (true) {
+            In_Flight_Message message;
+            {
+#if THINGSBOARD_USE_MUTEX
+                std::lock_guard<std::mutex> const lock(m_in_flight_mutex);
+#endif // THINGSBOARD_USE_MUTEX
+                m_early_acknowledgements.clear();
+                if (m_in_flight_messages.empty()) {
+                    return;
+                }
+                message = *m_in_flight_messages.begin();
+                m_in_flight_messages.erase(m_in_flight_messages.begin());
+            }
+            message.acknowledged_callback.Call_Callback(message.packet_id, false);
+        }
+    }
+
+    /// @brief MQTT callback that will be called once the connection to the server has been established.
+    /// Because we connect with the cleanSession attribute set to true, messages published with QoS level 1 in the previous session are never acknowledged and are therefore failed,
+    /// additionally the topics that establish a permanent connection are resubscribed
+    void onMQTTConnect() {
+        Fail_In_Flight_Messages();
+        Resubscribe_Topics();
+    }
+
+    /// @brief MQTT callback that will be called once the server has acknowledged a message published with QoS level 1
+    /// @param packet_id Packet identifier of the acknowledged message
+    void onMQTTPublishAcknowledged(uint16_t packet_id) {
+#if THINGSBOARD_ENABLE_DEBUG
+        Logger::printfln(PUBLISH_ACKNOWLEDGED, packet_id);
+#endif // THINGSBOARD_ENABLE_DEBUG
+        In_Flight_Message message;
+        {
+#if THINGSBOARD_USE_MUTEX
+            std::lock_guard<std::mutex> const lock(m_in_flight_mutex);
+#endif // THINGSBOARD_USE_MUTEX
+            auto found = m_in_flight_messages.end();
+            bool reserved = false;
+            for (auto it = m_in_flight_messages.begin(); it != m_in_flight_messages.end(); ++it) {
+                if (it->packet_id == packet_id) {
+                    found = it;
+                    break;
+                }
+                reserved |= it->packet_id == 0U;
+            }
+            if (found == m_in_flight_messages.end()) {
+                // Acknowledgement arrived before publish returned the packet identifier, remembered so that the message is completed as soon as the identifier is assigned
+                if (reserved && m_early_acknowledgements.size() < m_early_acknowledgements.capacity()) {
+                    m_early_acknowledgements.push_back(packet_id);
+                }
+                return;
+            }
+            message = *found;
+            m_in_flight_messages.erase(found);
+        }
+        message.acknowledged_callback.Call_Callback(message.packet_id, true);
     }
 
     /// @brief Attempts to send a single key-value pair with the given key and value of the given type
@@ -634,9 +1327,12 @@ class ThingsBoardSized {
     /// @param key Key of the key value pair we want to send
     /// @param value Value of the key value pair we want to send
     /// @param telemetry Whether the data we want to send should be sent as an attribute or telemetry data value
+    /// @param qos QoS level the data is published with
+    /// @param acknowledged_callback Callback that is called once the data published with QoS level 1 has been acknowledged or lost
+    /// @param priority Priority the data is queued with if the publish queue is enabled
     /// @return Whether sending the data was successful or not
     template<typename T>
-    bool sendKeyValue(char const * key, T const & value, bool telemetry = true) {
+    bool sendKeyValue(char const * key, T const & value, bool telemetry, uint8_t qos, typename Callback<void, uint16_t, bool>::function acknowledged_callback, Publish_Priority priority) {
         const Telemetry t(key, value);
         if (t.IsEmpty()) {
             return false;
@@ -647,7 +1343,7 @@ class ThingsBoardSized {
             Logger::printfln(UNABLE_TO_SERIALIZE);
             return false;
         }
-        return telemetry ? sendTelemetryJson(json_buffer, Helper::Measure_Json(json_buffer)) : sendAttributeJson(json_buffer, Helper::Measure_Json(json_buffer));
+        return telemetry ? sendTelemetryJson(json_buffer, Helper::Measure_Json(json_buffer), qos, acknowledged_callback, priority) : sendAttributeJson(json_buffer, Helper::Measure_Json(json_buffer), qos, acknowledged_callback, priority);
     }
 
     /// @brief Attempts to send aggregated attribute or telemetry data
@@ -657,6 +1353,9 @@ class ThingsBoardSized {
     /// @param first Iterator pointing to the first element in the data container
     /// @param last Iterator pointing to the end of the data container (last element + 1)
     /// @param telemetry Whether the data we want to send should be sent over the attribute or telemtry topic
+    /// @param qos QoS level the data is published with
+    /// @param acknowledged_callback Callback that is called once the data published with QoS level 1 has been acknowledged or lost
+    /// @param priority Priority the data is queued with if the publish queue is enabled
     /// @return Whether sending the aggregated data was successful or not
 #if THINGSBOARD_ENABLE_DYNAMIC
     template<typename InputIterator>
@@ -665,7 +1364,7 @@ class ThingsBoardSized {
     /// Should simply be the biggest distance between first and last iterator this method is ever called with
     template<size_t MaxKeyValuePairAmount, typename InputIterator>
 #endif // THINGSBOARD_ENABLE_DYNAMIC
-    bool sendDataArray(InputIterator const & first, InputIterator const & last, bool telemetry) {
+    bool sendDataArray(InputIterator const & first, InputIterator const & last, bool telemetry, uint8_t qos, typename Callback<void, uint16_t, bool>::function acknowledged_callback, Publish_Priority priority) {
         size_t const size = Helper::distance(first, last);
 #if THINGSBOARD_ENABLE_DYNAMIC
         // char const * are stored as only a pointer inside the JsonDocument --> zero copy, meaning the size for the strings is 0 bytes.
@@ -694,7 +1393,7 @@ class ThingsBoardSized {
             }
         }
 #endif // THINGSBOARD_ENABLE_STL
-        return telemetry ? sendTelemetryJson(json_buffer, Helper::Measure_Json(json_buffer)) : sendAttributeJson(json_buffer, Helper::Measure_Json(json_buffer));
+        return telemetry ? sendTelemetryJson(json_buffer, Helper::Measure_Json(json_buffer), qos, acknowledged_callback, priority) : sendAttributeJson(json_buffer, Helper::Measure_Json(json_buffer), qos, acknowledged_callback, priority);
     }
 
     /// @brief MQTT callback that will be called if a publish message is received from the server
@@ -711,13 +1410,19 @@ class ThingsBoardSized {
 #if THINGSBOARD_ENABLE_DEBUG
         Logger::printfln(RECEIVE_MESSAGE, length, topic);
 #endif // THINGSBOARD_ENABLE_DEBUG
+#if THINGSBOARD_ENABLE_METRICS
+        Metric::increment(m_metrics.messages_received);
+        Metric::increment(m_metrics.bytes_received, length);
+#endif // THINGSBOARD_ENABLE_METRICS
 
 #if THINGSBOARD_ENABLE_STL
 #if THINGSBOARD_ENABLE_CXX20
         auto filtered_raw_api_implementations = m_api_implementations | std::views::filter([&topic](IAPI_Implementation const * api) {
 #else
 #if THINGSBOARD_ENABLE_DYNAMIC
-        Vector<IAPI_Implementation *> filtered_raw_api_implementations = {};
+        // Reuses the already allocated memory of the member instead of allocating a new container for every received message
+        Vector<IAPI_Implementation *> & filtered_raw_api_implementations = m_filtered_api_implementations;
+        filtered_raw_api_implementations.clear();
 #else
         Array<IAPI_Implementation *, MaxEndpointsAmount> filtered_raw_api_implementations = {};
 #endif // THINGSBOARD_ENABLE_DYNAMIC
@@ -727,7 +1432,13 @@ class ThingsBoardSized {
         });
 
         for (auto & api : filtered_raw_api_implementations) {
+#if THINGSBOARD_ENABLE_METRICS
+            uint64_t const start_time = Metric::get_time_microseconds();
+#endif // THINGSBOARD_ENABLE_METRICS
             api->Process_Response(topic, payload, length);
+#if THINGSBOARD_ENABLE_METRICS
+            Record_API_Dispatch(api, start_time);
+#endif // THINGSBOARD_ENABLE_METRICS
         }
 
         // If the filtered api implementations was not emtpy it means the response was processed as its raw bytes representation atleast once,
@@ -742,7 +1453,13 @@ class ThingsBoardSized {
             if (api == nullptr || api->Get_Process_Type() != API_Process_Type::RAW || !api->Compare_Response_Topic(topic)) {
                 continue;
             }
+#if THINGSBOARD_ENABLE_METRICS
+            uint64_t const start_time = Metric::get_time_microseconds();
+#endif // THINGSBOARD_ENABLE_METRICS
             api->Process_Response(topic, payload, length);
+#if THINGSBOARD_ENABLE_METRICS
+            Record_API_Dispatch(api, start_time);
+#endif // THINGSBOARD_ENABLE_METRICS
             processed_response_as_raw = true;
         }
 
@@ -754,6 +1471,10 @@ class ThingsBoardSized {
         // Calculate size with the total amount of commas, always denotes the end of a key-value pair besides for the last element in an array or in an object where the comma is not permitted,
         // therfore we have to add the space for another key-value pair for all the occurences of thoose symbols as well
         size_t const size = Helper::getOccurences(payload, ',', length) + Helper::getOccurences(payload, '{', length) + Helper::getOccurences(payload, '[', length);
+#if THINGSBOARD_ENABLE_METRICS
+        // Recorded before the size is checked, so that the requirement of discarded messages is known as well
+        Metric::update_maximum(m_high_water_marks.max_required_document_size, JSON_OBJECT_SIZE(size));
+#endif // THINGSBOARD_ENABLE_METRICS
 #if THINGSBOARD_ENABLE_DYNAMIC
         // Buffer that we deserialize is writeable and not read only and therefore stored as a pointer inside the JsonDocument --> zero copy, meaning the size for the received payload is 0 bytes.
         // Data structure size, therefore only depends on the amount of key value pairs received.
@@ -763,11 +1484,14 @@ class ThingsBoardSized {
             Logger::printfln(MAXIMUM_RESPONSE_EXCEEDED, document_size, m_max_response_size);
             return;
         }
-        TBJsonDocument json_buffer(document_size);
+        TBPooledJsonDocument json_buffer(document_size, Json_Allocator_Handle(m_json_allocator));
         // Because we calcualte the allocation dynamically fromt he payload, which is user input, it could theoretically be malicious ({ "malicious" : "{{{{{{{{{..."}) and contain a lot of the symbols used to calculate the size.
         // But if that is the case adn the allocation still succeeds we delete the allocated memory relatively fast again so it shouldn't be a problem and if the allocation fails we simply return at this point with an appropriate error message
         if (json_buffer.capacity() != document_size) {
             Logger::printfln(HEAP_ALLOCATION_FAILED, document_size);
+#if THINGSBOARD_ENABLE_METRICS
+            Record_Allocation_Failure();
+#endif // THINGSBOARD_ENABLE_METRICS
             return;
         }
 #else
@@ -785,18 +1509,31 @@ class ThingsBoardSized {
         // The deserializeJson method we use, can use the zero copy mode because a writeable input was passed,
         // if that were not the case the needed allocated memory would drastically increase, because the keys would need to be copied as well.
         // See https://arduinojson.org/v6/doc/deserialization/ for more info on ArduinoJson deserialization
+#if THINGSBOARD_ENABLE_METRICS
+        Metric::update_maximum(m_metrics.max_document_size, document_size);
+        Metric::update_maximum(m_high_water_marks.max_allocated_document_size, document_size);
+        uint64_t const start_time = Metric::get_time_microseconds();
+#endif // THINGSBOARD_ENABLE_METRICS
         DeserializationError const error = deserializeJson(json_buffer, payload, length);
+#if THINGSBOARD_ENABLE_METRICS
+        m_metrics.deserialization.record_since(start_time);
+#endif // THINGSBOARD_ENABLE_METRICS
         if (error) {
             Logger::printfln(UNABLE_TO_DE_SERIALIZE_JSON, error.c_str());
             return;
         }
+#if THINGSBOARD_ENABLE_METRICS
+        Metric::update_maximum(m_high_water_marks.max_received_document_usage, json_buffer.memoryUsage());
+#endif // THINGSBOARD_ENABLE_METRICS
 
 #if THINGSBOARD_ENABLE_STL
 #if THINGSBOARD_ENABLE_CXX20
         auto filtered_json_api_implementations = m_api_implementations | std::views::filter([&topic](IAPI_Implementation const * api) {
 #else
 #if THINGSBOARD_ENABLE_DYNAMIC
-        Vector<IAPI_Implementation *> filtered_json_api_implementations = {};
+        // Reuses the already allocated memory of the member instead of allocating a new container for every received message
+        Vector<IAPI_Implementation *> & filtered_json_api_implementations = m_filtered_api_implementations;
+        filtered_json_api_implementations.clear();
 #else
         Array<IAPI_Implementation *, MaxEndpointsAmount> filtered_json_api_implementations = {};
 #endif // THINGSBOARD_ENABLE_DYNAMIC
@@ -806,18 +1543,109 @@ class ThingsBoardSized {
         });
 
         for (auto & api : filtered_json_api_implementations) {
+#if THINGSBOARD_ENABLE_METRICS
+            uint64_t const start_time = Metric::get_time_microseconds();
+#endif // THINGSBOARD_ENABLE_METRICS
             api->Process_Json_Response(topic, json_buffer);
+#if THINGSBOARD_ENABLE_METRICS
+            Record_API_Dispatch(api, start_time);
+#endif // THINGSBOARD_ENABLE_METRICS
         }
 #else
         for (auto & api : m_api_implementations) {
             if (api == nullptr || api->Get_Process_Type() != API_Process_Type::JSON || !api->Compare_Response_Topic(topic)) {
                 continue;
             }
+#if THINGSBOARD_ENABLE_METRICS
+            uint64_t const start_time = Metric::get_time_microseconds();
+#endif // THINGSBOARD_ENABLE_METRICS
             api->Process_Json_Response(topic, json_buffer);
+#if THINGSBOARD_ENABLE_METRICS
+            Record_API_Dispatch(api, start_time);
+#endif // THINGSBOARD_ENABLE_METRICS
         }
 #endif // THINGSBOARD_ENABLE_STL
     }
 
+    /// @brief MQTT callback that will be called if a fragment of a publish message is received from the server, because the complete message is bigger than the receive buffer of the client.
+    /// Fragments are only forwarded to API implementations that process the response as raw bytes, because json can not be deserialized from only a fragment of the complete payload.
+    /// Payload contains data from the internal buffer of the MQTT client, therefore the same restrictions as for onMQTTMessage apply
+    /// @param topic Previously subscribed topic, we got the response over
+    /// @param payload Fragment of the payload that was sent over the cloud and received over the given topic
+    /// @param length Length of the received fragment
+    /// @param offset Offset of the received fragment in the complete payload
+    /// @param total_length Total length of the complete payload
+    void onMQTTMessageFragment(char * topic, uint8_t * payload, unsigned int length, unsigned int offset, unsigned int total_length) {
+#if THINGSBOARD_ENABLE_DEBUG
+        Logger::printfln(RECEIVE_MESSAGE_FRAGMENT, length, offset, total_length, topic);
+#endif // THINGSBOARD_ENABLE_DEBUG
+#if THINGSBOARD_ENABLE_METRICS
+        // Fragments of the same message are only counted as one received message, but all their bytes are counted
+        if (offset == 0U) {
+            Metric::increment(m_metrics.messages_received);
+        }
+        Metric::increment(m_metrics.bytes_received, length);
+#endif // THINGSBOARD_ENABLE_METRICS
+
+        bool processed_response_as_raw = false;
+        for (auto & api : m_api_implementations) {
+            if (api == nullptr || api->Get_Process_Type() != API_Process_Type::RAW || !api->Compare_Response_Topic(topic)) {
+                continue;
+            }
+#if THINGSBOARD_ENABLE_METRICS
+            uint64_t const start_time = Metric::get_time_microseconds();
+#endif // THINGSBOARD_ENABLE_METRICS
+            api->Process_Response_Fragment(topic, payload, length, offset, total_length);
+#if THINGSBOARD_ENABLE_METRICS
+            Record_API_Dispatch(api, start_time);
+#endif // THINGSBOARD_ENABLE_METRICS
+            processed_response_as_raw = true;
+        }
+
+        // Only print the message for the first fragment, to ensure it is not repeated for every following fragment of the same message
+        if (!processed_response_as_raw && offset == 0U) {
+            Logger::printfln(FRAGMENTED_MESSAGE_DISCARDED, total_length, topic, m_client.get_receive_buffer_size());
+        }
+    }
+
+#if THINGSBOARD_ENABLE_METRICS
+    /// @brief Records a failed allocation of a json document or client buffer, in the metrics of the current interval and in the total since the device started
+    void Record_Allocation_Failure() {
+        Metric::increment(m_metrics.allocation_failures);
+        Metric::increment(m_high_water_marks.allocation_failures);
+    }
+
+    /// @brief Records that the given API implementation processed a received message and how long it needed to do so.
+    /// The metrics are stored at the same index as the API implementation, because API implementations are only ever appended, meaning the index stays the same
+    /// @param api API implementation that processed the received message
+    /// @param start_time Time in microseconds returned by Metric::get_time_microseconds() before the API implementation started processing the message
+    void Record_API_Dispatch(IAPI_Implementation const * api, uint64_t const & start_time) {
+        uint64_t const latency = Metric::get_time_microseconds() - start_time;
+        for (size_t i = 0U; i < m_api_implementations.size() && i < API_METRICS_AMOUNT; i++) {
+            if (m_api_implementations[i] != api) {
+                continue;
+            }
+            Metric::increment(m_api_metrics[i].dispatches);
+            m_api_metrics[i].handler.record(latency);
+            return;
+        }
+    }
+
+    /// @brief Adds the aggregated values of the given latency snapshot to the given json document under the given keys
+    /// @param json_buffer JsonDocument the values should be added to
+    /// @param snapshot Aggregated values of the latencies recorded in the last interval
+    /// @param count_key Key the amount of recorded latencies is added under
+    /// @param average_key Key the average latency is added under
+    /// @param maximum_key Key the maximum latency is added under
+    /// @param percentile_key Key the LATENCY_PERCENTILE of the latencies is added under
+    static void Add_Latency_Snapshot(JsonDocument & json_buffer, Latency_Snapshot const & snapshot, char const * count_key, char const * average_key, char const * maximum_key, char const * percentile_key) {
+        json_buffer[count_key] = snapshot.count;
+        json_buffer[average_key] = snapshot.average;
+        json_buffer[maximum_key] = snapshot.maximum;
+        json_buffer[percentile_key] = snapshot.percentile;
+    }
+#endif // THINGSBOARD_ENABLE_METRICS
+
 #if !THINGSBOARD_ENABLE_STL
     static void onStaticMQTTMessage(char * topic, uint8_t * payload, unsigned int length) {
         if (m_subscribedInstance == nullptr) {
@@ -826,11 +1654,25 @@ class ThingsBoardSized {
         m_subscribedInstance->onMQTTMessage(topic, payload, length);
     }
 
+    static void onStaticMQTTMessageFragment(char * topic, uint8_t * payload, unsigned int length, unsigned int offset, unsigned int total_length) {
+        if (m_subscribedInstance == nullptr) {
+            return;
+        }
+        m_subscribedInstance->onMQTTMessageFragment(topic, payload, length, offset, total_length);
+    }
+
+    static void staticMQTTPublishAcknowledged(uint16_t packet_id) {
+        if (m_subscribedInstance == nullptr) {
+            return;
+        }
+        m_subscribedInstance->onMQTTPublishAcknowledged(packet_id);
+    }
+
     static void staticMQTTConnect() {
         if (m_subscribedInstance == nullptr) {
             return;
         }
-        m_subscribedInstance->Resubscribe_Topics();
+        m_subscribedInstance->onMQTTConnect();
     }
 
     static void staticSubscribeImplementation(IAPI_Implementation & api) {
@@ -875,6 +1717,13 @@ class ThingsBoardSized {
         return m_subscribedInstance->getRequestID();
     }
 
+    static bool staticClientSupportsFragmentedReceive() {
+        if (m_subscribedInstance == nullptr) {
+            return false;
+        }
+        return m_subscribedInstance->clientSupportsFragmentedReceive();
+    }
+
     static uint16_t staticGetClientReceiveBufferSize() {
         if (m_subscribedInstance == nullptr) {
             return 0U;
@@ -902,18 +1751,44 @@ class ThingsBoardSized {
     static ThingsBoardSized *m_subscribedInstance;
 #endif // !THINGSBOARD_ENABLE_STL
 
-    IMQTT_Client&                                   m_client = {};              // MQTT client instance.
-    size_t                                          m_max_stack = {};           // Maximum stack size we allocate at once.
-    size_t                                          m_request_id = {};          // Internal id used to differentiate which request should receive which response for certain API calls. Can send 4'294'967'296 requests before wrapping back to 0
+    IMQTT_Client&                                          m_client = {};              // MQTT client instance.
+    size_t                                                 m_max_stack = {};           // Maximum stack size we allocate at once.
+    size_t                                                 m_request_id = {};          // Internal id used to differentiate which request should receive which response for certain API calls. Can send 4'294'967'296 requests before wrapping back to 0
 #if THINGSBOARD_ENABLE_STREAM_UTILS
-    size_t                                          m_buffering_size = {};      // Buffering size used to serialize directly into client.
+    size_t                                                 m_buffering_size = {};      // Buffering size used to serialize directly into client.
 #endif // THINGSBOARD_ENABLE_STREAM_UTILS
 #if !THINGSBOARD_ENABLE_DYNAMIC
-    Array<IAPI_Implementation*, MaxEndpointsAmount> m_api_implementations = {}; // Can hold a pointer to all possible API implementations (Server side RPC, Client side RPC, Shared attribute update, Client-side or shared attribute request, Provision)   
+    Array<IAPI_Implementation*, MaxEndpointsAmount>        m_api_implementations = {}; // Can hold a pointer to all possible API implementations (Server side RPC, Client side RPC, Shared attribute update, Client-side or shared attribute request, Provision)   
 #else
-    size_t                                          m_max_response_size = {};   // Maximum size allocated on the heap to hold the Json data structure for received cloud response payload, prevents possible malicious payload allocaitng a lot of memory
-    Vector<IAPI_Implementation*>                    m_api_implementations = {}; // Can hold a pointer to all  possible API implementations (Server side RPC, Client side RPC, Shared attribute update, Client-side or shared attribute request, Provision)   
+    size_t                                                 m_max_response_size = {};   // Maximum size allocated on the heap to hold the Json data structure for received cloud response payload, prevents possible malicious payload allocaitng a lot of memory
+    IJson_Allocator                                        *m_json_allocator = {};     // Optional allocator used to allocate the Json data structure for received cloud response payload, allocated with the TBJsonAllocator if it is nullptr
+    Vector<IAPI_Implementation*>                           m_api_implementations = {}; // Can hold a pointer to all  possible API implementations (Server side RPC, Client side RPC, Shared attribute update, Client-side or shared attribute request, Provision)   
+#if THINGSBOARD_ENABLE_STL && !THINGSBOARD_ENABLE_CXX20
+    Vector<IAPI_Implementation*>                           m_filtered_api_implementations = {}; // API implementations that should process the currently received message, kept as a member so its memory is reused for every received message
+#endif // THINGSBOARD_ENABLE_STL && !THINGSBOARD_ENABLE_CXX20
 #endif // !THINGSBOARD_ENABLE_DYNAMIC                
+    size_t                                                 m_max_in_flight = {};       // Maximum amount of messages published with QoS level 1 that may wait for their acknowledgement at once
+    Array<In_Flight_Message, Default_Max_In_Flight_Amount> m_in_flight_messages = {};  // Messages published with QoS level 1 that are waiting for their acknowledgement, keyed by their packet identifier
+    Array<uint16_t, Default_Max_In_Flight_Amount>          m_early_acknowledgements = {}; // Packet identifiers acknowledged while their message was still being published, before the identifier was assigned to the reserved slot
+#if THINGSBOARD_USE_MUTEX
+    mutable std::mutex                                     m_in_flight_mutex;          // Guards the in-flight messages and early acknowledgements, because clients might call the acknowledgement and connection callbacks from another task
+#endif // THINGSBOARD_USE_MUTEX
+    Publish_Queue<Default_Publish_Queue_Amount, Logger>    m_publish_queue = {};       // Bounded queue of messages that are published in the following loop() calls, disabled until setPublishQueueSize is called
+    bool                                                   m_resubscribing = {};       // Whether all API implementations are currently being resubscribed, in which case subscribed topics are collected instead of being subscribed directly
+#if !THINGSBOARD_ENABLE_DYNAMIC
+    Array<char const *, MaxEndpointsAmount>                m_resubscribe_topics = {};  // Topics collected while resubscribing, not copied because all API implementations subscribe constant topic strings
+    Array<Subscribed_Topic, MaxEndpointsAmount>            m_subscribed_topics = {};   // Topics referenced by API implementations, each topic is only contained once no matter how many API implementations reference it
+#else
+    Vector<char const *>                                   m_resubscribe_topics = {};  // Topics collected while resubscribing, not copied because all API implementations subscribe constant topic strings
+    Vector<Subscribed_Topic>                               m_subscribed_topics = {};   // Topics referenced by API implementations, each topic is only contained once no matter how many API implementations reference it
+#endif // !THINGSBOARD_ENABLE_DYNAMIC
+#if THINGSBOARD_ENABLE_METRICS
+    Metrics                                                m_metrics = {};             // Metrics recorded since they were last published
+    Memory_High_Water_Marks                                m_high_water_marks = {};    // Peak memory requirements since the device started, not reset when the metrics are published
+    API_Metrics                                            m_api_metrics[API_METRICS_AMOUNT] = {}; // Metrics of each subscribed API implementation, at the same index as the API implementation in m_api_implementations
+    uint64_t                                               m_metrics_interval = {};    // Interval in microseconds the metrics are published in, 0 if they are not published automatically
+    uint64_t                                               m_metrics_timestamp = {};   // Time in microseconds the metrics were last published at
+#endif // THINGSBOARD_ENABLE_METRICS
 };
 
 #if !THINGSBOARD_ENABLE_STL
@@ -12,26 +12,114 @@
 #include "Telemetry.h"
 #include "Helper.h"
 #include "IHTTP_Client.h"
+#include "IAPI_Implementation.h"
+#include "RPC_Callback.h"
+#include "Shared_Attribute_Callback.h"
 #include "DefaultLogger.h"
 
 
 // HTTP topics.
 char constexpr HTTP_TELEMETRY_TOPIC[] = "/api/v1/%s/telemetry";
 char constexpr HTTP_ATTRIBUTES_TOPIC[] = "/api/v1/%s/attributes";
+char constexpr HTTP_ATTRIBUTES_UPDATES_TOPIC[] = "/api/v1/%s/attributes/updates?timeout=%u";
+char constexpr HTTP_RPC_REQUEST_TOPIC[] = "/api/v1/%s/rpc?timeout=%u";
+char constexpr HTTP_RPC_RESPONSE_TOPIC[] = "/api/v1/%s/rpc/%u";
+// Size of the path buffer, big enough to hold the longest topic with an access token of up to MAX_FORMAT_STRING_CHARACTERS and the long poll timeout inserted
+size_t constexpr MAX_HTTP_PATH_SIZE = Helper::calculateFormatSize<char const *, uint32_t>(sizeof(HTTP_ATTRIBUTES_UPDATES_TOPIC));
 char constexpr HTTP_POST_PATH[] = "application/json";
 int constexpr HTTP_RESPONSE_SUCCESS_RANGE_START = 200;
 int constexpr HTTP_RESPONSE_SUCCESS_RANGE_END = 299;
+// Status code the server responds with, if no server-side RPC request or shared attribute update was sent before the timeout of the long poll request passed
+int constexpr HTTP_RESPONSE_REQUEST_TIMEOUT = 408;
+// Time the server holds a long poll request open, has to be lower than the time the used IHTTP_Client waits for the response or the request is failed by the client instead
+uint32_t constexpr HTTP_DEFAULT_LONG_POLL_TIMEOUT_MILLISECONDS = 10000U;
+char constexpr HTTP_RPC_ID_KEY[] = "id";
+char constexpr HTTP_TIMESTAMP_KEY[] = "ts";
+char constexpr HTTP_VALUES_KEY[] = "values";
+// Amount of bytes read at once from the response body, when it is deserialized in a streaming way or discarded before the connection is reused for the next request
+size_t constexpr HTTP_RESPONSE_CHUNK_SIZE = 32U;
 
 // Log messages.
 char constexpr POST[] = "POST";
 char constexpr GET[] = "GET";
 char constexpr HTTP_FAILED[] = "(%s) failed HTTP response (%d)";
+char constexpr HTTP_PATH_TOO_LONG[] = "Access token is too long, path would exceed the maximum size of (%u) characters";
+char constexpr HTTP_RESPONSE_NOT_JSON[] = "Unable to de-serialize HTTP response body with error (DeserializationError::%s)";
+char constexpr HTTP_UNABLE_TO_ALLOCATE_BATCH[] = "Allocating memory for the telemetry batch failed";
+char constexpr HTTP_BATCH_NOT_ALLOCATED[] = "Telemetry batch has not been allocated, call setTelemetryBatchSize() beforehand";
+char constexpr HTTP_BATCH_MESSAGE_TOO_BIG[] = "Message with (%u) bytes does not fit into the telemetry batch with (%u) bytes";
+char constexpr HTTP_RPC_RESPONSE_OVERFLOWED[] = "Server-side RPC response overflowed, increase MaxRPC (%u)";
+#if THINGSBOARD_ENABLE_DEBUG
+char constexpr HTTP_RPC_METHOD_NULL[] = "Received server-side RPC request without method name";
+char constexpr HTTP_CALLING_RPC_CB[] = "Calling subscribed callback for rpc with methodname (%s)";
+#endif // THINGSBOARD_ENABLE_DEBUG
+
+
+/// @brief Reader that allows ArduinoJson to deserialize the response body directly from the IHTTP_Client,
+/// the body is read in small chunks into an internal buffer, meaning the complete body never has to be copied into a string object.
+/// See https://arduinojson.org/v6/api/json/deserializejson/ for more information on the methods a custom reader has to implement
+class HTTP_Response_Reader {
+  public:
+    /// @brief Constructor
+    /// @param client Client the response body of the previously sent request should be read from
+    explicit HTTP_Response_Reader(IHTTP_Client & client)
+      : m_client(client)
+      , m_buffer()
+      , m_size(0U)
+      , m_position(0U)
+    {
+        // Nothing to do
+    }
+
+    /// @brief Reads the next byte of the response body
+    /// @return Read byte or -1 if the end of the response body has been reached
+    int read() {
+        if (m_position == m_size && !Fill_Buffer()) {
+            return -1;
+        }
+        return m_buffer[m_position++];
+    }
+
+    /// @brief Reads the next bytes of the response body into the given buffer
+    /// @param buffer Buffer the read bytes will be copied into
+    /// @param length Maximum amount of bytes that should be read
+    /// @return Amount of bytes actually read
+    size_t readBytes(char * buffer, size_t length) {
+        size_t read_bytes = 0U;
+        while (read_bytes < length) {
+            int const character = read();
+            if (character < 0) {
+                break;
+            }
+            buffer[read_bytes++] = static_cast<char>(character);
+        }
+        return read_bytes;
+    }
+
+  private:
+    /// @brief Reads the next chunk of the response body into the internal buffer
+    /// @return Whether any bytes could be read or the end of the response body has been reached
+    bool Fill_Buffer() {
+        m_size = m_client.read_response_body(m_buffer, sizeof(m_buffer));
+        m_position = 0U;
+        return m_size != 0U;
+    }
+
+    IHTTP_Client &m_client;                           // Client the response body is read from
+    uint8_t      m_buffer[HTTP_RESPONSE_CHUNK_SIZE];  // Chunk of the response body that has been read last
+    size_t       m_size;                              // Amount of bytes in the internal buffer
+    size_t       m_position;                          // Position of the next byte in the internal buffer, that will be returned by read()
+};
 
 
 /// @brief Wrapper around the ArduinoHttpClient or HTTPClient to allow connecting and sending / retrieving data from ThingsBoard over the HTTP orHTTPS protocol.
 /// BufferSize of the underlying data buffer as well as the maximum amount of data points that can ever be sent have to defined as template arguments.
 /// Changing is only possible if a new instance of this class is created. If theese values should be changeable and dynamic instead.
 /// Simply set THINGSBOARD_ENABLE_DYNAMIC to 1, before including ThingsBoardHttp.h.
+/// If keep alive is enabled the established connection is reused for all requests, instead of reconnecting for each request,
+/// additionally multiple telemetry messages can be batched and then sent in a single request, to further reduce the amount of requests that have to be sent.
+/// Requests are never pipelined, each request waits for its response before the next request is sent, because posted telemetry and attributes are not idempotent.
+/// Server-side RPC requests and shared attribute updates can be received with long poll requests, which the server holds open until it has something to send.
 /// @tparam Logger Implementation that should be used to print error messages generated by internal processes and additional debugging messages if THINGSBOARD_ENABLE_DEBUG is set, default = DefaultLogger
 template<typename Logger = DefaultLogger>
 class ThingsBoardHttpSized {
@@ -49,6 +137,11 @@ class ThingsBoardHttpSized {
       : m_client(client)
       , m_max_stack(max_stack_size)
       , m_token(access_token)
+      , m_keep_alive(keep_alive)
+      , m_batch_buffer(nullptr)
+      , m_batch_capacity(0U)
+      , m_batch_length(0U)
+      , m_batch_amount(0U)
     {
         m_client.set_keep_alive(keep_alive);
         if (m_client.connect(host, port) != 0) {
@@ -56,6 +149,18 @@ class ThingsBoardHttpSized {
         }
     }
 
+    /// @brief Copying is not allowed, because the copy would free the same telemetry batch again
+    ThingsBoardHttpSized(ThingsBoardHttpSized const &) = delete;
+
+    /// @brief Copying is not allowed, because the copy would free the same telemetry batch again
+    ThingsBoardHttpSized & operator=(ThingsBoardHttpSized const &) = delete;
+
+    /// @brief Destructor, frees the memory of the telemetry batch
+    ~ThingsBoardHttpSized() {
+        delete[] m_batch_buffer;
+        m_batch_buffer = nullptr;
+    }
+
     /// @brief Sets the maximum amount of bytes that we want to allocate on the stack, before the memory is allocated on the heap instead
     /// @param max_stack_size Maximum amount of bytes we want to allocate on the stack
     void setMaximumStackSize(size_t const & max_stack_size) {
@@ -69,41 +174,11 @@ class ThingsBoardHttpSized {
     /// @param json_size Size of the data inside the source
     /// @return Whether sending the data was successful or not
     bool Send_Json(char const * topic, JsonDocument const & source, size_t const & json_size) {
-        // Check if allocating needed memory failed when trying to create the JsonDocument,
-        // if it did the isNull() method will return true. See https://arduinojson.org/v6/api/jsonvariant/isnull/ for more information
-        if (source.isNull()) {
-            Logger::printfln(UNABLE_TO_ALLOCATE_JSON);
-            return false;
-        }
-        // Check if inserting any of the internal values failed because the JsonDocument was too small,
-        // if it did the overflowed() method will return true. See https://arduinojson.org/v6/api/jsondocument/overflowed/ for more information
-        if (source.overflowed()) {
-            Logger::printfln(JSON_SIZE_TO_SMALL);
+        char path[MAX_HTTP_PATH_SIZE] = {};
+        if (!buildPath(path, topic)) {
             return false;
         }
-        bool result = false;
-        if (getMaximumStackSize() < json_size) {
-            char * json = new char[json_size]();
-            if (serializeJson(source, json, json_size) < json_size - 1) {
-                Logger::printfln(UNABLE_TO_SERIALIZE_JSON);
-            }
-            else {
-                result = Send_Json_String(topic, json);
-            }
-            // Ensure to actually delete the memory placed onto the heap, to make sure we do not create a memory leak
-            // and set the pointer to null so we do not have a dangling reference.
-            delete[] json;
-            json = nullptr;
-        }
-        else {
-            char json[json_size] = {};
-            if (serializeJson(source, json, json_size) < json_size - 1) {
-                Logger::printfln(UNABLE_TO_SERIALIZE_JSON);
-                return result;
-            }
-            result = Send_Json_String(topic, json);
-        }
-        return result;
+        return postJson(path, source, json_size);
     }
 
     /// @brief Attempts to send custom json string over the given topic to the server
@@ -111,12 +186,14 @@ class ThingsBoardHttpSized {
     /// @param json String containing our json key value pairs we want to attempt to send
     /// @return Whether sending the data was successful or not
     bool Send_Json_String(char const * topic, char const * json) {
-        if (json == nullptr || m_token == nullptr) {
+        if (json == nullptr) {
             return false;
         }
 
-        char path[Helper::detectSize(topic, m_token)] = {};
-        (void)snprintf(path, sizeof(path), topic, m_token);
+        char path[MAX_HTTP_PATH_SIZE] = {};
+        if (!buildPath(path, topic)) {
+            return false;
+        }
         return postMessage(path, json);
     }
 
@@ -175,6 +252,134 @@ class ThingsBoardHttpSized {
         return Send_Json(HTTP_TELEMETRY_TOPIC, source, json_size);
     }
 
+    /// @brief Sets the size of the buffer multiple telemetry messages are collected in, before they are sent in a single request as a json array.
+    /// Sending the messages together instead of one request per message, allows to send a lot more messages per second, especially over slow connections with a high latency like GSM.
+    /// Allocates the memory on the heap once, already batched messages are discarded
+    /// @param batch_size Size of the batch in bytes, the serialized messages seperated by a comma and the enclosing brackets have to fit into it, 0 frees the batch
+    /// @return Whether allocating the batch was successful or not
+    bool setTelemetryBatchSize(size_t const & batch_size) {
+        delete[] m_batch_buffer;
+        m_batch_buffer = nullptr;
+        m_batch_capacity = 0U;
+        clearTelemetryBatch();
+        if (batch_size == 0U) {
+            return true;
+        }
+        m_batch_buffer = new char[batch_size];
+        if (m_batch_buffer == nullptr) {
+            Logger::printfln(HTTP_UNABLE_TO_ALLOCATE_BATCH);
+            return false;
+        }
+        m_batch_capacity = batch_size;
+        return true;
+    }
+
+    /// @brief Returns the amount of telemetry messages that are currently batched and will be sent with the next sendTelemetryBatch() call
+    /// @return Amount of batched telemetry messages
+    size_t const & getBatchedTelemetryAmount() const {
+        return m_batch_amount;
+    }
+
+    /// @brief Adds telemetry data with the given key and value of the given type to the telemetry batch, sends the batch first if the data would not fit into it anymore.
+    /// See https://thingsboard.io/docs/user-guide/telemetry/ for more information
+    /// @tparam T Type of the passed value
+    /// @param key Key of the key value pair we want to send
+    /// @param value Value of the key value pair we want to send
+    /// @param timestamp Unix timestamp in milliseconds the data was measured at, if it is 0 the time the server received the batch is used instead.
+    /// Should be set if the same key is batched multiple times, because the server would otherwise only keep the last value, because all values would have the same timestamp, default = 0
+    /// @return Whether adding the data to the batch was successful or not
+    template<typename T>
+    bool batchTelemetryData(char const * key, T const & value, uint64_t const & timestamp = 0U) {
+        Telemetry const t(key, value);
+        if (t.IsEmpty()) {
+            // Message is ignored and not sent at all.
+            return false;
+        }
+
+        StaticJsonDocument<JSON_OBJECT_SIZE(1)> json_buffer;
+        if (!t.SerializeKeyValue(json_buffer)) {
+            Logger::printfln(UNABLE_TO_SERIALIZE);
+            return false;
+        }
+        return batchTelemetryJson(json_buffer, timestamp);
+    }
+
+    /// @brief Adds telemetry key value pairs from custom source to the telemetry batch, sends the batch first if the data would not fit into it anymore.
+    /// See https://thingsboard.io/docs/user-guide/telemetry/ for more information
+    /// @param source JsonDocument containing our json key value pairs we want to send,
+    /// is checked before usage for any possible occuring internal errors. See https://arduinojson.org/v6/api/jsondocument/ for more information
+    /// @param timestamp Unix timestamp in milliseconds the data was measured at, if it is 0 the time the server received the batch is used instead, default = 0
+    /// @return Whether adding the data to the batch was successful or not
+    bool batchTelemetryJson(JsonDocument const & source, uint64_t const & timestamp = 0U) {
+        if (m_batch_buffer == nullptr) {
+            Logger::printfln(HTTP_BATCH_NOT_ALLOCATED);
+            return false;
+        }
+        else if (source.isNull()) {
+            Logger::printfln(UNABLE_TO_ALLOCATE_JSON);
+            return false;
+        }
+        else if (source.overflowed()) {
+            Logger::printfln(JSON_SIZE_TO_SMALL);
+            return false;
+        }
+
+        // Messages with a timestamp are wrapped into {"ts":timestamp,"values":message}, the closing bracket of the timestamp object is replaced with the values key instead
+        StaticJsonDocument<JSON_OBJECT_SIZE(1)> timestamp_buffer;
+        size_t prefix_size = 0U;
+        if (timestamp != 0U) {
+            timestamp_buffer[HTTP_TIMESTAMP_KEY] = timestamp;
+            prefix_size = measureJson(timestamp_buffer) - 1U + strlen(",\"\":") + strlen(HTTP_VALUES_KEY);
+        }
+        size_t const suffix_size = timestamp != 0U ? 1U : 0U;
+        // Every message is preceded by either the opening bracket of the array or the comma seperating it from the previous message
+        size_t const message_size = 1U + prefix_size + measureJson(source) + suffix_size;
+        // The closing bracket of the array and the null terminator have to fit into the batch as well, when it is sent
+        if (m_batch_length + message_size + 2U > m_batch_capacity) {
+            if (m_batch_amount != 0U && !sendTelemetryBatch()) {
+                return false;
+            }
+            if (message_size + 2U > m_batch_capacity) {
+                Logger::printfln(HTTP_BATCH_MESSAGE_TOO_BIG, message_size, m_batch_capacity);
+                return false;
+            }
+        }
+
+        char * const message = m_batch_buffer + m_batch_length;
+        size_t written = 0U;
+        message[written++] = m_batch_amount == 0U ? '[' : ',';
+        if (timestamp != 0U) {
+            written += serializeJson(timestamp_buffer, message + written, m_batch_capacity - m_batch_length - written) - 1U;
+            written += snprintf(message + written, m_batch_capacity - m_batch_length - written, ",\"%s\":", HTTP_VALUES_KEY);
+        }
+        written += serializeJson(source, message + written, m_batch_capacity - m_batch_length - written);
+        if (timestamp != 0U) {
+            message[written++] = '}';
+        }
+        if (written != message_size) {
+            Logger::printfln(UNABLE_TO_SERIALIZE_JSON);
+            return false;
+        }
+        m_batch_length += written;
+        m_batch_amount++;
+        return true;
+    }
+
+    /// @brief Sends all batched telemetry messages in a single request as a json array and clears the batch afterwards, even if sending failed.
+    /// Should be called periodically, because messages are otherwise only sent once the batch is full.
+    /// See https://thingsboard.io/docs/user-guide/telemetry/ for more information
+    /// @return Whether sending the batched messages was successful or not, or true if there were no batched messages
+    bool sendTelemetryBatch() {
+        if (m_batch_amount == 0U) {
+            return true;
+        }
+        m_batch_buffer[m_batch_length] = ']';
+        m_batch_buffer[m_batch_length + 1U] = '\0';
+        bool const result = sendTelemetryString(m_batch_buffer);
+        clearTelemetryBatch();
+        return result;
+    }
+
     /// @brief Attempts to send a GET request over HTTP or HTTPS
     /// @param path API path we want to get data from (example: /api/v1/$TOKEN/rpc)
     /// @param response String the GET response will be copied into,
@@ -188,6 +393,16 @@ class ThingsBoardHttpSized {
         return getMessage(path, response);
     }
 
+    /// @brief Attempts to send a GET request over HTTP or HTTPS and deserializes the json response body directly while it is received,
+    /// instead of copying the complete body into a string object first and then deserializing that string
+    /// @param path API path we want to get data from (example: /api/v1/$TOKEN/attributes?sharedKeys=fw_version)
+    /// @param response JsonDocument the GET response will be deserialized into, has to be big enough to hold the received json,
+    /// see https://arduinojson.org/v6/assistant/ for more information on the needed size. Will be cleared if the GET request wasn't successful
+    /// @return Whetherr sending the GET request and deserializing the response was successful or not
+    bool sendGetRequest(char const * path, JsonDocument & response) {
+        return getJsonMessage(path, response);
+    }
+
     /// @brief Attempts to send a POST request over HTTP or HTTPS
     /// @param path API path we want to send data to (example: /api/v1/$TOKEN/attributes)
     /// @param json String containing our json key value pairs we want to attempt to send
@@ -251,6 +466,120 @@ class ThingsBoardHttpSized {
         return Send_Json(HTTP_ATTRIBUTES_TOPIC, source, json_size);
     }
 
+    /// @brief Sends a long poll request, which the server holds open until one of the shared attributes of this device is changed or the given timeout has passed.
+    /// If an update is received every given callback that subscribed to atleast one of the changed attributes is called with the received update,
+    /// meaning the device receives the change as soon as the server sends it, instead of only on the next fixed polling interval.
+    /// The connection is blocked for the duration of the long poll, therefore this method should be called in a loop, with other requests sent in between.
+    /// See https://thingsboard.io/docs/reference/http-api/#subscribe-to-attribute-updates-from-the-server for more information
+    /// @tparam InputIterator Class that points to the begin and end iterator
+    /// of the given data container, allows for using / passing either std::vector or std::array.
+    /// See https://en.cppreference.com/w/cpp/iterator/input_iterator for more information on the requirements of the iterator
+    /// @param first Iterator pointing to the first Shared_Attribute_Callback in the data container
+    /// @param last Iterator pointing to the end of the data container (last element + 1)
+    /// @param update JsonDocument the received update will be deserialized into, has to be big enough to hold all attributes that can change at once,
+    /// see https://arduinojson.org/v6/assistant/ for more information on the needed size. Is cleared if no update was received
+    /// @param timeout_milliseconds Time the server holds the request open if no shared attribute is changed, default = HTTP_DEFAULT_LONG_POLL_TIMEOUT_MILLISECONDS (10 seconds)
+    /// @return Whether an update was received and passed to the subscribed callbacks, false if the long poll timed out without any update or failed
+    template<typename InputIterator>
+    bool pollSharedAttributeUpdates(InputIterator const & first, InputIterator const & last, JsonDocument & update, uint32_t const & timeout_milliseconds = HTTP_DEFAULT_LONG_POLL_TIMEOUT_MILLISECONDS) {
+        char path[MAX_HTTP_PATH_SIZE] = {};
+        if (!buildPath(path, HTTP_ATTRIBUTES_UPDATES_TOPIC, timeout_milliseconds) || !getJsonMessage(path, update, true)) {
+            return false;
+        }
+
+        JsonObjectConst object = update.as<JsonObjectConst>();
+        if (object.containsKey(SHARED_RESPONSE_KEY)) {
+            object = object[SHARED_RESPONSE_KEY];
+        }
+        for (auto it = first; it != last; ++it) {
+            auto const & callback = *it;
+            // Check if this callback did not subscribe to any keys that were in this update,
+            // if it did not we simply continue with the next subscribed callback.
+            if (!containsSubscribedKey(callback.Get_Attributes(), object)) {
+                continue;
+            }
+            callback.Call_Callback(object);
+        }
+        return true;
+    }
+
+    //----------------------------------------------------------------------------
+    // Server-side RPC API
+
+    /// @brief Sends a long poll request, which the server holds open until it sends a server-side RPC request to this device or the given timeout has passed.
+    /// If a request is received the first given callback subscribed to its method name is called and the data it entered into the response, is sent back to the server,
+    /// meaning the device receives the request as soon as the server sends it, instead of only on the next fixed polling interval.
+    /// The connection is blocked for the duration of the long poll, therefore this method should be called in a loop, with other requests sent in between.
+    /// See https://thingsboard.io/docs/reference/http-api/#server-side-rpc for more information
+#if THINGSBOARD_ENABLE_DYNAMIC
+    /// @tparam InputIterator Class that points to the begin and end iterator
+    /// of the given data container, allows for using / passing either std::vector or std::array.
+    /// See https://en.cppreference.com/w/cpp/iterator/input_iterator for more information on the requirements of the iterator
+    template<typename InputIterator>
+#else
+    /// @tparam MaxRPC Maximum amount of key-value pairs that will ever be sent in the response of any of the given callbacks, allows to use a StaticJsonDocument on the stack in the background, default = Default_RPC_Amount (0)
+    /// @tparam InputIterator Class that points to the begin and end iterator
+    /// of the given data container, allows for using / passing either std::vector or std::array.
+    /// See https://en.cppreference.com/w/cpp/iterator/input_iterator for more information on the requirements of the iterator
+    template<size_t MaxRPC = Default_RPC_Amount, typename InputIterator>
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+    /// @param first Iterator pointing to the first RPC_Callback in the data container
+    /// @param last Iterator pointing to the end of the data container (last element + 1)
+    /// @param request JsonDocument the received request will be deserialized into, has to be big enough to hold the method name, request id and parameters of the biggest expected request,
+    /// see https://arduinojson.org/v6/assistant/ for more information on the needed size. Is cleared if no request was received
+    /// @param timeout_milliseconds Time the server holds the request open if no server-side RPC request is sent, default = HTTP_DEFAULT_LONG_POLL_TIMEOUT_MILLISECONDS (10 seconds)
+    /// @return Whether a request was received and passed to the subscribed callback, as well as its response sent successfully if the callback entered any data into it.
+    /// False if the long poll timed out without any request or failed
+    bool pollRPCRequest(InputIterator const & first, InputIterator const & last, JsonDocument & request, uint32_t const & timeout_milliseconds = HTTP_DEFAULT_LONG_POLL_TIMEOUT_MILLISECONDS) {
+        char path[MAX_HTTP_PATH_SIZE] = {};
+        if (!buildPath(path, HTTP_RPC_REQUEST_TOPIC, timeout_milliseconds) || !getJsonMessage(path, request, true)) {
+            return false;
+        }
+
+        char const * method_name = request[RPC_METHOD_KEY];
+        if (Helper::stringIsNullorEmpty(method_name)) {
+#if THINGSBOARD_ENABLE_DEBUG
+            Logger::printfln(HTTP_RPC_METHOD_NULL);
+#endif // THINGSBOARD_ENABLE_DEBUG
+            return false;
+        }
+
+        for (auto it = first; it != last; ++it) {
+            auto const & rpc = *it;
+            char const * subscribedMethodName = rpc.Get_Name();
+            if (Helper::stringIsNullorEmpty(subscribedMethodName) || strncmp(subscribedMethodName, method_name, strlen(subscribedMethodName)) != 0) {
+                continue;
+            }
+#if THINGSBOARD_ENABLE_DEBUG
+            Logger::printfln(HTTP_CALLING_RPC_CB, method_name);
+#endif // THINGSBOARD_ENABLE_DEBUG
+
+            JsonVariantConst const param = request[RPC_PARAMS_KEY];
+#if THINGSBOARD_ENABLE_DYNAMIC
+            size_t const & rpc_response_size = rpc.Get_Response_Size();
+            TBJsonDocument json_buffer(rpc_response_size);
+#else
+            size_t constexpr rpc_response_size = MaxRPC;
+            StaticJsonDocument<JSON_OBJECT_SIZE(MaxRPC)> json_buffer;
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+            rpc.Call_Callback(param, json_buffer);
+
+            // Callbacks that do not enter any data into the response are used for RPC widgets that do not expect a response
+            if (json_buffer.isNull()) {
+                return true;
+            }
+            else if (json_buffer.overflowed()) {
+                Logger::printfln(HTTP_RPC_RESPONSE_OVERFLOWED, rpc_response_size);
+                return false;
+            }
+
+            char response_path[MAX_HTTP_PATH_SIZE] = {};
+            uint32_t const request_id = request[HTTP_RPC_ID_KEY];
+            return buildPath(response_path, HTTP_RPC_RESPONSE_TOPIC, request_id) && postJson(response_path, json_buffer, Helper::Measure_Json(json_buffer));
+        }
+        return true;
+    }
+
   private:
     /// @brief Returns the maximum amount of bytes that we want to allocate on the stack, before the memory is allocated on the heap instead
     /// @return Maximum amount of bytes we want to allocate on the stack
@@ -264,6 +593,113 @@ class ThingsBoardHttpSized {
         m_client.stop();
     }
 
+    /// @brief Finishes the previously sent request, if it was successful and keep alive is enabled, the remaining response body is discarded so the connection can be reused for the next request.
+    /// Otherwise the connection is closed instead, because the state of the connection is unknown and the next request will have to re-establish it
+    /// @param success Whether the previously sent request was successful or not
+    void finishRequest(bool const & success) {
+        if (!success || !m_keep_alive) {
+            clearConnection();
+            return;
+        }
+        uint8_t discarded[HTTP_RESPONSE_CHUNK_SIZE] = {};
+        while (m_client.read_response_body(discarded, sizeof(discarded)) != 0U) {
+            // Nothing to do, the response body is simply discarded
+        }
+    }
+
+    /// @brief Formats the given topic with the access token and the given additional arguments into the given path buffer
+    /// @tparam ...Args Types of the additional arguments inserted after the access token
+    /// @param path Buffer the formatted path is written into
+    /// @param topic Topic containing the format specifier for the access token, followed by the format specifiers of the additional arguments
+    /// @param ...args Additional arguments inserted after the access token
+    /// @return Whether the path could be formatted completly, fails if the access token is not set or too long
+    template<typename... Args>
+    bool buildPath(char (&path)[MAX_HTTP_PATH_SIZE], char const * topic, Args const &... args) const {
+        if (m_token == nullptr) {
+            return false;
+        }
+        int const written_characters = snprintf(path, sizeof(path), topic, m_token, args...);
+        // Sending to a truncated path would post the data for a different or non-existing device, therefore we have to fail instead
+        if (written_characters < 0 || static_cast<size_t>(written_characters) >= sizeof(path)) {
+            Logger::printfln(HTTP_PATH_TOO_LONG, MAX_HTTP_PATH_SIZE);
+            return false;
+        }
+        return true;
+    }
+
+    /// @brief Returns whether the given shared attribute update contains atleast one of the given subscribed keys, or if no keys were subscribed, meaning every update is of interest
+    /// @tparam Container Data container holding the subscribed keys (Vector or Array)
+    /// @param keys Keys subscribed by the callback
+    /// @param object Received shared attribute update
+    /// @return Whether the callback should be called with the given update
+    template<typename Container>
+    static bool containsSubscribedKey(Container const & keys, JsonObjectConst const & object) {
+        if (keys.empty()) {
+            return true;
+        }
+        for (auto const & att : keys) {
+            if (Helper::stringIsNullorEmpty(att)) {
+                continue;
+            }
+            // Break early if the key was subscribed to by this callback
+            else if (object.containsKey(att)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// @brief Clears all batched telemetry messages, but keeps the allocated memory
+    void clearTelemetryBatch() {
+        m_batch_length = 0U;
+        m_batch_amount = 0U;
+    }
+
+    /// @brief Attempts to serialize the given json and send it in a POST request over HTTP or HTTPS
+    /// @param path API path we want to send data to (example: /api/v1/$TOKEN/attributes)
+    /// @param source JsonDocument containing our json key value pairs we want to send,
+    /// is checked before usage for any possible occuring internal errors. See https://arduinojson.org/v6/api/jsondocument/ for more information
+    /// @param json_size Size of the data inside the source
+    /// @return Whether sending the POST request was successful or not
+    bool postJson(char const * path, JsonDocument const & source, size_t const & json_size) {
+        // Check if allocating needed memory failed when trying to create the JsonDocument,
+        // if it did the isNull() method will return true. See https://arduinojson.org/v6/api/jsonvariant/isnull/ for more information
+        if (source.isNull()) {
+            Logger::printfln(UNABLE_TO_ALLOCATE_JSON);
+            return false;
+        }
+        // Check if inserting any of the internal values failed because the JsonDocument was too small,
+        // if it did the overflowed() method will return true. See https://arduinojson.org/v6/api/jsondocument/overflowed/ for more information
+        if (source.overflowed()) {
+            Logger::printfln(JSON_SIZE_TO_SMALL);
+            return false;
+        }
+        bool result = false;
+        if (getMaximumStackSize() < json_size) {
+            char * json = new char[json_size]();
+            if (serializeJson(source, json, json_size) < json_size - 1) {
+                Logger::printfln(UNABLE_TO_SERIALIZE_JSON);
+            }
+            else {
+                result = postMessage(path, json);
+            }
+            // Ensure to actually delete the memory placed onto the heap, to make sure we do not create a memory leak
+            // and set the pointer to null so we do not have a dangling reference.
+            delete[] json;
+            json = nullptr;
+        }
+        else {
+            char json[json_size] = {};
+            if (serializeJson(source, json, json_size) < json_size - 1) {
+                Logger::printfln(UNABLE_TO_SERIALIZE_JSON);
+                return result;
+            }
+            result = postMessage(path, json);
+        }
+        return result;
+    }
+
+
     /// @brief Attempts to send a POST request over HTTP or HTTPS
     /// @param path API path we want to send data to (example: /api/v1/$TOKEN/attributes)
     /// @param json String containing our json key value pairs we want to attempt to send
@@ -277,7 +713,7 @@ class ThingsBoardHttpSized {
             success = false;
         }
 
-        clearConnection();
+        finishRequest(success);
         return success;
     }
 
@@ -291,7 +727,7 @@ class ThingsBoardHttpSized {
 #else
     bool getMessage(char const * path, String& response) {
 #endif // THINGSBOARD_ENABLE_STL
-        bool success = m_client.get(path);
+        bool success = m_client.get(path) == 0;
         int const status = m_client.get_response_status_code();
 
         if (!success || status < HTTP_RESPONSE_SUCCESS_RANGE_START || status > HTTP_RESPONSE_SUCCESS_RANGE_END) {
@@ -302,7 +738,43 @@ class ThingsBoardHttpSized {
         response = m_client.get_response_body();
 
         cleanup:
-        clearConnection();
+        finishRequest(success);
+        return success;
+    }
+
+    /// @brief Attempts to send a GET request over HTTP or HTTPS and deserializes the response body while it is received
+    /// @param path API path we want to get data from (example: /api/v1/$TOKEN/attributes?sharedKeys=fw_version)
+    /// @param response JsonDocument the GET response will be deserialized into
+    /// @param long_poll Whether the request is a long poll, where the server responding with a request timeout is expected and not an error, default = false
+    /// @return Whetherr sending the GET request and deserializing the response was successful or not
+    bool getJsonMessage(char const * path, JsonDocument & response, bool const & long_poll = false) {
+        bool success = m_client.get(path) == 0;
+        int const status = m_client.get_response_status_code();
+
+        if (success && long_poll && status == HTTP_RESPONSE_REQUEST_TIMEOUT) {
+            // Nothing was sent while the long poll was held open, the connection itself is still valid and can be reused for the next request
+            response.clear();
+            finishRequest(true);
+            return false;
+        }
+        if (!success || status < HTTP_RESPONSE_SUCCESS_RANGE_START || status > HTTP_RESPONSE_SUCCESS_RANGE_END) {
+            Logger::printfln(HTTP_FAILED, GET, status);
+            response.clear();
+            success = false;
+            goto cleanup;
+        }
+
+        {
+            HTTP_Response_Reader reader(m_client);
+            DeserializationError const error = deserializeJson(response, reader);
+            if (error) {
+                Logger::printfln(HTTP_RESPONSE_NOT_JSON, error.c_str());
+                success = false;
+            }
+        }
+
+        cleanup:
+        finishRequest(success);
         return success;
     }
 
@@ -372,9 +844,14 @@ class ThingsBoardHttpSized {
         return telemetry ? sendTelemetryJson(json_buffer, Helper::Measure_Json(json_buffer)) : sendAttributeJson(json_buffer, Helper::Measure_Json(json_buffer));
     }
 
-    IHTTP_Client& m_client = {};     // HttpClient instance
-    size_t        m_max_stack = {};  // Maximum stack size we allocate at once on the stack.
-    char const    *m_token = {};     // Access token used to connect with
+    IHTTP_Client& m_client = {};         // HttpClient instance
+    size_t        m_max_stack = {};      // Maximum stack size we allocate at once on the stack.
+    char const    *m_token = {};         // Access token used to connect with
+    bool          m_keep_alive = {};     // Whether the connection is reused for the next request, instead of being closed after each request
+    char          *m_batch_buffer = {};  // Telemetry messages that will be sent in a single request as a json array, allocated with setTelemetryBatchSize()
+    size_t        m_batch_capacity = {}; // Size of the telemetry batch in bytes
+    size_t        m_batch_length = {};   // Amount of bytes currently used by the batched telemetry messages
+    size_t        m_batch_amount = {};   // Amount of currently batched telemetry messages
 };
 
 using ThingsBoardHttp = ThingsBoardHttpSized<>;
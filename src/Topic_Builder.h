@@ -0,0 +1,113 @@
+#ifndef Topic_Builder_h
+#define Topic_Builder_h
+
+// Local includes.
+#include "Helper.h"
+
+// Library includes.
+#include <stdlib.h>
+#include <string.h>
+
+
+/// @brief Builds topics that consist out of a fixed prefix directly followed by a number, for example the request id of a response (v1/devices/me/rpc/response/$request_id).
+/// The prefix is copied into the internal buffer once when it is set and its length is cached, afterwards building a topic only writes the digits of the number after the prefix,
+/// instead of formatting the complete topic again with snprintf every time, which has to parse the whole format string.
+/// Because the prefix length is known, the builder can additionally be used to check if a received topic starts with the prefix and to parse the number following it
+/// @tparam Capacity Size of the internal buffer, has to be big enough to hold the complete prefix, MAX_NUMBER_CHARACTERS for the appended number and the null termination
+template<size_t Capacity>
+class Topic_Builder {
+  public:
+    /// @brief Constructs an empty topic builder, built topics only consist out of the number until a prefix has been set
+    Topic_Builder()
+      : m_topic()
+      , m_prefix_length(0U)
+      , m_length(0U)
+    {
+        // Nothing to do
+    }
+
+    /// @brief Constructs a topic builder with the given fixed prefix
+    /// @param prefix Null terminated prefix that every built topic should start with (v1/devices/me/rpc/response/)
+    explicit Topic_Builder(char const * prefix)
+      : Topic_Builder()
+    {
+        (void)set_prefix(prefix);
+    }
+
+    /// @brief Sets the fixed prefix that every built topic should start with and copies it into the internal buffer
+    /// @param prefix Null terminated prefix that every built topic should start with (v1/devices/me/rpc/response/)
+    /// @return Whether the prefix and the largest possible number fit into the internal buffer, if they do not the previous prefix is kept
+    bool set_prefix(char const * prefix) {
+        size_t const prefix_length = strlen(prefix);
+        if (prefix_length + MAX_NUMBER_CHARACTERS >= Capacity) {
+            return false;
+        }
+        (void)memcpy(m_topic, prefix, prefix_length + 1U);
+        m_prefix_length = prefix_length;
+        m_length = prefix_length;
+        return true;
+    }
+
+    /// @brief Sets the fixed prefix that every built topic should start with, where the prefix itself contains a number that stays the same for multiple built topics.
+    /// Allows to format that number only once, when it changes, instead of every time a topic is built (v2/fw/request/$request_id/chunk/)
+    /// @param start Null terminated string that should be copied in front of the given number (v2/fw/request/)
+    /// @param number Number that should be written between the start and end of the prefix ($request_id)
+    /// @param end Null terminated string that should be copied after the given number (/chunk/)
+    /// @return Whether the prefix and the largest possible number fit into the internal buffer, if they do not the previous prefix is kept
+    bool set_prefix(char const * start, size_t const & number, char const * end) {
+        size_t const start_length = strlen(start);
+        size_t const end_length = strlen(end);
+        if (start_length + MAX_NUMBER_CHARACTERS + end_length + MAX_NUMBER_CHARACTERS >= Capacity) {
+            return false;
+        }
+        (void)memcpy(m_topic, start, start_length);
+        size_t const number_end = start_length + Helper::writeNumber(m_topic + start_length, number);
+        (void)memcpy(m_topic + number_end, end, end_length + 1U);
+        m_prefix_length = number_end + end_length;
+        m_length = m_prefix_length;
+        return true;
+    }
+
+    /// @brief Builds the topic by writing the given number directly after the prefix, overwriting any previously built number
+    /// @param number Number that should be appended to the prefix ($request_id)
+    /// @return Pointer to the null terminated built topic, stays valid until the topic is built again or the prefix is changed
+    char const * build(size_t const & number) {
+        m_length = m_prefix_length + Helper::writeNumber(m_topic + m_prefix_length, number);
+        m_topic[m_length] = '\0';
+        return m_topic;
+    }
+
+    /// @brief Returns the last built topic, or only the prefix if no topic has been built since the prefix was set
+    /// @return Pointer to the null terminated topic
+    char const * c_str() const {
+        return m_topic;
+    }
+
+    /// @brief Returns the length of the last built topic, or of the prefix if no topic has been built since the prefix was set
+    /// @return Length of the topic not including the null termination
+    size_t const & length() const {
+        return m_length;
+    }
+
+    /// @brief Returns whether the given received topic starts with the prefix, compares only the cached amount of prefix characters instead of measuring the prefix again
+    /// @param topic Null terminated received topic that should be checked
+    /// @return Whether the received topic starts with the prefix
+    bool matches_prefix(char const * topic) const {
+        return strncmp(m_topic, topic, m_prefix_length) == 0;
+    }
+
+    /// @brief Parses the number directly following the prefix in the given received topic.
+    /// Should only be called if matches_prefix() returned true for the same topic, because the prefix length is skipped without checking the skipped characters
+    /// @param topic Null terminated received topic that contains the prefix as well as the number (v1/devices/me/rpc/response/$request_id)
+    /// @return Parsed number or 0 if the characters following the prefix are not a number
+    size_t parse_number(char const * topic) const {
+        return strtoul(topic + m_prefix_length, nullptr, 10);
+    }
+
+  private:
+    char   m_topic[Capacity];  // Internal buffer containing the prefix directly followed by the last built number and the null termination
+    size_t m_prefix_length;    // Cached length of the prefix, meaning the index the number is written at
+    size_t m_length;           // Length of the last built topic
+};
+
+#endif // Topic_Builder_h
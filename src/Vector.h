@@ -6,9 +6,21 @@
 
 // Library includes.
 #include <assert.h>
+#ifdef __has_include
+#  if __has_include(<new>)
+#    include <new>
+#  elif __has_include(<new.h>)
+#    include <new.h>
+#  endif
+#else
+#  include <new>
+#endif
 
 
 /// @brief Replacement data container for boards that do not support the C++ STL and therefore do not have the std::vector class.
+/// Elements are stored in uninitialized memory and only constructed once they are inserted, meaning growing the container does not default construct unused elements,
+/// and existing elements are moved into the grown memory instead of copied bytewise, which is required for elements that own memory themselves (RPC_Callback, Shared_Attribute_Callback, ...).
+/// The capacity is doubled each time the container is full, therefore inserting N elements only requires O(log N) allocations, or a single one if reserve() is called beforehand
 /// @tparam T Type of the underlying data the list should point too.
 template <typename T>
 class Vector {
@@ -16,7 +28,13 @@ class Vector {
     using value_type = T;
 
     /// @brief Constructor
-    Vector(void) = default;
+    Vector()
+      : m_elements(nullptr)
+      , m_capacity(0U)
+      , m_size(0U)
+    {
+        // Nothing to do
+    }
 
     /// @brief Constructor that allows compatibility with std::vector, simply forwards call to internal insert method and copies all data between the first and last iterator
     /// @tparam InputIterator Class that points to the begin and end iterator
@@ -26,9 +44,7 @@ class Vector {
     /// @param last Iterator pointing to one past the end of the elements we want to copy into our underlying data container
     template<typename InputIterator>
     Vector(InputIterator const & first, InputIterator const & last)
-      : m_elements(nullptr)
-      , m_capacity(0U)
-      , m_size(0U)
+      : Vector()
     {
         insert(nullptr, first, last);
     }
@@ -41,20 +57,44 @@ class Vector {
     /// @param container Data container with begin() and end() method that we want to copy fully into our underlying data container
     template<typename Container>
     Vector(Container const & container)
-      : m_elements(nullptr)
-      , m_capacity(0U)
-      , m_size(0U)
+      : Vector()
     {
         insert(nullptr, container.begin(), container.end());
     }
 
+    /// @brief Copy constructor, allocates memory for exactly the amount of elements in the other vector and copies them
+    /// @param other Vector whose elements should be copied
+    Vector(Vector const & other)
+      : Vector()
+    {
+        insert(nullptr, other.begin(), other.end());
+    }
+
+    /// @brief Move constructor, takes over the memory of the other vector without copying or moving any element
+    /// @param other Vector whose memory should be taken over, is empty afterwards
+    Vector(Vector && other)
+      : Vector()
+    {
+        swap(other);
+    }
+
+    /// @brief Copy and move assignment operator, the given vector is either copied or moved into the parameter and then swapped with this vector,
+    /// the previous elements of this vector are then destroyed together with the parameter
+    /// @param other Vector whose elements should be copied or moved
+    /// @return Reference to this vector
+    Vector & operator=(Vector other) {
+        swap(other);
+        return *this;
+    }
+
     /// @brief Destructor
     ~Vector() {
-        delete[] m_elements;
+        clear();
+        Deallocate(m_elements);
         m_elements = nullptr;
     }
 
-    /// @brief Method that allows compatibility with std::vector, simply forwards call to internal insert method and copies all data between the first and last iterator
+    /// @brief Method that allows compatibility with std::vector, replaces all elements with the data between the first and last iterator
     /// @tparam InputIterator Class that points to the begin and end iterator
     /// of the given data container, allows for using / passing either std::vector or std::array.
     /// See https://en.cppreference.com/w/cpp/iterator/input_iterator for more information on the requirements of the iterator
@@ -62,10 +102,11 @@ class Vector {
     /// @param last Iterator pointing to one past the end of the elements we want to copy into our underlying data container
     template<typename InputIterator>
     void assign(InputIterator const & first, InputIterator const & last) {
+        clear();
         insert(nullptr, first, last);
     }
 
-    /// @brief Method that allows compatibility with std::vector, simply forwards call to internal insert method and copies all data from the given container
+    /// @brief Method that allows compatibility with std::vector, replaces all elements with the data from the given container
     /// @tparam Container Class that contains the actual data we want to copy into our internal data container,
     /// requires access to a begin() and end() method, that point to the first element and one past the last element we want to copy respectively.
     /// Both methods need to return an InputIterator, allows for using / passing either std::vector or std::array.
@@ -73,7 +114,7 @@ class Vector {
     /// @param container Data container with begin() and end() method that we want to copy fully into our underlying data container
     template<typename Container>
     void assign(Container const & container) {
-        insert(nullptr, container.begin(), container.end());
+        assign(container.begin(), container.end());
     }
 
     /// @brief Returns whether there are still any element in the underlying data container
@@ -94,6 +135,24 @@ class Vector {
         return m_capacity;
     }
 
+    /// @brief Increases the capacity to atleast the given amount of elements, so that inserting up to that amount of elements does not need to allocate memory again.
+    /// Does nothing if the capacity is already big enough
+    /// @param new_capacity Amount of elements that should fit into the underlying data container
+    void reserve(size_t const & new_capacity) {
+        if (new_capacity <= m_capacity) {
+            return;
+        }
+        Move_Into(Allocate(new_capacity), new_capacity);
+    }
+
+    /// @brief Decreases the capacity to the current amount of elements, to free the memory that is not used anymore
+    void shrink_to_fit() {
+        if (m_size == m_capacity) {
+            return;
+        }
+        Move_Into(m_size == 0U ? nullptr : Allocate(m_size), m_size);
+    }
+
     /// @brief Returns a iterator to the first element of the underlying data container
     /// @return Iterator pointing to the first element of the underlying data container
     T * begin() {
@@ -137,28 +196,47 @@ class Vector {
         return m_elements + m_size;
     }
 
-    /// @brief Inserts the given element at the end of the underlying data container,
-    /// If the interal data structure is full already then this method will assert and stop the application.
-    /// Because if we do not we could cause an out of bounds write, which could possibly overwrite other memory.
-    /// Causing hard to debug issues, therefore this behaviour is not allowed in the first place
+    /// @brief Copies the given element to the end of the underlying data container, doubles the capacity if the underlying data container is full
     /// @param element Element that should be inserted at the end
     void push_back(T const & element) {
+        emplace_back(element);
+    }
+
+    /// @brief Moves the given element to the end of the underlying data container, doubles the capacity if the underlying data container is full
+    /// @param element Element that should be inserted at the end
+    void push_back(T && element) {
+        emplace_back(static_cast<T &&>(element));
+    }
+
+    /// @brief Constructs a new element at the end of the underlying data container directly from the given arguments, without any temporary element that would need to be copied or moved.
+    /// Doubles the capacity if the underlying data container is full, the new element is constructed before the existing elements are moved, so the arguments may reference elements of this vector
+    /// @tparam ...Args Types of the arguments passed to the constructor of the element
+    /// @param ...args Arguments passed to the constructor of the element
+    /// @return Reference to the constructed element
+    template<typename... Args>
+    T & emplace_back(Args &&... args) {
         if (m_size == m_capacity) {
-            m_capacity = (m_capacity == 0) ? 1 : 2 * m_capacity;
-            T* new_elements = new T[m_capacity]();
-            if (m_elements != nullptr) {
-                memcpy(new_elements, m_elements, m_size * sizeof(T));
-                delete[] m_elements;
-            }
-            m_elements = new_elements;
+            size_t const new_capacity = (m_capacity == 0U) ? 1U : 2U * m_capacity;
+            T * const new_elements = Allocate(new_capacity);
+            new (new_elements + m_size) T(static_cast<Args &&>(args)...);
+            Move_Into(new_elements, new_capacity);
+        }
+        else {
+            new (m_elements + m_size) T(static_cast<Args &&>(args)...);
         }
-        m_elements[m_size] = element;
         m_size++;
+        return back();
+    }
+
+    /// @brief Removes the last element of the underlying data container
+    void pop_back() {
+        assert(m_size != 0U);
+        m_size--;
+        m_elements[m_size].~T();
     }
 
-    /// @brief Inserts all element from the given start to the given end iterator into the underlying data container.
-    /// Simply calls push_back on each element, meaning if the initally allocated size if not big enough to hold all elements,
-    /// then this method will simply not insert those elements instead
+    /// @brief Inserts all element from the given start to the given end iterator at the end of the underlying data container.
+    /// Reserves the needed capacity once beforehand, so that inserting the elements requires atmost one allocation
     /// @tparam InputIterator Class that points to the begin and end iterator
     /// of the given data container, allows for using / passing either std::vector or std::array.
     /// See https://en.cppreference.com/w/cpp/iterator/input_iterator for more information on the requirements of the iterator
@@ -167,12 +245,13 @@ class Vector {
     /// @param last Iterator pointing to one past the end of the elements we want to copy into our underlying data container
     template<typename InputIterator>
     void insert(T const * position, InputIterator const & first, InputIterator const & last) {
+        reserve(m_size + Helper::distance(first, last));
         for (auto it = first; it != last; ++it) {
             push_back(*it);
         }
     }
 
-    /// @brief Removes the element at the given position, has to move all element one to the left if the index is not at the end of the array
+    /// @brief Removes the element at the given position, has to move all element one to the left if the index is not at the end of the array, which keeps the order of the remaining elements
     /// @tparam InputIterator Class that points to the begin and end iterator
     /// of the given data container, allows for using / passing either std::vector or std::array.
     /// See https://en.cppreference.com/w/cpp/iterator/input_iterator for more information on the requirements of the iterator
@@ -181,14 +260,33 @@ class Vector {
     void erase(InputIterator const & position) {
         size_t const index = Helper::distance(begin(), position);
         // Check if the given index is bigger or equal than the actual amount of elements if it is we can not erase that element because it does not exist
-        if (index < m_size) {
-            // Move all elements after the index one position to the left
-            for (size_t i = index; i < m_size - 1; ++i) {
-                m_elements[i] = m_elements[i + 1];
-            }
-            // Decrease the size of the vector to remove the last element, because either it was moved one index to the left or was the element we wanted to delete
-            m_size--;
+        if (index >= m_size) {
+            return;
+        }
+        // Move all elements after the index one position to the left
+        for (size_t i = index; i < m_size - 1U; ++i) {
+            m_elements[i] = static_cast<T &&>(m_elements[i + 1U]);
+        }
+        // Destroy the last element, because either it was moved one index to the left or was the element we wanted to delete
+        pop_back();
+    }
+
+    /// @brief Removes the element at the given position, by moving the last element into its place instead of moving all following elements one to the left.
+    /// Only requires a single move, but does not keep the order of the remaining elements, should therefore only be used if the order is not relevant
+    /// @tparam InputIterator Class that points to the begin and end iterator
+    /// of the given data container, allows for using / passing either std::vector or std::array.
+    /// See https://en.cppreference.com/w/cpp/iterator/input_iterator for more information on the requirements of the iterator
+    /// @param position Iterator pointing to the element, that should be removed from the underlying data container
+    template<typename InputIterator>
+    void erase_unordered(InputIterator const & position) {
+        size_t const index = Helper::distance(begin(), position);
+        if (index >= m_size) {
+            return;
+        }
+        if (index != m_size - 1U) {
+            m_elements[index] = static_cast<T &&>(m_elements[m_size - 1U]);
         }
+        pop_back();
     }
 
     /// @brief Method to access an element at a given index,
@@ -213,14 +311,56 @@ class Vector {
         return m_elements[index];
     }
 
-    /// @brief Clears the given underlying data container.
-    /// Simply sets the underlying size to 0, data will only be cleared in the destructor
+    /// @brief Destroys all elements in the underlying data container.
+    /// Keeps the allocated memory, so that inserting the same amount of elements again does not need to allocate memory, call shrink_to_fit() afterwards to free it
     void clear() {
-        m_size = 0;
+        while (m_size != 0U) {
+            pop_back();
+        }
+    }
+
+    /// @brief Swaps the elements of this vector with the elements of the given vector, by only swapping the pointers to the underlying memory
+    /// @param other Vector whose elements should be swapped with the elements of this vector
+    void swap(Vector & other) {
+        T * const elements = m_elements;
+        size_t const capacity = m_capacity;
+        size_t const size = m_size;
+        m_elements = other.m_elements;
+        m_capacity = other.m_capacity;
+        m_size = other.m_size;
+        other.m_elements = elements;
+        other.m_capacity = capacity;
+        other.m_size = size;
     }
 
   private:
-    T      *m_elements = {}; // Pointer to the start of our elements
+    /// @brief Allocates uninitialized memory for the given amount of elements, the elements are only constructed once they are inserted
+    /// @param capacity Amount of elements the memory should be able to hold
+    /// @return Pointer to the allocated memory
+    static T * Allocate(size_t const & capacity) {
+        return static_cast<T *>(::operator new(capacity * sizeof(T)));
+    }
+
+    /// @brief Frees memory previously returned by Allocate(), all elements in it have to be destroyed already
+    /// @param elements Pointer to the memory that should be freed
+    static void Deallocate(T * elements) {
+        ::operator delete(elements);
+    }
+
+    /// @brief Moves all elements into the given memory, destroys them in the previous memory and frees it
+    /// @param new_elements Memory the elements should be moved into, has to be able to hold atleast the current amount of elements
+    /// @param new_capacity Amount of elements the given memory can hold
+    void Move_Into(T * new_elements, size_t const & new_capacity) {
+        for (size_t i = 0U; i < m_size; i++) {
+            new (new_elements + i) T(static_cast<T &&>(m_elements[i]));
+            m_elements[i].~T();
+        }
+        Deallocate(m_elements);
+        m_elements = new_elements;
+        m_capacity = new_capacity;
+    }
+
+    T      *m_elements = {}; // Pointer to the start of our elements, only the first m_size elements are constructed
     size_t m_capacity = {};  // Allocated capacity that shows how many elements we could hold
     size_t m_size = {};      // Used size that shows how many elements we entered
 };
@@ -0,0 +1,111 @@
+// Local includes.
+#include "Callback.h"
+#include "Test.h"
+
+// Library includes.
+#include <chrono>
+#include <functional>
+#include <new>
+
+
+// Amount of times each callback is copied and called, high enough for the measured time to be much bigger than the resolution of the clock
+size_t constexpr ITERATIONS = 1000000U;
+
+static size_t allocations = 0U;
+// Written with the address of every copy, prevents the compiler from optimizing the unused copies away
+static void const * volatile copy_sink = nullptr;
+
+void * operator new(size_t size) {
+    allocations++;
+    void * const memory = malloc(size);
+    if (memory == nullptr) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void operator delete(void * memory) noexcept {
+    free(memory);
+}
+
+void operator delete(void * memory, size_t) noexcept {
+    free(memory);
+}
+
+/// @brief Class whose member method is bound the same way the ThingsBoard client binds its internal methods to the callbacks of the API implementations
+class Counter {
+  public:
+    void add(size_t value) {
+        m_sum += value;
+    }
+
+    size_t m_sum = {};
+};
+
+/// @brief Copies the given callback the given amount of times, the same way callbacks are copied into the data containers of the API implementations, and measures the allocations and the time needed
+/// @tparam Function Type the callback is stored in
+/// @param name Description of the measured callback
+/// @param function Callback that should be copied
+/// @return Amount of heap allocations per copy
+template<typename Function>
+size_t measure_copy(char const * name, Function const & function) {
+    size_t const previous_allocations = allocations;
+    auto const start = std::chrono::steady_clock::now();
+    for (size_t i = 0U; i < ITERATIONS; i++) {
+        Function copy(function);
+        copy_sink = &copy;
+    }
+    std::chrono::duration<double, std::nano> const elapsed = std::chrono::steady_clock::now() - start;
+    size_t const copy_allocations = (allocations - previous_allocations) / ITERATIONS;
+    printf("%-48s copy: %6.2f ns, %u allocations\n", name, elapsed.count() / ITERATIONS, static_cast<unsigned int>(copy_allocations));
+    return copy_allocations;
+}
+
+/// @brief Calls the given callback the given amount of times and measures the time needed for each call
+/// @tparam Function Type the callback is stored in
+/// @param name Description of the measured callback
+/// @param function Callback that should be called
+template<typename Function>
+void measure_call(char const * name, Function const & function) {
+    auto const start = std::chrono::steady_clock::now();
+    for (size_t i = 0U; i < ITERATIONS; i++) {
+        function(i);
+    }
+    std::chrono::duration<double, std::nano> const elapsed = std::chrono::steady_clock::now() - start;
+    printf("%-48s call: %6.2f ns\n", name, elapsed.count() / ITERATIONS);
+}
+
+int main() {
+    Counter counter;
+    size_t first = 0U, second = 0U, third = 0U, fourth = 0U;
+    auto const bound_member = std::bind(&Counter::add, &counter, std::placeholders::_1);
+    auto const small_lambda = [&counter, &first, &second, &third](size_t value) { counter.add(value + first + second + third); };
+    auto const big_lambda = [&counter, &first, &second, &third, &fourth](size_t value) { counter.add(value + first + second + third + fourth); };
+    auto const by_value_lambda = [counter](size_t value) mutable { counter.add(value); };
+
+    using Inplace = Callback<void, size_t>::function;
+    using Big_Inplace = Inplace_Function<void(size_t), 5U * sizeof(void *)>;
+    using Standard = std::function<void(size_t)>;
+    // Empty std::function and function pointers that are nullptr result in an empty callback
+    TEST_ASSERT(!Inplace(Standard()));
+    TEST_ASSERT(!Inplace(static_cast<void (*)(size_t)>(nullptr)));
+    TEST_ASSERT(Inplace(Standard(bound_member)));
+    // Member methods bound to an instance and lambdas capturing up to four pointers are stored inplace and therefore never allocate
+    TEST_ASSERT(measure_copy("Inplace_Function, bound member method", Inplace(bound_member)) == 0U);
+    (void)measure_copy("std::function, bound member method", Standard(bound_member));
+    TEST_ASSERT(measure_copy("Inplace_Function, lambda capturing 4 pointers", Inplace(small_lambda)) == 0U);
+    (void)measure_copy("std::function, lambda capturing 4 pointers", Standard(small_lambda));
+    // Bigger callables require an increased capacity, but are then still stored inplace, whereas std::function allocates them on the heap
+    TEST_ASSERT(measure_copy("Inplace_Function, lambda capturing 5 pointers", Big_Inplace(big_lambda)) == 0U);
+    (void)measure_copy("std::function, lambda capturing 5 pointers", Standard(big_lambda));
+    TEST_ASSERT(measure_copy("Inplace_Function, lambda capturing by value", Inplace(by_value_lambda)) == 0U);
+
+    measure_call("Inplace_Function, bound member method", Inplace(bound_member));
+    measure_call("std::function, bound member method", Standard(bound_member));
+    measure_call("Inplace_Function, lambda capturing 4 pointers", Inplace(small_lambda));
+    measure_call("std::function, lambda capturing 4 pointers", Standard(small_lambda));
+    measure_call("Inplace_Function, lambda capturing 5 pointers", Big_Inplace(big_lambda));
+    measure_call("std::function, lambda capturing 5 pointers", Standard(big_lambda));
+    TEST_ASSERT(counter.m_sum != 0U);
+    return EXIT_SUCCESS;
+}
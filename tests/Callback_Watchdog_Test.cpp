@@ -0,0 +1,60 @@
+// Local includes.
+#include "Callback_Watchdog.h"
+#include "Test.h"
+
+// Library includes.
+#include <time.h>
+
+
+// Timeout the watchdog is started with, long enough that the first update() directly after starting it never reaches the timeout
+uint64_t constexpr TIMEOUT_MICROSECONDS = 50000U;
+
+static size_t timeouts = 0U;
+
+/// @brief Blocks for the given amount of microseconds
+/// @param microseconds Time that should be waited
+void sleep_microseconds(uint64_t const & microseconds) {
+    timespec const duration = {static_cast<time_t>(microseconds / 1000000U), static_cast<long>((microseconds % 1000000U) * 1000U)};
+    (void)nanosleep(&duration, nullptr);
+}
+
+int main() {
+    static_assert(THINGSBOARD_USE_POSIX_TIMER, "Test expects the POSIX timer to be used on the host");
+    Callback_Watchdog watchdog([]() { timeouts++; });
+
+    // Never fires before the timeout has passed
+    watchdog.once(TIMEOUT_MICROSECONDS);
+    watchdog.update();
+    TEST_ASSERT(timeouts == 0U);
+
+    // Fires exactly once after the timeout has passed, even if update() is called multiple times
+    sleep_microseconds(TIMEOUT_MICROSECONDS * 2U);
+    watchdog.update();
+    TEST_ASSERT(timeouts == 1U);
+    watchdog.update();
+    TEST_ASSERT(timeouts == 1U);
+
+    // Never fires after it has been detached
+    watchdog.once(TIMEOUT_MICROSECONDS);
+    watchdog.detach();
+    sleep_microseconds(TIMEOUT_MICROSECONDS * 2U);
+    watchdog.update();
+    TEST_ASSERT(timeouts == 1U);
+
+    // Can be restarted after it fired and restarting an already started timer, moves the timeout into the future
+    watchdog.once(TIMEOUT_MICROSECONDS);
+    sleep_microseconds(TIMEOUT_MICROSECONDS / 2U);
+    watchdog.once(TIMEOUT_MICROSECONDS * 4U);
+    sleep_microseconds(TIMEOUT_MICROSECONDS);
+    watchdog.update();
+    TEST_ASSERT(timeouts == 1U);
+    sleep_microseconds(TIMEOUT_MICROSECONDS * 4U);
+    watchdog.update();
+    TEST_ASSERT(timeouts == 2U);
+
+    // Watchdog without a callback does not crash once the timeout passes
+    Callback_Watchdog empty_watchdog;
+    empty_watchdog.once(0U);
+    empty_watchdog.update();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,132 @@
+// Local includes.
+#include "Ed25519_Firmware_Verifier.h"
+#include "Helper.h"
+#include "IUpdater.h"
+#include "NullLogger.h"
+#include "OTA_Handler.h"
+#include "Test.h"
+
+// Library includes.
+#include <string.h>
+
+
+// Firmware image the tests sign and update with, consists of the bytes 0 to 199
+size_t constexpr FIRMWARE_SIZE = 200U;
+// Byte that is changed in the manipulated firmware image
+size_t constexpr MANIPULATED_BYTE = 100U;
+// Test key pair created with openssl genpkey -algorithm ed25519, only the public key is needed to verify
+char constexpr FIRMWARE_PUBLIC_KEY[] = "4f9c0b6a9edf59bb2b60de56faeb2c48e9a3df6b036103b0bf7737af5ecc47ea";
+// openssl pkeyutl -sign -rawin over the firmware image with the private key of the test key pair
+char constexpr FIRMWARE_SIGNATURE[] = "ebc35dc999fb03261cac09a779fe197e1b36fbc66d1d8f64a8ddd62ec7cb052a9b9d1ac5c4fd2636e11d38589cf49d06d586f531159fdd41d6ca936a1ece350e";
+// SHA-256 checksum of the firmware image and of the manipulated firmware image
+char constexpr FIRMWARE_CHECKSUM[] = "1901da1c9f699b48f6b2636e65cbf73abf99d0441ef67f5c540a42f7051dec6f";
+char constexpr MANIPULATED_FIRMWARE_CHECKSUM[] = "13fad74beb446df356e8a0523b8c12d446170ee135f0e8600fab377a8d14675a";
+
+/// @brief IUpdater implementation that only records which methods were called, instead of writing the firmware anywhere
+class Recording_Updater : public IUpdater {
+  public:
+    bool begin(size_t const & firmware_size) override {
+        return true;
+    }
+
+    size_t write(uint8_t * payload, size_t const & total_bytes) override {
+        m_written_bytes += total_bytes;
+        return total_bytes;
+    }
+
+    void reset() override {
+        m_written_bytes = 0U;
+    }
+
+    bool end() override {
+        m_ended = true;
+        return true;
+    }
+
+    size_t m_written_bytes = {};
+    bool   m_ended = {};
+};
+
+static size_t finished_updates = 0U;
+static bool update_result = false;
+
+/// @brief Verifies the given signature of the given message with the given public key, the message is passed to the verifier in a single update
+/// @param public_key Hex representation of the public key
+/// @param message Message the signature was created over
+/// @param message_length Amount of bytes in the given message
+/// @param signature Hex representation of the signature
+/// @return Whether the verifier accepted the signature
+bool verify_message(char const * public_key, uint8_t const * message, size_t const & message_length, char const * signature) {
+    uint8_t public_key_bytes[ED25519_PUBLIC_KEY_SIZE] = {};
+    TEST_ASSERT(Helper::parseHexString(public_key, public_key_bytes, ED25519_PUBLIC_KEY_SIZE));
+    Ed25519_Firmware_Verifier verifier(public_key_bytes);
+    return verifier.set_signature(signature) && verifier.begin(message_length) && verifier.update(message, message_length) && verifier.verify();
+}
+
+/// @brief Runs a complete firmware update with the given firmware image, received as a single chunk, which is verified with the signature of the original firmware image
+/// @param firmware Firmware image that is received, contains FIRMWARE_SIZE bytes
+/// @param checksum Hex representation of the SHA-256 checksum sent by the server for the received firmware image
+/// @param updater Updater the received firmware image is written into
+/// @return Whether the firmware update was successful
+bool run_update(uint8_t * firmware, char const * checksum, Recording_Updater & updater) {
+    uint8_t public_key[ED25519_PUBLIC_KEY_SIZE] = {};
+    TEST_ASSERT(Helper::parseHexString(FIRMWARE_PUBLIC_KEY, public_key, ED25519_PUBLIC_KEY_SIZE));
+    Ed25519_Firmware_Verifier verifier(public_key);
+    TEST_ASSERT(verifier.set_signature(FIRMWARE_SIGNATURE));
+    OTA_Update_Callback callback("title", "1.0.0", &updater, [](bool const & success) { finished_updates++; update_result = success; }, nullptr, nullptr, 0U);
+    callback.Set_Verifier(&verifier);
+    OTA_Handler<NullLogger> handler([](size_t const &, size_t const &, uint16_t const &) { return true; }, [](char const * const, char const * const) { return true; }, []() { return true; }, [](uint16_t const &) { return true; });
+
+    uint8_t checksum_bytes[MBEDTLS_MD_MAX_SIZE] = {};
+    TEST_ASSERT(Helper::parseHexString(checksum, checksum_bytes, HashGenerator::mbedtls_type_to_size(mbedtls_md_type_t::MBEDTLS_MD_SHA256)));
+    size_t const previous_updates = finished_updates;
+    handler.Start_Firmware_Update(callback, FIRMWARE_SIZE, checksum_bytes, mbedtls_md_type_t::MBEDTLS_MD_SHA256);
+    handler.Process_Firmware_Packet(0U, firmware, FIRMWARE_SIZE);
+    TEST_ASSERT(finished_updates == previous_updates + 1U);
+    return update_result;
+}
+
+int main() {
+    // RFC 8032 section 7.1 test 1 and test 2
+    TEST_ASSERT(verify_message("d75a980182b10ab7d54bfed3c964073a0ee172f3daa62325af021a68f707511a", nullptr, 0U, "e5564300c360ac729086e2cc806e828a84877f1eb8e5d974d873e065224901555fb8821590a33bacc61e39701cf9b46bd25bf5f0595bbe24655141438e7a100b"));
+    uint8_t const test_2_message[] = {0x72U};
+    TEST_ASSERT(verify_message("3d4017c3e843895a92b70aa74d1b7ebc9c982ccf2ec4968cc0cd55f12af4660c", test_2_message, sizeof(test_2_message), "92a009a9f0d4cab8720e820b5f642540a2b27b5416503f8fb3762223ebdb69da085ac1e43e15996e458f3613d0f11d8c387b2eaeb4302aeeb00d291612bb0c00"));
+
+    uint8_t firmware[FIRMWARE_SIZE] = {};
+    for (size_t i = 0U; i < FIRMWARE_SIZE; i++) {
+        firmware[i] = static_cast<uint8_t>(i);
+    }
+
+    // Signatures over another message, with another key or with a changed point R are rejected
+    TEST_ASSERT(verify_message(FIRMWARE_PUBLIC_KEY, firmware, FIRMWARE_SIZE, FIRMWARE_SIGNATURE));
+    TEST_ASSERT(!verify_message(FIRMWARE_PUBLIC_KEY, firmware, FIRMWARE_SIZE - 1U, FIRMWARE_SIGNATURE));
+    TEST_ASSERT(!verify_message("3d4017c3e843895a92b70aa74d1b7ebc9c982ccf2ec4968cc0cd55f12af4660c", firmware, FIRMWARE_SIZE, FIRMWARE_SIGNATURE));
+    char changed_signature[sizeof(FIRMWARE_SIGNATURE)] = {};
+    (void)memcpy(changed_signature, FIRMWARE_SIGNATURE, sizeof(FIRMWARE_SIGNATURE));
+    changed_signature[0U] = 'f';
+    TEST_ASSERT(!verify_message(FIRMWARE_PUBLIC_KEY, firmware, FIRMWARE_SIZE, changed_signature));
+
+    // Missing, truncated or malformed signatures, as well as signatures whose scalar S is not smaller than the group order, are rejected before the update is started
+    uint8_t public_key[ED25519_PUBLIC_KEY_SIZE] = {};
+    TEST_ASSERT(Helper::parseHexString(FIRMWARE_PUBLIC_KEY, public_key, ED25519_PUBLIC_KEY_SIZE));
+    Ed25519_Firmware_Verifier verifier(public_key);
+    TEST_ASSERT(!verifier.set_signature(nullptr));
+    TEST_ASSERT(!verifier.set_signature("ebc35dc999fb03261cac09a779fe197e"));
+    TEST_ASSERT(!verifier.set_signature("zzc35dc999fb03261cac09a779fe197e1b36fbc66d1d8f64a8ddd62ec7cb052a9b9d1ac5c4fd2636e11d38589cf49d06d586f531159fdd41d6ca936a1ece350e"));
+    TEST_ASSERT(!verifier.set_signature("ebc35dc999fb03261cac09a779fe197e1b36fbc66d1d8f64a8ddd62ec7cb052aedd3f55c1a631258d69cf7a2def9de1400000000000000000000000000000010"));
+    TEST_ASSERT(verifier.begin(0U));
+    TEST_ASSERT(!verifier.verify());
+
+    // Original firmware image is accepted and the update is finished
+    Recording_Updater updater;
+    TEST_ASSERT(run_update(firmware, FIRMWARE_CHECKSUM, updater));
+    TEST_ASSERT(updater.m_written_bytes == FIRMWARE_SIZE);
+    TEST_ASSERT(updater.m_ended);
+
+    // Manipulated firmware image is rejected even though the server sent the matching checksum, because the signature does not match anymore
+    firmware[MANIPULATED_BYTE] ^= 0x01U;
+    Recording_Updater manipulated_updater;
+    TEST_ASSERT(!run_update(firmware, MANIPULATED_FIRMWARE_CHECKSUM, manipulated_updater));
+    TEST_ASSERT(!manipulated_updater.m_ended);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,55 @@
+// Local includes.
+#include "Ed25519_Firmware_Verifier.h"
+#include "HMAC_Firmware_Verifier.h"
+#include "Helper.h"
+#include "Test.h"
+
+// Library includes.
+#include <chrono>
+#include <string.h>
+
+
+// Firmware image the verifiers are updated with, consists of the bytes 0 to 199
+size_t constexpr FIRMWARE_SIZE = 200U;
+// Amount of times each verification is run, verify() of the Ed25519_Firmware_Verifier takes milliseconds, so a few iterations are enough to get a stable result
+size_t constexpr ITERATIONS = 20U;
+char constexpr FIRMWARE_KEY[] = "secret firmware signing key";
+// Same test key pair and signatures of the firmware image, as used by the verifier tests
+char constexpr FIRMWARE_PUBLIC_KEY[] = "4f9c0b6a9edf59bb2b60de56faeb2c48e9a3df6b036103b0bf7737af5ecc47ea";
+char constexpr FIRMWARE_ED25519_SIGNATURE[] = "ebc35dc999fb03261cac09a779fe197e1b36fbc66d1d8f64a8ddd62ec7cb052a9b9d1ac5c4fd2636e11d38589cf49d06d586f531159fdd41d6ca936a1ece350e";
+char constexpr FIRMWARE_HMAC_SIGNATURE[] = "4f154a2e4fe746fab02766185d367884f671439416399f16ea51adc78ff16836";
+
+/// @brief Passes the firmware image to the given verifier and measures only the time the final verify() call needs,
+/// which is the latency added to the end of the update, because the firmware binary itself is already hashed alongside the download
+/// @param name Description of the measured verifier
+/// @param verifier Verifier the firmware image is verified with, needs to have the matching signature set already
+/// @param firmware Firmware image that is verified, contains FIRMWARE_SIZE bytes
+void measure_verify(char const * name, IFirmware_Verifier & verifier, uint8_t const * firmware) {
+    std::chrono::duration<double, std::micro> elapsed = {};
+    for (size_t i = 0U; i < ITERATIONS; i++) {
+        TEST_ASSERT(verifier.begin(FIRMWARE_SIZE));
+        TEST_ASSERT(verifier.update(firmware, FIRMWARE_SIZE));
+        auto const start = std::chrono::steady_clock::now();
+        TEST_ASSERT(verifier.verify());
+        elapsed += std::chrono::steady_clock::now() - start;
+    }
+    printf("%-32s verify: %10.2f us\n", name, elapsed.count() / ITERATIONS);
+}
+
+int main() {
+    uint8_t firmware[FIRMWARE_SIZE] = {};
+    for (size_t i = 0U; i < FIRMWARE_SIZE; i++) {
+        firmware[i] = static_cast<uint8_t>(i);
+    }
+
+    HMAC_Firmware_Verifier hmac_verifier(reinterpret_cast<uint8_t const *>(FIRMWARE_KEY), strlen(FIRMWARE_KEY));
+    TEST_ASSERT(hmac_verifier.set_signature(FIRMWARE_HMAC_SIGNATURE));
+    measure_verify("HMAC_Firmware_Verifier", hmac_verifier, firmware);
+
+    uint8_t public_key[ED25519_PUBLIC_KEY_SIZE] = {};
+    TEST_ASSERT(Helper::parseHexString(FIRMWARE_PUBLIC_KEY, public_key, ED25519_PUBLIC_KEY_SIZE));
+    Ed25519_Firmware_Verifier ed25519_verifier(public_key);
+    TEST_ASSERT(ed25519_verifier.set_signature(FIRMWARE_ED25519_SIGNATURE));
+    measure_verify("Ed25519_Firmware_Verifier", ed25519_verifier, firmware);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,126 @@
+// Local includes.
+#include "HMAC_Firmware_Verifier.h"
+#include "Helper.h"
+#include "IUpdater.h"
+#include "NullLogger.h"
+#include "OTA_Handler.h"
+#include "Test.h"
+
+// Library includes.
+#include <string.h>
+
+
+// Firmware image the tests sign and update with, consists of the bytes 0 to 199
+size_t constexpr FIRMWARE_SIZE = 200U;
+// Byte that is changed in the manipulated firmware image
+size_t constexpr MANIPULATED_BYTE = 100U;
+char constexpr FIRMWARE_KEY[] = "secret firmware signing key";
+// openssl dgst -sha256 -hmac "secret firmware signing key" over the firmware image
+char constexpr FIRMWARE_SIGNATURE[] = "4f154a2e4fe746fab02766185d367884f671439416399f16ea51adc78ff16836";
+// SHA-256 checksum of the firmware image and of the manipulated firmware image
+char constexpr FIRMWARE_CHECKSUM[] = "1901da1c9f699b48f6b2636e65cbf73abf99d0441ef67f5c540a42f7051dec6f";
+char constexpr MANIPULATED_FIRMWARE_CHECKSUM[] = "13fad74beb446df356e8a0523b8c12d446170ee135f0e8600fab377a8d14675a";
+
+/// @brief IUpdater implementation that only records which methods were called, instead of writing the firmware anywhere
+class Recording_Updater : public IUpdater {
+  public:
+    bool begin(size_t const & firmware_size) override {
+        return true;
+    }
+
+    size_t write(uint8_t * payload, size_t const & total_bytes) override {
+        m_written_bytes += total_bytes;
+        return total_bytes;
+    }
+
+    void reset() override {
+        m_written_bytes = 0U;
+    }
+
+    bool end() override {
+        m_ended = true;
+        return true;
+    }
+
+    size_t m_written_bytes = {};
+    bool   m_ended = {};
+};
+
+static size_t finished_updates = 0U;
+static bool update_result = false;
+
+/// @brief Calculates the code of the given message with the given key and compares it to the expected code from RFC 2202 or RFC 4231
+/// @param type Hash algorithm the code is calculated with
+/// @param key Secret key the code is calculated with
+/// @param key_length Amount of bytes in the given key
+/// @param message Message the code is calculated over, passed to the verifier in a single update
+/// @param expected_code Hex representation of the expected code
+/// @return Whether the verifier accepted the expected code
+bool verify_message(mbedtls_md_type_t const & type, uint8_t const * key, size_t const & key_length, char const * message, char const * expected_code) {
+    HMAC_Firmware_Verifier verifier(key, key_length, type);
+    size_t const message_length = strlen(message);
+    return verifier.set_signature(expected_code) && verifier.begin(message_length) && verifier.update(reinterpret_cast<uint8_t const *>(message), message_length) && verifier.verify();
+}
+
+/// @brief Runs a complete firmware update with the given firmware image, received as a single chunk, which is verified with the HMAC of the original firmware image
+/// @param firmware Firmware image that is received, contains FIRMWARE_SIZE bytes
+/// @param checksum Hex representation of the SHA-256 checksum sent by the server for the received firmware image
+/// @param updater Updater the received firmware image is written into
+/// @return Whether the firmware update was successful
+bool run_update(uint8_t * firmware, char const * checksum, Recording_Updater & updater) {
+    HMAC_Firmware_Verifier verifier(reinterpret_cast<uint8_t const *>(FIRMWARE_KEY), strlen(FIRMWARE_KEY));
+    TEST_ASSERT(verifier.set_signature(FIRMWARE_SIGNATURE));
+    OTA_Update_Callback callback("title", "1.0.0", &updater, [](bool const & success) { finished_updates++; update_result = success; }, nullptr, nullptr, 0U);
+    callback.Set_Verifier(&verifier);
+    OTA_Handler<NullLogger> handler([](size_t const &, size_t const &, uint16_t const &) { return true; }, [](char const * const, char const * const) { return true; }, []() { return true; }, [](uint16_t const &) { return true; });
+
+    uint8_t checksum_bytes[MBEDTLS_MD_MAX_SIZE] = {};
+    TEST_ASSERT(Helper::parseHexString(checksum, checksum_bytes, HashGenerator::mbedtls_type_to_size(mbedtls_md_type_t::MBEDTLS_MD_SHA256)));
+    size_t const previous_updates = finished_updates;
+    handler.Start_Firmware_Update(callback, FIRMWARE_SIZE, checksum_bytes, mbedtls_md_type_t::MBEDTLS_MD_SHA256);
+    handler.Process_Firmware_Packet(0U, firmware, FIRMWARE_SIZE);
+    TEST_ASSERT(finished_updates == previous_updates + 1U);
+    return update_result;
+}
+
+int main() {
+    uint8_t const jefe[] = {'J', 'e', 'f', 'e'};
+    char const jefe_message[] = "what do ya want for nothing?";
+    // RFC 2202 test case 2 and RFC 4231 test case 2
+    TEST_ASSERT(verify_message(mbedtls_md_type_t::MBEDTLS_MD_MD5, jefe, sizeof(jefe), jefe_message, "750c783e6ab0b503eaa86e310a5db738"));
+    TEST_ASSERT(verify_message(mbedtls_md_type_t::MBEDTLS_MD_SHA256, jefe, sizeof(jefe), jefe_message, "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843"));
+    TEST_ASSERT(verify_message(mbedtls_md_type_t::MBEDTLS_MD_SHA384, jefe, sizeof(jefe), jefe_message, "af45d2e376484031617f78d2b58a6b1b9c7ef464f5a01b47e42ec3736322445e8e2240ca5e69e2c78b3239ecfab21649"));
+    TEST_ASSERT(verify_message(mbedtls_md_type_t::MBEDTLS_MD_SHA512, jefe, sizeof(jefe), jefe_message, "164b7a7bfcf819e2e395fbe73b56e0a387bd64222e831fd610270cd7ea2505549758bf75c05a994a6d034f65f8f0e6fdcaeab1a34d4a6b4b636e070a38bce737"));
+    // RFC 4231 test case 6, keys bigger than the block size are hashed first
+    uint8_t long_key[131U] = {};
+    (void)memset(long_key, 0xAA, sizeof(long_key));
+    TEST_ASSERT(verify_message(mbedtls_md_type_t::MBEDTLS_MD_SHA256, long_key, sizeof(long_key), "Test Using Larger Than Block-Size Key - Hash Key First", "60e431591ee0b67f0d8a26aacbf5b77f8e0bc6213728c5140546040f0ee37f54"));
+
+    // Wrong codes, wrong keys, as well as missing, truncated or malformed signatures are rejected
+    TEST_ASSERT(!verify_message(mbedtls_md_type_t::MBEDTLS_MD_SHA256, jefe, sizeof(jefe), jefe_message, "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3844"));
+    TEST_ASSERT(!verify_message(mbedtls_md_type_t::MBEDTLS_MD_SHA256, jefe, sizeof(jefe) - 1U, jefe_message, "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843"));
+    HMAC_Firmware_Verifier verifier(jefe, sizeof(jefe));
+    TEST_ASSERT(!verifier.set_signature(nullptr));
+    TEST_ASSERT(!verifier.set_signature("5bdcc146bf60754e"));
+    TEST_ASSERT(!verifier.set_signature("zzdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843"));
+    TEST_ASSERT(verifier.begin(0U));
+    TEST_ASSERT(!verifier.verify());
+
+    uint8_t firmware[FIRMWARE_SIZE] = {};
+    for (size_t i = 0U; i < FIRMWARE_SIZE; i++) {
+        firmware[i] = static_cast<uint8_t>(i);
+    }
+
+    // Original firmware image is accepted and the update is finished
+    Recording_Updater updater;
+    TEST_ASSERT(run_update(firmware, FIRMWARE_CHECKSUM, updater));
+    TEST_ASSERT(updater.m_written_bytes == FIRMWARE_SIZE);
+    TEST_ASSERT(updater.m_ended);
+
+    // Manipulated firmware image is rejected even though the server sent the matching checksum, because the signature does not match anymore
+    firmware[MANIPULATED_BYTE] ^= 0x01U;
+    Recording_Updater manipulated_updater;
+    TEST_ASSERT(!run_update(firmware, MANIPULATED_FIRMWARE_CHECKSUM, manipulated_updater));
+    TEST_ASSERT(!manipulated_updater.m_ended);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,87 @@
+// Local includes.
+#include "HashGenerator.h"
+#include "Test.h"
+
+// Library includes.
+#include <string.h>
+
+
+/// @brief Known answer of a hash type for a given message, taken from the test vectors of RFC 1321 and FIPS 180-2
+struct Test_Vector {
+    mbedtls_md_type_t type;
+    char const        *message;
+    size_t            repetitions;
+    char const        *expected;
+};
+
+char constexpr TWO_BLOCK_MESSAGE[] = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+char constexpr LONG_TWO_BLOCK_MESSAGE[] = "abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmnhijklmnoijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu";
+// Chunk sizes the message is passed to update() with, to test partially filled blocks, complete blocks and data spanning multiple blocks
+size_t constexpr CHUNK_SIZES[] = {1U, 3U, 63U, 64U, 127U, 128U, 1000U, 1000000U};
+
+Test_Vector constexpr TEST_VECTORS[] = {
+    {MBEDTLS_MD_MD5, "", 1U, "d41d8cd98f00b204e9800998ecf8427e"},
+    {MBEDTLS_MD_MD5, "abc", 1U, "900150983cd24fb0d6963f7d28e17f72"},
+    {MBEDTLS_MD_MD5, TWO_BLOCK_MESSAGE, 1U, "8215ef0796a20bcaaae116d3876c664a"},
+    {MBEDTLS_MD_MD5, "a", 1000000U, "7707d6ae4e027c70eea2a935c2296f21"},
+    {MBEDTLS_MD_SHA256, "", 1U, "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855"},
+    {MBEDTLS_MD_SHA256, "abc", 1U, "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"},
+    {MBEDTLS_MD_SHA256, TWO_BLOCK_MESSAGE, 1U, "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1"},
+    {MBEDTLS_MD_SHA256, "a", 1000000U, "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0"},
+    {MBEDTLS_MD_SHA384, "", 1U, "38b060a751ac96384cd9327eb1b1e36a21fdb71114be07434c0cc7bf63f6e1da274edebfe76f65fbd51ad2f14898b95b"},
+    {MBEDTLS_MD_SHA384, "abc", 1U, "cb00753f45a35e8bb5a03d699ac65007272c32ab0eded1631a8b605a43ff5bed8086072ba1e7cc2358baeca134c825a7"},
+    {MBEDTLS_MD_SHA384, LONG_TWO_BLOCK_MESSAGE, 1U, "09330c33f71147e83d192fc782cd1b4753111b173b3b05d22fa08086e3b0f712fcc7c71a557e2db966c3e9fa91746039"},
+    {MBEDTLS_MD_SHA384, "a", 1000000U, "9d0e1809716474cb086e834e310a4a1ced149e9c00f248527972cec5704c2a5b07b8b3dc38ecc4ebae97ddd87f3d8985"},
+    {MBEDTLS_MD_SHA512, "", 1U, "cf83e1357eefb8bdf1542850d66d8007d620e4050b5715dc83f4a921d36ce9ce47d0d13c5d85f2b0ff8318d2877eec2f63b931bd47417a81a538327af927da3e"},
+    {MBEDTLS_MD_SHA512, "abc", 1U, "ddaf35a193617abacc417349ae20413112e6fa4e89a97ea20a9eeee64b55d39a2192992a274fc1a836ba3c23a3feebbd454d4423643ce80e2a9ac94fa54ca49f"},
+    {MBEDTLS_MD_SHA512, LONG_TWO_BLOCK_MESSAGE, 1U, "8e959b75dae313da8cf4f72814fc143f8f7779c6eb9f7fa17299aeadb6889018501d289e4900f7e4331b99dec4b5433ac7d329eeb6dd26545e96e55b874be909"},
+    {MBEDTLS_MD_SHA512, "a", 1000000U, "e718483d0ce769644e2e42c7bc15b4638e1f98b13b2044285632a803afa973ebde0ff244877ea60a4cb0432ce577c31beb009c5c2c49aa2e4eadb217ad8cc09b"},
+};
+
+
+/// @brief Hashes the given test vector, passing the message to update() in chunks of the given size and compares the result with the known answer
+/// @param vector Test vector that should be hashed
+/// @param message Complete message the test vector consists of
+/// @param length Amount of bytes in the complete message
+/// @param chunk_size Maximum amount of bytes passed to each call to update()
+void check_vector(Test_Vector const & vector, uint8_t const * message, size_t const & length, size_t const & chunk_size) {
+    HashGenerator hash;
+    TEST_ASSERT(hash.start(vector.type));
+    for (size_t offset = 0U; offset < length; offset += chunk_size) {
+        size_t const remaining = length - offset;
+        TEST_ASSERT(hash.update(message + offset, remaining < chunk_size ? remaining : chunk_size));
+    }
+    uint8_t result[MBEDTLS_MD_MAX_SIZE] = {};
+    TEST_ASSERT(hash.finish(result));
+    TEST_ASSERT(hash.get_size() == strlen(vector.expected) / 2U);
+
+    char hex[(MBEDTLS_MD_MAX_SIZE * 2U) + 1U] = {};
+    for (size_t i = 0U; i < hash.get_size(); i++) {
+        (void)snprintf(hex + (i * 2U), 3U, "%02x", result[i]);
+    }
+    if (strcmp(hex, vector.expected) != 0) {
+        fprintf(stderr, "Hash type (%u) of (%u) bytes in chunks of (%u) was (%s) instead of (%s)\n", vector.type, static_cast<unsigned>(length), static_cast<unsigned>(chunk_size), hex, vector.expected);
+    }
+    TEST_ASSERT(strcmp(hex, vector.expected) == 0);
+}
+
+int main() {
+    static uint8_t message[1000000U] = {};
+    for (auto const & vector : TEST_VECTORS) {
+        size_t const message_length = strlen(vector.message);
+        size_t const length = message_length * vector.repetitions;
+        TEST_ASSERT(length <= sizeof(message));
+        for (size_t i = 0U; i < vector.repetitions; i++) {
+            (void)memcpy(message + (i * message_length), vector.message, message_length);
+        }
+        for (auto const & chunk_size : CHUNK_SIZES) {
+            check_vector(vector, message, length, chunk_size);
+        }
+    }
+
+    // Unsupported types can not be started and the generator can be reused for another hash after it has been finished
+    HashGenerator hash;
+    TEST_ASSERT(!hash.start(MBEDTLS_MD_NONE));
+    TEST_ASSERT(HashGenerator::mbedtls_type_to_size(MBEDTLS_MD_NONE) == 0U);
+    return EXIT_SUCCESS;
+}
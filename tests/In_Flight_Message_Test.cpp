@@ -0,0 +1,93 @@
+// Local includes.
+#include "Loopback_MQTT_Client.h"
+#include "NullLogger.h"
+#include "ThingsBoard.h"
+#include "Test.h"
+
+
+uint16_t constexpr BUFFER_SIZE = 256U;
+char constexpr TELEMETRY[] = "{\"temperature\":42}";
+
+/// @brief Loopback client that can acknowledge messages published with QoS level 1 or reconnect before publish() returns,
+/// the same way a client calling its callbacks from another task could, if that task is scheduled while the device is still publishing
+class Early_Acknowledgement_Client : public Loopback_MQTT_Client<8U, 8U, NullLogger> {
+  public:
+    void set_publish_acknowledged_callback(Callback<void, uint16_t>::function callback) override {
+        m_acknowledged_callback.Set_Callback(callback);
+        Loopback_MQTT_Client::set_publish_acknowledged_callback(callback);
+    }
+
+    void set_connect_callback(Callback<void>::function callback) override {
+        m_connect_callback.Set_Callback(callback);
+        Loopback_MQTT_Client::set_connect_callback(callback);
+    }
+
+    bool publish(char const * topic, uint8_t const * payload, size_t const & length, uint8_t qos, uint16_t & packet_id) override {
+        if (!Loopback_MQTT_Client::publish(topic, payload, length, qos, packet_id)) {
+            return false;
+        }
+        if (m_acknowledge_early && qos != 0U) {
+            m_acknowledged_callback.Call_Callback(packet_id);
+        }
+        if (m_reconnect_early) {
+            m_connect_callback.Call_Callback();
+        }
+        return true;
+    }
+
+    Callback<void, uint16_t> m_acknowledged_callback = {};
+    Callback<void>           m_connect_callback = {};
+    bool                     m_acknowledge_early = {};
+    bool                     m_reconnect_early = {};
+};
+
+static size_t acknowledged_messages = 0U;
+static size_t failed_messages = 0U;
+
+/// @brief Counts the result of every message published with QoS level 1
+/// @param packet_id Packet identifier of the message
+/// @param success Whether the message was acknowledged or lost
+void count_result(uint16_t const packet_id, bool const success) {
+    (success ? acknowledged_messages : failed_messages)++;
+}
+
+int main() {
+    Early_Acknowledgement_Client client;
+    ThingsBoardSized<Default_Response_Amount, Default_Endpoints_Amount, NullLogger> tb(client, BUFFER_SIZE, BUFFER_SIZE);
+    TEST_ASSERT(tb.setMaxInFlightMessages(2U));
+    TEST_ASSERT(tb.connect("localhost", "token"));
+
+    // Acknowledgements received before publish() returned the packet identifier complete the message as soon as the identifier is assigned, instead of keeping it in-flight forever
+    client.m_acknowledge_early = true;
+    for (size_t i = 0U; i < 4U; i++) {
+        TEST_ASSERT(tb.sendTelemetryString(TELEMETRY, 1U, count_result));
+        TEST_ASSERT(tb.getInFlightMessages() == 0U);
+    }
+    TEST_ASSERT(acknowledged_messages == 4U && failed_messages == 0U);
+
+    // The same acknowledgements arriving again through loop() are ignored, because their messages are not in-flight anymore
+    TEST_ASSERT(tb.loop());
+    TEST_ASSERT(acknowledged_messages == 4U && tb.getInFlightMessages() == 0U);
+
+    // Acknowledgements received in the regular order still complete the message, the window is checked while publishing
+    client.m_acknowledge_early = false;
+    TEST_ASSERT(tb.sendTelemetryString(TELEMETRY, 1U, count_result));
+    TEST_ASSERT(tb.sendTelemetryString(TELEMETRY, 1U, count_result));
+    TEST_ASSERT(tb.getInFlightMessages() == 2U);
+    TEST_ASSERT(!tb.sendTelemetryString(TELEMETRY, 1U, count_result));
+    TEST_ASSERT(tb.loop());
+    TEST_ASSERT(acknowledged_messages == 6U && tb.getInFlightMessages() == 0U);
+
+    // Reconnecting while the message is still being published fails it and does not leave the reserved slot behind
+    client.m_reconnect_early = true;
+    TEST_ASSERT(tb.sendTelemetryString(TELEMETRY, 1U, count_result));
+    TEST_ASSERT(failed_messages == 1U && tb.getInFlightMessages() == 0U);
+    client.m_reconnect_early = false;
+
+    // Publishing failures release the reserved slot again
+    client.disconnect();
+    TEST_ASSERT(!tb.sendTelemetryString(TELEMETRY, 1U, count_result));
+    TEST_ASSERT(tb.getInFlightMessages() == 0U);
+    TEST_ASSERT(acknowledged_messages == 6U && failed_messages == 1U);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,117 @@
+// Local includes.
+#include "Loopback_MQTT_Client.h"
+#include "NullLogger.h"
+#include "Test.h"
+
+// Library include.
+#include <string.h>
+
+
+uint16_t constexpr RECEIVE_BUFFER_SIZE = 64U;
+uint16_t constexpr SEND_BUFFER_SIZE = 1024U;
+size_t constexpr OVERSIZED_LENGTH = 1000U;
+size_t constexpr FIRMWARE_SIZE = 300U;
+char constexpr ATTRIBUTE_TOPIC[] = "v1/devices/me/attributes";
+char constexpr RPC_REQUEST_TOPIC[] = "v1/devices/me/rpc/request/1";
+char constexpr RPC_RESPONSE_TOPIC[] = "v1/devices/me/rpc/response/+";
+char constexpr FIRMWARE_RESPONSE_TOPIC[] = "v2/fw/response/+";
+char constexpr FIRMWARE_REQUEST_TOPIC[] = "v2/fw/request/1/chunk/0";
+char constexpr FIRMWARE_CHUNK_SIZE[] = "256";
+
+using Client = Loopback_MQTT_Client<4U, 4U, NullLogger>;
+
+static size_t received_messages = 0U;
+static size_t received_bytes = 0U;
+static size_t received_fragment_bytes = 0U;
+static uint16_t acknowledged_packet_id = 0U;
+static uint8_t firmware[FIRMWARE_SIZE] = {};
+
+/// @brief Creates a connected client, that counts every received message and fragment and checks that fragments contain the firmware binary
+/// @param client Client that should be configured and connected
+/// @param fragmented_receive Whether messages bigger than the receive buffer should be delivered in fragments
+void connect_client(Client & client, bool fragmented_receive) {
+    received_messages = 0U;
+    received_bytes = 0U;
+    received_fragment_bytes = 0U;
+    acknowledged_packet_id = 0U;
+    client.set_fragmented_receive(fragmented_receive);
+    client.set_data_callback([](char * topic, uint8_t * payload, unsigned int length) {
+        TEST_ASSERT(length <= RECEIVE_BUFFER_SIZE);
+        received_messages++;
+        received_bytes += length;
+    });
+    client.set_data_fragment_callback([](char * topic, uint8_t * payload, unsigned int length, unsigned int offset, unsigned int total_length) {
+        TEST_ASSERT(length <= RECEIVE_BUFFER_SIZE && offset == received_fragment_bytes && total_length == 256U);
+        TEST_ASSERT(memcmp(payload, firmware + offset, length) == 0);
+        received_fragment_bytes += length;
+    });
+    client.set_publish_acknowledged_callback([](uint16_t packet_id) { acknowledged_packet_id = packet_id; });
+    TEST_ASSERT(client.set_buffer_size(RECEIVE_BUFFER_SIZE, SEND_BUFFER_SIZE));
+    TEST_ASSERT(client.connect("client", "token", nullptr));
+}
+
+int main() {
+    for (size_t i = 0U; i < FIRMWARE_SIZE; i++) {
+        firmware[i] = static_cast<uint8_t>(i);
+    }
+    uint8_t oversized[OVERSIZED_LENGTH] = {};
+    (void)memset(oversized, 'a', sizeof(oversized));
+
+    for (bool const fragmented_receive : { false, true }) {
+        Client client;
+        connect_client(client, fragmented_receive);
+        char const * topics[3U] = { ATTRIBUTE_TOPIC, RPC_RESPONSE_TOPIC, FIRMWARE_RESPONSE_TOPIC };
+        TEST_ASSERT(client.subscribe(topics, 3U));
+
+        // Messages that fit into the receive buffer are delivered in the next loop() call
+        TEST_ASSERT(client.inject(ATTRIBUTE_TOPIC, reinterpret_cast<uint8_t const *>("{\"a\":1}"), 7U));
+        TEST_ASSERT(client.get_pending_count() == 1U);
+        TEST_ASSERT(client.loop());
+        TEST_ASSERT(received_messages == 1U && received_bytes == 7U);
+
+        // Injected messages bigger than the receive buffer are rejected, even if fragmented receive is enabled, because they would not fit into the payload memory of the message
+        TEST_ASSERT(!client.inject(ATTRIBUTE_TOPIC, oversized, sizeof(oversized)));
+        TEST_ASSERT(client.get_pending_count() == 0U);
+        TEST_ASSERT(client.get_dropped_count() == 1U);
+
+        // Echoing a client-side RPC request that is bigger than the receive buffer is dropped the same way
+        TEST_ASSERT(client.publish(RPC_REQUEST_TOPIC, oversized, sizeof(oversized)));
+        TEST_ASSERT(client.get_pending_count() == 0U);
+        TEST_ASSERT(client.get_dropped_count() == 2U);
+        TEST_ASSERT(client.publish(RPC_REQUEST_TOPIC, oversized, RECEIVE_BUFFER_SIZE));
+        TEST_ASSERT(client.loop());
+        TEST_ASSERT(received_messages == 2U && received_bytes == 7U + RECEIVE_BUFFER_SIZE);
+
+        // Firmware chunks bigger than the receive buffer are only delivered in fragments if that is enabled
+        client.set_firmware(firmware, sizeof(firmware));
+        TEST_ASSERT(client.publish(FIRMWARE_REQUEST_TOPIC, reinterpret_cast<uint8_t const *>(FIRMWARE_CHUNK_SIZE), strlen(FIRMWARE_CHUNK_SIZE)));
+        TEST_ASSERT(client.get_pending_count() == (fragmented_receive ? 1U : 0U));
+        TEST_ASSERT(client.loop());
+        TEST_ASSERT(received_fragment_bytes == (fragmented_receive ? 256U : 0U));
+
+        // Acknowledgements of messages published with QoS level 1 and injected messages are delayed by the configured latency
+        client.set_latency(2U);
+        uint16_t packet_id = 0U;
+        TEST_ASSERT(client.publish(ATTRIBUTE_TOPIC, oversized, 1U, 1U, packet_id));
+        TEST_ASSERT(packet_id != 0U);
+        TEST_ASSERT(client.loop() && client.loop());
+        TEST_ASSERT(acknowledged_packet_id != packet_id);
+        TEST_ASSERT(client.loop());
+        TEST_ASSERT(acknowledged_packet_id == packet_id);
+
+        // Messages on topics that are not subscribed are dropped once they are due
+        TEST_ASSERT(client.unsubscribe(ATTRIBUTE_TOPIC));
+        size_t const dropped = client.get_dropped_count();
+        TEST_ASSERT(client.inject(ATTRIBUTE_TOPIC, oversized, 1U));
+        TEST_ASSERT(client.loop() && client.loop() && client.loop());
+        TEST_ASSERT(client.get_dropped_count() == dropped + 1U);
+    }
+
+    // Connection attempts are refused if the credentials are rejected
+    Client client;
+    client.set_reject_credentials(true);
+    TEST_ASSERT(client.set_buffer_size(RECEIVE_BUFFER_SIZE, SEND_BUFFER_SIZE));
+    TEST_ASSERT(!client.connect("client", "token", nullptr));
+    TEST_ASSERT(client.authentication_rejected());
+    return EXIT_SUCCESS;
+}
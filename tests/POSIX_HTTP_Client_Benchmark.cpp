@@ -0,0 +1,92 @@
+// Local includes.
+#include "NullLogger.h"
+#include "POSIX_HTTP_Client.h"
+#include "Test.h"
+#include "Test_Server.h"
+
+// Library includes.
+#include <chrono>
+#include <string.h>
+#include <thread>
+
+
+char constexpr HOST[] = "127.0.0.1";
+char constexpr TELEMETRY_PATH[] = "/api/v1/token/telemetry";
+char constexpr CONTENT_TYPE[] = "application/json";
+char constexpr TELEMETRY_PAYLOAD[] = "{\"temperature\":25,\"humidity\":60}";
+char constexpr RESPONSE[] = "HTTP/1.1 200 OK\r\nContent-Length: 0\r\n\r\n";
+// Amount of requests sent over a single kept alive connection and with a new connection per request
+size_t constexpr KEEP_ALIVE_REQUESTS = 5000U;
+size_t constexpr RECONNECT_REQUESTS = 500U;
+
+/// @brief Receives the first request of the client byte by byte, to measure its size, every following request has the same size and can therefore be received at once
+/// @param server Server the client is connected to
+/// @return Size of the request, including its body
+size_t measure_request(Test_Server & server) {
+    char head[512U] = {};
+    size_t length = 0U;
+    while (length < 4U || memcmp(head + length - 4U, "\r\n\r\n", 4U) != 0) {
+        TEST_ASSERT(length + 1U < sizeof(head));
+        TEST_ASSERT(server.read_exact(reinterpret_cast<uint8_t *>(head + length), 1U));
+        length++;
+    }
+    uint8_t body[sizeof(TELEMETRY_PAYLOAD)] = {};
+    TEST_ASSERT(server.read_exact(body, strlen(TELEMETRY_PAYLOAD)));
+    return length + strlen(TELEMETRY_PAYLOAD);
+}
+
+/// @brief Server standing in for ThingsBoard, answers every request with an empty response, first over a single connection and then over a new connection per request
+/// @param server Server the client connects to
+void run_server(Test_Server & server) {
+    uint8_t request[1024U] = {};
+    server.accept_client();
+    size_t const request_size = measure_request(server);
+    TEST_ASSERT(request_size <= sizeof(request));
+    server.write_string(RESPONSE);
+    for (size_t i = 1U; i < KEEP_ALIVE_REQUESTS; i++) {
+        TEST_ASSERT(server.read_exact(request, request_size));
+        server.write_string(RESPONSE);
+    }
+    for (size_t i = 0U; i < RECONNECT_REQUESTS; i++) {
+        server.accept_client();
+        // Connection header changes from keep-alive to close, which is five characters shorter
+        TEST_ASSERT(server.read_exact(request, request_size - 5U));
+        server.write_string(RESPONSE);
+    }
+    server.close_client();
+}
+
+/// @brief Sends the given amount of telemetry posts and reads their responses
+/// @param client Client the requests are sent with
+/// @param requests Amount of requests that should be sent
+/// @param reconnect Whether the connection is closed after every response, the same way the server would close it if keep alive is disabled
+/// @return Amount of requests per second
+double post_telemetry(POSIX_HTTP_Client<NullLogger> & client, size_t const & requests, bool const & reconnect) {
+    client.set_keep_alive(!reconnect);
+    auto const start = std::chrono::steady_clock::now();
+    for (size_t i = 0U; i < requests; i++) {
+        TEST_ASSERT(client.post(TELEMETRY_PATH, CONTENT_TYPE, TELEMETRY_PAYLOAD) == POSIX_HTTP_SUCCESS);
+        TEST_ASSERT(client.get_response_status_code() == 200);
+        if (reconnect) {
+            client.stop();
+        }
+    }
+    std::chrono::duration<double> const elapsed = std::chrono::steady_clock::now() - start;
+    return requests / elapsed.count();
+}
+
+int main() {
+    Test_Server server;
+    std::thread server_thread(run_server, std::ref(server));
+
+    POSIX_HTTP_Client<NullLogger> client;
+    TEST_ASSERT(client.connect(HOST, server.port()) == POSIX_HTTP_SUCCESS);
+    double const keep_alive_rate = post_telemetry(client, KEEP_ALIVE_REQUESTS, false);
+    client.stop();
+    double const reconnect_rate = post_telemetry(client, RECONNECT_REQUESTS, true);
+    server_thread.join();
+
+    printf("Telemetry posts over a kept alive connection:   %10.0f requests/s (%u requests)\n", keep_alive_rate, static_cast<unsigned int>(KEEP_ALIVE_REQUESTS));
+    printf("Telemetry posts with a new connection each:     %10.0f requests/s (%u requests)\n", reconnect_rate, static_cast<unsigned int>(RECONNECT_REQUESTS));
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,149 @@
+// Local includes.
+#include "NullLogger.h"
+#include "POSIX_HTTP_Client.h"
+#include "Test.h"
+#include "Test_Server.h"
+
+// Library includes.
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+
+
+char constexpr HOST[] = "127.0.0.1";
+char constexpr TELEMETRY_PATH[] = "/api/v1/token/telemetry";
+char constexpr ATTRIBUTES_PATH[] = "/api/v1/token/attributes";
+char constexpr CONTENT_TYPE[] = "application/json";
+char constexpr TELEMETRY_PAYLOAD[] = "{\"temperature\":25}";
+// Timeout of the request the server does not answer, short to keep the test fast
+uint32_t constexpr SHORT_NETWORK_TIMEOUT_MILLISECONDS = 100U;
+
+/// @brief Received HTTP request, with the request line and headers kept as text and the body seperated from them
+struct Request {
+    char   head[512U];
+    char   body[256U];
+    size_t body_length;
+};
+
+/// @brief Receives the next complete request from the client, the body is read if the request contains a Content-Length header
+/// @param server Server the client is connected to
+/// @return Received request
+Request read_request(Test_Server & server) {
+    Request request = {};
+    size_t length = 0U;
+    while (length < 4U || memcmp(request.head + length - 4U, "\r\n\r\n", 4U) != 0) {
+        TEST_ASSERT(length + 1U < sizeof(request.head));
+        TEST_ASSERT(server.read_exact(reinterpret_cast<uint8_t *>(request.head + length), 1U));
+        length++;
+    }
+    char const * const content_length = strstr(request.head, "Content-Length: ");
+    if (content_length != nullptr) {
+        request.body_length = strtoul(content_length + strlen("Content-Length: "), nullptr, 10);
+        TEST_ASSERT(request.body_length < sizeof(request.body));
+        TEST_ASSERT(server.read_exact(reinterpret_cast<uint8_t *>(request.body), request.body_length));
+    }
+    return request;
+}
+
+/// @brief Checks that the given request starts with the given request line
+/// @param request Received request
+/// @param method Expected HTTP method
+/// @param path Expected URL path
+void expect_request_line(Request const & request, char const * method, char const * path) {
+    char expected[128U] = {};
+    (void)snprintf(expected, sizeof(expected), "%s %s HTTP/1.1\r\n", method, path);
+    TEST_ASSERT(strncmp(request.head, expected, strlen(expected)) == 0);
+}
+
+/// @brief Scripted server, answers each request with a different way of delimiting the response body
+/// @param server Server the client connects to
+void run_server(Test_Server & server) {
+    server.accept_client();
+
+    // Header and body are received as one request, the body delimited by its content length
+    Request request = read_request(server);
+    expect_request_line(request, "POST", TELEMETRY_PATH);
+    TEST_ASSERT(strstr(request.head, "Connection: keep-alive\r\n") != nullptr);
+    TEST_ASSERT(strstr(request.head, "Content-Type: application/json\r\n") != nullptr);
+    TEST_ASSERT(request.body_length == strlen(TELEMETRY_PAYLOAD) && memcmp(request.body, TELEMETRY_PAYLOAD, request.body_length) == 0);
+    server.write_string("HTTP/1.1 200 OK\r\nContent-Length: 5\r\n\r\nhello");
+
+    // The connection is kept alive, therefore the following request is received over the same connection, the response is chunked
+    request = read_request(server);
+    expect_request_line(request, "GET", ATTRIBUTES_PATH);
+    server.write_string("HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n4\r\nabcd\r\n3\r\nefg\r\n0\r\n\r\n");
+
+    // The body of this response is not read by the client, which has to discard it before sending the next request
+    request = read_request(server);
+    expect_request_line(request, "POST", TELEMETRY_PATH);
+    server.write_string("HTTP/1.1 200 OK\r\nContent-Length: 10\r\n\r\n0123456789");
+    request = read_request(server);
+    expect_request_line(request, "GET", ATTRIBUTES_PATH);
+    server.write_string("HTTP/1.1 204 No Content\r\n\r\n");
+
+    // Body is delimited by closing the connection, the client has to reconnect for the following request
+    request = read_request(server);
+    expect_request_line(request, "GET", ATTRIBUTES_PATH);
+    server.write_string("HTTP/1.1 200 OK\r\nConnection: close\r\n\r\nbye");
+    server.close_client();
+
+    // Request is not answered, so that the client runs into its timeout
+    server.accept_client();
+    request = read_request(server);
+    expect_request_line(request, "GET", ATTRIBUTES_PATH);
+    uint8_t closed = 0U;
+    TEST_ASSERT(!server.read_exact(&closed, 1U));
+}
+
+/// @brief Reads the remaining response body into a buffer that is smaller than the body, to ensure it is received in multiple calls
+/// @param client Client that received the response
+/// @param body Buffer the complete body is copied into, null terminated
+/// @param size Size of the buffer
+void read_body(POSIX_HTTP_Client<NullLogger> & client, char * body, size_t const & size) {
+    size_t length = 0U;
+    uint8_t part[2U] = {};
+    for (size_t received = client.read_response_body(part, sizeof(part)); received != 0U; received = client.read_response_body(part, sizeof(part))) {
+        TEST_ASSERT(length + received < size);
+        (void)memcpy(body + length, part, received);
+        length += received;
+    }
+    body[length] = '\0';
+}
+
+int main() {
+    Test_Server server;
+    std::thread server_thread(run_server, std::ref(server));
+
+    POSIX_HTTP_Client<NullLogger> client;
+    client.set_keep_alive(true);
+    TEST_ASSERT(client.connect(HOST, server.port()) == POSIX_HTTP_SUCCESS);
+
+    char body[64U] = {};
+    TEST_ASSERT(client.post(TELEMETRY_PATH, CONTENT_TYPE, TELEMETRY_PAYLOAD) == POSIX_HTTP_SUCCESS);
+    TEST_ASSERT(client.get_response_status_code() == 200);
+    read_body(client, body, sizeof(body));
+    TEST_ASSERT(strcmp(body, "hello") == 0);
+
+    TEST_ASSERT(client.get(ATTRIBUTES_PATH) == POSIX_HTTP_SUCCESS);
+    TEST_ASSERT(client.get_response_status_code() == 200);
+    TEST_ASSERT(client.get_response_body() == "abcdefg");
+
+    TEST_ASSERT(client.post(TELEMETRY_PATH, CONTENT_TYPE, TELEMETRY_PAYLOAD) == POSIX_HTTP_SUCCESS);
+    TEST_ASSERT(client.get_response_status_code() == 200);
+    TEST_ASSERT(client.get(ATTRIBUTES_PATH) == POSIX_HTTP_SUCCESS);
+    TEST_ASSERT(client.get_response_status_code() == 204);
+    read_body(client, body, sizeof(body));
+    TEST_ASSERT(body[0U] == '\0');
+
+    TEST_ASSERT(client.get(ATTRIBUTES_PATH) == POSIX_HTTP_SUCCESS);
+    TEST_ASSERT(client.get_response_status_code() == 200);
+    read_body(client, body, sizeof(body));
+    TEST_ASSERT(strcmp(body, "bye") == 0);
+
+    client.set_network_timeout(SHORT_NETWORK_TIMEOUT_MILLISECONDS);
+    TEST_ASSERT(client.get(ATTRIBUTES_PATH) == POSIX_HTTP_SUCCESS);
+    TEST_ASSERT(client.get_response_status_code() < 0);
+
+    server_thread.join();
+    return EXIT_SUCCESS;
+}
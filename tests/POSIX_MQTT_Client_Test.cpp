@@ -0,0 +1,240 @@
+// Local includes.
+#include "NullLogger.h"
+#include "POSIX_MQTT_Client.h"
+#include "Test.h"
+#include "Test_Server.h"
+
+// Library includes.
+#include <string.h>
+#include <thread>
+
+
+// Receive buffer is smaller than the big message sent by the broker, to ensure it is received in fragments
+uint16_t constexpr RECEIVE_BUFFER_SIZE = 64U;
+uint16_t constexpr SEND_BUFFER_SIZE = 256U;
+size_t constexpr BIG_PAYLOAD_SIZE = 200U;
+// Maximum time in milliseconds the client loops while waiting for the broker
+uint64_t constexpr LOOP_DEADLINE_MILLISECONDS = 5000U;
+char constexpr CLIENT_ID[] = "client";
+char constexpr USER_NAME[] = "token";
+char constexpr PASSWORD[] = "secret";
+char constexpr RPC_TOPIC[] = "v1/devices/me/rpc/request/+";
+char constexpr ATTRIBUTE_TOPIC[] = "v1/devices/me/attributes";
+char constexpr TELEMETRY_TOPIC[] = "v1/devices/me/telemetry";
+char constexpr TELEMETRY_PAYLOAD[] = "{\"temperature\":25}";
+char constexpr ATTRIBUTE_PAYLOAD[] = "{\"shared\":2}";
+
+/// @brief Received MQTT control packet, with its body being the remaining length of the packet after the fixed header
+struct Packet {
+    uint8_t header;
+    uint8_t body[512U];
+    size_t  length;
+};
+
+/// @brief Receives the next complete packet from the client
+/// @param server Server the client is connected to
+/// @return Received packet
+Packet read_packet(Test_Server & server) {
+    Packet packet = {};
+    TEST_ASSERT(server.read_exact(&packet.header, 1U));
+    size_t multiplier = 1U;
+    uint8_t encoded_byte = 0U;
+    do {
+        TEST_ASSERT(server.read_exact(&encoded_byte, 1U));
+        packet.length += (encoded_byte & 127U) * multiplier;
+        multiplier *= 128U;
+    } while ((encoded_byte & 128U) != 0U);
+    TEST_ASSERT(packet.length <= sizeof(packet.body));
+    TEST_ASSERT(server.read_exact(packet.body, packet.length));
+    return packet;
+}
+
+/// @brief Checks that the body of the given packet contains the given length prefixed string at the given position and moves the position behind it
+/// @param packet Received packet
+/// @param position Position of the length prefix in the body of the packet
+/// @param expected String the packet should contain
+void expect_string(Packet const & packet, size_t & position, char const * expected) {
+    size_t const length = strlen(expected);
+    TEST_ASSERT(position + 2U + length <= packet.length);
+    TEST_ASSERT(static_cast<size_t>((packet.body[position] << 8U) | packet.body[position + 1U]) == length);
+    TEST_ASSERT(memcmp(packet.body + position + 2U, expected, length) == 0);
+    position += 2U + length;
+}
+
+/// @brief Sends a PUBLISH packet with the given topic and payload to the client
+/// @param server Server the client is connected to
+/// @param qos QoS level the message is sent with, QoS level 1 additionally sends the packet identifier 0x1234
+/// @param topic Topic the message is sent on
+/// @param payload Payload of the message
+/// @param length Amount of bytes in the payload
+void write_publish(Test_Server & server, uint8_t qos, char const * topic, uint8_t const * payload, size_t length) {
+    size_t const topic_length = strlen(topic);
+    size_t const remaining_length = 2U + topic_length + (qos != 0U ? 2U : 0U) + length;
+    uint8_t header[POSIX_MQTT_MAX_HEADER_SIZE] = { static_cast<uint8_t>(0x30U | (qos << 1U)) };
+    size_t header_size = 1U;
+    size_t encoded_length = remaining_length;
+    do {
+        header[header_size] = static_cast<uint8_t>(encoded_length & 127U);
+        encoded_length >>= 7U;
+        if (encoded_length != 0U) {
+            header[header_size] |= 128U;
+        }
+        header_size++;
+    } while (encoded_length != 0U);
+    server.write_all(header, header_size);
+    uint8_t const topic_prefix[2U] = { static_cast<uint8_t>(topic_length >> 8U), static_cast<uint8_t>(topic_length) };
+    server.write_all(topic_prefix, sizeof(topic_prefix));
+    server.write_string(topic);
+    if (qos != 0U) {
+        uint8_t const packet_id[2U] = { 0x12U, 0x34U };
+        server.write_all(packet_id, sizeof(packet_id));
+    }
+    server.write_all(payload, length);
+}
+
+/// @brief Scripted broker, checks every packet sent by the client and responds the same way a MQTT 3.1.1 broker would
+/// @param server Server the client connects to
+void run_broker(Test_Server & server) {
+    server.accept_client();
+
+    // CONNECT with a clean session and the given credentials
+    Packet packet = read_packet(server);
+    TEST_ASSERT(packet.header == 0x10U);
+    size_t position = 0U;
+    expect_string(packet, position, "MQTT");
+    TEST_ASSERT(packet.body[position++] == 4U);
+    TEST_ASSERT(packet.body[position++] == 0xC2U);
+    TEST_ASSERT(((packet.body[position] << 8U) | packet.body[position + 1U]) == POSIX_MQTT_DEFAULT_KEEP_ALIVE_SECONDS);
+    position += 2U;
+    expect_string(packet, position, CLIENT_ID);
+    expect_string(packet, position, USER_NAME);
+    expect_string(packet, position, PASSWORD);
+    TEST_ASSERT(position == packet.length);
+    uint8_t const connack[4U] = { 0x20U, 2U, 0U, 0U };
+    server.write_all(connack, sizeof(connack));
+
+    // Both topics are subscribed with a single SUBSCRIBE packet
+    packet = read_packet(server);
+    TEST_ASSERT(packet.header == 0x82U);
+    position = 2U;
+    expect_string(packet, position, RPC_TOPIC);
+    TEST_ASSERT(packet.body[position++] == 0U);
+    expect_string(packet, position, ATTRIBUTE_TOPIC);
+    TEST_ASSERT(packet.body[position++] == 0U);
+    TEST_ASSERT(position == packet.length);
+    uint8_t const suback[6U] = { 0x90U, 4U, packet.body[0U], packet.body[1U], 0U, 0U };
+    server.write_all(suback, sizeof(suback));
+
+    // PUBLISH with QoS level 1 is acknowledged with the same packet identifier
+    packet = read_packet(server);
+    TEST_ASSERT(packet.header == 0x32U);
+    position = 0U;
+    expect_string(packet, position, TELEMETRY_TOPIC);
+    uint8_t const puback[4U] = { 0x40U, 2U, packet.body[position], packet.body[position + 1U] };
+    position += 2U;
+    TEST_ASSERT(packet.length - position == strlen(TELEMETRY_PAYLOAD));
+    TEST_ASSERT(memcmp(packet.body + position, TELEMETRY_PAYLOAD, strlen(TELEMETRY_PAYLOAD)) == 0);
+    server.write_all(puback, sizeof(puback));
+
+    // Message that fits into the receive buffer, followed by a message that is received in fragments and a message with QoS level 1 that has to be acknowledged by the client
+    write_publish(server, 0U, ATTRIBUTE_TOPIC, reinterpret_cast<uint8_t const *>(ATTRIBUTE_PAYLOAD), strlen(ATTRIBUTE_PAYLOAD));
+    uint8_t big_payload[BIG_PAYLOAD_SIZE] = {};
+    for (size_t i = 0U; i < BIG_PAYLOAD_SIZE; i++) {
+        big_payload[i] = static_cast<uint8_t>(i);
+    }
+    write_publish(server, 0U, ATTRIBUTE_TOPIC, big_payload, sizeof(big_payload));
+    write_publish(server, 1U, ATTRIBUTE_TOPIC, reinterpret_cast<uint8_t const *>(ATTRIBUTE_PAYLOAD), strlen(ATTRIBUTE_PAYLOAD));
+    packet = read_packet(server);
+    TEST_ASSERT(packet.header == 0x40U && packet.length == 2U && packet.body[0U] == 0x12U && packet.body[1U] == 0x34U);
+
+    packet = read_packet(server);
+    TEST_ASSERT(packet.header == 0xA2U);
+    position = 2U;
+    expect_string(packet, position, RPC_TOPIC);
+    TEST_ASSERT(position == packet.length);
+    uint8_t const unsuback[4U] = { 0xB0U, 2U, packet.body[0U], packet.body[1U] };
+    server.write_all(unsuback, sizeof(unsuback));
+
+    packet = read_packet(server);
+    TEST_ASSERT(packet.header == 0xE0U && packet.length == 0U);
+
+    // Second connection is refused because the credentials are not authorized
+    server.accept_client();
+    packet = read_packet(server);
+    TEST_ASSERT(packet.header == 0x10U);
+    uint8_t const connack_refused[4U] = { 0x20U, 2U, 0U, POSIX_MQTT_CONNACK_NOT_AUTHORIZED };
+    server.write_all(connack_refused, sizeof(connack_refused));
+}
+
+static uint16_t acknowledged_packet_id = 0U;
+static size_t received_messages = 0U;
+static uint8_t fragments[BIG_PAYLOAD_SIZE] = {};
+static size_t received_fragment_bytes = 0U;
+
+/// @brief Calls loop() on the given client until the given condition is fulfilled
+/// @param client Client that should receive the outstanding messages
+/// @param condition Condition that should be fulfilled
+/// @return Whether the condition was fulfilled before the deadline
+template <typename Condition>
+bool loop_until(POSIX_MQTT_Client<NullLogger> & client, Condition condition) {
+    timespec start = {};
+    (void)clock_gettime(CLOCK_MONOTONIC, &start);
+    while (!condition()) {
+        TEST_ASSERT(client.loop());
+        timespec now = {};
+        (void)clock_gettime(CLOCK_MONOTONIC, &now);
+        if (static_cast<uint64_t>(now.tv_sec - start.tv_sec) * 1000U > LOOP_DEADLINE_MILLISECONDS) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main() {
+    Test_Server server;
+    std::thread broker(run_broker, std::ref(server));
+
+    POSIX_MQTT_Client<NullLogger> client;
+    TEST_ASSERT(client.supports_fragmented_receive());
+    TEST_ASSERT(client.set_buffer_size(RECEIVE_BUFFER_SIZE, SEND_BUFFER_SIZE));
+    client.set_loop_timeout(10U);
+    client.set_publish_acknowledged_callback([](uint16_t packet_id) { acknowledged_packet_id = packet_id; });
+    client.set_data_callback([](char * topic, uint8_t * payload, unsigned int length) {
+        TEST_ASSERT(strcmp(topic, ATTRIBUTE_TOPIC) == 0);
+        TEST_ASSERT(length == strlen(ATTRIBUTE_PAYLOAD) && memcmp(payload, ATTRIBUTE_PAYLOAD, length) == 0);
+        received_messages++;
+    });
+    client.set_data_fragment_callback([](char * topic, uint8_t * payload, unsigned int length, unsigned int offset, unsigned int total_length) {
+        TEST_ASSERT(strcmp(topic, ATTRIBUTE_TOPIC) == 0);
+        TEST_ASSERT(total_length == BIG_PAYLOAD_SIZE && offset == received_fragment_bytes && offset + length <= total_length);
+        (void)memcpy(fragments + offset, payload, length);
+        received_fragment_bytes += length;
+    });
+    client.set_server("127.0.0.1", server.port());
+
+    TEST_ASSERT(client.connect(CLIENT_ID, USER_NAME, PASSWORD));
+    TEST_ASSERT(client.connected());
+    TEST_ASSERT(!client.authentication_rejected());
+
+    char const * topics[2U] = { RPC_TOPIC, ATTRIBUTE_TOPIC };
+    TEST_ASSERT(client.subscribe(topics, 2U));
+
+    uint16_t packet_id = 0U;
+    TEST_ASSERT(client.publish(TELEMETRY_TOPIC, reinterpret_cast<uint8_t const *>(TELEMETRY_PAYLOAD), strlen(TELEMETRY_PAYLOAD), 1U, packet_id));
+    TEST_ASSERT(packet_id != 0U);
+    TEST_ASSERT(loop_until(client, [packet_id]() { return acknowledged_packet_id == packet_id; }));
+
+    TEST_ASSERT(loop_until(client, []() { return received_messages == 2U && received_fragment_bytes == BIG_PAYLOAD_SIZE; }));
+    for (size_t i = 0U; i < BIG_PAYLOAD_SIZE; i++) {
+        TEST_ASSERT(fragments[i] == static_cast<uint8_t>(i));
+    }
+
+    TEST_ASSERT(client.unsubscribe(RPC_TOPIC));
+    client.disconnect();
+    TEST_ASSERT(!client.connected());
+
+    TEST_ASSERT(!client.connect(CLIENT_ID, USER_NAME, PASSWORD));
+    TEST_ASSERT(client.authentication_rejected());
+    broker.join();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,83 @@
+// Local includes.
+#include "Loopback_MQTT_Client.h"
+#include "NullLogger.h"
+#include "Server_Side_RPC.h"
+#include "Shared_Attribute_Update.h"
+#include "ThingsBoard.h"
+#include "Test.h"
+
+
+uint16_t constexpr BUFFER_SIZE = 256U;
+char constexpr RPC_REQUEST[] = "v1/devices/me/rpc/request/1";
+char constexpr SHARED_ATTRIBUTE_UPDATE[] = "v1/devices/me/attributes";
+char constexpr EMPTY_PAYLOAD[] = "{}";
+
+/// @brief Loopback client whose subscriptions can be made to fail, the same way they would if the SUBSCRIBE packet could not be sent
+class Failing_Subscribe_Client : public Loopback_MQTT_Client<8U, 8U, NullLogger> {
+  public:
+    bool subscribe(char const * topic) override {
+        return !m_fail_subscribe && Loopback_MQTT_Client::subscribe(topic);
+    }
+
+    bool subscribe(char const * const * topics, size_t const & count) override {
+        return !m_fail_subscribe && Loopback_MQTT_Client::subscribe(topics, count);
+    }
+
+    bool m_fail_subscribe = {};
+};
+
+/// @brief Injects an empty message on the given topic and delivers it
+/// @param client Client the message is injected into
+/// @param tb Instance that receives the message
+/// @param topic Topic the message is sent over
+/// @return Whether the message was delivered, because the topic was subscribed, or dropped
+template<typename ThingsBoard_Client>
+bool deliver(Failing_Subscribe_Client & client, ThingsBoard_Client & tb, char const * topic) {
+    size_t const dropped = client.get_dropped_count();
+    TEST_ASSERT(client.inject(topic, reinterpret_cast<uint8_t const *>(EMPTY_PAYLOAD), strlen(EMPTY_PAYLOAD)));
+    TEST_ASSERT(tb.loop());
+    return client.get_dropped_count() == dropped;
+}
+
+void ignore_request(JsonVariantConst const & data, JsonDocument & response) {
+    // Nothing to do
+}
+
+void ignore_update(JsonObjectConst const & data) {
+    // Nothing to do
+}
+
+int main() {
+    Failing_Subscribe_Client client;
+    Server_Side_RPC<2U, 2U, NullLogger> rpc;
+    Shared_Attribute_Update<2U, 2U, NullLogger> shared_update;
+    IAPI_Implementation * apis[2U] = { &rpc, &shared_update };
+    ThingsBoardSized<Default_Response_Amount, Default_Endpoints_Amount, NullLogger> tb(client, BUFFER_SIZE, BUFFER_SIZE, Default_Max_Stack_Size, apis + 0U, apis + 2U);
+
+    // Subscribing before connecting fails, the topic is then subscribed together with all other topics once connected
+    TEST_ASSERT(rpc.RPC_Subscribe(RPC_Callback("method", ignore_request)));
+    client.m_fail_subscribe = true;
+    TEST_ASSERT(tb.connect("localhost", "token"));
+    TEST_ASSERT(!deliver(client, tb, RPC_REQUEST));
+
+    // Topics whose subscription failed while connecting are kept and retried in the following loop() calls
+    client.m_fail_subscribe = false;
+    TEST_ASSERT(tb.loop());
+    TEST_ASSERT(deliver(client, tb, RPC_REQUEST));
+
+    // Failing to subscribe the first callback is retried by the next subscribed callback, instead of never being subscribed because the topic is shared
+    char const * keys[1U] = { "key" };
+    client.m_fail_subscribe = true;
+    TEST_ASSERT(shared_update.Shared_Attributes_Subscribe(Shared_Attribute_Callback<2U>(ignore_update, keys + 0U, keys + 1U)));
+    TEST_ASSERT(!deliver(client, tb, SHARED_ATTRIBUTE_UPDATE));
+    client.m_fail_subscribe = false;
+    TEST_ASSERT(shared_update.Shared_Attributes_Subscribe(Shared_Attribute_Callback<2U>(ignore_update, keys + 0U, keys + 1U)));
+    TEST_ASSERT(deliver(client, tb, SHARED_ATTRIBUTE_UPDATE));
+
+    // Unsubscribing removes the retried subscriptions like any other
+    TEST_ASSERT(rpc.RPC_Unsubscribe());
+    TEST_ASSERT(shared_update.Shared_Attributes_Unsubscribe());
+    TEST_ASSERT(!deliver(client, tb, RPC_REQUEST));
+    TEST_ASSERT(!deliver(client, tb, SHARED_ATTRIBUTE_UPDATE));
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,19 @@
+#ifndef Test_h
+#define Test_h
+
+// Library includes.
+#include <stdio.h>
+#include <stdlib.h>
+
+
+/// @brief Checks the given condition and ends the test with a failure, that contains the location and the failed condition, if it is not fulfilled.
+/// Each test is a seperate executable registered with add_test(), which fails if it returns a non zero exit code, therefore no further test framework is required
+#define TEST_ASSERT(condition) \
+    do { \
+        if (!(condition)) { \
+            fprintf(stderr, "%s:%d: Assertion failed: %s\n", __FILE__, __LINE__, #condition); \
+            exit(EXIT_FAILURE); \
+        } \
+    } while (false)
+
+#endif // Test_h
@@ -0,0 +1,105 @@
+#ifndef Test_Server_h
+#define Test_Server_h
+
+// Local include.
+#include "Test.h"
+
+// Library includes.
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+
+/// @brief Minimal blocking TCP server listening on a random free port of the loopback interface, used to stand in for the ThingsBoard server in tests of the POSIX clients.
+/// Is meant to be driven by a scripted test thread, which accepts the connection of the client under test and then reads and writes exactly the expected bytes
+class Test_Server {
+  public:
+    /// @brief Constructor, starts listening on a port choosen by the operating system, which can then be queried with port()
+    Test_Server()
+      : m_listen_socket(socket(AF_INET, SOCK_STREAM, 0))
+      , m_socket(-1)
+      , m_port(0U)
+    {
+        TEST_ASSERT(m_listen_socket >= 0);
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = 0U;
+        TEST_ASSERT(bind(m_listen_socket, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == 0);
+        TEST_ASSERT(listen(m_listen_socket, 4) == 0);
+        socklen_t length = sizeof(address);
+        TEST_ASSERT(getsockname(m_listen_socket, reinterpret_cast<sockaddr *>(&address), &length) == 0);
+        m_port = ntohs(address.sin_port);
+    }
+
+    /// @brief Destructor
+    ~Test_Server() {
+        close_client();
+        (void)close(m_listen_socket);
+    }
+
+    /// @brief Gets the port the server is listening on
+    /// @return Port choosen by the operating system
+    uint16_t port() const {
+        return m_port;
+    }
+
+    /// @brief Blocks until the next client connected, closes the previously accepted connection if there is any
+    void accept_client() {
+        close_client();
+        m_socket = accept(m_listen_socket, nullptr, nullptr);
+        TEST_ASSERT(m_socket >= 0);
+    }
+
+    /// @brief Closes the accepted connection, which the client notices as a lost connection
+    void close_client() {
+        if (m_socket >= 0) {
+            (void)close(m_socket);
+            m_socket = -1;
+        }
+    }
+
+    /// @brief Blocks until exactly the given amount of bytes has been received from the accepted client
+    /// @param data Output buffer the received bytes are copied into
+    /// @param length Amount of bytes that have to be received
+    /// @return Whether all bytes have been received or the connection was closed before
+    bool read_exact(uint8_t * data, size_t length) {
+        while (length != 0U) {
+            ssize_t const received = recv(m_socket, data, length, 0);
+            if (received <= 0) {
+                return false;
+            }
+            data += received;
+            length -= received;
+        }
+        return true;
+    }
+
+    /// @brief Sends all of the given bytes to the accepted client
+    /// @param data Bytes that should be sent
+    /// @param length Amount of bytes that should be sent
+    void write_all(uint8_t const * data, size_t length) {
+        while (length != 0U) {
+            ssize_t const sent = send(m_socket, data, length, MSG_NOSIGNAL);
+            TEST_ASSERT(sent > 0);
+            data += sent;
+            length -= sent;
+        }
+    }
+
+    /// @brief Sends the given string to the accepted client, without its null terminator
+    /// @param data String that should be sent
+    void write_string(char const * data) {
+        write_all(reinterpret_cast<uint8_t const *>(data), strlen(data));
+    }
+
+  private:
+    int      m_listen_socket = {}; // File descriptor of the listening socket
+    int      m_socket = {};        // File descriptor of the accepted client connection, -1 if no client is connected
+    uint16_t m_port = {};          // Port the listening socket is bound to
+};
+
+#endif // Test_Server_h